@@ -0,0 +1,674 @@
+/****************************************************************************
+ * apps/canutils/canardnode/canard_node.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <nuttx/can/can.h>
+
+#include "canutils/canard_node.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CANARDNODE_TICK_USEC   (CONFIG_CANARDNODE_TICK_MS * 1000)
+#define CANARDNODE_CLEANUP_MS  1000
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: canard_node_now
+ *
+ * Description:
+ *   Return the monotonic time in microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t canard_node_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: canard_node_link
+ *
+ * Description:
+ *   Link a timer into the wheel so that it expires "ticks" ticks from now.
+ *
+ ****************************************************************************/
+
+static void canard_node_link(FAR struct canard_node_s *node,
+                             FAR struct canard_node_timer_s *timer)
+{
+  timer->rounds = (timer->ticks - 1) / CONFIG_CANARDNODE_WHEEL_SLOTS;
+  timer->slot   = (node->tick + timer->ticks) %
+                  CONFIG_CANARDNODE_WHEEL_SLOTS;
+  timer->flink  = node->wheel[timer->slot];
+  node->wheel[timer->slot] = timer;
+}
+
+/****************************************************************************
+ * Name: canard_node_unlink
+ *
+ * Description:
+ *   Remove a timer from the list at "head".  Returns true if it was found.
+ *
+ ****************************************************************************/
+
+static bool canard_node_unlink(FAR struct canard_node_timer_s **head,
+                               FAR struct canard_node_timer_s *timer)
+{
+  FAR struct canard_node_timer_s **prev;
+
+  for (prev = head; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == timer)
+        {
+          *prev = timer->flink;
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: canard_node_expire
+ *
+ * Description:
+ *   Advance the timer wheel up to "now" and run the expired timers.
+ *
+ ****************************************************************************/
+
+static void canard_node_expire(FAR struct canard_node_s *node, uint64_t now)
+{
+  FAR struct canard_node_timer_s *timer;
+  uint16_t slot;
+
+  while (now >= node->nexttick)
+    {
+      node->tick++;
+      node->nexttick += CANARDNODE_TICK_USEC;
+
+      /* Detach the slot, then re-link or fire each timer.  Timers are
+       * re-linked before their callback runs so that the callback may
+       * stop or restart them.  A callback may also stop a timer that is
+       * still waiting in the detached list, so it is unlinked from there
+       * and no longer fires.
+       */
+
+      slot = node->tick % CONFIG_CANARDNODE_WHEEL_SLOTS;
+      node->expiring    = node->wheel[slot];
+      node->wheel[slot] = NULL;
+
+      while ((timer = node->expiring) != NULL)
+        {
+          node->expiring = timer->flink;
+
+          if (!timer->active)
+            {
+              continue;
+            }
+
+          if (timer->rounds > 0)
+            {
+              timer->rounds--;
+              timer->flink = node->wheel[slot];
+              node->wheel[slot] = timer;
+              continue;
+            }
+
+          canard_node_link(node, timer);
+          timer->callback(node, timer->arg, now);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: canard_node_timeout
+ *
+ * Description:
+ *   Return the milliseconds until the next wheel slot that holds a timer.
+ *   Empty slots are skipped so that an idle node does not wake up on every
+ *   tick.
+ *
+ ****************************************************************************/
+
+static int canard_node_timeout(FAR struct canard_node_s *node, uint64_t now)
+{
+  uint64_t expiry;
+  int i;
+
+  for (i = 1; i < CONFIG_CANARDNODE_WHEEL_SLOTS; i++)
+    {
+      if (node->wheel[(node->tick + i) % CONFIG_CANARDNODE_WHEEL_SLOTS] !=
+          NULL)
+        {
+          break;
+        }
+    }
+
+  expiry = node->nexttick + (uint64_t)(i - 1) * CANARDNODE_TICK_USEC;
+  return now >= expiry ? 0 : (int)((expiry - now + 999) / 1000);
+}
+
+/****************************************************************************
+ * Name: canard_node_cleanup
+ *
+ * Description:
+ *   Periodic purge of stale RX transfers.
+ *
+ ****************************************************************************/
+
+static void canard_node_cleanup(FAR struct canard_node_s *node,
+                                FAR void *arg, uint64_t now)
+{
+  canardCleanupStaleTransfers(&node->canard, now);
+}
+
+/****************************************************************************
+ * Name: canard_node_onreception
+ *
+ * Description:
+ *   libcanard reception callback.  Accounts the RX-to-handler latency and
+ *   forwards the transfer to the application.
+ *
+ ****************************************************************************/
+
+static void canard_node_onreception(FAR CanardInstance *ins,
+                                    FAR CanardRxTransfer *transfer)
+{
+  FAR struct canard_node_s *node = canard_node_getnode(ins);
+  uint64_t latency = canard_node_now() - node->rxtime;
+
+  node->stats.rx_transfers++;
+  node->stats.rx_latency_sum += latency;
+  if (latency > node->stats.rx_latency_max)
+    {
+      node->stats.rx_latency_max = (uint32_t)latency;
+    }
+
+  if (node->onreception != NULL)
+    {
+      node->onreception(ins, transfer);
+    }
+}
+
+/****************************************************************************
+ * Name: canard_node_receive
+ *
+ * Description:
+ *   Read all frames available in one read() and feed them to libcanard.
+ *
+ ****************************************************************************/
+
+static int canard_node_receive(FAR struct canard_node_s *node)
+{
+  FAR struct can_msg_s *msg;
+  CanardCANFrame frame;
+  ssize_t nbytes;
+  size_t offset;
+  size_t msglen;
+
+  nbytes = read(node->fd, node->rxbuf, sizeof(node->rxbuf));
+  if (nbytes < 0)
+    {
+      if (errno == EAGAIN || errno == EINTR)
+        {
+          return OK;
+        }
+
+      node->stats.rx_errors++;
+      return -errno;
+    }
+
+  node->stats.rx_reads++;
+
+  /* The driver returns whole messages, each CAN_MSGLEN(dlc) bytes long */
+
+  for (offset = 0; offset + CAN_MSGLEN(0) <= (size_t)nbytes;
+       offset += msglen)
+    {
+      msg    = (FAR struct can_msg_s *)&node->rxbuf[offset];
+      msglen = CAN_MSGLEN(msg->cm_hdr.ch_dlc);
+
+#ifdef CONFIG_CAN_ERRORS
+      if (msg->cm_hdr.ch_error)
+        {
+          continue;
+        }
+#endif
+
+      frame.id = msg->cm_hdr.ch_id;
+      if (msg->cm_hdr.ch_extid)
+        {
+          frame.id |= CANARD_CAN_FRAME_EFF;
+        }
+
+      if (msg->cm_hdr.ch_rtr)
+        {
+          frame.id |= CANARD_CAN_FRAME_RTR;
+        }
+
+      frame.data_len = msg->cm_hdr.ch_dlc;
+      memcpy(frame.data, msg->cm_data, msg->cm_hdr.ch_dlc);
+
+      node->stats.rx_frames++;
+      canardHandleRxFrame(&node->canard, &frame, node->rxtime);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: canard_node_stage
+ *
+ * Description:
+ *   Move frames from the libcanard TX queue into the TX batch buffer.
+ *
+ ****************************************************************************/
+
+static void canard_node_stage(FAR struct canard_node_s *node)
+{
+  FAR const CanardCANFrame *frame;
+  FAR struct can_msg_s *msg;
+
+  while ((frame = canardPeekTxQueue(&node->canard)) != NULL)
+    {
+      if (node->txlen + CAN_MSGLEN(frame->data_len) > sizeof(node->txbuf))
+        {
+          node->stats.tx_full++;
+          break;
+        }
+
+      msg = (FAR struct can_msg_s *)&node->txbuf[node->txlen];
+      memset(&msg->cm_hdr, 0, sizeof(msg->cm_hdr));
+
+      msg->cm_hdr.ch_id    = frame->id & CANARD_CAN_EXT_ID_MASK;
+      msg->cm_hdr.ch_dlc   = frame->data_len;
+      msg->cm_hdr.ch_extid = (frame->id & CANARD_CAN_FRAME_EFF) != 0;
+      msg->cm_hdr.ch_rtr   = (frame->id & CANARD_CAN_FRAME_RTR) != 0;
+      memcpy(msg->cm_data, frame->data, frame->data_len);
+
+      node->txlen += CAN_MSGLEN(frame->data_len);
+      node->txcount++;
+      canardPopTxQueue(&node->canard);
+    }
+
+  if (node->txcount > node->stats.tx_queue_hwm)
+    {
+      node->stats.tx_queue_hwm = node->txcount;
+    }
+}
+
+/****************************************************************************
+ * Name: canard_node_transmit
+ *
+ * Description:
+ *   Write the TX batch buffer with one write().  The driver accepts as many
+ *   whole messages as fit in its queue; the remainder stays buffered until
+ *   the device is writable again.
+ *
+ ****************************************************************************/
+
+static int canard_node_transmit(FAR struct canard_node_s *node)
+{
+  FAR struct can_msg_s *msg;
+  ssize_t nbytes;
+  size_t offset;
+  int ret = OK;
+
+  canard_node_stage(node);
+
+  if (node->txlen == 0)
+    {
+      return OK;
+    }
+
+  nbytes = write(node->fd, node->txbuf, node->txlen);
+  node->stats.tx_writes++;
+
+  if (nbytes < 0)
+    {
+      if (errno == EAGAIN || errno == EINTR)
+        {
+          return OK;
+        }
+
+      /* Drop the whole batch rather than retrying a failing device */
+
+      ret = -errno;
+      node->stats.tx_errors += node->txcount;
+      node->txlen   = 0;
+      node->txcount = 0;
+      return ret;
+    }
+
+  /* Count the messages that were accepted */
+
+  for (offset = 0; offset < (size_t)nbytes; )
+    {
+      msg = (FAR struct can_msg_s *)&node->txbuf[offset];
+      offset += CAN_MSGLEN(msg->cm_hdr.ch_dlc);
+      node->stats.tx_frames++;
+      node->txcount--;
+    }
+
+  node->txlen -= nbytes;
+  if (node->txlen > 0)
+    {
+      memmove(node->txbuf, &node->txbuf[nbytes], node->txlen);
+    }
+
+  /* Room was made; pick up frames that did not fit before */
+
+  canard_node_stage(node);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: canard_node_initialize
+ *
+ * Description:
+ *   Open the CAN device and initialize libcanard.  "onreception" and
+ *   "shouldaccept" are the usual libcanard callbacks; "arg" can be
+ *   retrieved from the callbacks with canard_node_getarg().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int canard_node_initialize(FAR struct canard_node_s *node,
+                           FAR const char *devpath,
+                           FAR void *mempool, size_t poolsize,
+                           uint8_t nodeid,
+                           CanardOnTransferReception onreception,
+                           CanardShouldAcceptTransfer shouldaccept,
+                           FAR void *arg)
+{
+  memset(node, 0, sizeof(*node));
+
+  node->fd = open(devpath, O_RDWR | O_NONBLOCK);
+  if (node->fd < 0)
+    {
+      return -errno;
+    }
+
+  node->onreception = onreception;
+  node->arg         = arg;
+  node->nexttick    = canard_node_now() + CANARDNODE_TICK_USEC;
+
+  canardInit(&node->canard, mempool, poolsize, canard_node_onreception,
+             shouldaccept, node);
+  canardSetLocalNodeID(&node->canard, nodeid);
+
+  return canard_node_timer_start(node, &node->cleanup,
+                                 CANARDNODE_CLEANUP_MS,
+                                 canard_node_cleanup, NULL);
+}
+
+/****************************************************************************
+ * Name: canard_node_uninitialize
+ *
+ * Description:
+ *   Close the CAN device.
+ *
+ ****************************************************************************/
+
+void canard_node_uninitialize(FAR struct canard_node_s *node)
+{
+  if (node->fd >= 0)
+    {
+      close(node->fd);
+      node->fd = -1;
+    }
+}
+
+/****************************************************************************
+ * Name: canard_node_getnode / canard_node_getarg
+ *
+ * Description:
+ *   Get the runtime instance or the application argument from the
+ *   libcanard instance passed to the callbacks.
+ *
+ ****************************************************************************/
+
+FAR struct canard_node_s *canard_node_getnode(FAR CanardInstance *ins)
+{
+  return (FAR struct canard_node_s *)canardGetUserReference(ins);
+}
+
+FAR void *canard_node_getarg(FAR CanardInstance *ins)
+{
+  return canard_node_getnode(ins)->arg;
+}
+
+/****************************************************************************
+ * Name: canard_node_timer_start
+ *
+ * Description:
+ *   Start a periodic timer.  The period is rounded up to the wheel tick
+ *   (CONFIG_CANARDNODE_TICK_MS).  The callback runs in the context of
+ *   canard_node_spin() and may queue transfers.
+ *
+ ****************************************************************************/
+
+int canard_node_timer_start(FAR struct canard_node_s *node,
+                            FAR struct canard_node_timer_s *timer,
+                            uint32_t period_ms,
+                            canard_node_timer_t callback, FAR void *arg)
+{
+  if (callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (timer->active)
+    {
+      canard_node_timer_stop(node, timer);
+    }
+
+  timer->callback = callback;
+  timer->arg      = arg;
+  timer->ticks    = (period_ms + CONFIG_CANARDNODE_TICK_MS - 1) /
+                    CONFIG_CANARDNODE_TICK_MS;
+  if (timer->ticks == 0)
+    {
+      timer->ticks = 1;
+    }
+
+  timer->active = true;
+  canard_node_link(node, timer);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: canard_node_timer_stop
+ *
+ * Description:
+ *   Stop a periodic timer.  It is safe to call from the timer callback.
+ *
+ ****************************************************************************/
+
+void canard_node_timer_stop(FAR struct canard_node_s *node,
+                            FAR struct canard_node_timer_s *timer)
+{
+  if (!timer->active)
+    {
+      return;
+    }
+
+  /* If it is not in the wheel, it is waiting in the slot being expired */
+
+  if (!canard_node_unlink(&node->wheel[timer->slot], timer))
+    {
+      canard_node_unlink(&node->expiring, timer);
+    }
+
+  timer->flink  = NULL;
+  timer->active = false;
+}
+
+/****************************************************************************
+ * Name: canard_node_spin
+ *
+ * Description:
+ *   Run one iteration of the event loop:  Wait up to "timeout_ms" (or until
+ *   the next timer tick) for the CAN device to become readable or, if
+ *   frames are waiting, writable; then receive, expire timers and transmit.
+ *   A negative timeout waits for events or timers only.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int canard_node_spin(FAR struct canard_node_s *node, int timeout_ms)
+{
+  struct pollfd fds;
+  uint64_t now;
+  int tickms;
+  int ret;
+
+  /* Never sleep past the next timer expiry */
+
+  now    = canard_node_now();
+  tickms = canard_node_timeout(node, now);
+
+  if (timeout_ms < 0 || timeout_ms > tickms)
+    {
+      timeout_ms = tickms;
+    }
+
+  fds.fd      = node->fd;
+  fds.events  = POLLIN;
+  fds.revents = 0;
+
+  if (node->txlen > 0)
+    {
+      fds.events |= POLLOUT;
+    }
+
+  ret = poll(&fds, 1, timeout_ms);
+  if (ret < 0 && errno != EINTR)
+    {
+      return -errno;
+    }
+
+  node->rxtime = canard_node_now();
+
+  if (ret > 0 && (fds.revents & POLLIN) != 0)
+    {
+      ret = canard_node_receive(node);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  canard_node_expire(node, node->rxtime);
+
+  /* Handlers and timers may have queued transfers:  Send them right away
+   * rather than waiting for the next POLLOUT.
+   */
+
+  return canard_node_transmit(node);
+}
+
+/****************************************************************************
+ * Name: canard_node_run
+ *
+ * Description:
+ *   Run the event loop until canard_node_stop() is called.
+ *
+ ****************************************************************************/
+
+int canard_node_run(FAR struct canard_node_s *node)
+{
+  int ret = OK;
+
+  node->stop = false;
+
+  while (!node->stop)
+    {
+      ret = canard_node_spin(node, -1);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: canard_node_stop
+ *
+ * Description:
+ *   Make canard_node_run() return after the current iteration.
+ *
+ ****************************************************************************/
+
+void canard_node_stop(FAR struct canard_node_s *node)
+{
+  node->stop = true;
+}
+
+/****************************************************************************
+ * Name: canard_node_getstats / canard_node_resetstats
+ *
+ * Description:
+ *   Get or reset the runtime counters.
+ *
+ ****************************************************************************/
+
+void canard_node_getstats(FAR struct canard_node_s *node,
+                          FAR struct canard_node_stats_s *stats)
+{
+  memcpy(stats, &node->stats, sizeof(*stats));
+}
+
+void canard_node_resetstats(FAR struct canard_node_s *node)
+{
+  memset(&node->stats, 0, sizeof(node->stats));
+}
@@ -40,6 +40,101 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: obd_set_filters
+ *
+ * Description:
+ *   Install CAN ID filters in the driver so that only ECU responses are
+ *   received.  Drivers without filter support keep receiving all frames.
+ *
+ *   Returns OK or a negated errno value.
+ *
+ ****************************************************************************/
+
+int obd_set_filters(FAR struct obd_dev_s *dev)
+{
+  int ret;
+
+  if (dev->can_filter >= 0)
+    {
+      return OK;
+    }
+
+  if (dev->can_mode == CAN_EXT)
+    {
+#ifdef CONFIG_CAN_EXTID
+      struct canioc_extfilter_s xfilter;
+
+      /* Responses 0x18daf1xx: Any ECU answering the tester 0xf1 */
+
+      xfilter.xf_id1  = OBD_PID_EXT_RESPONSE & 0x1fffff00;
+      xfilter.xf_id2  = 0x1fffff00;
+      xfilter.xf_type = CAN_FILTER_MASK;
+      xfilter.xf_prio = CAN_MSGPRIO_HIGH;
+
+      ret = ioctl(dev->can_fd, CANIOC_ADD_EXTFILTER,
+                  (unsigned long)((uintptr_t)&xfilter));
+#else
+      return -ENOSYS;
+#endif
+    }
+  else
+    {
+      struct canioc_stdfilter_s sfilter;
+
+      /* Responses 0x7e8-0x7ef: ECUs #1 to #8 */
+
+      sfilter.sf_id1  = OBD_PID_STD_RESPONSE;
+      sfilter.sf_id2  = 0x7f8;
+      sfilter.sf_type = CAN_FILTER_MASK;
+      sfilter.sf_prio = CAN_MSGPRIO_HIGH;
+
+      ret = ioctl(dev->can_fd, CANIOC_ADD_STDFILTER,
+                  (unsigned long)((uintptr_t)&sfilter));
+    }
+
+  if (ret < 0)
+    {
+      return -errno;
+    }
+
+  /* The driver returns the ID needed to remove the filter again */
+
+  dev->can_filter = ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: obd_clear_filters
+ *
+ * Description:
+ *   Remove the filters installed by obd_set_filters(), if any.
+ *
+ ****************************************************************************/
+
+void obd_clear_filters(FAR struct obd_dev_s *dev)
+{
+  if (dev->can_filter < 0)
+    {
+      return;
+    }
+
+#ifdef CONFIG_CAN_EXTID
+  if (dev->can_mode == CAN_EXT)
+    {
+      ioctl(dev->can_fd, CANIOC_DEL_EXTFILTER,
+            (unsigned long)dev->can_filter);
+    }
+  else
+#endif
+    {
+      ioctl(dev->can_fd, CANIOC_DEL_STDFILTER,
+            (unsigned long)dev->can_filter);
+    }
+
+  dev->can_filter = -1;
+}
+
 /****************************************************************************
  * Name: obd_init
  *
@@ -103,7 +198,11 @@ struct obd_dev_s *obd_init(char *devfile, int baudate, int mode)
       return NULL;
     }
 
-  dev->can_mode = mode;
+  dev->can_mode   = mode;
+  dev->can_filter = -1;
+  dev->datalen    = 0;
+  dev->nresp      = 0;
+  dev->necus      = 0;
 
   printf("OBD-II device initialized!\n");
 
@@ -42,12 +42,84 @@
 
 #define MAXDATA 16
 
+/* Number of mode 01/02 PIDs known to the numeric decoder (0x00-0x3f) */
+
+#define OBD_NPIDS 0x40
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Conversion from the data bytes A, B to the physical value */
+
+enum obd_conv_e
+{
+  OBD_CONV_RAW = 0,    /* Bit-encoded or plain count: raw value            */
+  OBD_CONV_PERCENT,    /* A * 100 / 255                        (%)         */
+  OBD_CONV_TEMP,       /* A - 40                               (degC)      */
+  OBD_CONV_FUELTRIM,   /* A * 100 / 128 - 100                  (%)         */
+  OBD_CONV_X3,         /* A * 3                                (kPa)       */
+  OBD_CONV_RPM,        /* (256A + B) / 4                       (rpm)       */
+  OBD_CONV_ADVANCE,    /* A / 2 - 64                           (degrees)   */
+  OBD_CONV_MAF,        /* (256A + B) / 100                     (g/s)       */
+  OBD_CONV_O2VOLT,     /* A / 200                              (V)         */
+  OBD_CONV_WORD,       /* 256A + B                                         */
+  OBD_CONV_RAILVAC,    /* (256A + B) * 0.079                   (kPa)       */
+  OBD_CONV_RAILDI,     /* (256A + B) * 10                      (kPa)       */
+  OBD_CONV_LAMBDA,     /* (256A + B) * 2 / 65536               (ratio)     */
+  OBD_CONV_EVAP,       /* (int16_t)(256A + B) / 4              (Pa)        */
+  OBD_CONV_LAMBDAC,    /* (256A + B) / 32768                   (ratio)     */
+  OBD_CONV_CATTEMP     /* (256A + B) / 10 - 40                 (degC)      */
+};
+
+struct obd_pidinfo_s
+{
+  uint8_t len;         /* Number of data bytes */
+  uint8_t conv;        /* enum obd_conv_e */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 static char g_data[MAXDATA];
 
+static const struct obd_pidinfo_s g_pidinfo[OBD_NPIDS] =
+{
+  {4, OBD_CONV_RAW},      {4, OBD_CONV_RAW},      /* 0x00 - 0x01 */
+  {2, OBD_CONV_RAW},      {2, OBD_CONV_RAW},      /* 0x02 - 0x03 */
+  {1, OBD_CONV_PERCENT},  {1, OBD_CONV_TEMP},     /* 0x04 - 0x05 */
+  {1, OBD_CONV_FUELTRIM}, {1, OBD_CONV_FUELTRIM}, /* 0x06 - 0x07 */
+  {1, OBD_CONV_FUELTRIM}, {1, OBD_CONV_FUELTRIM}, /* 0x08 - 0x09 */
+  {1, OBD_CONV_X3},       {1, OBD_CONV_RAW},      /* 0x0a - 0x0b */
+  {2, OBD_CONV_RPM},      {1, OBD_CONV_RAW},      /* 0x0c - 0x0d */
+  {1, OBD_CONV_ADVANCE},  {1, OBD_CONV_TEMP},     /* 0x0e - 0x0f */
+  {2, OBD_CONV_MAF},      {1, OBD_CONV_PERCENT},  /* 0x10 - 0x11 */
+  {1, OBD_CONV_RAW},      {1, OBD_CONV_RAW},      /* 0x12 - 0x13 */
+  {2, OBD_CONV_O2VOLT},   {2, OBD_CONV_O2VOLT},   /* 0x14 - 0x15 */
+  {2, OBD_CONV_O2VOLT},   {2, OBD_CONV_O2VOLT},   /* 0x16 - 0x17 */
+  {2, OBD_CONV_O2VOLT},   {2, OBD_CONV_O2VOLT},   /* 0x18 - 0x19 */
+  {2, OBD_CONV_O2VOLT},   {2, OBD_CONV_O2VOLT},   /* 0x1a - 0x1b */
+  {1, OBD_CONV_RAW},      {1, OBD_CONV_RAW},      /* 0x1c - 0x1d */
+  {1, OBD_CONV_RAW},      {2, OBD_CONV_WORD},     /* 0x1e - 0x1f */
+  {4, OBD_CONV_RAW},      {2, OBD_CONV_WORD},     /* 0x20 - 0x21 */
+  {2, OBD_CONV_RAILVAC},  {2, OBD_CONV_RAILDI},   /* 0x22 - 0x23 */
+  {4, OBD_CONV_LAMBDA},   {4, OBD_CONV_LAMBDA},   /* 0x24 - 0x25 */
+  {4, OBD_CONV_LAMBDA},   {4, OBD_CONV_LAMBDA},   /* 0x26 - 0x27 */
+  {4, OBD_CONV_LAMBDA},   {4, OBD_CONV_LAMBDA},   /* 0x28 - 0x29 */
+  {4, OBD_CONV_LAMBDA},   {4, OBD_CONV_LAMBDA},   /* 0x2a - 0x2b */
+  {1, OBD_CONV_PERCENT},  {1, OBD_CONV_FUELTRIM}, /* 0x2c - 0x2d */
+  {1, OBD_CONV_PERCENT},  {1, OBD_CONV_PERCENT},  /* 0x2e - 0x2f */
+  {1, OBD_CONV_RAW},      {2, OBD_CONV_WORD},     /* 0x30 - 0x31 */
+  {2, OBD_CONV_EVAP},     {1, OBD_CONV_RAW},      /* 0x32 - 0x33 */
+  {4, OBD_CONV_LAMBDAC},  {4, OBD_CONV_LAMBDAC},  /* 0x34 - 0x35 */
+  {4, OBD_CONV_LAMBDAC},  {4, OBD_CONV_LAMBDAC},  /* 0x36 - 0x37 */
+  {4, OBD_CONV_LAMBDAC},  {4, OBD_CONV_LAMBDAC},  /* 0x38 - 0x39 */
+  {4, OBD_CONV_LAMBDAC},  {4, OBD_CONV_LAMBDAC},  /* 0x3a - 0x3b */
+  {2, OBD_CONV_CATTEMP},  {2, OBD_CONV_CATTEMP},  /* 0x3c - 0x3d */
+  {2, OBD_CONV_CATTEMP},  {2, OBD_CONV_CATTEMP},  /* 0x3e - 0x3f */
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -118,3 +190,203 @@ FAR char *obd_decode_pid(FAR struct obd_dev_s *dev, uint8_t pid)
 
   return g_data;
 }
+
+/****************************************************************************
+ * Name: obd_pid_datalen
+ *
+ * Description:
+ *   Return the number of data bytes of a mode 01/02 PID or a negated errno
+ *   value if the PID is not known.
+ *
+ ****************************************************************************/
+
+int obd_pid_datalen(uint8_t pid)
+{
+  if (pid >= OBD_NPIDS)
+    {
+      return -ENOENT;
+    }
+
+  return g_pidinfo[pid].len;
+}
+
+/****************************************************************************
+ * Name: obd_decode_value
+ *
+ * Description:
+ *   Decode the data bytes of one mode 01/02 PID to a number.  Bit-encoded
+ *   PIDs report the raw data in both "raw" and "value".
+ *
+ *   It will return OK or a negated errno value if the PID is not known.
+ *
+ ****************************************************************************/
+
+int obd_decode_value(uint8_t pid, FAR const uint8_t *data,
+                     FAR struct obd_value_s *value)
+{
+  FAR const struct obd_pidinfo_s *info;
+  uint32_t ab;
+  float a;
+  int i;
+
+  if (pid >= OBD_NPIDS)
+    {
+      return -ENOENT;
+    }
+
+  info = &g_pidinfo[pid];
+
+  value->pid = pid;
+  value->len = info->len;
+  value->raw = 0;
+
+  for (i = 0; i < info->len; i++)
+    {
+      value->raw = (value->raw << 8) | data[i];
+    }
+
+  /* Most formulas only use the first one or two bytes */
+
+  a  = data[0];
+  ab = info->len >= 2 ? ((uint32_t)data[0] << 8) | data[1] : data[0];
+
+  switch (info->conv)
+    {
+      case OBD_CONV_PERCENT:
+        value->value = a * 100.0f / 255.0f;
+        break;
+
+      case OBD_CONV_TEMP:
+        value->value = a - 40.0f;
+        break;
+
+      case OBD_CONV_FUELTRIM:
+        value->value = a * 100.0f / 128.0f - 100.0f;
+        break;
+
+      case OBD_CONV_X3:
+        value->value = a * 3.0f;
+        break;
+
+      case OBD_CONV_RPM:
+        value->value = ab / 4.0f;
+        break;
+
+      case OBD_CONV_ADVANCE:
+        value->value = a / 2.0f - 64.0f;
+        break;
+
+      case OBD_CONV_MAF:
+        value->value = ab / 100.0f;
+        break;
+
+      case OBD_CONV_O2VOLT:
+        value->value = a / 200.0f;
+        break;
+
+      case OBD_CONV_WORD:
+        value->value = ab;
+        break;
+
+      case OBD_CONV_RAILVAC:
+        value->value = ab * 0.079f;
+        break;
+
+      case OBD_CONV_RAILDI:
+        value->value = ab * 10.0f;
+        break;
+
+      case OBD_CONV_LAMBDA:
+        value->value = ab * 2.0f / 65536.0f;
+        break;
+
+      case OBD_CONV_EVAP:
+        value->value = (int16_t)ab / 4.0f;
+        break;
+
+      case OBD_CONV_LAMBDAC:
+        value->value = ab / 32768.0f;
+        break;
+
+      case OBD_CONV_CATTEMP:
+        value->value = ab / 10.0f - 40.0f;
+        break;
+
+      case OBD_CONV_RAW:
+      default:
+        value->value = value->raw;
+        break;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: obd_decode_response
+ *
+ * Description:
+ *   Decode all PIDs in the responses received by
+ *   obd_wait_response_multi(), in the order the ECUs started answering.
+ *
+ *   It will return the number of decoded values or a negated errno value.
+ *
+ ****************************************************************************/
+
+int obd_decode_response(FAR struct obd_dev_s *dev,
+                        FAR struct obd_value_s *values, int nvalues)
+{
+  FAR struct obd_response_s *resp;
+  FAR const uint8_t *data;
+  uint16_t offset;
+  int datalen;
+  int skip;
+  int count = 0;
+  int error = OK;
+  int i;
+
+  for (i = 0; i < dev->nresp && count < nvalues; i++)
+    {
+      resp = &dev->resp[i];
+      if (resp->len < resp->total || resp->len < 1)
+        {
+          continue;
+        }
+
+      /* The payload is a list of PID, data.  Freeze frame responses carry
+       * the frame number between each PID and its data.
+       */
+
+      data = &dev->data[resp->offset];
+      skip = data[0] == OBD_SHOW_FREEZED_DATA + OBD_RESP_BASE ? 1 : 0;
+
+      /* Skip the response mode byte */
+
+      offset = 1;
+      while (offset < resp->len && count < nvalues)
+        {
+          datalen = obd_pid_datalen(data[offset]);
+          if (datalen < 0)
+            {
+              /* The length of an unknown PID is unknown, so nothing after
+               * it can be decoded.
+               */
+
+              break;
+            }
+
+          if (offset + 1 + skip + datalen > resp->len)
+            {
+              error = -EPROTO;
+              break;
+            }
+
+          obd_decode_value(data[offset], &data[offset + 1 + skip],
+                           &values[count]);
+          values[count].ecuid = resp->ecuid;
+          offset += 1 + skip + datalen;
+          count++;
+        }
+    }
+
+  return count > 0 ? count : error;
+}
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * apps/canutils/libobd2/obd_pollpids.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <nuttx/can/can.h>
+
+#include "canutils/obd.h"
+#include "canutils/obd_pid.h"
+#include "canutils/obd_frame.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: obd_poll_pids
+ *
+ * Description:
+ *   Read any number of PIDs.  The PIDs are requested in groups of
+ *   OBD_MAX_PIDS (OBD_MAX_FF_PIDS in mode 02) and the responses of all
+ *   ECUs are decoded into the "nvalues" entries of "values", in the order
+ *   they were reported.  Every group is requested even if "values" is
+ *   full.  Responses to each group are collected for up to "timeout"
+ *   milliseconds, see obd_wait_response_multi().  The response filters
+ *   are installed once for the whole poll.
+ *
+ *   It will return the number of decoded values or a negated errno value.
+ *
+ ****************************************************************************/
+
+int obd_poll_pids(FAR struct obd_dev_s *dev, uint8_t opmode,
+                  FAR const uint8_t *pids, int npids,
+                  FAR struct obd_value_s *values, int nvalues,
+                  int timeout)
+{
+  int count = 0;
+  int error = -ETIMEDOUT;
+  int maxpids;
+  int group;
+  int ret;
+  int i;
+
+  maxpids = opmode == OBD_SHOW_FREEZED_DATA ? OBD_MAX_FF_PIDS :
+                                              OBD_MAX_PIDS;
+
+  /* Only wake up for ECU responses if the driver supports filtering */
+
+  ret = obd_set_filters(dev);
+  if (ret < 0 && ret != -ENOTTY)
+    {
+      printf("WARNING: Failed to set the CAN filters: %d\n", ret);
+    }
+
+  for (i = 0; i < npids; i += group)
+    {
+      group = npids - i;
+      if (group > maxpids)
+        {
+          group = maxpids;
+        }
+
+      ret = obd_send_request_multi(dev, opmode, &pids[i], group);
+      if (ret < 0)
+        {
+          error = ret;
+          break;
+        }
+
+      /* An ECU may not answer a group with unsupported PIDs; carry on
+       * with the next group.
+       */
+
+      ret = obd_wait_response_multi(dev, opmode, timeout);
+      if (ret >= 0)
+        {
+          ret = obd_decode_response(dev, &values[count], nvalues - count);
+        }
+
+      if (ret < 0)
+        {
+          error = ret;
+          continue;
+        }
+
+      count += ret;
+    }
+
+  obd_clear_filters(dev);
+  return count > 0 ? count : error;
+}
@@ -28,6 +28,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <nuttx/can/can.h>
@@ -134,3 +136,83 @@ int obd_send_request(FAR struct obd_dev_s *dev, uint8_t opmode, uint8_t pid)
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: obd_send_request_multi
+ *
+ * Description:
+ *   Send a "Request Message" for up to OBD_MAX_PIDS PIDs in one single
+ *   frame.  In mode 02, up to OBD_MAX_FF_PIDS PIDs of freeze frame 0 are
+ *   requested.
+ *
+ *   It will return an error case the message fails to be sent.
+ *
+ ****************************************************************************/
+
+int obd_send_request_multi(FAR struct obd_dev_s *dev, uint8_t opmode,
+                           FAR const uint8_t *pids, int npids)
+{
+  int nbytes;
+  int msgsize;
+  int step;
+  int i;
+
+  /* Freeze frame requests carry a frame number after each PID */
+
+  step = opmode == OBD_SHOW_FREEZED_DATA ? 2 : 1;
+
+  if (npids < 1 || npids * step > OBD_MAX_PIDS)
+    {
+      return -EINVAL;
+    }
+
+  /* Construct the TX message header */
+
+  if (dev->can_mode == CAN_EXT)
+    {
+#ifdef CONFIG_CAN_EXTID
+      dev->can_txmsg.cm_hdr.ch_id   = OBD_PID_EXT_REQUEST;
+      dev->can_txmsg.cm_hdr.ch_extid = true;
+#else
+      return -ENOSYS;
+#endif
+    }
+  else
+    {
+      dev->can_txmsg.cm_hdr.ch_id   = OBD_PID_STD_REQUEST;
+#ifdef CONFIG_CAN_EXTID
+      dev->can_txmsg.cm_hdr.ch_extid = false;
+#endif
+    }
+
+  dev->can_txmsg.cm_hdr.ch_rtr    = false;
+  dev->can_txmsg.cm_hdr.ch_dlc    = 8;
+  dev->can_txmsg.cm_hdr.ch_unused = 0;
+
+  /* Single Frame: Mode followed by the PIDs, padded to 8 bytes.  The
+   * frame numbers are left 0, the only freeze frame most ECUs store.
+   */
+
+  memset(dev->can_txmsg.cm_data, 0, 8);
+  dev->can_txmsg.cm_data[0] = OBD_SINGLE_FRAME |
+                              OBD_SF_DATA_LEN((npids * step + 1));
+  dev->can_txmsg.cm_data[1] = opmode;
+
+  for (i = 0; i < npids; i++)
+    {
+      dev->can_txmsg.cm_data[2 + i * step] = pids[i];
+    }
+
+  /* Send the TX message */
+
+  msgsize = CAN_MSGLEN(8);
+  nbytes = write(dev->can_fd, &dev->can_txmsg, msgsize);
+  if (nbytes != msgsize)
+    {
+      printf("ERROR: write(%ld) returned %ld\n",
+             (long)msgsize, (long)nbytes);
+      return -EAGAIN;
+    }
+
+  return OK;
+}
@@ -31,12 +31,157 @@
 #include <string.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
 #include <nuttx/can/can.h>
 
 #include "canutils/obd.h"
 #include "canutils/obd_pid.h"
 #include "canutils/obd_frame.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flow control status values */
+
+#define OBD_FC_CTS               0  /* Continue to send */
+#define OBD_FC_OVERFLOW          2  /* Overflow, abort the transfer */
+
+/* Negative response service ID */
+
+#define OBD_NEGATIVE_RESPONSE    0x7f
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: obd_is_response
+ *
+ * Description:
+ *   Check if a received CAN ID is an ECU response in the current mode.
+ *
+ ****************************************************************************/
+
+static bool obd_is_response(FAR struct obd_dev_s *dev, uint32_t id)
+{
+  if (dev->can_mode == CAN_EXT)
+    {
+      return (id & 0x1fffff00) == (OBD_PID_EXT_RESPONSE & 0x1fffff00);
+    }
+
+  return (id & 0x7f8) == OBD_PID_STD_RESPONSE;
+}
+
+/****************************************************************************
+ * Name: obd_ecu_index
+ *
+ * Description:
+ *   Return the index of an ECU in dev->ecus or -1 if it is not known.
+ *
+ ****************************************************************************/
+
+static int obd_ecu_index(FAR struct obd_dev_s *dev, uint32_t ecuid)
+{
+  int i;
+
+  for (i = 0; i < dev->necus; i++)
+    {
+      if (dev->ecus[i] == ecuid)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: obd_ecu_done
+ *
+ * Description:
+ *   Record that a known ECU has finished answering the current query.
+ *
+ ****************************************************************************/
+
+static void obd_ecu_done(FAR struct obd_dev_s *dev, uint32_t ecuid,
+                         FAR uint16_t *done)
+{
+  int i = obd_ecu_index(dev, ecuid);
+
+  if (i >= 0)
+    {
+      *done |= 1 << i;
+    }
+}
+
+/****************************************************************************
+ * Name: obd_send_flowctrl
+ *
+ * Description:
+ *   Send a flow control frame to the ECU that sent a first frame.  The ECU
+ *   is addressed physically: 0x7e8+n answers to 0x7e0+n, 0x18daf1xx to
+ *   0x18daxxf1.
+ *
+ ****************************************************************************/
+
+static int obd_send_flowctrl(FAR struct obd_dev_s *dev, uint32_t ecuid,
+                             uint8_t status)
+{
+  struct can_msg_s msg;
+  int msgsize;
+
+  memset(&msg, 0, sizeof(msg));
+
+  if (dev->can_mode == CAN_EXT)
+    {
+#ifdef CONFIG_CAN_EXTID
+      msg.cm_hdr.ch_id    = (ecuid & 0x1fff0000) | ((ecuid & 0xff) << 8) |
+                            ((ecuid >> 8) & 0xff);
+      msg.cm_hdr.ch_extid = true;
+#endif
+    }
+  else
+    {
+      msg.cm_hdr.ch_id = ecuid - 8;
+    }
+
+  msg.cm_hdr.ch_dlc = 8;
+
+  /* Block size 0 and STmin 0: Send all remaining frames without delay */
+
+  msg.cm_data[0] = OBD_FLWCTRL_FRAME | OBD_FC_FLOW_STATUS(status);
+  msg.cm_data[1] = 0;
+  msg.cm_data[2] = 0;
+
+  msgsize = CAN_MSGLEN(8);
+  if (write(dev->can_fd, &msg, msgsize) != msgsize)
+    {
+      return -EAGAIN;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: obd_elapsed
+ *
+ * Description:
+ *   Return the milliseconds elapsed since "start".
+ *
+ ****************************************************************************/
+
+static int obd_elapsed(FAR const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1000 +
+         (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -143,3 +288,254 @@ int obd_wait_response(FAR struct obd_dev_s *dev, uint8_t opmode, uint8_t pid,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: obd_wait_response_multi
+ *
+ * Description:
+ *   Collect the responses of all ECUs to obd_send_request_multi().  Single
+ *   and multi-frame (ISO-TP) responses are supported; for multi-frame
+ *   responses the flow control frame is sent to each responding ECU.  The
+ *   payloads, starting at the response mode byte, are left in dev->data
+ *   and described by dev->resp.
+ *
+ *   The ECUs that answer are remembered in dev->ecus.  Once every one of
+ *   them has answered, it returns without waiting for the rest of
+ *   "timeout" milliseconds.  While no ECU is known, or if a known ECU
+ *   does not answer, responses are collected for the whole timeout.  Set
+ *   dev->necus to zero to discover the ECUs again.
+ *
+ *   Call obd_set_filters() beforehand to only wake up for ECU responses.
+ *
+ *   It will return the number of complete responses.  If there are none,
+ *   it returns -EPROTO if an ECU answered with a negative response or broke
+ *   the ISO-TP sequence, -E2BIG if a response did not fit in dev->data, or
+ *   -ETIMEDOUT.
+ *
+ ****************************************************************************/
+
+int obd_wait_response_multi(FAR struct obd_dev_s *dev, uint8_t opmode,
+                            int timeout)
+{
+  FAR struct can_msg_s *msg = &dev->can_rxmsg;
+  FAR const uint8_t *d = msg->cm_data;
+  FAR struct obd_response_s *resp;
+  struct timespec start;
+  struct pollfd fds;
+  uint16_t done = 0;
+  uint16_t total;
+  uint16_t copy;
+  int error = -ETIMEDOUT;
+  int remaining;
+  int nbytes;
+  int msgdlc;
+  int count;
+  int ret;
+  int i;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  fds.fd     = dev->can_fd;
+  fds.events = POLLIN;
+
+  dev->datalen = 0;
+  dev->nresp   = 0;
+
+  /* Several ECUs may answer a functional request, so keep collecting
+   * until all known ECUs have answered or the timeout expires.
+   */
+
+  while ((remaining = timeout - obd_elapsed(&start)) > 0)
+    {
+      if (dev->necus > 0 && done == (1 << dev->necus) - 1)
+        {
+          break;
+        }
+
+      ret = poll(&fds, 1, remaining);
+      if (ret < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          error = -errno;
+          break;
+        }
+      else if (ret == 0)
+        {
+          break;
+        }
+
+      nbytes = read(dev->can_fd, msg, sizeof(struct can_msg_s));
+      if (nbytes < CAN_MSGLEN(0) || nbytes > sizeof(struct can_msg_s))
+        {
+          error = -EAGAIN;
+          break;
+        }
+
+      msgdlc = msg->cm_hdr.ch_dlc;
+      if (msgdlc < 2 || !obd_is_response(dev, msg->cm_hdr.ch_id))
+        {
+          continue;
+        }
+
+      /* Find the response this ECU already started, if any */
+
+      resp = NULL;
+      for (i = 0; i < dev->nresp; i++)
+        {
+          if (dev->resp[i].ecuid == msg->cm_hdr.ch_id)
+            {
+              resp = &dev->resp[i];
+              break;
+            }
+        }
+
+      switch (OBD_FRAME_TYPE(d[0]))
+        {
+          case OBD_SINGLE_FRAME:
+            copy = OBD_SF_DATA_LEN(d[0]);
+            if (resp != NULL || copy < 1 || copy > msgdlc - 1)
+              {
+                break;
+              }
+
+            if (d[1] == OBD_NEGATIVE_RESPONSE && copy >= 2 &&
+                d[2] == opmode)
+              {
+                obd_ecu_done(dev, msg->cm_hdr.ch_id, &done);
+                error = -EPROTO;
+                break;
+              }
+
+            if (d[1] != opmode + OBD_RESP_BASE)
+              {
+                break;
+              }
+
+            if (dev->nresp >= OBD_MAX_ECUS ||
+                dev->datalen + copy > sizeof(dev->data))
+              {
+                obd_ecu_done(dev, msg->cm_hdr.ch_id, &done);
+                error = -E2BIG;
+                break;
+              }
+
+            resp         = &dev->resp[dev->nresp++];
+            resp->ecuid  = msg->cm_hdr.ch_id;
+            resp->offset = dev->datalen;
+            resp->len    = copy;
+            resp->total  = copy;
+            resp->seq    = 0;
+
+            memcpy(&dev->data[resp->offset], &d[1], copy);
+            dev->datalen += copy;
+            obd_ecu_done(dev, resp->ecuid, &done);
+            break;
+
+          case OBD_FIRST_FRAME:
+            if (resp != NULL || msgdlc < 8 ||
+                d[2] != opmode + OBD_RESP_BASE)
+              {
+                break;
+              }
+
+            total = OBD_FF_DATA_LEN_D0(d[0]) | OBD_FF_DATA_LEN_D1(d[1]);
+            if (total < 6)
+              {
+                break;
+              }
+
+            if (dev->nresp >= OBD_MAX_ECUS ||
+                dev->datalen + total > sizeof(dev->data))
+              {
+                obd_send_flowctrl(dev, msg->cm_hdr.ch_id, OBD_FC_OVERFLOW);
+                obd_ecu_done(dev, msg->cm_hdr.ch_id, &done);
+                error = -E2BIG;
+                break;
+              }
+
+            /* Reserve the whole payload, consecutive frames of several
+             * ECUs may be interleaved.
+             */
+
+            resp         = &dev->resp[dev->nresp++];
+            resp->ecuid  = msg->cm_hdr.ch_id;
+            resp->offset = dev->datalen;
+            resp->len    = 6;
+            resp->total  = total;
+            resp->seq    = 1;
+
+            memcpy(&dev->data[resp->offset], &d[2], 6);
+            dev->datalen += total;
+
+            ret = obd_send_flowctrl(dev, resp->ecuid, OBD_FC_CTS);
+            if (ret < 0)
+              {
+                error = ret;
+              }
+            break;
+
+          case OBD_CONSEC_FRAME:
+            if (resp == NULL || resp->len >= resp->total)
+              {
+                break;
+              }
+
+            if (OBD_CF_SEQ_NUM(d[0]) != resp->seq)
+              {
+                printf("Sequence error: expected %u got %u\n",
+                       resp->seq, OBD_CF_SEQ_NUM(d[0]));
+
+                /* Drop the rest of this response */
+
+                resp->seq = 0xff;
+                error     = -EPROTO;
+                obd_ecu_done(dev, resp->ecuid, &done);
+                break;
+              }
+
+            copy = resp->total - resp->len;
+            if (copy > msgdlc - 1)
+              {
+                copy = msgdlc - 1;
+              }
+
+            memcpy(&dev->data[resp->offset + resp->len], &d[1], copy);
+            resp->len += copy;
+            resp->seq  = (resp->seq + 1) & 0xf;
+
+            if (resp->len >= resp->total)
+              {
+                obd_ecu_done(dev, resp->ecuid, &done);
+              }
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  /* Remember the ECUs that answered so that the next query can return as
+   * soon as they are done.
+   */
+
+  count = 0;
+  for (i = 0; i < dev->nresp; i++)
+    {
+      if (dev->resp[i].len >= dev->resp[i].total)
+        {
+          if (obd_ecu_index(dev, dev->resp[i].ecuid) < 0 &&
+              dev->necus < OBD_MAX_ECUS)
+            {
+              dev->ecus[dev->necus++] = dev->resp[i].ecuid;
+            }
+
+          count++;
+        }
+    }
+
+  return count > 0 ? count : error;
+}
@@ -39,8 +39,8 @@
 
 #include <nuttx/can/can.h>
 #include <canard.h>
-#include <canard_nuttx.h>       /* CAN backend driver for nuttx, distributed
-                                 * with Libcanard */
+
+#include "canutils/canard_node.h"
 
 #include <sys/ioctl.h>
 #include <sched.h>
@@ -90,12 +90,13 @@
  * Private Data
  ****************************************************************************/
 
-/* Library instance.
+/* Node runtime instance, it holds the library instance.
  * In simple applications it makes sense to make it static, but it is not
  * necessary.
  */
 
-static CanardInstance canard;
+static struct canard_node_s g_node;
+static struct canard_node_timer_s g_1hz_timer;
 
 /* Arena for memory allocation, used by the library */
 
@@ -280,23 +281,20 @@ static bool shouldAcceptTransfer(const CanardInstance * ins,
  * Name: process1HzTasks
  *
  * Description:
- *   This function is called at 1 Hz rate from the main loop.
+ *   This function is called at 1 Hz rate from the node runtime timer wheel.
  *
  ****************************************************************************/
 
-void process1HzTasks(uint64_t timestamp_usec)
+void process1HzTasks(FAR struct canard_node_s *node, FAR void *arg,
+                     uint64_t timestamp_usec)
 {
-  /* Purging transfers that are no longer transmitted. This will occasionally
-   * free up some memory.
-   */
-
-  canardCleanupStaleTransfers(&canard, timestamp_usec);
+  /* Stale transfers are purged by the node runtime */
 
   /* Printing the memory usage statistics. */
 
   {
     const CanardPoolAllocatorStatistics stats =
-      canardGetPoolAllocatorStatistics(&canard);
+      canardGetPoolAllocatorStatistics(&node->canard);
     const unsigned peak_percent =
       100U * stats.peak_usage_blocks / stats.capacity_blocks;
 
@@ -318,6 +316,23 @@ void process1HzTasks(uint64_t timestamp_usec)
       }
   }
 
+#ifdef CONFIG_DEBUG_CAN
+  /* Printing the runtime statistics */
+
+  {
+    struct canard_node_stats_s nstats;
+
+    canard_node_getstats(node, &nstats);
+    printf("RX %lu frames in %lu reads, %lu transfers, latency max %lu us, "
+           "TX %lu frames in %lu writes, queue hwm %lu\n",
+           (unsigned long)nstats.rx_frames, (unsigned long)nstats.rx_reads,
+           (unsigned long)nstats.rx_transfers,
+           (unsigned long)nstats.rx_latency_max,
+           (unsigned long)nstats.tx_frames, (unsigned long)nstats.tx_writes,
+           (unsigned long)nstats.tx_queue_hwm);
+  }
+#endif
+
   /* Transmitting the node status message periodically. */
 
   {
@@ -327,7 +342,7 @@ void process1HzTasks(uint64_t timestamp_usec)
     static uint8_t transfer_id;
 
     const int bc_res =
-      canardBroadcast(&canard, UAVCAN_NODE_STATUS_DATA_TYPE_SIGNATURE,
+      canardBroadcast(&node->canard, UAVCAN_NODE_STATUS_DATA_TYPE_SIGNATURE,
                       UAVCAN_NODE_STATUS_DATA_TYPE_ID, &transfer_id,
                       CANARD_TRANSFER_PRIORITY_LOW,
                       buffer, UAVCAN_NODE_STATUS_MESSAGE_SIZE);
@@ -343,7 +358,7 @@ void process1HzTasks(uint64_t timestamp_usec)
     uint8_t payload[1];
     uint8_t dest_id = 2;
     const int resp_res =
-      canardRequestOrRespond(&canard, dest_id,
+      canardRequestOrRespond(&node->canard, dest_id,
                              UAVCAN_GET_NODE_INFO_DATA_TYPE_SIGNATURE,
                              UAVCAN_GET_NODE_INFO_DATA_TYPE_ID, &transfer_id,
                              CANARD_TRANSFER_PRIORITY_LOW, CanardRequest,
@@ -358,61 +373,6 @@ void process1HzTasks(uint64_t timestamp_usec)
   node_mode = UAVCAN_NODE_MODE_OPERATIONAL;
 }
 
-/****************************************************************************
- * Name: processTxRxOnce
- *
- * Description:
- *   Transmits all frames from the TX queue, receives up to one frame.
- *
- ****************************************************************************/
-
-void processTxRxOnce(CanardNuttXInstance * nuttxcan, int timeout_msec)
-{
-  const CanardCANFrame *txf;
-
-  /* Transmitting */
-
-  for (txf = NULL; (txf = canardPeekTxQueue(&canard)) != NULL;)
-    {
-      const int tx_res = canardNuttXTransmit(nuttxcan, txf, 0);
-      if (tx_res < 0)           /* Failure - drop the frame and report */
-        {
-          canardPopTxQueue(&canard);
-          fprintf(stderr,
-                  "Transmit error %d, frame dropped, errno '%s'\n",
-                  tx_res, strerror(errno));
-        }
-      else if (tx_res > 0)      /* Success - just drop the frame */
-        {
-          canardPopTxQueue(&canard);
-        }
-      else                      /* Timeout - just exit and try again later */
-        {
-          break;
-        }
-    }
-
-  /* Receiving */
-
-  CanardCANFrame rx_frame;
-  const uint64_t timestamp = getMonotonicTimestampUSec();
-  const int rx_res = canardNuttXReceive(nuttxcan, &rx_frame, timeout_msec);
-
-  if (rx_res < 0)               /* Failure - report */
-    {
-      fprintf(stderr, "Receive error %d, errno '%s'\n", rx_res,
-              strerror(errno));
-    }
-  else if (rx_res > 0)          /* Success - process the frame */
-    {
-      canardHandleRxFrame(&canard, &rx_frame, timestamp);
-    }
-  else
-    {
-      ;                         /* Timeout - nothing to do */
-    }
-}
-
 /****************************************************************************
  * Name: canard_daemon
  *
@@ -422,7 +382,6 @@ void processTxRxOnce(CanardNuttXInstance * nuttxcan, int timeout_msec)
 
 static int canard_daemon(int argc, char *argv[])
 {
-  static CanardNuttXInstance canardnuttx_instance;
 #ifdef CONFIG_DEBUG_CAN
   struct canioc_bittiming_s bt;
 #endif
@@ -433,14 +392,18 @@ static int canard_daemon(int argc, char *argv[])
    * specific logic to running this test.
    */
 
-  /* Open the CAN device for reading */
+  /* Open the CAN device and initialize the library */
 
-  ret = canardNuttXInit(&canardnuttx_instance,
-                        CONFIG_EXAMPLES_LIBCANARD_DEVPATH);
+  ret = canard_node_initialize(&g_node, CONFIG_EXAMPLES_LIBCANARD_DEVPATH,
+                               canard_memory_pool,
+                               sizeof(canard_memory_pool),
+                               CONFIG_EXAMPLES_LIBCANARD_NODE_ID,
+                               onTransferReceived, shouldAcceptTransfer,
+                               NULL);
   if (ret < 0)
     {
       printf("canard_daemon: ERROR: open %s failed: %d\n",
-             CONFIG_EXAMPLES_LIBCANARD_DEVPATH, errno);
+             CONFIG_EXAMPLES_LIBCANARD_DEVPATH, ret);
       errval = 2;
       goto errout_with_dev;
     }
@@ -450,9 +413,8 @@ static int canard_daemon(int argc, char *argv[])
    * drivers will support this IOCTL.
    */
 
-  ret =
-    ioctl(canardNuttXGetDeviceFileDescriptor(&canardnuttx_instance),
-          CANIOC_GET_BITTIMING, (unsigned long)((uintptr_t)&bt));
+  ret = ioctl(g_node.fd, CANIOC_GET_BITTIMING,
+              (unsigned long)((uintptr_t)&bt));
   if (ret < 0)
     {
       printf("canard_daemon: Bit timing not available: %d\n", errno);
@@ -467,31 +429,28 @@ static int canard_daemon(int argc, char *argv[])
     }
 #endif
 
-  canardInit(&canard, canard_memory_pool, sizeof(canard_memory_pool),
-             onTransferReceived, shouldAcceptTransfer, (void *)(12345));
-  canardSetLocalNodeID(&canard, CONFIG_EXAMPLES_LIBCANARD_NODE_ID);
   printf("canard_daemon: canard initialized\n");
   printf("start node (ID: %d Name: %s)\n", CONFIG_EXAMPLES_LIBCANARD_NODE_ID,
          APP_NODE_NAME);
 
   g_canard_daemon_started = true;
-  uint64_t next_1hz_service_at = getMonotonicTimestampUSec();
 
-  for (;;)
-    {
-      processTxRxOnce(&canardnuttx_instance, 10);
+  /* The node status and the GetNodeInfo request are sent from a 1 Hz
+   * timer; everything else is driven by CAN events.
+   */
 
-      const uint64_t ts = getMonotonicTimestampUSec();
+  canard_node_timer_start(&g_node, &g_1hz_timer, 1000, process1HzTasks,
+                          NULL);
 
-      if (ts >= next_1hz_service_at)
-        {
-          next_1hz_service_at += 1000000;
-          process1HzTasks(ts);
-        }
+  ret = canard_node_run(&g_node);
+  if (ret < 0)
+    {
+      printf("canard_daemon: ERROR: event loop failed: %d\n", ret);
+      errval = 3;
     }
 
 errout_with_dev:
-  canardNuttXClose(&canardnuttx_instance);
+  canard_node_uninitialize(&g_node);
 
   g_canard_daemon_started = false;
   printf("canard_daemon: Terminating!\n");
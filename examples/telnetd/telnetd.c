@@ -245,6 +245,7 @@ int main(int argc, FAR char *argv[])
   config.t_priority  = CONFIG_EXAMPLES_TELNETD_CLIENTPRIO;
   config.t_stacksize = CONFIG_EXAMPLES_TELNETD_CLIENTSTACKSIZE;
   config.t_entry     = telnetd_session;
+  config.t_poolsize  = 0;
 
   /* Start the telnet daemon */
 
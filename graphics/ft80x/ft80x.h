@@ -282,6 +282,35 @@ uint16_t ft80x_ramcmd_freespace(int fd, FAR uint16_t *offset,
 
 int ft80x_ramcmd_waitfifoempty(int fd);
 
+#ifdef CONFIG_GRAPHICS_FT80X_STREAMING
+/****************************************************************************
+ * Name: ft80x_ramcmd_stream
+ *
+ * Description:
+ *   Stream data into RAM CMD, refilling the FIFO as soon as the
+ *   co-processor frees any space rather than waiting for it to drain.
+ *
+ * Input Parameters:
+ *   ops   - Device accessors.  NULL selects the FT80x driver.
+ *   fd    - The file descriptor of the FT80x device.  Opened by the caller
+ *           with write access.
+ *   data  - A pointer to the start of the data to be append to RAM CMD.
+ *   len   - The number of bytes to be appended.
+ *   stats - Location to accumulate bytes and stalls.  May be NULL.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+struct ft80x_streamops_s;
+struct ft80x_streamstats_s;
+
+int ft80x_ramcmd_stream(FAR const struct ft80x_streamops_s *ops, int fd,
+                        FAR const void *data, size_t len,
+                        FAR struct ft80x_streamstats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: ft80x_dl_swap
  *
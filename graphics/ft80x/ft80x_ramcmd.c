@@ -74,6 +74,11 @@
 
 int ft80x_ramcmd_append(int fd, FAR const void *data, size_t len)
 {
+#ifdef CONFIG_GRAPHICS_FT80X_STREAMING
+  /* Refill the FIFO as soon as any space frees up */
+
+  return ft80x_ramcmd_stream(NULL, fd, data, len, NULL);
+#else
   struct ft80x_relmem_s wrdesc;
   FAR const uint8_t *src;
   ssize_t remaining;
@@ -193,6 +198,7 @@ int ft80x_ramcmd_append(int fd, FAR const void *data, size_t len)
   while (remaining > 0);
 
   return OK;
+#endif
 }
 
 /****************************************************************************
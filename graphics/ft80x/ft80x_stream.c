@@ -0,0 +1,629 @@
+/****************************************************************************
+ * apps/graphics/ft80x/ft80x_stream.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/lcd/ft80x.h>
+
+#include "graphics/ft80x.h"
+#include "ft80x.h"
+
+#ifdef CONFIG_GRAPHICS_FT80X_STREAMING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* REG_CMD_READ reads back as 0xfff if the co-processor detected a fault */
+
+#define FT80X_CMDFIFO_FAULT      0xfff
+
+/* Give up if the co-processor makes no progress for this long */
+
+#define FT80X_STREAM_TIMEOUT_US  (1000 * 1000)
+#define FT80X_STREAM_MAXPOLLS \
+  (FT80X_STREAM_TIMEOUT_US / CONFIG_GRAPHICS_FT80X_STREAM_POLLDELAY + 1)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ft80x_stream_putramcmd(int fd, uint16_t offset,
+                                  FAR const void *data, size_t len);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Register and memory accessors that go to the real device */
+
+static const struct ft80x_streamops_s g_ft80x_devops =
+{
+  ft80x_getregs,           /* getregs */
+  ft80x_putreg16,          /* putreg16 */
+  ft80x_stream_putramcmd   /* putramcmd */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ft80x_stream_putramcmd
+ *
+ * Description:
+ *   Write data to RAM CMD at the specified offset using the FT80x driver.
+ *
+ ****************************************************************************/
+
+static int ft80x_stream_putramcmd(int fd, uint16_t offset,
+                                  FAR const void *data, size_t len)
+{
+  struct ft80x_relmem_s wrdesc;
+  int ret;
+
+  wrdesc.offset = offset;
+  wrdesc.nbytes = len;
+  wrdesc.value  = (FAR void *)data;  /* Discards 'const' qualifier */
+
+  ret = ioctl(fd, FT80X_IOC_PUTRAMCMD, (unsigned long)((uintptr_t)&wrdesc));
+  if (ret < 0)
+    {
+      int errcode = errno;
+      ft80x_err("ERROR: ioctl() FT80X_IOC_PUTRAMCMD failed: %d\n", errcode);
+      return -errcode;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_waitempty
+ *
+ * Description:
+ *   Poll until the co-processor has consumed everything in the FIFO.
+ *
+ ****************************************************************************/
+
+static int ft80x_stream_waitempty(FAR const struct ft80x_streamops_s *ops,
+                                  int fd)
+{
+  uint32_t regs[2];
+  unsigned int npolls;
+  int ret;
+
+  for (npolls = 0; npolls < FT80X_STREAM_MAXPOLLS; npolls++)
+    {
+      ret = ops->getregs(fd, FT80X_REG_CMD_READ, 2, regs);
+      if (ret < 0)
+        {
+          ft80x_err("ERROR: getregs failed: %d\n", ret);
+          return ret;
+        }
+
+      if ((regs[0] & FT80X_CMDFIFO_MASK) == FT80X_CMDFIFO_FAULT)
+        {
+          ft80x_err("ERROR: Co-processor fault\n");
+          return -EIO;
+        }
+
+      if ((regs[0] & FT80X_CMDFIFO_MASK) == (regs[1] & FT80X_CMDFIFO_MASK))
+        {
+          return OK;
+        }
+
+      usleep(CONFIG_GRAPHICS_FT80X_STREAM_POLLDELAY);
+    }
+
+  ft80x_err("ERROR: Timed out waiting for FIFO to empty\n");
+  return -ETIMEDOUT;
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_thread
+ *
+ * Description:
+ *   The transmitter thread.  Sends each buffer queued by the constructing
+ *   thread to RAM CMD and then returns it for reuse.
+ *
+ ****************************************************************************/
+
+static FAR void *ft80x_stream_thread(FAR void *arg)
+{
+  FAR struct ft80x_stream_s *stream = (FAR struct ft80x_stream_s *)arg;
+  int ret;
+
+  for (; ; )
+    {
+      /* Wait for a buffer to be queued */
+
+      while (sem_wait(&stream->txsem) < 0)
+        {
+          DEBUGASSERT(errno == EINTR);
+        }
+
+      if (stream->stop)
+        {
+          break;
+        }
+
+      /* Send it.  Once an error has been seen, just discard the data so
+       * that the constructing thread does not deadlock; the error will be
+       * reported when it next submits a buffer.
+       */
+
+      if (stream->result >= 0)
+        {
+          ret = ft80x_ramcmd_stream(stream->ops, stream->fd,
+                                    stream->buffer[stream->txndx],
+                                    stream->buflen[stream->txndx],
+                                    &stream->stats);
+          if (ret < 0)
+            {
+              stream->result = ret;
+            }
+        }
+
+      stream->buflen[stream->txndx] = 0;
+      stream->txndx ^= 1;
+
+      /* Return the buffer to the constructing thread */
+
+      sem_post(&stream->freesem);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_submit
+ *
+ * Description:
+ *   Queue the buffer under construction for transmission and switch to the
+ *   other buffer, waiting until the transmitter is finished with it.
+ *
+ ****************************************************************************/
+
+static int ft80x_stream_submit(FAR struct ft80x_stream_s *stream)
+{
+  if (stream->buflen[stream->fillndx] > 0)
+    {
+      sem_post(&stream->txsem);
+      stream->fillndx ^= 1;
+
+      while (sem_wait(&stream->freesem) < 0)
+        {
+          DEBUGASSERT(errno == EINTR);
+        }
+    }
+
+  return stream->result;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ft80x_ramcmd_stream
+ *
+ * Description:
+ *   Stream data into RAM CMD.  Unlike waiting for the FIFO to drain
+ *   completely, this refills the FIFO as soon as the co-processor has
+ *   consumed any part of it by tracking REG_CMD_READ and REG_CMD_WRITE.
+ *
+ ****************************************************************************/
+
+int ft80x_ramcmd_stream(FAR const struct ft80x_streamops_s *ops, int fd,
+                        FAR const void *data, size_t len,
+                        FAR struct ft80x_streamstats_s *stats)
+{
+  FAR const uint8_t *src;
+  uint32_t regs[2];
+  unsigned int npolls;
+  size_t remaining;
+  size_t wrsize;
+  uint16_t rdoffset;
+  uint16_t wroffset;
+  uint16_t avail;
+  int ret;
+
+  DEBUGASSERT(data != NULL && ((uintptr_t)data & 3) == 0 && (len & 3) == 0);
+
+  if (ops == NULL)
+    {
+      ops = &g_ft80x_devops;
+    }
+
+  src       = data;
+  remaining = len;
+  npolls    = 0;
+
+  while (remaining > 0)
+    {
+      /* Read both the FT80X_REG_CMD_READ and FT80X_REG_CMD_WRITE
+       * registers.
+       */
+
+      ret = ops->getregs(fd, FT80X_REG_CMD_READ, 2, regs);
+      if (ret < 0)
+        {
+          ft80x_err("ERROR: getregs failed: %d\n", ret);
+          return ret;
+        }
+
+      rdoffset = regs[0] & FT80X_CMDFIFO_MASK;
+      wroffset = regs[1] & FT80X_CMDFIFO_MASK;
+
+      if (rdoffset == FT80X_CMDFIFO_FAULT)
+        {
+          ft80x_err("ERROR: Co-processor fault\n");
+          return -EIO;
+        }
+
+      /* NOTE that 4 bytes of the FIFO are not available */
+
+      avail = (FT80X_CMDFIFO_SIZE - 4) -
+              ((wroffset - rdoffset) & FT80X_CMDFIFO_MASK);
+
+      if (avail == 0)
+        {
+          /* The FIFO is full.  Count the stall once, then poll until the
+           * co-processor frees some space.
+           */
+
+          if (npolls == 0 && stats != NULL)
+            {
+              stats->stalls++;
+            }
+
+          if (++npolls > FT80X_STREAM_MAXPOLLS)
+            {
+              ft80x_err("ERROR: Timed out waiting for FIFO space\n");
+              return -ETIMEDOUT;
+            }
+
+          usleep(CONFIG_GRAPHICS_FT80X_STREAM_POLLDELAY);
+          continue;
+        }
+
+      npolls = 0;
+
+      /* Write as much as will fit without wrapping around the end of the
+       * FIFO.  The remainder goes out on the next pass.
+       */
+
+      wrsize = remaining;
+      if (wrsize > avail)
+        {
+          wrsize = avail;
+        }
+
+      if (wroffset + wrsize > FT80X_CMDFIFO_SIZE)
+        {
+          wrsize = FT80X_CMDFIFO_SIZE - wroffset;
+        }
+
+      ret = ops->putramcmd(fd, wroffset, src, wrsize);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Hand the new commands to the co-processor */
+
+      ret = ops->putreg16(fd, FT80X_REG_CMD_WRITE,
+                          (wroffset + wrsize) & FT80X_CMDFIFO_MASK);
+      if (ret < 0)
+        {
+          ft80x_err("ERROR: putreg16 failed: %d\n", ret);
+          return ret;
+        }
+
+      if (stats != NULL)
+        {
+          stats->bytes += wrsize;
+        }
+
+      remaining -= wrsize;
+      src       += wrsize;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_initialize
+ *
+ * Description:
+ *   Initialize a double-buffered co-processor command stream and start its
+ *   transmitter thread.
+ *
+ * Input Parameters:
+ *   fd     - The file descriptor of the FT80x device.  Opened by the caller
+ *            with write access.
+ *   stream - An instance of struct ft80x_stream_s allocated by the caller.
+ *   ops    - Device accessors.  NULL selects the FT80x driver; a test may
+ *            provide accessors for a mocked device.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_initialize(int fd, FAR struct ft80x_stream_s *stream,
+                            FAR const struct ft80x_streamops_s *ops)
+{
+  int ret;
+
+  DEBUGASSERT(stream != NULL);
+
+  memset(stream, 0, sizeof(struct ft80x_stream_s));
+  stream->fd  = fd;
+  stream->ops = ops != NULL ? ops : &g_ft80x_devops;
+
+  /* One buffer is under construction, the other is free */
+
+  sem_init(&stream->txsem, 0, 0);
+  sem_init(&stream->freesem, 0, 1);
+
+  ret = pthread_create(&stream->txthread, NULL, ft80x_stream_thread,
+                       stream);
+  if (ret != 0)
+    {
+      ft80x_err("ERROR: pthread_create failed: %d\n", ret);
+      sem_destroy(&stream->txsem);
+      sem_destroy(&stream->freesem);
+      return -ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_uninitialize
+ *
+ * Description:
+ *   Stop the transmitter thread and release resources.  Any data not yet
+ *   submitted is discarded.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_uninitialize(FAR struct ft80x_stream_s *stream)
+{
+  DEBUGASSERT(stream != NULL);
+
+  stream->stop = true;
+  sem_post(&stream->txsem);
+  pthread_join(stream->txthread, NULL);
+
+  sem_destroy(&stream->txsem);
+  sem_destroy(&stream->freesem);
+  return stream->result;
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_data
+ *
+ * Description:
+ *   Add co-processor commands to the stream.  Whenever the buffer under
+ *   construction fills, it is handed to the transmitter thread and
+ *   construction continues in the other buffer.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *   data   - The data to be added
+ *   datlen - The length of the data.  If this is not an even multiple of 4
+ *            bytes, then the data will be padded with zero bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_data(FAR struct ft80x_stream_s *stream,
+                      FAR const void *data, size_t datlen)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  FAR uint8_t *dest;
+  size_t padlen;
+  size_t nbytes;
+  uint16_t buflen;
+  int ret;
+
+  DEBUGASSERT(stream != NULL && data != NULL);
+
+  padlen = (datlen + 3) & ~3;
+
+  while (padlen > 0)
+    {
+      buflen = stream->buflen[stream->fillndx];
+      if (buflen >= FT80X_DL_BUFSIZE)
+        {
+          ret = ft80x_stream_submit(stream);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          continue;
+        }
+
+      nbytes = FT80X_DL_BUFSIZE - buflen;
+      if (nbytes > padlen)
+        {
+          nbytes = padlen;
+        }
+
+      dest = (FAR uint8_t *)stream->buffer[stream->fillndx] + buflen;
+
+      if (nbytes <= datlen)
+        {
+          memcpy(dest, src, nbytes);
+          src    += nbytes;
+          datlen -= nbytes;
+        }
+      else
+        {
+          /* Final, padded piece */
+
+          memcpy(dest, src, datlen);
+          memset(dest + datlen, 0, nbytes - datlen);
+          datlen = 0;
+        }
+
+      stream->buflen[stream->fillndx] = buflen + nbytes;
+      padlen -= nbytes;
+    }
+
+  return stream->result;
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_flush
+ *
+ * Description:
+ *   Hand any buffered commands to the transmitter thread without waiting
+ *   for the co-processor to execute them.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_flush(FAR struct ft80x_stream_s *stream)
+{
+  DEBUGASSERT(stream != NULL);
+  return ft80x_stream_submit(stream);
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_endframe
+ *
+ * Description:
+ *   Flush the stream, wait until the transmitter is idle and the
+ *   co-processor has consumed all commands, then close the per-frame
+ *   statistics.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_endframe(FAR struct ft80x_stream_s *stream)
+{
+  FAR struct ft80x_streamstats_s *stats;
+  int ret;
+
+  DEBUGASSERT(stream != NULL);
+
+  ft80x_stream_submit(stream);
+
+  /* Wait for the transmitter to return the last buffer, then give it
+   * back.
+   */
+
+  while (sem_wait(&stream->freesem) < 0)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+
+  sem_post(&stream->freesem);
+
+  ret = stream->result;
+  if (ret >= 0)
+    {
+      ret = ft80x_stream_waitempty(stream->ops, stream->fd);
+    }
+
+  /* The transmitter is idle so the statistics are stable */
+
+  stats = &stream->stats;
+  stats->frames++;
+  stats->totalbytes  += stats->bytes;
+  stats->totalstalls += stats->stalls;
+  stats->lastbytes    = stats->bytes;
+  stats->laststalls   = stats->stalls;
+
+  if (stats->bytes > stats->maxbytes)
+    {
+      stats->maxbytes = stats->bytes;
+    }
+
+  if (stats->stalls > stats->maxstalls)
+    {
+      stats->maxstalls = stats->stalls;
+    }
+
+  stats->bytes  = 0;
+  stats->stalls = 0;
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ft80x_stream_getstats
+ *
+ * Description:
+ *   Return a snapshot of the stream statistics.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *   stats  - The location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ft80x_stream_getstats(FAR struct ft80x_stream_s *stream,
+                           FAR struct ft80x_streamstats_s *stats)
+{
+  DEBUGASSERT(stream != NULL && stats != NULL);
+  memcpy(stats, &stream->stats, sizeof(struct ft80x_streamstats_s));
+}
+
+#endif /* CONFIG_GRAPHICS_FT80X_STREAMING */
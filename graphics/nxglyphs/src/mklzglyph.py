@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+############################################################################
+# apps/graphics/nxglyphs/src/mklzglyph.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+'''Convert an RLE paletted glyph source to the LZ paletted format.
+
+The input is a glyph source file holding SRlePaletteBitmapEntry arrays,
+one per color depth in the conditional sections of the file, and one
+SRlePaletteBitmap descriptor.  The output is the same file with each RLE
+array replaced by LZ-compressed palette indices and the descriptor made
+an SLzPaletteBitmap, to be read by CLzPaletteBitmap.  The LUTs and the
+preprocessor logic are kept as they are.
+
+The token format is described in clzpalettebitmap.hxx.
+'''
+
+import argparse
+import os
+import re
+import sys
+
+LITERAL_MAX = 128
+MATCH_MIN = 3
+MATCH_EXT = 63
+MATCH_MAX = MATCH_MIN + MATCH_EXT + 255
+WINDOW_MAX = 32768
+MAX_CHAIN = 32
+
+RLE_ARRAY_RE = re.compile(
+    r'static const struct SRlePaletteBitmapEntry (\w+)\[\]\s*=\s*\{(.*?)\};',
+    re.S)
+RLE_ENTRY_RE = re.compile(r'\{\s*(\d+)\s*,\s*(\d+)\s*\}')
+DESCRIPTOR_RE = re.compile(
+    r'const struct SRlePaletteBitmap ([\w:]+)\s*=\s*\{(.*?)\n\};', re.S)
+NUMBER_RE = re.compile(r'^\s*(\w+),\s*//\s*(width|height)\b', re.M)
+DEFINE_RE = re.compile(r'^#\s*define\s+(\w+)\s+(\d+)\b', re.M)
+DATA_RE = re.compile(r'^(\s*)(\w+)(\s*)// data .*$', re.M)
+
+
+class GlyphError(Exception):
+    pass
+
+
+def compress(indices, window):
+    '''LZ-compress a sequence of palette indices.'''
+
+    out = bytearray()
+    literals = []
+    heads = {}
+    chain = [0] * len(indices)
+    n = len(indices)
+    pos = 0
+
+    def flush():
+        while literals:
+            chunk = literals[:LITERAL_MAX]
+            del literals[:LITERAL_MAX]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    def insert(i):
+        if i + MATCH_MIN <= n:
+            key = tuple(indices[i:i + MATCH_MIN])
+            chain[i] = heads.get(key, -1)
+            heads[key] = i
+
+    def match_length(cand, i, limit):
+        length = 0
+        while length < limit and indices[cand + length] == indices[i + length]:
+            length += 1
+        return length
+
+    while pos < n:
+        best_len = 0
+        best_dist = 0
+        limit = min(MATCH_MAX, n - pos)
+
+        if limit >= MATCH_MIN:
+            # A run of one color is a match at distance 1, which the hash
+            # chain only finds after the run has started.
+
+            if pos > 0:
+                best_len = match_length(pos - 1, pos, limit)
+                best_dist = 1
+
+            cand = heads.get(tuple(indices[pos:pos + MATCH_MIN]), -1)
+            depth = 0
+            while cand >= 0 and pos - cand <= window and depth < MAX_CHAIN:
+                if best_len < limit:
+                    length = match_length(cand, pos, limit)
+                    if length > best_len:
+                        best_len = length
+                        best_dist = pos - cand
+                cand = chain[cand]
+                depth += 1
+
+        if best_len >= MATCH_MIN:
+            flush()
+            code = best_len - MATCH_MIN
+            token = 0x80 | min(code, MATCH_EXT)
+            dist = best_dist - 1
+            if dist > 0xff:
+                token |= 0x40
+            out.append(token)
+            if code >= MATCH_EXT:
+                out.append(code - MATCH_EXT)
+            out.append(dist & 0xff)
+            if dist > 0xff:
+                out.append(dist >> 8)
+            for i in range(pos, pos + best_len):
+                insert(i)
+            pos += best_len
+        else:
+            literals.append(indices[pos])
+            insert(pos)
+            pos += 1
+
+    flush()
+    return bytes(out)
+
+
+def decompress(data, npixels):
+    '''Decode compressed indices, as CLzPaletteBitmap does.'''
+
+    out = []
+    i = 0
+    while i < len(data):
+        token = data[i]
+        i += 1
+        if token < 0x80:
+            out.extend(data[i:i + token + 1])
+            i += token + 1
+            continue
+
+        length = (token & 0x3f) + MATCH_MIN
+        if token & 0x3f == MATCH_EXT:
+            length += data[i]
+            i += 1
+        dist = data[i] + 1
+        i += 1
+        if token & 0x40:
+            dist += data[i] << 8
+            i += 1
+        for _ in range(length):
+            out.append(out[-dist])
+
+    if len(out) != npixels:
+        raise GlyphError('round trip failed')
+    return out
+
+
+def rle_indices(body):
+    indices = []
+    for npixels, lookup in RLE_ENTRY_RE.findall(body):
+        indices.extend([int(lookup)] * int(npixels))
+    return indices
+
+
+def hex_lines(data, indent='  ', per_line=12):
+    lines = []
+    for i in range(0, len(data), per_line):
+        chunk = data[i:i + per_line]
+        lines.append(indent + ' '.join('0x%02x,' % b for b in chunk))
+    return lines
+
+
+def convert(text, source, window, report):
+    m = DESCRIPTOR_RE.search(text)
+    if not m:
+        raise GlyphError('%s: no SRlePaletteBitmap descriptor' % source)
+
+    # The size is a number or a macro defined in the file
+
+    defines = dict(DEFINE_RE.findall(text))
+    dims = {}
+    for value, name in NUMBER_RE.findall(m.group(2)):
+        value = defines.get(value, value)
+        if not value.isdigit():
+            raise GlyphError('%s: cannot find the bitmap %s' % (source, name))
+        dims[name] = int(value)
+
+    if 'width' not in dims or 'height' not in dims:
+        raise GlyphError('%s: cannot find the bitmap size' % source)
+
+    npixels = dims['width'] * dims['height']
+
+    def replace_array(am):
+        name = am.group(1)
+        indices = rle_indices(am.group(2))
+        if len(indices) != npixels:
+            raise GlyphError('%s: %s has %d pixels, expected %d' %
+                             (source, name, len(indices), npixels))
+
+        data = compress(indices, window)
+        if decompress(data, npixels) != indices:
+            raise GlyphError('%s: %s round trip failed' % (source, name))
+
+        rlesize = 2 * len(RLE_ENTRY_RE.findall(am.group(2)))
+        report.append((name, rlesize, len(data)))
+
+        lines = ['/* %d bytes, %d as RLE */' % (len(data), rlesize), '',
+                 'static const uint8_t %s[] =' % lzname(name), '{']
+        lines.extend(hex_lines(data))
+        lines.append('};')
+        return '\n'.join(lines)
+
+    def replace_descriptor(dm):
+        body = DATA_RE.sub(
+            lambda d: ('%s%-22s // window - Longest match distance\n'
+                       '%s%-22s // size   - Size of the compressed data\n'
+                       '%s%-22s // data   - Pointer to the beginning of the'
+                       ' compressed data') %
+                      (d.group(1), '%d,' % window,
+                       d.group(1), 'sizeof(%s),' % lzname(d.group(2)),
+                       d.group(1), lzname(d.group(2))),
+            dm.group(2), count=1)
+        return 'const struct SLzPaletteBitmap %s =\n{%s\n};' % (dm.group(1), body)
+
+    text, narrays = RLE_ARRAY_RE.subn(replace_array, text)
+    if narrays == 0:
+        raise GlyphError('%s: no SRlePaletteBitmapEntry arrays' % source)
+
+    text = DESCRIPTOR_RE.sub(replace_descriptor, text, count=1)
+    text = text.replace('"graphics/nxwidgets/crlepalettebitmap.hxx"',
+                        '"graphics/nxwidgets/clzpalettebitmap.hxx"')
+
+    banner = ('/* Automatically generated from %s by mklzglyph.py.'
+              '  Do not edit. */\n\n' % os.path.basename(source))
+    return banner + text
+
+
+def lzname(name):
+    if 'RleEntries' in name:
+        return name.replace('RleEntries', 'LzData')
+    return name + 'Lz'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-w', dest='window', type=int, default=1024,
+                        help='longest match distance, a power of two '
+                             '(default: 1024)')
+    parser.add_argument('-o', dest='output', required=True,
+                        help='LZ glyph source file')
+    parser.add_argument('-v', dest='verbose', action='store_true',
+                        help='report the size of each conversion')
+    parser.add_argument('source', help='RLE glyph source file')
+    args = parser.parse_args()
+
+    if args.window < 1 or args.window > WINDOW_MAX or \
+       args.window & (args.window - 1):
+        sys.stderr.write('mklzglyph.py: the window must be a power of two '
+                         'up to %d\n' % WINDOW_MAX)
+        return 1
+
+    report = []
+    try:
+        with open(args.source) as f:
+            text = convert(f.read(), args.source, args.window, report)
+    except (GlyphError, IOError) as e:
+        sys.stderr.write('mklzglyph.py: %s\n' % e)
+        return 1
+
+    if args.verbose:
+        for name, rlesize, lzsize in report:
+            print('%s: %s: %d bytes as RLE, %d bytes as LZ (%d%%)' %
+                  (os.path.basename(args.source), name, rlesize, lzsize,
+                   lzsize * 100 // rlesize))
+
+    with open(args.output, 'w') as f:
+        f.write(text)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,673 @@
+/////////////////////////////////////////////////////////////////////////////
+// apps/graphics/nxwidgets/UnitTests/Benchmark/nxwidgetsbench_main.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Included Files
+/////////////////////////////////////////////////////////////////////////////
+
+#include <nuttx/config.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <malloc.h>
+#include <unistd.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxbe.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+#include "graphics/nxwidgets/cnxserver.hxx"
+#include "graphics/nxwidgets/cnxwindow.hxx"
+#include "graphics/nxwidgets/cwidgetcontrol.hxx"
+#include "graphics/nxwidgets/cgraphicsport.hxx"
+#include "graphics/nxwidgets/cnxstring.hxx"
+#include "graphics/nxwidgets/tnxarray.hxx"
+#include "graphics/nxwidgets/cbutton.hxx"
+#include "graphics/nxwidgets/cbuttonarray.hxx"
+#include "graphics/nxwidgets/ccheckbox.hxx"
+#include "graphics/nxwidgets/ckeypad.hxx"
+#include "graphics/nxwidgets/clabel.hxx"
+#include "graphics/nxwidgets/clistbox.hxx"
+#include "graphics/nxwidgets/cmultilinetextbox.hxx"
+#include "graphics/nxwidgets/cprogressbar.hxx"
+#include "graphics/nxwidgets/cradiobuttongroup.hxx"
+#include "graphics/nxwidgets/cscrollbarvertical.hxx"
+#include "graphics/nxwidgets/csliderhorizontal.hxx"
+#include "graphics/nxwidgets/ctextbox.hxx"
+#include "graphics/nxwidgets/cimage.hxx"
+#include "graphics/nxwidgets/crlepalettebitmap.hxx"
+#include "graphics/nxwidgets/clzpalettebitmap.hxx"
+#include "graphics/nxglyphs.hxx"
+
+/////////////////////////////////////////////////////////////////////////////
+// Definitions
+/////////////////////////////////////////////////////////////////////////////
+
+#define DEFAULT_FRAMES  100
+#define DEFAULT_WIDTH   320
+#define DEFAULT_HEIGHT  240
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Types
+/////////////////////////////////////////////////////////////////////////////
+
+using namespace NXWidgets;
+
+// Everything that a scene needs to create its widgets
+
+struct SBenchContext
+{
+  NXHANDLE              hNxServer;  // Needed by CKeypad
+  CWidgetControl       *control;    // Control of the off-screen window
+  nxgl_coord_t          width;      // Size of the off-screen window
+  nxgl_coord_t          height;
+  TNxArray<CNxWidget*>  widgets;    // Top-level widgets redrawn each frame
+  IBitmap              *bitmap;     // Bitmap drawn by the scene, if any
+};
+
+typedef void (*scenefunc_t)(FAR struct SBenchContext *ctx);
+
+struct SScene
+{
+  FAR const char *name;
+  scenefunc_t func;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Data
+/////////////////////////////////////////////////////////////////////////////
+
+static const char g_paragraph[] =
+  "The quick brown fox jumps over the lazy dog.  Pack my box with five "
+  "dozen liquor jugs.  How vexingly quick daft zebras jump!  Sphinx of "
+  "black quartz, judge my vow.";
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Function Prototypes
+/////////////////////////////////////////////////////////////////////////////
+
+// Suppress name-mangling
+
+extern "C" int main(int argc, char *argv[]);
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Functions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: usec
+/////////////////////////////////////////////////////////////////////////////
+
+static uint64_t usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: add
+//
+// Description:
+//   Make a new top-level widget part of the scene.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+static void add(FAR struct SBenchContext *ctx, CNxWidget *widget)
+{
+  widget->enableDrawing();
+  ctx->widgets.push_back(widget);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: scene*
+//
+// Description:
+//   Create the widgets of one scene.  The single widget scenes use about a
+//   quarter of the window, the compositions fill all of it.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+static void sceneButton(FAR struct SBenchContext *ctx)
+{
+  add(ctx, new CButton(ctx->control, 8, 8, ctx->width / 2, 24,
+                       CNxString("Push Me")));
+}
+
+static void sceneLabel(FAR struct SBenchContext *ctx)
+{
+  add(ctx, new CLabel(ctx->control, 8, 8, ctx->width / 2, 24,
+                      CNxString("Label text")));
+}
+
+static void sceneTextBox(FAR struct SBenchContext *ctx)
+{
+  add(ctx, new CTextBox(ctx->control, 8, 8, ctx->width / 2, 24,
+                        CNxString("Editable text")));
+}
+
+static void sceneCheckBox(FAR struct SBenchContext *ctx)
+{
+  CCheckBox *checkBox = new CCheckBox(ctx->control, 8, 8, 24, 24);
+  checkBox->setState(CCheckBox::CHECK_BOX_STATE_ON);
+  add(ctx, checkBox);
+}
+
+static void sceneRadioButtons(FAR struct SBenchContext *ctx)
+{
+  CRadioButtonGroup *group = new CRadioButtonGroup(ctx->control, 8, 8);
+  for (int i = 0; i < 4; i++)
+    {
+      group->newRadioButton(0, i * 28, 24, 24);
+    }
+
+  add(ctx, group);
+}
+
+static void sceneProgressBar(FAR struct SBenchContext *ctx)
+{
+  CProgressBar *bar = new CProgressBar(ctx->control, 8, 8,
+                                       ctx->width / 2, 24);
+  bar->setMinimumValue(0);
+  bar->setMaximumValue(100);
+  bar->setValue(42);
+  add(ctx, bar);
+}
+
+static void sceneSlider(FAR struct SBenchContext *ctx)
+{
+  CSliderHorizontal *slider = new CSliderHorizontal(ctx->control, 8, 8,
+                                                    ctx->width / 2, 24);
+  slider->setMinimumValue(0);
+  slider->setMaximumValue(100);
+  slider->setValue(42);
+  add(ctx, slider);
+}
+
+static void sceneScrollbar(FAR struct SBenchContext *ctx)
+{
+  CScrollbarVertical *scrollbar =
+    new CScrollbarVertical(ctx->control, 8, 8, 24, ctx->height / 2);
+  scrollbar->setMinimumValue(0);
+  scrollbar->setMaximumValue(100);
+  scrollbar->setPageSize(10);
+  scrollbar->setValue(42);
+  add(ctx, scrollbar);
+}
+
+static void sceneListBox(FAR struct SBenchContext *ctx)
+{
+  CListBox *listBox = new CListBox(ctx->control, 8, 8, ctx->width / 2,
+                                   ctx->height / 2);
+  for (int i = 0; i < 32; i++)
+    {
+      char text[16];
+      snprintf(text, sizeof(text), "Option %d", i);
+      listBox->addOption(CNxString(text), i);
+    }
+
+  listBox->setOptionSelected(1, true);
+  add(ctx, listBox);
+}
+
+static void sceneMultiLine(FAR struct SBenchContext *ctx)
+{
+  add(ctx, new CMultiLineTextBox(ctx->control, 8, 8, ctx->width / 2,
+                                 ctx->height / 2, CNxString(g_paragraph),
+                                 0));
+}
+
+static void sceneButtonArray(FAR struct SBenchContext *ctx)
+{
+  CButtonArray *array = new CButtonArray(ctx->control, 8, 8, 4, 4,
+                                         ctx->width / 8, ctx->height / 8);
+  for (int row = 0; row < 4; row++)
+    {
+      for (int col = 0; col < 4; col++)
+        {
+          char text[4];
+          snprintf(text, sizeof(text), "%c", 'A' + row * 4 + col);
+          array->setText(col, row, CNxString(text));
+        }
+    }
+
+  add(ctx, array);
+}
+
+static void sceneKeypad(FAR struct SBenchContext *ctx)
+{
+  add(ctx, new CKeypad(ctx->control, ctx->hNxServer, 0, 0, ctx->width,
+                       ctx->height));
+}
+
+// A dialog: a column of labelled text boxes over a row of buttons
+
+static void sceneForm(FAR struct SBenchContext *ctx)
+{
+  nxgl_coord_t rowHeight = ctx->height / 8;
+  nxgl_coord_t half      = ctx->width / 2;
+
+  for (int i = 0; i < 6; i++)
+    {
+      char text[16];
+      snprintf(text, sizeof(text), "Field %d", i);
+      add(ctx, new CLabel(ctx->control, 0, i * rowHeight, half, rowHeight,
+                          CNxString(text)));
+      add(ctx, new CTextBox(ctx->control, half, i * rowHeight, half,
+                            rowHeight, CNxString("Value")));
+    }
+
+  add(ctx, new CButton(ctx->control, 0, 7 * rowHeight, half, rowHeight,
+                       CNxString("OK")));
+  add(ctx, new CButton(ctx->control, half, 7 * rowHeight, half, rowHeight,
+                       CNxString("Cancel")));
+}
+
+// A launcher: the window tiled with small buttons
+
+static void sceneGrid(FAR struct SBenchContext *ctx)
+{
+  nxgl_coord_t cellWidth  = ctx->width / 8;
+  nxgl_coord_t cellHeight = ctx->height / 8;
+
+  for (int row = 0; row < 8; row++)
+    {
+      for (int col = 0; col < 8; col++)
+        {
+          char text[4];
+          snprintf(text, sizeof(text), "%d", row * 8 + col);
+          add(ctx, new CButton(ctx->control, col * cellWidth,
+                               row * cellHeight, cellWidth, cellHeight,
+                               CNxString(text)));
+        }
+    }
+}
+
+// A settings page: list, scrollbar, slider, progress and check boxes
+
+static void sceneSettings(FAR struct SBenchContext *ctx)
+{
+  nxgl_coord_t half    = ctx->width / 2;
+  nxgl_coord_t quarter = ctx->height / 4;
+
+  CListBox *listBox = new CListBox(ctx->control, 0, 0, half - 24,
+                                   ctx->height);
+  for (int i = 0; i < 16; i++)
+    {
+      char text[16];
+      snprintf(text, sizeof(text), "Setting %d", i);
+      listBox->addOption(CNxString(text), i);
+    }
+
+  add(ctx, listBox);
+
+  CScrollbarVertical *scrollbar =
+    new CScrollbarVertical(ctx->control, half - 24, 0, 24, ctx->height);
+  scrollbar->setMaximumValue(16);
+  scrollbar->setPageSize(4);
+  add(ctx, scrollbar);
+
+  CSliderHorizontal *slider =
+    new CSliderHorizontal(ctx->control, half, 0, half, quarter);
+  slider->setMaximumValue(100);
+  slider->setValue(75);
+  add(ctx, slider);
+
+  CProgressBar *bar = new CProgressBar(ctx->control, half, quarter, half,
+                                       quarter);
+  bar->setMaximumValue(100);
+  bar->setValue(25);
+  add(ctx, bar);
+
+  for (int i = 0; i < 2; i++)
+    {
+      CCheckBox *checkBox =
+        new CCheckBox(ctx->control, half, (2 + i) * quarter, quarter,
+                      quarter);
+      checkBox->setState(i ? CCheckBox::CHECK_BOX_STATE_ON :
+                             CCheckBox::CHECK_BOX_STATE_OFF);
+      add(ctx, checkBox);
+    }
+}
+
+// The NuttX logo, which measures how fast its bitmap format decodes
+
+static void sceneLogo(FAR struct SBenchContext *ctx)
+{
+  ctx->bitmap = new CNxLogoBitmap(&g_nuttxBitmap160x160);
+  add(ctx, new CImage(ctx->control, 0, 0, ctx->width, ctx->height,
+                      ctx->bitmap));
+}
+
+#ifdef CONFIG_NXGLYPHS_LZ_LOGO
+// The same with the decoded image kept in RAM
+
+static void sceneLogoCache(FAR struct SBenchContext *ctx)
+{
+  ctx->bitmap = new CLzPaletteBitmap(&g_nuttxBitmap160x160, true);
+  add(ctx, new CImage(ctx->control, 0, 0, ctx->width, ctx->height,
+                      ctx->bitmap));
+}
+#endif
+
+static const struct SScene g_scenes[] =
+{
+  { "button",      sceneButton       },
+  { "label",       sceneLabel        },
+  { "textbox",     sceneTextBox      },
+  { "checkbox",    sceneCheckBox     },
+  { "radio",       sceneRadioButtons },
+  { "progress",    sceneProgressBar  },
+  { "slider",      sceneSlider       },
+  { "scrollbar",   sceneScrollbar    },
+  { "listbox",     sceneListBox      },
+  { "multiline",   sceneMultiLine    },
+  { "buttonarray", sceneButtonArray  },
+  { "keypad",      sceneKeypad       },
+  { "form",        sceneForm         },
+  { "grid",        sceneGrid         },
+  { "settings",    sceneSettings     },
+  { "logo",        sceneLogo         },
+#ifdef CONFIG_NXGLYPHS_LZ_LOGO
+  { "logocache",   sceneLogoCache    },
+#endif
+};
+
+#define NSCENES (sizeof(g_scenes) / sizeof(g_scenes[0]))
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: redrawAll
+/////////////////////////////////////////////////////////////////////////////
+
+static void redrawAll(FAR struct SBenchContext *ctx)
+{
+  for (int i = 0; i < ctx->widgets.size(); i++)
+    {
+      ctx->widgets[i]->redraw();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: runScene
+/////////////////////////////////////////////////////////////////////////////
+
+static void runScene(FAR struct SBenchContext *ctx,
+                     FAR const struct SScene *scene, int frames, bool csv)
+{
+  CGraphicsPort *port = ctx->control->getGraphicsPort();
+
+  scene->func(ctx);
+
+  // The first frame pays for one-time work such as font caches
+
+  redrawAll(ctx);
+  port->resetDrawStats();
+
+  struct mallinfo before = mallinfo();
+  uint64_t start = usec();
+
+  for (int n = 0; n < frames; n++)
+    {
+      redrawAll(ctx);
+    }
+
+  uint64_t elapsed = usec() - start;
+  struct mallinfo after = mallinfo();
+
+  struct SDrawStats stats;
+  port->getDrawStats(&stats);
+
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  printf(csv ? "%s,%d,%d,%llu,%llu,%llu,%lu,%lu.%02lu,%ld\n" :
+               "%-11s %7d %6d %9llu %8llu %11llu %7lu %6lu.%02lu %9ld\n",
+         scene->name, ctx->widgets.size(), frames,
+         (unsigned long long)elapsed,
+         (unsigned long long)((uint64_t)frames * 1000000 / elapsed),
+         (unsigned long long)(stats.pixels / frames),
+         (unsigned long)(stats.operations / frames),
+         (unsigned long)(stats.allocations / frames),
+         (unsigned long)(stats.allocations * 100 / frames % 100),
+         (long)(after.uordblks - before.uordblks));
+
+  // Tear the scene down, topmost widget first
+
+  for (int i = ctx->widgets.size() - 1; i > -1; i--)
+    {
+      delete ctx->widgets[i];
+    }
+
+  ctx->widgets.clear();
+
+  if (ctx->bitmap)
+    {
+      delete ctx->bitmap;
+      ctx->bitmap = (FAR IBitmap *)NULL;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: showUsage
+/////////////////////////////////////////////////////////////////////////////
+
+static void showUsage(FAR const char *progname, int exitcode)
+{
+  printf("USAGE: %s [-n <frames>] [-w <width>] [-h <height>] [-C] "
+         "[<scene> ...]\n", progname);
+  printf("  -n <frames>  Frames timed per scene.  Default: %d\n",
+         DEFAULT_FRAMES);
+  printf("  -w <width>   Width of the off-screen window.  Default: %d\n",
+         DEFAULT_WIDTH);
+  printf("  -h <height>  Height of the off-screen window.  Default: %d\n",
+         DEFAULT_HEIGHT);
+  printf("  -C           Print the results as CSV\n");
+  printf("Scenes (default: all):");
+
+  for (unsigned int i = 0; i < NSCENES; i++)
+    {
+      printf(" %s", g_scenes[i].name);
+    }
+
+  printf("\n");
+  exit(exitcode);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Functions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: main
+/////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+  struct SBenchContext ctx;
+  struct nxgl_size_s size;
+  struct nxgl_size_s actual;
+  struct nxgl_point_s pos;
+  int frames = DEFAULT_FRAMES;
+  bool csv = false;
+  int option;
+  int i;
+  int j;
+
+  size.w = DEFAULT_WIDTH;
+  size.h = DEFAULT_HEIGHT;
+
+  while ((option = getopt(argc, argv, "n:w:h:C")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'n':
+            frames = atoi(optarg);
+            break;
+
+          case 'w':
+            size.w = atoi(optarg);
+            break;
+
+          case 'h':
+            size.h = atoi(optarg);
+            break;
+
+          case 'C':
+            csv = true;
+            break;
+
+          default:
+            showUsage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (frames < 1 || size.w < 32 || size.h < 32)
+    {
+      showUsage(argv[0], EXIT_FAILURE);
+    }
+
+  for (j = optind; j < argc; j++)
+    {
+      for (i = 0; i < (int)NSCENES; i++)
+        {
+          if (strcmp(argv[j], g_scenes[i].name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (i == (int)NSCENES)
+        {
+          printf("nxwidgetsbench_main: Unknown scene %s\n", argv[j]);
+          showUsage(argv[0], EXIT_FAILURE);
+        }
+    }
+
+  // Connect to the NX server
+
+  CNxServer *server = new CNxServer();
+  if (!server->connect())
+    {
+      printf("nxwidgetsbench_main: Failed to connect to the NX server\n");
+      delete server;
+      return EXIT_FAILURE;
+    }
+
+  // Create a hidden window that draws into its own RAM frame buffer, so
+  // that nothing reaches the display
+
+  ctx.hNxServer = server->getServer();
+  ctx.bitmap    = (FAR IBitmap *)NULL;
+  ctx.control   = new CWidgetControl((CWidgetStyle *)NULL);
+
+  CNxWindow *window =
+    server->createRawWindow(ctx.control,
+                            NXBE_WINDOW_RAMBACKED | NXBE_WINDOW_HIDDEN);
+  if (!window)
+    {
+      printf("nxwidgetsbench_main: Failed to create the window\n");
+      delete ctx.control;
+      delete server;
+      return EXIT_FAILURE;
+    }
+
+  if (!window->open())
+    {
+      printf("nxwidgetsbench_main: Failed to open the off-screen window\n");
+      delete window;
+      delete server;
+      return EXIT_FAILURE;
+    }
+
+  pos.x = 0;
+  pos.y = 0;
+
+  if (!window->setPosition(&pos) || !window->setSize(&size))
+    {
+      printf("nxwidgetsbench_main: Failed to size the window\n");
+      delete window;
+      delete server;
+      return EXIT_FAILURE;
+    }
+
+  // Wait for the new geometry to be reported back.  getSize() returns
+  // whatever geometry arrived last, which may still be the one from open
+  // time, so poll until it matches.
+
+  actual.w = 0;
+  actual.h = 0;
+
+  for (i = 0; i < 100; i++)
+    {
+      if (window->getSize(&actual) &&
+          actual.w == size.w && actual.h == size.h)
+        {
+          break;
+        }
+
+      usleep(10000);
+    }
+
+  if (i == 100)
+    {
+      printf("nxwidgetsbench_main: WARNING: The window reports %dx%d\n",
+             actual.w, actual.h);
+    }
+
+  ctx.width  = size.w;
+  ctx.height = size.h;
+
+  printf(csv ? "scene,widgets,frames,usec,fps,pixels_frame,ops_frame,"
+               "allocs_frame,heap_delta\n" :
+               "Scene       Widgets Frames      Usec  Frames/s "
+               "Pixels/frm Ops/frm Allocs/frm HeapDelta\n");
+
+  for (i = 0; i < (int)NSCENES; i++)
+    {
+      // Run the scenes named on the command line, or all of them
+
+      for (j = optind; j < argc; j++)
+        {
+          if (strcmp(argv[j], g_scenes[i].name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (optind < argc && j == argc)
+        {
+          continue;
+        }
+
+      runScene(&ctx, &g_scenes[i], frames, csv);
+    }
+
+  // Deleting the window also deletes its widget control
+
+  delete window;
+  delete server;
+  return EXIT_SUCCESS;
+}
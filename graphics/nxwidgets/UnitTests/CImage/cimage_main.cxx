@@ -35,6 +35,7 @@
 #include <nuttx/nx/nx.h>
 
 #include "graphics/nxwidgets/crlepalettebitmap.hxx"
+#include "graphics/nxwidgets/clzpalettebitmap.hxx"
 #include "graphics/nxglyphs.hxx"
 #include "graphics/nxwidgets/cimagetest.hxx"
 
@@ -158,7 +159,7 @@ int main(int argc, char *argv[])
 
   // Create an instance of the NuttX logo
 
-  CRlePaletteBitmap *nuttxBitmap = new CRlePaletteBitmap(&g_nuttxBitmap160x160);
+  CNxLogoBitmap *nuttxBitmap = new CNxLogoBitmap(&g_nuttxBitmap160x160);
   updateMemoryUsage(&g_mmprevious, "After creating the bitmap");
 
   // Create a CImage instance
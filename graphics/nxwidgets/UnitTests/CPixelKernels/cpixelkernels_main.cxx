@@ -0,0 +1,663 @@
+/////////////////////////////////////////////////////////////////////////////
+// apps/graphics/nxwidgets/UnitTests/CPixelKernels/cpixelkernels_main.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Included Files
+/////////////////////////////////////////////////////////////////////////////
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <nuttx/video/fb.h>
+
+#include "graphics/nxwidgets/cpixelkernels.hxx"
+
+/////////////////////////////////////////////////////////////////////////////
+// Definitions
+/////////////////////////////////////////////////////////////////////////////
+
+#define DEFAULT_FBDEV      "/dev/fb0"
+#define DEFAULT_ITERATIONS 10
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Types
+/////////////////////////////////////////////////////////////////////////////
+
+using namespace NXWidgets;
+
+typedef void (*benchfunc_t)(FAR const struct SPixelRect *fb,
+                            FAR const struct SPixelRect *work);
+
+struct SBenchmark
+{
+  FAR const char *name;
+  benchfunc_t func;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Data
+/////////////////////////////////////////////////////////////////////////////
+
+static unsigned int g_errors;
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Function Prototypes
+/////////////////////////////////////////////////////////////////////////////
+
+// Suppress name-mangling
+
+extern "C" int main(int argc, char *argv[]);
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Functions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: usec
+/////////////////////////////////////////////////////////////////////////////
+
+static uint64_t usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: refLoad / refStore
+//
+// Description:
+//   Per-pixel access with the format dispatched for every pixel, as
+//   CGraphicsPort used to do it.  Components are returned with the low
+//   bits cleared, like the RGB*RED() etc. macros.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+static void refLoad(FAR const struct SPixelRect *rect, FAR const uint8_t *p,
+                    uint32_t &r, uint32_t &g, uint32_t &b,
+                    uint32_t &a)
+{
+  uint32_t pixel;
+
+  a = 0;
+  switch (rect->fmt)
+    {
+      case FB_FMT_RGB8_332:
+        r = *p & 0xe0;
+        g = (*p << 3) & 0xe0;
+        b = (*p << 6) & 0xc0;
+        break;
+
+      case FB_FMT_RGB16_565:
+        pixel = *(FAR const uint16_t *)p;
+        r = (pixel >> 8) & 0xf8;
+        g = (pixel >> 3) & 0xfc;
+        b = (pixel << 3) & 0xf8;
+        break;
+
+      case FB_FMT_RGB24:
+        r = p[2];
+        g = p[1];
+        b = p[0];
+        break;
+
+      default:
+        pixel = *(FAR const uint32_t *)p;
+        a = pixel & 0xff000000;
+        r = (pixel >> 16) & 0xff;
+        g = (pixel >> 8) & 0xff;
+        b = pixel & 0xff;
+        break;
+    }
+}
+
+static void refStore(FAR const struct SPixelRect *rect, FAR uint8_t *p,
+                     uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+  r &= 0xff;
+  g &= 0xff;
+  b &= 0xff;
+
+  switch (rect->fmt)
+    {
+      case FB_FMT_RGB8_332:
+        *p = (r & 0xe0) | ((g >> 3) & 0x1c) | (b >> 6);
+        break;
+
+      case FB_FMT_RGB16_565:
+        *(FAR uint16_t *)p = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+        break;
+
+      case FB_FMT_RGB24:
+        p[0] = b;
+        p[1] = g;
+        p[2] = r;
+        break;
+
+      default:
+        *(FAR uint32_t *)p = a | (r << 16) | (g << 8) | b;
+        break;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: refGreyScale / refInvert
+/////////////////////////////////////////////////////////////////////////////
+
+static void refGreyScale(FAR const struct SPixelRect *rect)
+{
+  unsigned int bytes = CPixelKernels::bitsPerPixel(rect->fmt) >> 3;
+
+  for (nxgl_coord_t row = 0; row < rect->height; row++)
+    {
+      FAR uint8_t *p = rect->data + row * rect->stride;
+      for (nxgl_coord_t col = 0; col < rect->width; col++, p += bytes)
+        {
+          uint32_t r;
+          uint32_t g;
+          uint32_t b;
+          uint32_t a;
+
+          refLoad(rect, p, r, g, b, a);
+          uint32_t avg = (r + g + b) / 3;
+          refStore(rect, p, avg, avg, avg, a);
+        }
+    }
+}
+
+static void refInvert(FAR const struct SPixelRect *rect)
+{
+  unsigned int bytes = CPixelKernels::bitsPerPixel(rect->fmt) >> 3;
+
+  for (nxgl_coord_t row = 0; row < rect->height; row++)
+    {
+      FAR uint8_t *p = rect->data + row * rect->stride;
+      for (nxgl_coord_t col = 0; col < rect->width; col++, p += bytes)
+        {
+          uint32_t r;
+          uint32_t g;
+          uint32_t b;
+          uint32_t a;
+
+          refLoad(rect, p, r, g, b, a);
+          refStore(rect, p, ~r, ~g, ~b, a);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: sameRows
+/////////////////////////////////////////////////////////////////////////////
+
+static bool sameRows(FAR const struct SPixelRect *a,
+                     FAR const struct SPixelRect *b)
+{
+  unsigned int nbytes = CPixelKernels::stride(a->fmt, a->width);
+
+  for (nxgl_coord_t row = 0; row < a->height; row++)
+    {
+      if (std::memcmp(a->data + row * a->stride, b->data + row * b->stride,
+                      nbytes) != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: blendMatches
+//
+// Description:
+//   Check that "out" is "src" blended onto "before" with "alpha", to within
+//   half a level of each component (a whole level for RGB565, which is
+//   blended with a 5-bit alpha).
+//
+/////////////////////////////////////////////////////////////////////////////
+
+static bool blendMatches(FAR const struct SPixelRect *out,
+                         FAR const struct SPixelRect *before,
+                         FAR const struct SPixelRect *src, uint8_t alpha)
+{
+  unsigned int bytes = CPixelKernels::bitsPerPixel(out->fmt) >> 3;
+  int alpha256 = alpha + (alpha >> 7);
+  int step[3];
+  int tolerance;
+
+  switch (out->fmt)
+    {
+      case FB_FMT_RGB8_332:
+        step[0] = 32;
+        step[1] = 32;
+        step[2] = 64;
+        tolerance = 1;
+        break;
+
+      case FB_FMT_RGB16_565:
+        step[0] = 8;
+        step[1] = 4;
+        step[2] = 8;
+        tolerance = 2;
+        break;
+
+      default:
+        step[0] = 1;
+        step[1] = 1;
+        step[2] = 1;
+        tolerance = 1;
+        break;
+    }
+
+  for (nxgl_coord_t row = 0; row < out->height; row++)
+    {
+      FAR const uint8_t *o = out->data + row * out->stride;
+      FAR const uint8_t *d = before->data + row * before->stride;
+      FAR const uint8_t *s = src->data + row * src->stride;
+
+      for (nxgl_coord_t col = 0; col < out->width;
+           col++, o += bytes, d += bytes, s += bytes)
+        {
+          uint32_t oc[4];
+          uint32_t dc[4];
+          uint32_t sc[4];
+
+          refLoad(out, o, oc[0], oc[1], oc[2], oc[3]);
+          refLoad(before, d, dc[0], dc[1], dc[2], dc[3]);
+          refLoad(src, s, sc[0], sc[1], sc[2], sc[3]);
+
+          // Compare in 1/256ths of a component value; "tolerance" is in
+          // half levels
+
+          for (int c = 0; c < 3; c++)
+            {
+              int exact = (int)dc[c] * 256 +
+                          ((int)sc[c] - (int)dc[c]) * alpha256;
+              int error = (int)oc[c] * 256 - exact;
+
+              if (std::abs(error) > tolerance * step[c] * 128)
+                {
+                  return false;
+                }
+            }
+        }
+    }
+
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: check
+/////////////////////////////////////////////////////////////////////////////
+
+static void check(bool cond, FAR const char *what)
+{
+  if (!cond)
+    {
+      printf("cpixelkernels_main: ERROR: %s\n", what);
+      g_errors++;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: makeRect
+/////////////////////////////////////////////////////////////////////////////
+
+static bool makeRect(FAR struct SPixelRect *rect, uint8_t fmt,
+                     nxgl_coord_t width, nxgl_coord_t height)
+{
+  rect->fmt    = fmt;
+  rect->width  = width;
+  rect->height = height;
+  rect->stride = (CPixelKernels::stride(fmt, width) + 3) & ~3;
+  rect->data   = new uint8_t[rect->stride * height];
+  return rect->data != (FAR uint8_t *)0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: bench*
+//
+// Description:
+//   The operations timed on the frame buffer.  "work" is an off-screen
+//   rectangle of the frame buffer format and size.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+static void benchRefGreyScale(FAR const struct SPixelRect *fb,
+                              FAR const struct SPixelRect *work)
+{
+  refGreyScale(fb);
+}
+
+static void benchGreyScale(FAR const struct SPixelRect *fb,
+                           FAR const struct SPixelRect *work)
+{
+  CPixelKernels::greyScale(fb, fb);
+}
+
+static void benchRefInvert(FAR const struct SPixelRect *fb,
+                           FAR const struct SPixelRect *work)
+{
+  refInvert(fb);
+}
+
+static void benchInvert(FAR const struct SPixelRect *fb,
+                        FAR const struct SPixelRect *work)
+{
+  CPixelKernels::invert(fb, fb);
+}
+
+static void benchFill(FAR const struct SPixelRect *fb,
+                      FAR const struct SPixelRect *work)
+{
+  CPixelKernels::fill(fb, 0x00336699);
+}
+
+static void benchBlend(FAR const struct SPixelRect *fb,
+                       FAR const struct SPixelRect *work)
+{
+  CPixelKernels::blend(fb, work, 96);
+}
+
+static void benchConvert(FAR const struct SPixelRect *fb, uint8_t fmt)
+{
+  struct SPixelRect dest;
+
+  if (makeRect(&dest, fmt, fb->width, fb->height))
+    {
+      CPixelKernels::convert(&dest, fb);
+      delete[] dest.data;
+    }
+}
+
+static void benchTo332(FAR const struct SPixelRect *fb,
+                       FAR const struct SPixelRect *work)
+{
+  benchConvert(fb, FB_FMT_RGB8_332);
+}
+
+static void benchTo565(FAR const struct SPixelRect *fb,
+                       FAR const struct SPixelRect *work)
+{
+  benchConvert(fb, FB_FMT_RGB16_565);
+}
+
+static void benchTo888(FAR const struct SPixelRect *fb,
+                       FAR const struct SPixelRect *work)
+{
+  benchConvert(fb, FB_FMT_RGB24);
+}
+
+static void benchTo8888(FAR const struct SPixelRect *fb,
+                        FAR const struct SPixelRect *work)
+{
+  benchConvert(fb, FB_FMT_RGB32);
+}
+
+static const struct SBenchmark g_benchmarks[] =
+{
+  { "greyscale (per-pixel)", benchRefGreyScale },
+  { "greyscale",             benchGreyScale    },
+  { "invert (per-pixel)",    benchRefInvert    },
+  { "invert",                benchInvert       },
+  { "fill",                  benchFill         },
+  { "blend",                 benchBlend        },
+  { "convert to RGB332",     benchTo332        },
+  { "convert to RGB565",     benchTo565        },
+  { "convert to RGB888",     benchTo888        },
+  { "convert to ARGB8888",   benchTo8888       },
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: verify
+//
+// Description:
+//   Check the kernels against the per-pixel reference on a test pattern in
+//   the frame buffer format.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+static void verify(uint8_t fmt, nxgl_coord_t width, nxgl_coord_t height)
+{
+  struct SPixelRect pattern;
+  struct SPixelRect ref;
+  struct SPixelRect out;
+  struct SPixelRect wide;
+
+  if (!makeRect(&pattern, fmt, width, height) ||
+      !makeRect(&ref, fmt, width, height) ||
+      !makeRect(&out, fmt, width, height) ||
+      !makeRect(&wide, FB_FMT_RGB32, width, height))
+    {
+      check(false, "allocation");
+      return;
+    }
+
+  // A pattern that covers every component value
+
+  for (nxgl_coord_t row = 0; row < height; row++)
+    {
+      FAR uint32_t *p = (FAR uint32_t *)(wide.data + row * wide.stride);
+      for (nxgl_coord_t col = 0; col < width; col++)
+        {
+          p[col] = 0xff000000 | ((uint32_t)(col * 7) & 0xff) << 16 |
+                   ((uint32_t)(row * 5) & 0xff) << 8 |
+                   ((uint32_t)(col + row) & 0xff);
+        }
+    }
+
+  check(CPixelKernels::convert(&pattern, &wide), "convert from ARGB8888");
+
+  // Greyscale and invert must match the reference exactly
+
+  CPixelKernels::convert(&ref, &pattern);
+  refGreyScale(&ref);
+  check(CPixelKernels::greyScale(&out, &pattern), "greyscale");
+  check(sameRows(&out, &ref), "greyscale matches the reference");
+
+  CPixelKernels::convert(&ref, &pattern);
+  refInvert(&ref);
+  check(CPixelKernels::invert(&out, &pattern), "invert");
+  check(sameRows(&out, &ref), "invert matches the reference");
+
+  // Widening and narrowing back is lossless
+
+  check(CPixelKernels::convert(&wide, &pattern), "convert to ARGB8888");
+  check(CPixelKernels::convert(&out, &wide), "convert back");
+  check(sameRows(&out, &pattern), "conversion round trip");
+
+  // Blending with opaque and transparent alpha
+
+  CPixelKernels::fill(&out, 0);
+  CPixelKernels::blend(&out, &pattern, 0);
+  CPixelKernels::fill(&ref, 0);
+  check(sameRows(&out, &ref), "transparent blend");
+
+  CPixelKernels::blend(&out, &pattern, 255);
+  check(sameRows(&out, &pattern), "opaque blend");
+
+  // Blending a rectangle onto itself changes nothing
+
+  CPixelKernels::convert(&out, &pattern);
+  CPixelKernels::blend(&out, &out, 128);
+  check(sameRows(&out, &pattern), "self blend");
+
+  // Intermediate alpha values, darkening and lightening, against the
+  // exact blend
+
+  static const uint8_t alphas[] =
+  {
+    1, 32, 96, 128, 160, 254
+  };
+
+  for (unsigned int i = 0; i < sizeof(alphas); i++)
+    {
+      CPixelKernels::invert(&ref, &pattern);
+      CPixelKernels::convert(&out, &ref);
+      CPixelKernels::blend(&out, &pattern, alphas[i]);
+      check(blendMatches(&out, &ref, &pattern, alphas[i]),
+            "blend matches the reference");
+    }
+
+  delete[] pattern.data;
+  delete[] ref.data;
+  delete[] out.data;
+  delete[] wide.data;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Functions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: main
+/////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+  FAR const char *fbdev = DEFAULT_FBDEV;
+  int iterations = DEFAULT_ITERATIONS;
+  struct fb_videoinfo_s vinfo;
+  struct fb_planeinfo_s pinfo;
+  struct SPixelRect fb;
+  struct SPixelRect work;
+  FAR void *fbmem;
+  int fd;
+
+  if (argc > 1)
+    {
+      fbdev = argv[1];
+    }
+
+  if (argc > 2)
+    {
+      iterations = atoi(argv[2]);
+    }
+
+  g_errors = 0;
+
+  // Verify every supported format before timing anything
+
+  static const uint8_t formats[] =
+  {
+    FB_FMT_RGB8_332, FB_FMT_RGB16_565, FB_FMT_RGB24, FB_FMT_RGB32
+  };
+
+  for (unsigned int i = 0; i < sizeof(formats); i++)
+    {
+      verify(formats[i], 61, 37);
+    }
+
+  // Map the frame buffer
+
+  fd = open(fbdev, O_RDWR);
+  if (fd < 0)
+    {
+      printf("cpixelkernels_main: Failed to open %s: %d\n", fbdev, errno);
+      return 1;
+    }
+
+  if (ioctl(fd, FBIOGET_VIDEOINFO, (unsigned long)((uintptr_t)&vinfo)) < 0 ||
+      ioctl(fd, FBIOGET_PLANEINFO, (unsigned long)((uintptr_t)&pinfo)) < 0)
+    {
+      printf("cpixelkernels_main: Failed to get the frame buffer info: %d\n",
+             errno);
+      close(fd);
+      return 1;
+    }
+
+  fbmem = mmap(NULL, pinfo.fblen, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_FILE, fd, 0);
+  if (fbmem == MAP_FAILED)
+    {
+      printf("cpixelkernels_main: Failed to map the frame buffer: %d\n",
+             errno);
+      close(fd);
+      return 1;
+    }
+
+  fb.fmt    = vinfo.fmt;
+  fb.width  = vinfo.xres;
+  fb.height = vinfo.yres;
+  fb.stride = pinfo.stride;
+  fb.data   = (FAR uint8_t *)fbmem;
+
+  if (CPixelKernels::bitsPerPixel(fb.fmt) == 0 ||
+      !makeRect(&work, fb.fmt, fb.width, fb.height))
+    {
+      printf("cpixelkernels_main: Unsupported format %u\n", fb.fmt);
+      munmap(fbmem, pinfo.fblen);
+      close(fd);
+      return 1;
+    }
+
+  CPixelKernels::convert(&work, &fb);
+
+  printf("cpixelkernels_main: %s %ux%u fmt %u, %d iterations\n",
+         fbdev, fb.width, fb.height, fb.fmt, iterations);
+  printf("%-24s %10s %10s\n", "Operation", "us/frame", "Mpixel/s");
+
+  uint32_t npixels = (uint32_t)fb.width * fb.height;
+
+  for (unsigned int i = 0;
+       i < sizeof(g_benchmarks) / sizeof(g_benchmarks[0]); i++)
+    {
+      uint64_t start = usec();
+
+      for (int n = 0; n < iterations; n++)
+        {
+          g_benchmarks[i].func(&fb, &work);
+        }
+
+      uint64_t elapsed = usec() - start;
+      uint64_t perframe = iterations > 0 ? elapsed / iterations : 0;
+
+      printf("%-24s %10lu %10lu\n", g_benchmarks[i].name,
+             (unsigned long)perframe,
+             (unsigned long)(perframe > 0 ? npixels / perframe : 0));
+    }
+
+  // Restore the original screen content
+
+  CPixelKernels::convert(&fb, &work);
+  delete[] work.data;
+
+  munmap(fbmem, pinfo.fblen);
+  close(fd);
+
+  if (g_errors > 0)
+    {
+      printf("cpixelkernels_main: FAILED: %u errors\n", g_errors);
+      return 1;
+    }
+
+  printf("cpixelkernels_main: PASSED\n");
+  return 0;
+}
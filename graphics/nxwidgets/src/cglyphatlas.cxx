@@ -0,0 +1,408 @@
+/****************************************************************************
+ * apps/graphics/nxwidgets/src/cglyphatlas.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <cstring>
+#include <pthread.h>
+#include <debug.h>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+#include "graphics/nxwidgets/cbitmap.hxx"
+#include "graphics/nxwidgets/cglyphatlas.hxx"
+
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+// The list of all atlases in use and the amount of memory that they hold.
+// Both are protected by g_atlasLock.
+
+static pthread_mutex_t g_atlasLock = PTHREAD_MUTEX_INITIALIZER;
+static FAR NXWidgets::CGlyphAtlas *g_atlasList;
+static size_t g_atlasMemory;
+
+/****************************************************************************
+ * CGlyphAtlas Method Implementations
+ ****************************************************************************/
+
+using namespace NXWidgets;
+
+/**
+ * Constructor.  Use acquire() to get an atlas instance.
+ *
+ * @param fontid The font ID to use.
+ * @param fontColor The color that the glyphs are rendered in.
+ */
+
+CGlyphAtlas::CGlyphAtlas(enum nx_fontid_e fontid, nxgl_mxpixel_t fontColor)
+{
+  m_flink      = (FAR CGlyphAtlas *)0;
+  m_fontId     = fontid;
+  m_fontHandle = nxf_getfonthandle(fontid);
+  m_pFontSet   = (FAR const struct nx_font_s *)0;
+  m_fontColor  = fontColor;
+
+  // The key color marks pixels that are not part of a glyph.  The font
+  // renderer only ever writes the font color so any other value will do.
+
+  m_keyColor   = fontColor ^ 1;
+  m_refs       = 1;
+  m_poolSize   = 0;
+  m_pool       = (FAR uint8_t *)0;
+
+  std::memset(m_glyphs, 0, sizeof(m_glyphs));
+}
+
+/**
+ * Destructor.  Use release() to free an atlas instance.
+ */
+
+CGlyphAtlas::~CGlyphAtlas(void)
+{
+  if (m_pool != (FAR uint8_t *)0)
+    {
+      delete[] m_pool;
+    }
+}
+
+/**
+ * Build the metrics table and pre-render all glyphs.
+ *
+ * @return True if the atlas was successfully built.
+ */
+
+bool CGlyphAtlas::build(void)
+{
+  if (m_fontHandle == (NXHANDLE)0)
+    {
+      gerr("ERROR: No font handle for font ID %d\n", m_fontId);
+      return false;
+    }
+
+  m_pFontSet = nxf_getfontset(m_fontHandle);
+
+  // First pass:  Collect the metrics of each glyph and assign each one a
+  // region of the pixel pool.
+
+  uint32_t offset = 0;
+  for (unsigned int code = 0; code < GLYPHATLAS_NCODES; code++)
+    {
+      FAR struct SGlyphAtlasEntry *entry = &m_glyphs[code];
+      FAR const struct nx_fontbitmap_s *fbm =
+        nxf_getbitmap(m_fontHandle, (uint16_t)code);
+
+      if (fbm != (FAR const struct nx_fontbitmap_s *)0)
+        {
+          entry->stride  = fbm->metric.stride;
+          entry->width   = fbm->metric.width;
+          entry->height  = fbm->metric.height;
+          entry->xoffset = fbm->metric.xoffset;
+          entry->yoffset = fbm->metric.yoffset;
+          entry->advance = fbm->metric.width + fbm->metric.xoffset;
+          entry->present = true;
+          entry->offset  = offset;
+
+          unsigned int fwidth  = entry->width + entry->xoffset;
+          unsigned int fheight = entry->height + entry->yoffset;
+          unsigned int fstride = (fwidth * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+
+          offset += fstride * fheight;
+        }
+      else
+        {
+          // Use the metrics of a space which has no width and no height
+          // but an advance equal to the standard width of a space.
+
+          entry->stride  = (m_pFontSet->spwidth * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+          entry->xoffset = m_pFontSet->spwidth;
+          entry->advance = m_pFontSet->spwidth;
+          entry->present = false;
+        }
+    }
+
+  m_poolSize = offset;
+  if (m_poolSize == 0)
+    {
+      return true;
+    }
+
+  m_pool = new uint8_t[m_poolSize];
+  if (m_pool == (FAR uint8_t *)0)
+    {
+      gerr("ERROR: Failed to allocate %lu byte glyph atlas\n",
+           (unsigned long)m_poolSize);
+      return false;
+    }
+
+  // Second pass:  Fill each glyph cell with the key color then render the
+  // glyph into it.
+
+  for (unsigned int code = 0; code < GLYPHATLAS_NCODES; code++)
+    {
+      FAR struct SGlyphAtlasEntry *entry = &m_glyphs[code];
+      if (!entry->present)
+        {
+          continue;
+        }
+
+      FAR const struct nx_fontbitmap_s *fbm =
+        nxf_getbitmap(m_fontHandle, (uint16_t)code);
+
+      unsigned int fwidth  = entry->width + entry->xoffset;
+      unsigned int fheight = entry->height + entry->yoffset;
+      unsigned int fstride = (fwidth * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+      FAR uint8_t *cell    = &m_pool[entry->offset];
+
+      for (unsigned int row = 0; row < fheight; row++)
+        {
+          FAR uint8_t *dest = &cell[row * fstride];
+          for (unsigned int col = 0; col < fwidth; col++)
+            {
+#if CONFIG_NXWIDGETS_BPP == 8
+              dest[col] = (uint8_t)m_keyColor;
+#elif CONFIG_NXWIDGETS_BPP == 16
+              ((FAR uint16_t *)dest)[col] = (uint16_t)m_keyColor;
+#elif CONFIG_NXWIDGETS_BPP == 24
+              dest[3 * col]     = (uint8_t)m_keyColor;
+              dest[3 * col + 1] = (uint8_t)(m_keyColor >> 8);
+              dest[3 * col + 2] = (uint8_t)(m_keyColor >> 16);
+#else
+              ((FAR uint32_t *)dest)[col] = (uint32_t)m_keyColor;
+#endif
+            }
+        }
+
+      FONT_RENDERER((FAR nxgl_mxpixel_t *)cell, fheight, fwidth, fstride,
+                    fbm, m_fontColor);
+    }
+
+  return true;
+}
+
+/**
+ * Get a reference to the shared atlas for a font ID and color,
+ * creating and pre-rendering it on the first reference.
+ *
+ * @param fontid The font ID to use.
+ * @param fontColor The color that the glyphs are rendered in.
+ * @return The shared atlas or NULL if it could not be created.
+ */
+
+FAR CGlyphAtlas *CGlyphAtlas::acquire(enum nx_fontid_e fontid,
+                                      nxgl_mxpixel_t fontColor)
+{
+  pthread_mutex_lock(&g_atlasLock);
+
+  // Is there already an atlas for this font and color?
+
+  FAR CGlyphAtlas *atlas;
+  for (atlas = g_atlasList; atlas != (FAR CGlyphAtlas *)0;
+       atlas = atlas->m_flink)
+    {
+      if (atlas->m_fontId == fontid && atlas->m_fontColor == fontColor)
+        {
+          atlas->m_refs++;
+          pthread_mutex_unlock(&g_atlasLock);
+          return atlas;
+        }
+    }
+
+  // No.. create and pre-render a new one.  This is done with the lock held
+  // so that two threads cannot race to build the same atlas.
+
+  atlas = new CGlyphAtlas(fontid, fontColor);
+  if (atlas != (FAR CGlyphAtlas *)0)
+    {
+      if (!atlas->build())
+        {
+          delete atlas;
+          atlas = (FAR CGlyphAtlas *)0;
+        }
+      else
+        {
+          atlas->m_flink  = g_atlasList;
+          g_atlasList     = atlas;
+          g_atlasMemory  += sizeof(CGlyphAtlas) + atlas->m_poolSize;
+
+          ginfo("Font %d color %08lx: %lu byte atlas, %lu bytes total\n",
+                fontid, (unsigned long)fontColor,
+                (unsigned long)atlas->m_poolSize,
+                (unsigned long)g_atlasMemory);
+        }
+    }
+
+  pthread_mutex_unlock(&g_atlasLock);
+  return atlas;
+}
+
+/**
+ * Release a reference obtained with acquire().  The atlas is freed when
+ * the last reference is released.
+ *
+ * @param atlas The atlas to release.
+ */
+
+void CGlyphAtlas::release(FAR CGlyphAtlas *atlas)
+{
+  if (atlas == (FAR CGlyphAtlas *)0)
+    {
+      return;
+    }
+
+  pthread_mutex_lock(&g_atlasLock);
+
+  if (--atlas->m_refs == 0)
+    {
+      // Remove the atlas from the list
+
+      FAR CGlyphAtlas *prev = (FAR CGlyphAtlas *)0;
+      FAR CGlyphAtlas *curr;
+
+      for (curr = g_atlasList; curr != (FAR CGlyphAtlas *)0;
+           prev = curr, curr = curr->m_flink)
+        {
+          if (curr == atlas)
+            {
+              if (prev == (FAR CGlyphAtlas *)0)
+                {
+                  g_atlasList = curr->m_flink;
+                }
+              else
+                {
+                  prev->m_flink = curr->m_flink;
+                }
+
+              break;
+            }
+        }
+
+      g_atlasMemory -= sizeof(CGlyphAtlas) + atlas->m_poolSize;
+      delete atlas;
+    }
+
+  pthread_mutex_unlock(&g_atlasLock);
+}
+
+/**
+ * Get the total amount of memory currently used by all glyph atlases.
+ *
+ * @return The number of bytes allocated for atlases.
+ */
+
+size_t CGlyphAtlas::getMemoryUsage(void)
+{
+  pthread_mutex_lock(&g_atlasLock);
+  size_t memory = g_atlasMemory;
+  pthread_mutex_unlock(&g_atlasLock);
+  return memory;
+}
+
+/**
+ * Copy a pre-rendered glyph into a bitmap.  Only the pixels that belong
+ * to the glyph are copied; the remainder of the bitmap is left
+ * untouched so that the glyph is drawn on the existing background.
+ *
+ * @param bitmap The bitmap to draw to.  The caller should use the
+ *   character metrics to assure that the buffer will hold the glyph.
+ * @param letter The character to output.  Must be covered by the
+ *   atlas.
+ */
+
+void CGlyphAtlas::blitChar(FAR SBitmap *bitmap, nxwidget_char_t letter) const
+{
+  FAR const struct SGlyphAtlasEntry *entry = &m_glyphs[(unsigned int)letter];
+  if (!entry->present)
+    {
+      return;
+    }
+
+  // Clip the glyph cell to the destination bitmap
+
+  unsigned int fwidth  = entry->width + entry->xoffset;
+  unsigned int fheight = entry->height + entry->yoffset;
+  unsigned int fstride = (fwidth * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+
+  if (fwidth > (unsigned int)bitmap->width)
+    {
+      fwidth = bitmap->width;
+    }
+
+  if (fheight > (unsigned int)bitmap->height)
+    {
+      fheight = bitmap->height;
+    }
+
+  // The rows above yoffset and the columns left of xoffset never contain
+  // glyph pixels so they can be skipped entirely.
+
+  FAR const uint8_t *src = &m_pool[entry->offset];
+  FAR uint8_t *dest      = (FAR uint8_t *)bitmap->data;
+
+  for (unsigned int row = entry->yoffset; row < fheight; row++)
+    {
+      FAR const uint8_t *sline = &src[row * fstride];
+      FAR uint8_t *dline       = &dest[row * bitmap->stride];
+
+      for (unsigned int col = entry->xoffset; col < fwidth; col++)
+        {
+#if CONFIG_NXWIDGETS_BPP == 8
+          uint8_t pixel = sline[col];
+          if (pixel != (uint8_t)m_keyColor)
+            {
+              dline[col] = pixel;
+            }
+#elif CONFIG_NXWIDGETS_BPP == 16
+          uint16_t pixel = ((FAR const uint16_t *)sline)[col];
+          if (pixel != (uint16_t)m_keyColor)
+            {
+              ((FAR uint16_t *)dline)[col] = pixel;
+            }
+#elif CONFIG_NXWIDGETS_BPP == 24
+          if (sline[3 * col] != (uint8_t)m_keyColor)
+            {
+              dline[3 * col]     = sline[3 * col];
+              dline[3 * col + 1] = sline[3 * col + 1];
+              dline[3 * col + 2] = sline[3 * col + 2];
+            }
+#else
+          uint32_t pixel = ((FAR const uint32_t *)sline)[col];
+          if (pixel != (uint32_t)m_keyColor)
+            {
+              ((FAR uint32_t *)dline)[col] = pixel;
+            }
+#endif
+        }
+    }
+}
+
+#endif // CONFIG_NXWIDGETS_GLYPHATLAS
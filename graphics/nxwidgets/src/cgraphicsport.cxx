@@ -90,6 +90,7 @@
 #include "graphics/nxwidgets/cgraphicsport.hxx"
 #include "graphics/nxwidgets/cwidgetstyle.hxx"
 #include "graphics/nxwidgets/cbitmap.hxx"
+#include "graphics/nxwidgets/cpixelkernels.hxx"
 #include "graphics/nxwidgets/singletons.hxx"
 
 /****************************************************************************
@@ -102,6 +103,31 @@
 
 using namespace NXWidgets;
 
+/**
+ * Allocate a buffer for a band of rows.  The whole height is tried first
+ * and the band is halved until the allocation succeeds.
+ *
+ * @param stride The number of bytes in one row.
+ * @param height The number of rows wanted.
+ * @param nrows Returns the number of rows that the buffer holds.
+ * @return The buffer (to be freed with delete[]) or NULL.
+ */
+
+static FAR uint8_t *allocateBand(unsigned int stride, nxgl_coord_t height,
+                                 nxgl_coord_t &nrows)
+{
+  for (nrows = height; nrows > 0; nrows >>= 1)
+    {
+      FAR uint8_t *buffer = new uint8_t[(size_t)nrows * stride];
+      if (buffer)
+        {
+          return buffer;
+        }
+    }
+
+  return (FAR uint8_t *)0;
+}
+
 /**
  * Constructor.
  *
@@ -115,11 +141,19 @@ CGraphicsPort::CGraphicsPort(INxWindow *pNxWnd, nxgl_mxpixel_t backColor)
 {
   m_pNxWnd    = pNxWnd;
   m_backColor = backColor;
+
+#ifdef CONFIG_NXWIDGETS_DRAWSTATS
+  resetDrawStats();
+#endif
 }
 #else
 CGraphicsPort::CGraphicsPort(INxWindow *pNxWnd)
 {
   m_pNxWnd = pNxWnd;
+
+#ifdef CONFIG_NXWIDGETS_DRAWSTATS
+  resetDrawStats();
+#endif
 }
 #endif
 
@@ -177,6 +211,11 @@ void CGraphicsPort::drawPixel(nxgl_coord_t x, nxgl_coord_t y,
   pos.x = x;
   pos.y = y;
   m_pNxWnd->setPixel(&pos, color);
+
+  struct nxgl_rect_s rect;
+  rect.pt1 = pos;
+  rect.pt2 = pos;
+  countDraw(&rect);
 }
 
 /**
@@ -202,6 +241,7 @@ void CGraphicsPort::drawHorizLine(nxgl_coord_t x, nxgl_coord_t y,
 
   // Draw the line
 
+  countDraw(&dest);
   if (!m_pNxWnd->fill(&dest, color))
     {
       gerr("ERROR: INxWindow::fill failed\n");
@@ -232,6 +272,7 @@ void CGraphicsPort::drawVertLine(nxgl_coord_t x, nxgl_coord_t y,
 
   // Draw the line
 
+  countDraw(&dest);
   if (!m_pNxWnd->fill(&dest, color))
     {
       gerr("ERROR: INxWindow::fill failed\n");
@@ -261,6 +302,18 @@ void CGraphicsPort::drawLine(nxgl_coord_t x1, nxgl_coord_t y1,
   vector.pt2.x = x2;
   vector.pt2.y = y2;
 
+  // Count the line as the pixels along its longer axis
+
+  nxgl_coord_t dx = x2 > x1 ? x2 - x1 : x1 - x2;
+  nxgl_coord_t dy = y2 > y1 ? y2 - y1 : y1 - y2;
+
+  struct nxgl_rect_s rect;
+  rect.pt1.x = 0;
+  rect.pt1.y = 0;
+  rect.pt2.x = dx > dy ? dx : dy;
+  rect.pt2.y = 0;
+  countDraw(&rect);
+
   if (!m_pNxWnd->drawLine(&vector, 1, color, caps))
     {
       gerr("ERROR: INxWindow::drawLine failed\n");
@@ -286,6 +339,7 @@ void CGraphicsPort::drawFilledRect(nxgl_coord_t x, nxgl_coord_t y,
   rect.pt1.y = y;
   rect.pt2.x = x + width - 1;
   rect.pt2.y = y + height - 1;
+  countDraw(&rect);
   m_pNxWnd->fill(&rect, color);
 }
 
@@ -369,6 +423,7 @@ void CGraphicsPort::drawBitmap(nxgl_coord_t x, nxgl_coord_t y,
 
   // Blit the bitmap
 
+  countDraw(&dest);
   m_pNxWnd->bitmap(&dest, (FAR const void *)bitmap->data, &origin, bitmap->stride);
 }
 
@@ -507,6 +562,7 @@ void CGraphicsPort::drawBitmap(nxgl_coord_t x, nxgl_coord_t y,
 
       // Blit the bitmap
 
+      countDraw(&dest);
       m_pNxWnd->bitmap(&dest, (FAR const void *)runPtr, &origin, bitmap->stride);
     }
 }
@@ -530,71 +586,70 @@ void CGraphicsPort::drawBitmapGreyScale(nxgl_coord_t x, nxgl_coord_t y,
                                         const struct SBitmap *bitmap,
                                         int bitmapX, int bitmapY)
 {
-  // Working buffer.  Holds one converted row from the bitmap
+  if (width < 1 || height < 1)
+    {
+      return;
+    }
 
-  FAR nxwidget_pixel_t *run = new nxwidget_pixel_t[width];
-  if (!run)
+  // Working buffer.  Holds as many converted rows of the bitmap as memory
+  // allows
+
+  unsigned int stride = CPixelKernels::stride(CONFIG_NXWIDGETS_FMT, width);
+  nxgl_coord_t nrows;
+  FAR uint8_t *buffer = allocateBand(stride, height, nrows);
+  if (!buffer)
     {
       ginfo("ERROR: Failed to allocated run buffer\n");
       return;
     }
 
-  // Pointer to the beginning of the first source row
-
-  FAR uint8_t *src = (FAR uint8_t *)bitmap->data + bitmapY * bitmap->stride + bitmapX;
+  countAllocation();
 
-  // Setup non-changing blit parameters
+  // Describe the source bitmap region and the working buffer
 
-  struct nxgl_point_s origin;
-  origin.x   = x;
-  origin.y   = y;
+  struct SPixelRect src;
+  src.fmt    = CONFIG_NXWIDGETS_FMT;
+  src.width  = width;
+  src.stride = bitmap->stride;
+  src.data   = (FAR uint8_t *)bitmap->data + bitmapY * bitmap->stride +
+               ((bitmapX * CONFIG_NXWIDGETS_BPP) >> 3);
 
-  struct nxgl_rect_s dest;
-  dest.pt1.x = x;
-  dest.pt1.y = y;
-  dest.pt2.x = x + width - 1;
-  dest.pt2.y = y;
+  struct SPixelRect dest;
+  dest.fmt    = CONFIG_NXWIDGETS_FMT;
+  dest.width  = width;
+  dest.stride = stride;
+  dest.data   = buffer;
 
-  // Convert each row to greyscale and send it to the display
+  // Convert each band of rows to greyscale and send it to the display
 
-  for (int row = 0; row < height; row++)
+  for (nxgl_coord_t row = 0; row < height; row += nrows)
     {
-      // Convert the next row
-
-      FAR nxwidget_pixel_t *runSrc  = (FAR nxwidget_pixel_t *)src;
-      FAR nxwidget_pixel_t *runDest = run;
-
-      for (int col = 0; col < width; col++)
+      if (nrows > height - row)
         {
-          // Get the next RGB pixel and break out the individual components
-
-          nxwidget_pixel_t rgb = *runSrc++;
-          nxwidget_pixel_t r   = RGB2RED(rgb);
-          nxwidget_pixel_t g   = RGB2GREEN(rgb);
-          nxwidget_pixel_t b   = RGB2BLUE(rgb);
-
-          // A truly accurate greyscale conversion would be complex.  Let's
-          // just average.
-
-          nxwidget_pixel_t avg = (r + g + b) / 3;
-          *runDest++ = MKRGB(avg, avg, avg);
+          nrows = height - row;
         }
 
-      // Now blit the single row
+      src.height  = nrows;
+      dest.height = nrows;
+      CPixelKernels::greyScale(&dest, &src);
 
-      m_pNxWnd->bitmap(&dest, run, &origin, bitmap->stride);
+      struct nxgl_point_s origin;
+      origin.x = x;
+      origin.y = y + row;
 
-       // Setup for the next source row
+      struct nxgl_rect_s rect;
+      rect.pt1.x = x;
+      rect.pt1.y = y + row;
+      rect.pt2.x = x + width - 1;
+      rect.pt2.y = y + row + nrows - 1;
 
-       y++;
-       origin.y   = y;
-       dest.pt1.y = y;
-       dest.pt2.y = y;
+      countDraw(&rect);
+      m_pNxWnd->bitmap(&rect, (FAR const void *)buffer, &origin, stride);
 
-       src += bitmap->stride;
+      src.data += nrows * bitmap->stride;
     }
 
-  delete run;
+  delete[] buffer;
 }
 
 /**
@@ -740,6 +795,7 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
 
   unsigned int glyphSize =  bmWidth * bmHeight;
   FAR uint8_t  *glyph    =  new uint8_t[glyphSize];
+  countAllocation();
 
   // Get the bounding rectangle in NX form
 
@@ -826,6 +882,7 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
 
               // Then put the font on the display
 
+              countDraw(&intersection);
               if (!m_pNxWnd->bitmap(&intersection, (FAR const void *)bitmap.data,
                                    pos, bitmap.stride))
                 {
@@ -869,6 +926,7 @@ void CGraphicsPort::copy(nxgl_coord_t sourceX, nxgl_coord_t sourceY,
   offset.x = destX - sourceX;
   offset.y = destY - sourceY;
 
+  countDraw(&rect);
   m_pNxWnd->move(&rect, &offset);
 }
 
@@ -897,6 +955,7 @@ void CGraphicsPort::move(nxgl_coord_t x, nxgl_coord_t y,
   offset.x = deltaX;
   offset.y = deltaY;
 
+  countDraw(&rect);
   m_pNxWnd->move(&rect, &offset);
 }
 
@@ -912,72 +971,7 @@ void CGraphicsPort::move(nxgl_coord_t x, nxgl_coord_t y,
 void CGraphicsPort::greyScale(nxgl_coord_t x, nxgl_coord_t y,
                               nxgl_coord_t width, nxgl_coord_t height)
 {
-  // Allocate memory to hold one row of graphics data
-
-  unsigned int stride    = ((unsigned int)width * CONFIG_NXWIDGETS_BPP + 7) >> 3;
-  FAR uint8_t *rowBuffer = new uint8_t[height * stride];
-  if (!rowBuffer)
-    {
-      return;
-    }
-
-  // Describe the receiving bitmap memory
-
-  SBitmap rowBitmap;
-  rowBitmap.bpp    = CONFIG_NXWIDGETS_BPP;
-  rowBitmap.fmt    = CONFIG_NXWIDGETS_FMT;
-  rowBitmap.width  = width;
-  rowBitmap.height = 1;
-  rowBitmap.stride = stride;
-  rowBitmap.data   = (FAR const nxgl_mxpixel_t *)rowBuffer;
-
-  // Partially describe the source rectangle
-
-  struct nxgl_rect_s rect;
-  rect.pt1.x = x;
-  rect.pt2.x = x + width - 1;
-
-  // Partially setup the graphics origin
-
-  struct nxgl_point_s origin;
-  origin.x = x;
-
-  // Loop for each row in the region to be inverted
-
-  for (int row = 0; row < height; row++)
-    {
-      // Read the graphic memory corresponding to the row
-
-      rect.pt1.y = rect.pt2.y = y + row;
-      m_pNxWnd->getRectangle(&rect, &rowBitmap);
-
-      // Convert each bit to  each bit
-
-      nxwidget_pixel_t *ptr = (nxwidget_pixel_t *)rowBuffer;
-      for (int col = 0; col < width; col++)
-        {
-          // Get the next RGB pixel and break out the individual components
-
-          nxwidget_pixel_t color = *ptr;
-          uint8_t red   = RGB2RED(color);
-          uint8_t green = RGB2GREEN(color);
-          uint8_t blue  = RGB2BLUE(color);
-
-          // A truly accurate greyscale conversion would be complex.  Let's
-          // just average.
-
-          nxwidget_pixel_t avg = (red + green + blue) / 3;
-          *ptr++ = MKRGB(avg, avg, avg);
-        }
-
-      // Then write the row back to graphics memory
-
-      origin.y = rect.pt1.y;
-      m_pNxWnd->bitmap(&rect, (FAR const void *)rowBitmap.data,
-                       &origin, rowBitmap.stride) ;
-    }
-
-  delete rowBuffer;
+  transformRegion(x, y, width, height, CPixelKernels::greyScale);
 }
 
 /**
@@ -995,63 +989,92 @@ void CGraphicsPort::greyScale(nxgl_coord_t x, nxgl_coord_t y,
 void CGraphicsPort::invert(nxgl_coord_t x, nxgl_coord_t y,
                            nxgl_coord_t width, nxgl_coord_t height)
 {
-  // Allocate memory to hold one row of graphics data
+  transformRegion(x, y, width, height, CPixelKernels::invert);
+}
 
-  unsigned int stride    = ((unsigned int)width * CONFIG_NXWIDGETS_BPP + 7) >> 3;
-  FAR uint8_t *rowBuffer = new uint8_t[height * stride];
-  if (!rowBuffer)
+/**
+ * Read a region of graphics memory, transform it with a pixel kernel
+ * and write it back.  The region is handled in as few bands of rows as
+ * memory allows, ideally one read and one write for the whole region.
+ *
+ * @param x X coordinate of the region to change.
+ * @param y Y coordinate of the region to change.
+ * @param width Width of the region to change.
+ * @param height Height of the region to change.
+ * @param kernel The CPixelKernels operation to apply in place.
+ */
+
+void CGraphicsPort::transformRegion(nxgl_coord_t x, nxgl_coord_t y,
+                                    nxgl_coord_t width, nxgl_coord_t height,
+                                    CODE bool (*kernel)(FAR const struct SPixelRect *dest,
+                                                        FAR const struct SPixelRect *src))
+{
+  if (width < 1 || height < 1)
     {
       return;
     }
 
-  // Describe the receiving bitmap memory
+  // Allocate memory to hold the region, or as much of it as possible
 
-  SBitmap rowBitmap;
-  rowBitmap.bpp    = CONFIG_NXWIDGETS_BPP;
-  rowBitmap.fmt    = CONFIG_NXWIDGETS_FMT;
-  rowBitmap.width  = width;
-  rowBitmap.height = 1;
-  rowBitmap.stride = stride;
-  rowBitmap.data   = (FAR const nxgl_mxpixel_t *)rowBuffer;
+  unsigned int stride = CPixelKernels::stride(CONFIG_NXWIDGETS_FMT, width);
+  nxgl_coord_t nrows;
+  FAR uint8_t *buffer = allocateBand(stride, height, nrows);
+  if (!buffer)
+    {
+      return;
+    }
 
-  // Partially describe the source rectangle
+  countAllocation();
 
-  struct nxgl_rect_s rect;
-  rect.pt1.x = x;
-  rect.pt2.x = x + width - 1;
+  // Describe the receiving bitmap memory
 
-  // Partially setup the graphics origin
+  SBitmap bandBitmap;
+  bandBitmap.bpp    = CONFIG_NXWIDGETS_BPP;
+  bandBitmap.fmt    = CONFIG_NXWIDGETS_FMT;
+  bandBitmap.width  = width;
+  bandBitmap.stride = stride;
+  bandBitmap.data   = (FAR const nxgl_mxpixel_t *)buffer;
 
-  struct nxgl_point_s origin;
-  origin.x = x;
+  struct SPixelRect pixels;
+  pixels.fmt    = CONFIG_NXWIDGETS_FMT;
+  pixels.width  = width;
+  pixels.stride = stride;
+  pixels.data   = buffer;
 
-  // Loop for each row in the region to be inverted
+  // Loop for each band of rows in the region
 
-  for (int row = 0; row < height; row++)
+  for (nxgl_coord_t row = 0; row < height; row += nrows)
     {
-      // Read the graphic memory corresponding to the row
+      if (nrows > height - row)
+        {
+          nrows = height - row;
+        }
 
-      rect.pt1.y = rect.pt2.y = y + row;
-      m_pNxWnd->getRectangle(&rect, &rowBitmap);
+      // Read the graphic memory corresponding to the band
 
-      // Invert each bit
+      struct nxgl_rect_s rect;
+      rect.pt1.x = x;
+      rect.pt1.y = y + row;
+      rect.pt2.x = x + width - 1;
+      rect.pt2.y = y + row + nrows - 1;
 
-      nxwidget_pixel_t *ptr = (nxwidget_pixel_t *)rowBuffer;
-      for (int col = 0; col < width; col++)
-        {
-          nxwidget_pixel_t color = *ptr;
-          uint8_t red   = RGB2RED(color);
-          uint8_t green = RGB2GREEN(color);
-          uint8_t blue  = RGB2BLUE(color);
-          *ptr++ = MKRGB(~red, ~green, ~blue);
-        }
+      bandBitmap.height = nrows;
+      m_pNxWnd->getRectangle(&rect, &bandBitmap);
 
-      // Then write the row back to graphics memory
+      // Transform all of the rows at once
 
-      origin.y = rect.pt1.y;
-      m_pNxWnd->bitmap(&rect, (FAR const void *)rowBitmap.data,
-                       &origin, rowBitmap.stride) ;
+      pixels.height = nrows;
+      kernel(&pixels, &pixels);
+
+      // Then write the band back to graphics memory
+
+      struct nxgl_point_s origin;
+      origin.x = x;
+      origin.y = y + row;
+
+      countDraw(&rect);
+      m_pNxWnd->bitmap(&rect, (FAR const void *)buffer, &origin, stride);
     }
 
-  delete rowBuffer;
-};
+  delete[] buffer;
+}
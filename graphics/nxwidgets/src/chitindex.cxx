@@ -0,0 +1,265 @@
+/****************************************************************************
+ * apps/graphics/nxwidgets/src/chitindex.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <cstring>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "graphics/nxwidgets/cnxwidget.hxx"
+#include "graphics/nxwidgets/chitindex.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+#define CELL_SHIFT CONFIG_NXWIDGETS_HITINDEX_CELLSHIFT
+#define CELL_SIZE  (1 << CELL_SHIFT)
+
+/****************************************************************************
+ * Method Implementations
+ ****************************************************************************/
+
+using namespace NXWidgets;
+
+/**
+ * Constructor.
+ */
+
+CHitIndex::CHitIndex(void)
+{
+  m_cellStart  = (FAR unsigned int *)0;
+  m_entries    = (FAR uint16_t *)0;
+  m_maxEntries = 0;
+  m_maxCells   = 0;
+  m_cols       = 0;
+  m_rows       = 0;
+  m_dirty      = true;
+  m_valid      = false;
+}
+
+/**
+ * Destructor.
+ */
+
+CHitIndex::~CHitIndex(void)
+{
+  delete[] m_cellStart;
+  delete[] m_entries;
+}
+
+/**
+ * Get the range of cells overlapped by a widget.
+ *
+ * @param widget The widget.
+ * @param rect Populated with the first and last cell column (x) and
+ *   row (y).
+ * @return False if the widget is hidden or outside of the grid.
+ */
+
+bool CHitIndex::getCells(FAR const CNxWidget *widget,
+                         FAR struct nxgl_rect_s *rect) const
+{
+  if (widget->isHidden())
+    {
+      return false;
+    }
+
+  // Use the full widget bounds.  The area that accepts clicks is never
+  // larger, so a border change does not need a rebuild.
+
+  nxgl_coord_t x1 = widget->getX();
+  nxgl_coord_t y1 = widget->getY();
+  nxgl_coord_t x2 = x1 + widget->getWidth() - 1;
+  nxgl_coord_t y2 = y1 + widget->getHeight() - 1;
+
+  if (x2 < 0 || y2 < 0 || x2 < x1 || y2 < y1)
+    {
+      return false;
+    }
+
+  rect->pt1.x = x1 < 0 ? 0 : x1 >> CELL_SHIFT;
+  rect->pt1.y = y1 < 0 ? 0 : y1 >> CELL_SHIFT;
+  rect->pt2.x = x2 >> CELL_SHIFT;
+  rect->pt2.y = y2 >> CELL_SHIFT;
+
+  if (rect->pt1.x >= m_cols || rect->pt1.y >= m_rows)
+    {
+      return false;
+    }
+
+  if (rect->pt2.x >= m_cols)
+    {
+      rect->pt2.x = m_cols - 1;
+    }
+
+  if (rect->pt2.y >= m_rows)
+    {
+      rect->pt2.y = m_rows - 1;
+    }
+
+  return true;
+}
+
+/**
+ * Rebuild the grid from the controlled widgets of a window.
+ *
+ * @param widgets The controlled widgets in the window.
+ * @param width The width of the window.
+ * @param height The height of the window.
+ * @return False if the grid could not be built, in which case all
+ *   lookups fail until the next successful rebuild.
+ */
+
+bool CHitIndex::rebuild(const TNxArray<CNxWidget*> &widgets,
+                        nxgl_coord_t width, nxgl_coord_t height)
+{
+  m_dirty = false;
+  m_valid = false;
+
+  if (width <= 0 || height <= 0 || widgets.size() > UINT16_MAX)
+    {
+      return false;
+    }
+
+  m_cols = (width + CELL_SIZE - 1) >> CELL_SHIFT;
+  m_rows = (height + CELL_SIZE - 1) >> CELL_SHIFT;
+
+  unsigned int ncells = (unsigned int)m_cols * m_rows;
+  if (ncells > m_maxCells)
+    {
+      delete[] m_cellStart;
+      m_cellStart = new unsigned int[ncells + 1];
+      if (m_cellStart == (FAR unsigned int *)0)
+        {
+          m_maxCells = 0;
+          return false;
+        }
+
+      m_maxCells = ncells;
+    }
+
+  // Count the widgets in each cell
+
+  std::memset(m_cellStart, 0, (ncells + 1) * sizeof(unsigned int));
+
+  for (int i = 0; i < widgets.size(); i++)
+    {
+      struct nxgl_rect_s cells;
+      if (getCells(widgets[i], &cells))
+        {
+          for (nxgl_coord_t row = cells.pt1.y; row <= cells.pt2.y; row++)
+            {
+              FAR unsigned int *count = &m_cellStart[row * m_cols];
+              for (nxgl_coord_t col = cells.pt1.x; col <= cells.pt2.x; col++)
+                {
+                  count[col]++;
+                }
+            }
+        }
+    }
+
+  // Turn the counts into the end of each cell
+
+  unsigned int total = 0;
+  for (unsigned int cell = 0; cell < ncells; cell++)
+    {
+      total            += m_cellStart[cell];
+      m_cellStart[cell] = total;
+    }
+
+  m_cellStart[ncells] = total;
+
+  if (total > m_maxEntries)
+    {
+      delete[] m_entries;
+      m_entries = new uint16_t[total];
+      if (m_entries == (FAR uint16_t *)0)
+        {
+          m_maxEntries = 0;
+          return false;
+        }
+
+      m_maxEntries = total;
+    }
+
+  // Fill the cells from the end, topmost widget first, so that each list
+  // ends up in ascending order and each end has moved back to the start.
+
+  for (int i = widgets.size() - 1; i > -1; i--)
+    {
+      struct nxgl_rect_s cells;
+      if (getCells(widgets[i], &cells))
+        {
+          for (nxgl_coord_t row = cells.pt1.y; row <= cells.pt2.y; row++)
+            {
+              FAR unsigned int *start = &m_cellStart[row * m_cols];
+              for (nxgl_coord_t col = cells.pt1.x; col <= cells.pt2.x; col++)
+                {
+                  m_entries[--start[col]] = (uint16_t)i;
+                }
+            }
+        }
+    }
+
+  m_valid = true;
+  return true;
+}
+
+/**
+ * Get the widgets that may contain a point.
+ *
+ * @param x The x coordinate of the point.
+ * @param y The y coordinate of the point.
+ * @param candidates Populated with the first candidate.
+ * @param ncandidates Populated with the number of candidates.
+ * @return False if the grid is out of date or invalid or the point
+ *   is outside of it.
+ */
+
+bool CHitIndex::lookup(nxgl_coord_t x, nxgl_coord_t y,
+                       FAR const uint16_t **candidates,
+                       FAR int *ncandidates) const
+{
+  if (m_dirty || !m_valid || x < 0 || y < 0)
+    {
+      return false;
+    }
+
+  nxgl_coord_t col = x >> CELL_SHIFT;
+  nxgl_coord_t row = y >> CELL_SHIFT;
+
+  if (col >= m_cols || row >= m_rows)
+    {
+      return false;
+    }
+
+  unsigned int cell = (unsigned int)row * m_cols + col;
+  *candidates  = &m_entries[m_cellStart[cell]];
+  *ncandidates = m_cellStart[cell + 1] - m_cellStart[cell];
+  return true;
+}
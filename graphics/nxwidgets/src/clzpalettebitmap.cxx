@@ -0,0 +1,439 @@
+/****************************************************************************
+ * apps/graphics/nxwidgets/src/clzpalettebitmap.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <cstdint>
+#include <cstdbool>
+#include <cstring>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+#include "graphics/nxwidgets/clzpalettebitmap.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Method Implementations
+ ****************************************************************************/
+
+using namespace NXWidgets;
+
+/**
+ * Constructor.
+ *
+ * @param bitmap The bitmap structure being wrapped.
+ * @param cache True: keep the whole decoded image, one byte per pixel.
+ */
+
+CLzPaletteBitmap::CLzPaletteBitmap(const struct SLzPaletteBitmap *bitmap,
+                                   bool cache)
+{
+  m_bitmap  = bitmap;
+  m_lut     = bitmap->lut[0];
+  m_history = (FAR uint8_t *)0;
+  m_mask    = 0;
+  m_cached  = false;
+
+  // The whole image doubles as the history of the decoder.  Without it,
+  // a ring buffer holds the indices that matches may refer back to.
+
+  if (cache)
+    {
+      m_history = new uint8_t[(uint32_t)bitmap->width * bitmap->height];
+      if (m_history)
+        {
+          m_mask   = UINT32_MAX;
+          m_cached = true;
+        }
+    }
+
+  if (!m_history && bitmap->window > 0 &&
+      bitmap->window <= LZBITMAP_WINDOW_MAX &&
+      (bitmap->window & (bitmap->window - 1)) == 0)
+    {
+      m_history = new uint8_t[bitmap->window];
+      m_mask    = bitmap->window - 1;
+    }
+
+  startOfImage();
+}
+
+/**
+ * Destructor.
+ */
+
+CLzPaletteBitmap::~CLzPaletteBitmap(void)
+{
+  if (m_history)
+    {
+      delete[] m_history;
+    }
+}
+
+/**
+ * Get the bitmap's color format.
+ *
+ * @return The bitmap's color format.
+ */
+
+const uint8_t CLzPaletteBitmap::getColorFormat(void) const
+{
+  return m_bitmap->fmt;
+}
+
+/**
+ * Get the bitmap's color depth.
+ *
+ * @return The bitmap's pixel depth.
+ */
+
+const uint8_t CLzPaletteBitmap::getBitsPerPixel(void) const
+{
+  return m_bitmap->bpp;
+}
+
+/**
+ * Get the bitmap's width (in pixels/columns).
+ *
+ * @return The bitmap's width.
+ */
+
+const nxgl_coord_t CLzPaletteBitmap::getWidth(void) const
+{
+  return m_bitmap->width;
+}
+
+/**
+ * Get the bitmap's height (in rows).
+ *
+ * @return The bitmap's height.
+ */
+
+const nxgl_coord_t CLzPaletteBitmap::getHeight(void) const
+{
+  return m_bitmap->height;
+}
+
+/**
+ * Get the bitmap's width (in bytes).
+ *
+ * @return The bitmap's width.
+ */
+
+const size_t CLzPaletteBitmap::getStride(void) const
+{
+  // This only works if the bpp is an even multiple of 8-bit bytes
+
+  return (m_bitmap->width * m_bitmap->bpp) >> 3;
+}
+
+/**
+ * Use the colors associated with a selected image.
+ *
+ * @param selected.  true: Use colors for a selected widget,
+ *   false: Use normal (default) colors.
+ */
+
+void CLzPaletteBitmap::setSelected(bool selected)
+{
+  m_lut = m_bitmap->lut[selected ? 1 : 0];
+}
+
+/**
+ * Get one row from the bit map image using the selected LUT.
+ *
+ * @param x The offset into the row to get
+ * @param y The row number to get
+ * @param width The number of pixels to get from the row
+ * @param data The memory location provided by the caller
+ *   in which to return the data.  This should be at least
+ *   (getWidth()*getBitsPerPixl() + 7)/8 bytes in length
+ *   and properly aligned for the pixel color format.
+ * @param True if the run was returned successfully.
+ */
+
+bool CLzPaletteBitmap::getRun(nxgl_coord_t x, nxgl_coord_t y,
+                              nxgl_coord_t width, FAR void *data)
+{
+  // Check ranges.  Casts to unsigned int are ugly but permit one-sided comparisons
+
+  if (((unsigned int)x           <  (unsigned int)m_bitmap->width) &&
+      ((unsigned int)(x + width) <= (unsigned int)m_bitmap->width) &&
+      ((unsigned int)y           <  (unsigned int)m_bitmap->height) &&
+      m_history)
+    {
+      uint32_t start = (uint32_t)y * m_bitmap->width + x;
+
+      if (m_cached)
+        {
+          // Decode the whole image on first use, then only look up colors
+
+          uint32_t npixels = (uint32_t)m_bitmap->width * m_bitmap->height;
+          if (m_pos < npixels && !decode(npixels - m_pos, NULL))
+            {
+              return false;
+            }
+
+          FAR const nxwidget_pixel_t *lut = (FAR const nxwidget_pixel_t *)m_lut;
+          FAR const uint8_t *src = &m_history[start];
+          FAR nxwidget_pixel_t *dest = (FAR nxwidget_pixel_t *)data;
+
+          for (int i = 0; i < width; i++)
+            {
+              dest[i] = lut[src[i]];
+            }
+
+          return true;
+        }
+
+      // Rewind if the run is behind the decoder, then skip up to the run
+
+      if (start < m_pos)
+        {
+          startOfImage();
+        }
+
+      if (start > m_pos && !decode(start - m_pos, NULL))
+        {
+          return false;
+        }
+
+      return decode(width, (FAR nxwidget_pixel_t *)data);
+    }
+
+  return false;
+}
+
+/**
+ * Reset to the beginning of the image
+ */
+
+void CLzPaletteBitmap::startOfImage(void)
+{
+  m_src      = m_bitmap->data;
+  m_pos      = 0;
+  m_literal  = 0;
+  m_match    = 0;
+  m_distance = 0;
+}
+
+/**
+ * Read the next token of the compressed data.
+ *
+ * @return False if the data is exhausted or corrupt
+ */
+
+bool CLzPaletteBitmap::nextToken(void)
+{
+  FAR const uint8_t *end = m_bitmap->data + m_bitmap->size;
+
+  if (m_src >= end)
+    {
+      return false;
+    }
+
+  uint8_t token = *m_src++;
+  if ((token & 0x80) == 0)
+    {
+      m_literal = token + 1;
+      return m_src + m_literal <= end;
+    }
+
+  uint16_t length = (token & 0x3f) + LZBITMAP_MATCH_MIN;
+  int nbytes = (token & 0x40) ? 2 : 1;
+
+  if ((token & 0x3f) == LZBITMAP_MATCH_EXT)
+    {
+      nbytes++;
+    }
+
+  if (m_src + nbytes > end)
+    {
+      return false;
+    }
+
+  if ((token & 0x3f) == LZBITMAP_MATCH_EXT)
+    {
+      length += *m_src++;
+    }
+
+  uint32_t distance = *m_src++;
+  if (token & 0x40)
+    {
+      distance |= (uint32_t)*m_src++ << 8;
+    }
+
+  distance++;
+
+  // A match may not reach before the image or outside of the window
+
+  if (distance > m_pos || (!m_cached && distance > m_bitmap->window))
+    {
+      return false;
+    }
+
+  m_match    = length;
+  m_distance = distance;
+  return true;
+}
+
+/**
+ * Decode pixels at the current position.
+ *
+ * @param npixels The number of pixels to decode
+ * @param data The memory location in which to return the colors of
+ *   the pixels, or NULL to skip them.
+ * @return False if this goes beyond the end of the image
+ */
+
+bool CLzPaletteBitmap::decode(uint32_t npixels, FAR nxwidget_pixel_t *data)
+{
+  FAR const nxwidget_pixel_t *lut = (FAR const nxwidget_pixel_t *)m_lut;
+  FAR uint8_t *history = m_history;
+  uint32_t mask = m_mask;
+  uint32_t pos = m_pos;
+
+  while (npixels > 0)
+    {
+      if (m_literal == 0 && m_match == 0)
+        {
+          m_pos = pos;
+          if (!nextToken())
+            {
+              return false;
+            }
+        }
+
+      if (m_literal > 0)
+        {
+          // Copy indices from the compressed data
+
+          uint32_t n = m_literal < npixels ? m_literal : npixels;
+          FAR const uint8_t *src = m_src;
+
+          m_literal -= n;
+          m_src     += n;
+          npixels   -= n;
+
+          if (data)
+            {
+              for (; n > 0; n--)
+                {
+                  uint8_t index = *src++;
+                  history[pos++ & mask] = index;
+                  *data++ = lut[index];
+                }
+            }
+          else
+            {
+              for (; n > 0; n--)
+                {
+                  history[pos++ & mask] = *src++;
+                }
+            }
+        }
+      else if (m_distance == 1)
+        {
+          // A run of one color
+
+          uint32_t n = m_match < npixels ? m_match : npixels;
+          uint8_t index = history[(pos - 1) & mask];
+
+          m_match -= n;
+          npixels -= n;
+
+          if (data)
+            {
+              nxwidget_pixel_t color = lut[index];
+              for (uint32_t i = 0; i < n; i++)
+                {
+                  data[i] = color;
+                }
+
+              data += n;
+            }
+
+          for (; n > 0; n--)
+            {
+              history[pos++ & mask] = index;
+            }
+        }
+      else
+        {
+          // Copy indices from the history, in pieces that neither overlap
+          // the indices that they produce nor wrap around the window.
+
+          uint32_t n = m_match < npixels ? m_match : npixels;
+          uint32_t from = pos - m_distance;
+
+          m_match -= n;
+          npixels -= n;
+
+          while (n > 0)
+            {
+              uint32_t src   = from & mask;
+              uint32_t dest  = pos & mask;
+              uint32_t chunk = n < m_distance ? n : m_distance;
+
+              if (!m_cached)
+                {
+                  uint32_t room = mask + 1 - (src > dest ? src : dest);
+                  if (chunk > room)
+                    {
+                      chunk = room;
+                    }
+
+                  // After the source has wrapped, it lies just above the
+                  // destination
+
+                  if (src > dest && chunk > src - dest)
+                    {
+                      chunk = src - dest;
+                    }
+                }
+
+              std::memcpy(&history[dest], &history[src], chunk);
+
+              if (data)
+                {
+                  for (uint32_t i = 0; i < chunk; i++)
+                    {
+                      *data++ = lut[history[dest + i]];
+                    }
+                }
+
+              from += chunk;
+              pos  += chunk;
+              n    -= chunk;
+            }
+        }
+    }
+
+  m_pos = pos;
+  return true;
+}
@@ -52,6 +52,7 @@
 #include "graphics/nxwidgets/cstringiterator.hxx"
 #include "graphics/nxwidgets/cnxfont.hxx"
 #include "graphics/nxwidgets/cbitmap.hxx"
+#include "graphics/nxwidgets/cglyphatlas.hxx"
 
 /****************************************************************************
  * Pre-Processor Definitions
@@ -80,6 +81,24 @@ CNxFont::CNxFont(enum nx_fontid_e fontid, nxgl_mxpixel_t fontColor,
   m_pFontSet         = nxf_getfontset(m_fontHandle);
   m_fontColor        = fontColor;
   m_transparentColor = transparentColor;
+
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+  // Attach to the shared atlas for this font and color.  If that fails,
+  // the font still works, just without the pre-rendered glyphs.
+
+  m_atlas            = CGlyphAtlas::acquire(fontid, fontColor);
+#endif
+}
+
+/**
+ * CNxFont Destructor.
+ */
+
+CNxFont::~CNxFont()
+{
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+  CGlyphAtlas::release(m_atlas);
+#endif
 }
 
 /**
@@ -94,6 +113,13 @@ const bool CNxFont::isCharBlank(const nxwidget_char_t letter) const
 {
   FAR const struct nx_fontbitmap_s *fbm;
 
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+  if (m_atlas != (FAR CGlyphAtlas *)0 && m_atlas->contains(letter))
+    {
+      return !m_atlas->getEntry(letter)->present;
+    }
+#endif
+
   /* Get the bitmap associated with the character */
 
   fbm = nxf_getbitmap(m_fontHandle, (uint16_t)letter);
@@ -113,6 +139,17 @@ const bool CNxFont::isCharBlank(const nxwidget_char_t letter) const
 
 void CNxFont::drawChar(FAR SBitmap *bitmap, nxwidget_char_t letter)
 {
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+  // Copy the pre-rendered glyph if the atlas matches the current color
+
+  if (m_atlas != (FAR CGlyphAtlas *)0 && m_atlas->contains(letter) &&
+      m_atlas->getColor() == m_fontColor)
+    {
+      m_atlas->blitChar(bitmap, letter);
+      return;
+    }
+#endif
+
   // Get the NX bitmap associated with the font
 
   FAR const struct nx_fontbitmap_s *fbm;
@@ -141,6 +178,15 @@ void CNxFont::drawChar(FAR SBitmap *bitmap, nxwidget_char_t letter)
 
 nxgl_coord_t CNxFont::getStringWidth(const CNxString &text) const
 {
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+  // With an atlas, the width is a simple sum of table lookups
+
+  if (m_atlas != (FAR CGlyphAtlas *)0)
+    {
+      return getStringWidth(text, 0, text.getLength());
+    }
+#endif
+
   CStringIterator *iter = text.newStringIterator();
 
   // Get the width of the string of characters
@@ -182,6 +228,33 @@ nxgl_coord_t CNxFont::getStringWidth(const CNxString &text) const
 nxgl_coord_t CNxFont::getStringWidth(const CNxString &text,
                                      int startIndex, int length) const
 {
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+  if (m_atlas != (FAR CGlyphAtlas *)0)
+    {
+      int stringLength = text.getLength();
+      if (startIndex < 0 || startIndex >= stringLength)
+        {
+          return 0;
+        }
+
+      if (length > stringLength - startIndex)
+        {
+          length = stringLength - startIndex;
+        }
+
+      unsigned int width = 0;
+
+      for (int i = startIndex; i < startIndex + length; i++)
+        {
+          nxwidget_char_t ch = text.getCharAt(i);
+          width += m_atlas->contains(ch) ? m_atlas->getCharWidth(ch) :
+                                           getCharWidth(ch);
+        }
+
+      return width;
+    }
+#endif
+
   CStringIterator *iter = text.newStringIterator();
 
   // Get the width of the string of characters
@@ -222,6 +295,22 @@ void CNxFont::getCharMetrics(nxwidget_char_t letter,
 {
   FAR const struct nx_fontbitmap_s *fbm;
 
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+  // Use the precomputed metrics from the atlas
+
+  if (m_atlas != (FAR CGlyphAtlas *)0 && m_atlas->contains(letter))
+    {
+      FAR const struct SGlyphAtlasEntry *entry = m_atlas->getEntry(letter);
+
+      metrics->stride  = entry->stride;
+      metrics->width   = entry->width;
+      metrics->height  = entry->height;
+      metrics->xoffset = entry->xoffset;
+      metrics->yoffset = entry->yoffset;
+      return;
+    }
+#endif
+
   // Get the font bitmap for this character
 
   fbm = nxf_getbitmap(m_fontHandle, letter);
@@ -256,6 +345,13 @@ nxgl_coord_t CNxFont::getCharWidth(nxwidget_char_t letter) const
   FAR const struct nx_fontbitmap_s *fbm;
   nxgl_coord_t width;
 
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+  if (m_atlas != (FAR CGlyphAtlas *)0 && m_atlas->contains(letter))
+    {
+      return m_atlas->getCharWidth(letter);
+    }
+#endif
+
   /* Get the font bitmap for this character */
 
   fbm = nxf_getbitmap(m_fontHandle, letter);
@@ -587,6 +587,7 @@ bool CNxWidget::show(void)
   if (m_flags.hidden)
     {
       m_flags.hidden = false;
+      m_widgetControl->invalidateHitIndex();
 
       m_widgetEventHandlers->raiseShowEvent();
       redraw();
@@ -609,6 +610,7 @@ bool CNxWidget::hide(void)
   if (!m_flags.hidden)
     {
       m_flags.hidden = true;
+      m_widgetControl->invalidateHitIndex();
       m_widgetEventHandlers->raiseHideEvent();
       return true;
     }
@@ -1059,6 +1061,7 @@ bool CNxWidget::moveTo(nxgl_coord_t x, nxgl_coord_t y)
 
       m_rect.setX(x);
       m_rect.setY(y);
+      m_widgetControl->invalidateHitIndex();
 
       redraw();
       m_widgetEventHandlers->raiseMoveEvent(x, y, x - oldX, y - oldY);
@@ -1117,6 +1120,7 @@ bool CNxWidget::resize(nxgl_coord_t width, nxgl_coord_t height)
 
       m_rect.setWidth(width);
       m_rect.setHeight(height);
+      m_widgetControl->invalidateHitIndex();
 
       onResize(width, height);
 
@@ -1294,6 +1298,7 @@ void CNxWidget::addWidget(CNxWidget *widget)
     {
       widget->setParent(this);
       m_children.push_back(widget);
+      m_widgetControl->invalidateHitIndex();
 
       // Should the widget steal the focus?
 
@@ -1322,6 +1327,7 @@ void CNxWidget::insertWidget(CNxWidget *widget)
     {
       widget->setParent(this);
       m_children.insert(0, widget);
+      m_widgetControl->invalidateHitIndex();
 
       widget->enableDrawing();
       widget->redraw();
@@ -1379,6 +1385,7 @@ bool CNxWidget::removeChild(CNxWidget *widget)
 
   widget->setParent((CNxWidget *)NULL);
   widget->disableDrawing();
+  m_widgetControl->invalidateHitIndex();
 
   // Locate widget in main vector
 
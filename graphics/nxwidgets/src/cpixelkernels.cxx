@@ -0,0 +1,682 @@
+/****************************************************************************
+ * apps/graphics/nxwidgets/src/cpixelkernels.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <cstring>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/video/fb.h>
+
+#include "graphics/nxwidgets/cpixelkernels.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+// (r + g + b) / 3 as a multiply and shift.  Exact for sums up to 765.
+
+#define GREY_AVERAGE(r, g, b) ((((r) + (g) + (b)) * 21846) >> 16)
+
+// RGB565 with green moved to the upper half-word, leaving room between the
+// fields for the products of the 5-bit alpha blend.
+
+#define RGB565_SPREAD_MASK 0x07e0f81f
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+using namespace NXWidgets;
+
+namespace
+{
+  // Pixel codecs used by the format conversion.  Each one loads a pixel as
+  // 0xAARRGGBB and stores an 0xAARRGGBB value as a pixel.
+
+  struct SRgb8
+  {
+    static const unsigned int bytes = 1;
+
+    static inline uint32_t load(FAR const uint8_t *p)
+    {
+      uint32_t r = *p >> 5;
+      uint32_t g = (*p >> 2) & 7;
+      uint32_t b = *p & 3;
+
+      return 0xff000000 |
+             (((r << 5) | (r << 2) | (r >> 1)) << 16) |
+             (((g << 5) | (g << 2) | (g >> 1)) << 8) |
+             (b * 0x55);
+    }
+
+    static inline void store(FAR uint8_t *p, uint32_t argb)
+    {
+      *p = ((argb >> 16) & 0xe0) | ((argb >> 11) & 0x1c) |
+           ((argb >> 6) & 0x03);
+    }
+  };
+
+  struct SRgb16
+  {
+    static const unsigned int bytes = 2;
+
+    static inline uint32_t load(FAR const uint8_t *p)
+    {
+      uint32_t pixel = *(FAR const uint16_t *)p;
+      uint32_t r = pixel >> 11;
+      uint32_t g = (pixel >> 5) & 0x3f;
+      uint32_t b = pixel & 0x1f;
+
+      return 0xff000000 | (((r << 3) | (r >> 2)) << 16) |
+             (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+    }
+
+    static inline void store(FAR uint8_t *p, uint32_t argb)
+    {
+      *(FAR uint16_t *)p = ((argb >> 8) & 0xf800) | ((argb >> 5) & 0x07e0) |
+                           ((argb >> 3) & 0x001f);
+    }
+  };
+
+  struct SRgb24
+  {
+    static const unsigned int bytes = 3;
+
+    static inline uint32_t load(FAR const uint8_t *p)
+    {
+      return 0xff000000 | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) |
+             p[0];
+    }
+
+    static inline void store(FAR uint8_t *p, uint32_t argb)
+    {
+      p[0] = (uint8_t)argb;
+      p[1] = (uint8_t)(argb >> 8);
+      p[2] = (uint8_t)(argb >> 16);
+    }
+  };
+
+  struct SRgb32
+  {
+    static const unsigned int bytes = 4;
+
+    static inline uint32_t load(FAR const uint8_t *p)
+    {
+      return *(FAR const uint32_t *)p;
+    }
+
+    static inline void store(FAR uint8_t *p, uint32_t argb)
+    {
+      *(FAR uint32_t *)p = argb;
+    }
+  };
+}
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/**
+ * Check that two rectangles have the same format and size.
+ */
+
+static inline bool sameShape(FAR const struct SPixelRect *a,
+                             FAR const struct SPixelRect *b)
+{
+  return a->fmt == b->fmt && a->width == b->width && a->height == b->height;
+}
+
+/**
+ * Convert all rows of a rectangle with a pair of pixel codecs.
+ */
+
+template <typename S, typename D>
+static void convertRows(FAR const struct SPixelRect *dest,
+                        FAR const struct SPixelRect *src)
+{
+  FAR uint8_t *drow = dest->data;
+  FAR const uint8_t *srow = src->data;
+
+  for (nxgl_coord_t row = 0; row < dest->height; row++)
+    {
+      FAR uint8_t *d = drow;
+      FAR const uint8_t *s = srow;
+
+      for (nxgl_coord_t col = 0; col < dest->width; col++)
+        {
+          D::store(d, S::load(s));
+          d += D::bytes;
+          s += S::bytes;
+        }
+
+      drow += dest->stride;
+      srow += src->stride;
+    }
+}
+
+/**
+ * Select the destination codec of a conversion.
+ */
+
+template <typename S>
+static bool convertTo(FAR const struct SPixelRect *dest,
+                      FAR const struct SPixelRect *src)
+{
+  switch (dest->fmt)
+    {
+      case FB_FMT_RGB8_332:
+        convertRows<S, SRgb8>(dest, src);
+        return true;
+
+      case FB_FMT_RGB16_565:
+        convertRows<S, SRgb16>(dest, src);
+        return true;
+
+      case FB_FMT_RGB24:
+        convertRows<S, SRgb24>(dest, src);
+        return true;
+
+      case FB_FMT_RGB32:
+        convertRows<S, SRgb32>(dest, src);
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+/**
+ * Greyscale kernels, one row each.
+ */
+
+static void greyRow8(FAR uint8_t *d, FAR const uint8_t *s, nxgl_coord_t n)
+{
+  for (nxgl_coord_t i = 0; i < n; i++)
+    {
+      uint32_t pixel = s[i];
+      uint32_t avg   = GREY_AVERAGE(pixel & 0xe0, (pixel << 3) & 0xe0,
+                                    (pixel << 6) & 0xc0);
+
+      d[i] = (avg & 0xe0) | ((avg >> 3) & 0x1c) | (avg >> 6);
+    }
+}
+
+static void greyRow16(FAR uint16_t *d, FAR const uint16_t *s,
+                      nxgl_coord_t n)
+{
+  for (nxgl_coord_t i = 0; i < n; i++)
+    {
+      uint32_t pixel = s[i];
+      uint32_t avg   = GREY_AVERAGE((pixel >> 8) & 0xf8, (pixel >> 3) & 0xfc,
+                                    (pixel << 3) & 0xf8);
+
+      d[i] = (uint16_t)(((avg & 0xf8) << 8) | ((avg & 0xfc) << 3) |
+                        (avg >> 3));
+    }
+}
+
+static void greyRow24(FAR uint8_t *d, FAR const uint8_t *s, nxgl_coord_t n)
+{
+  for (nxgl_coord_t i = 0; i < n; i++)
+    {
+      uint32_t avg = GREY_AVERAGE(s[0], s[1], s[2]);
+
+      d[0] = d[1] = d[2] = (uint8_t)avg;
+      d += 3;
+      s += 3;
+    }
+}
+
+static void greyRow32(FAR uint32_t *d, FAR const uint32_t *s,
+                      nxgl_coord_t n)
+{
+  for (nxgl_coord_t i = 0; i < n; i++)
+    {
+      uint32_t pixel = s[i];
+      uint32_t avg   = GREY_AVERAGE((pixel >> 16) & 0xff, (pixel >> 8) & 0xff,
+                                    pixel & 0xff);
+
+      d[i] = (pixel & 0xff000000) | (avg * 0x010101);
+    }
+}
+
+/**
+ * Exclusive-OR a row with a mask.  Whole words are used where both rows
+ * are word aligned; "mask" must then repeat in every byte.
+ */
+
+static void xorRow(FAR uint8_t *d, FAR const uint8_t *s, size_t nbytes,
+                   uint8_t mask)
+{
+  size_t i = 0;
+
+  if ((((uintptr_t)d | (uintptr_t)s) & 3) == 0)
+    {
+      FAR uint32_t *dw = (FAR uint32_t *)d;
+      FAR const uint32_t *sw = (FAR const uint32_t *)s;
+      uint32_t wmask = mask * 0x01010101u;
+      size_t nwords = nbytes >> 2;
+
+      for (size_t w = 0; w < nwords; w++)
+        {
+          dw[w] = sw[w] ^ wmask;
+        }
+
+      i = nwords << 2;
+    }
+
+  for (; i < nbytes; i++)
+    {
+      d[i] = s[i] ^ mask;
+    }
+}
+
+/**
+ * Blend kernels, one row each.  "alpha" is 0-256.  The RGB332 and byte
+ * kernels round to the nearest level; truncating would pull every
+ * darkening blend down by a whole level.
+ */
+
+static void blendRow8(FAR uint8_t *d, FAR const uint8_t *s, nxgl_coord_t n,
+                      int alpha)
+{
+  for (nxgl_coord_t i = 0; i < n; i++)
+    {
+      int sp = s[i];
+      int dp = d[i];
+      int r  = dp >> 5;
+      int g  = (dp >> 2) & 7;
+      int b  = dp & 3;
+
+      r += (((sp >> 5) - r) * alpha + 128) >> 8;
+      g += ((((sp >> 2) & 7) - g) * alpha + 128) >> 8;
+      b += (((sp & 3) - b) * alpha + 128) >> 8;
+
+      d[i] = (uint8_t)((r << 5) | (g << 2) | b);
+    }
+}
+
+static void blendRow16(FAR uint16_t *d, FAR const uint16_t *s,
+                       nxgl_coord_t n, int alpha)
+{
+  // All three fields are blended with one multiply using a 5-bit alpha
+
+  uint32_t alpha5 = ((uint32_t)alpha + 4) >> 3;
+
+  for (nxgl_coord_t i = 0; i < n; i++)
+    {
+      uint32_t fg = s[i];
+      uint32_t bg = d[i];
+
+      fg = (fg | (fg << 16)) & RGB565_SPREAD_MASK;
+      bg = (bg | (bg << 16)) & RGB565_SPREAD_MASK;
+
+      uint32_t res = ((((fg - bg) * alpha5) >> 5) + bg) & RGB565_SPREAD_MASK;
+      d[i] = (uint16_t)((res >> 16) | res);
+    }
+}
+
+static void blendBytes(FAR uint8_t *d, FAR const uint8_t *s, size_t nbytes,
+                       int alpha)
+{
+  for (size_t i = 0; i < nbytes; i++)
+    {
+      int dp = d[i];
+      d[i] = (uint8_t)(dp + (((s[i] - dp) * alpha + 128) >> 8));
+    }
+}
+
+/****************************************************************************
+ * CPixelKernels Method Implementations
+ ****************************************************************************/
+
+/**
+ * Get the number of bits per pixel of a format.
+ *
+ * @param fmt The pixel format (FB_FMT_*).
+ * @return The number of bits per pixel or zero if the format is not
+ *   supported.
+ */
+
+unsigned int CPixelKernels::bitsPerPixel(uint8_t fmt)
+{
+  switch (fmt)
+    {
+      case FB_FMT_RGB8_332:
+        return 8;
+
+      case FB_FMT_RGB16_565:
+        return 16;
+
+      case FB_FMT_RGB24:
+        return 24;
+
+      case FB_FMT_RGB32:
+        return 32;
+
+      default:
+        return 0;
+    }
+}
+
+/**
+ * Get the minimum number of bytes per row of a format.
+ *
+ * @param fmt The pixel format (FB_FMT_*).
+ * @param width The width of the row in pixels.
+ * @return The stride in bytes, zero if the format is not supported.
+ */
+
+unsigned int CPixelKernels::stride(uint8_t fmt, nxgl_coord_t width)
+{
+  return ((unsigned int)width * bitsPerPixel(fmt) + 7) >> 3;
+}
+
+/**
+ * Convert a rectangle to greyscale.  The grey level is the average of
+ * the red, green and blue components.
+ *
+ * @param dest The rectangle receiving the greyscale pixels.
+ * @param src The rectangle to convert.  Same format and size as dest.
+ * @return True on success.
+ */
+
+bool CPixelKernels::greyScale(FAR const struct SPixelRect *dest,
+                              FAR const struct SPixelRect *src)
+{
+  if (!sameShape(dest, src) || bitsPerPixel(dest->fmt) == 0)
+    {
+      return false;
+    }
+
+  FAR uint8_t *drow = dest->data;
+  FAR const uint8_t *srow = src->data;
+
+  for (nxgl_coord_t row = 0; row < dest->height; row++)
+    {
+      switch (dest->fmt)
+        {
+          case FB_FMT_RGB8_332:
+            greyRow8(drow, srow, dest->width);
+            break;
+
+          case FB_FMT_RGB16_565:
+            greyRow16((FAR uint16_t *)drow, (FAR const uint16_t *)srow,
+                      dest->width);
+            break;
+
+          case FB_FMT_RGB24:
+            greyRow24(drow, srow, dest->width);
+            break;
+
+          case FB_FMT_RGB32:
+            greyRow32((FAR uint32_t *)drow, (FAR const uint32_t *)srow,
+                      dest->width);
+            break;
+        }
+
+      drow += dest->stride;
+      srow += src->stride;
+    }
+
+  return true;
+}
+
+/**
+ * Invert the color components of a rectangle.  The alpha component of
+ * FB_FMT_RGB32 pixels is preserved.
+ *
+ * @param dest The rectangle receiving the inverted pixels.
+ * @param src The rectangle to invert.  Same format and size as dest.
+ * @return True on success.
+ */
+
+bool CPixelKernels::invert(FAR const struct SPixelRect *dest,
+                           FAR const struct SPixelRect *src)
+{
+  if (!sameShape(dest, src) || bitsPerPixel(dest->fmt) == 0)
+    {
+      return false;
+    }
+
+  // Every bit of the packed formats is a color bit, so inverting each
+  // component is the same as inverting every byte of the row.
+
+  size_t nbytes = stride(dest->fmt, dest->width);
+  FAR uint8_t *drow = dest->data;
+  FAR const uint8_t *srow = src->data;
+
+  for (nxgl_coord_t row = 0; row < dest->height; row++)
+    {
+      if (dest->fmt == FB_FMT_RGB32)
+        {
+          FAR uint32_t *d = (FAR uint32_t *)drow;
+          FAR const uint32_t *s = (FAR const uint32_t *)srow;
+
+          for (nxgl_coord_t col = 0; col < dest->width; col++)
+            {
+              d[col] = s[col] ^ 0x00ffffff;
+            }
+        }
+      else
+        {
+          xorRow(drow, srow, nbytes, 0xff);
+        }
+
+      drow += dest->stride;
+      srow += src->stride;
+    }
+
+  return true;
+}
+
+/**
+ * Fill a rectangle with one color.
+ *
+ * @param dest The rectangle to fill.
+ * @param color The color in the format of the rectangle.
+ * @return True on success.
+ */
+
+bool CPixelKernels::fill(FAR const struct SPixelRect *dest, uint32_t color)
+{
+  if (bitsPerPixel(dest->fmt) == 0 || dest->height < 1)
+    {
+      return false;
+    }
+
+  // Fill the first row, then copy it to the others
+
+  FAR uint8_t *first = dest->data;
+
+  switch (dest->fmt)
+    {
+      case FB_FMT_RGB8_332:
+        std::memset(first, (int)(color & 0xff), dest->width);
+        break;
+
+      case FB_FMT_RGB16_565:
+        {
+          FAR uint16_t *d = (FAR uint16_t *)first;
+          for (nxgl_coord_t col = 0; col < dest->width; col++)
+            {
+              d[col] = (uint16_t)color;
+            }
+        }
+        break;
+
+      case FB_FMT_RGB24:
+        {
+          FAR uint8_t *d = first;
+          for (nxgl_coord_t col = 0; col < dest->width; col++)
+            {
+              SRgb24::store(d, color);
+              d += 3;
+            }
+        }
+        break;
+
+      case FB_FMT_RGB32:
+        {
+          FAR uint32_t *d = (FAR uint32_t *)first;
+          for (nxgl_coord_t col = 0; col < dest->width; col++)
+            {
+              d[col] = color;
+            }
+        }
+        break;
+    }
+
+  size_t nbytes = stride(dest->fmt, dest->width);
+  FAR uint8_t *drow = first + dest->stride;
+
+  for (nxgl_coord_t row = 1; row < dest->height; row++)
+    {
+      std::memcpy(drow, first, nbytes);
+      drow += dest->stride;
+    }
+
+  return true;
+}
+
+/**
+ * Blend a rectangle onto another with a constant alpha:
+ * dest = (src * alpha + dest * (255 - alpha)) / 255, approximately.
+ * FB_FMT_RGB16_565 pixels are blended with alpha reduced to 5 bits.
+ *
+ * @param dest The rectangle blended onto.
+ * @param src The rectangle to blend.  Same format and size as dest.
+ * @param alpha The opacity of src, 0 (transparent) to 255 (opaque).
+ * @return True on success.
+ */
+
+bool CPixelKernels::blend(FAR const struct SPixelRect *dest,
+                          FAR const struct SPixelRect *src, uint8_t alpha)
+{
+  if (!sameShape(dest, src) || bitsPerPixel(dest->fmt) == 0)
+    {
+      return false;
+    }
+
+  size_t nbytes = stride(dest->fmt, dest->width);
+  FAR uint8_t *drow = dest->data;
+  FAR const uint8_t *srow = src->data;
+
+  // Scale alpha to 0-256 so that the divide becomes a shift and both
+  // ends are exact
+
+  int alpha256 = alpha + (alpha >> 7);
+
+  for (nxgl_coord_t row = 0; row < dest->height; row++)
+    {
+      if (alpha == 255)
+        {
+          std::memmove(drow, srow, nbytes);
+        }
+      else if (alpha != 0)
+        {
+          switch (dest->fmt)
+            {
+              case FB_FMT_RGB8_332:
+                blendRow8(drow, srow, dest->width, alpha256);
+                break;
+
+              case FB_FMT_RGB16_565:
+                blendRow16((FAR uint16_t *)drow, (FAR const uint16_t *)srow,
+                           dest->width, alpha256);
+                break;
+
+              default:
+
+                // The components of the 24- and 32-bit formats are whole
+                // bytes
+
+                blendBytes(drow, srow, nbytes, alpha256);
+                break;
+            }
+        }
+
+      drow += dest->stride;
+      srow += src->stride;
+    }
+
+  return true;
+}
+
+/**
+ * Convert a rectangle from one pixel format to another.  Components
+ * are truncated when narrowed and replicated into the low bits when
+ * widened; pixels converted to FB_FMT_RGB32 are opaque.
+ *
+ * @param dest The rectangle receiving the converted pixels.
+ * @param src The rectangle to convert.  Same size as dest.
+ * @return True on success.
+ */
+
+bool CPixelKernels::convert(FAR const struct SPixelRect *dest,
+                            FAR const struct SPixelRect *src)
+{
+  if (dest->width != src->width || dest->height != src->height ||
+      bitsPerPixel(dest->fmt) == 0)
+    {
+      return false;
+    }
+
+  if (dest->fmt == src->fmt)
+    {
+      size_t nbytes = stride(dest->fmt, dest->width);
+      FAR uint8_t *drow = dest->data;
+      FAR const uint8_t *srow = src->data;
+
+      for (nxgl_coord_t row = 0; row < dest->height; row++)
+        {
+          std::memmove(drow, srow, nbytes);
+          drow += dest->stride;
+          srow += src->stride;
+        }
+
+      return true;
+    }
+
+  switch (src->fmt)
+    {
+      case FB_FMT_RGB8_332:
+        return convertTo<SRgb8>(dest, src);
+
+      case FB_FMT_RGB16_565:
+        return convertTo<SRgb16>(dest, src);
+
+      case FB_FMT_RGB24:
+        return convertTo<SRgb24>(dest, src);
+
+      case FB_FMT_RGB32:
+        return convertTo<SRgb32>(dest, src);
+
+      default:
+        return false;
+    }
+}
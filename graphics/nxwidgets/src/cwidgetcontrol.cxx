@@ -108,6 +108,10 @@ CWidgetControl::CWidgetControl(FAR const CWidgetStyle *style)
   m_nCh                = 0;
   m_nCc                = 0;
 
+#ifdef CONFIG_NXWIDGETS_DISPATCHSTATS
+  resetDispatchStats();
+#endif
+
   // Initialize semaphores:
   //
   // m_waitSem. The semaphore that will wake up the external logic on mouse events,
@@ -292,6 +296,7 @@ void CWidgetControl::removeControlledWidget(CNxWidget *widget)
   if (index >= 0)
     {
       m_widgets.erase(index);
+      invalidateHitIndex();
     }
 }
 
@@ -385,8 +390,13 @@ void CWidgetControl::geometryEvent(NXHANDLE hWindow,
 
   m_pos.x   = pos->x;
   m_pos.y   = pos->y;
-  m_size.h  = size->h;
-  m_size.w  = size->w;
+
+  if (m_size.h != size->h || m_size.w != size->w)
+    {
+      m_size.h  = size->h;
+      m_size.w  = size->w;
+      invalidateHitIndex();
+    }
 
   // The first callback is important.  This is the handshake that proves
   // that we are truly communicating with the servier.  This is also
@@ -743,31 +753,119 @@ uint32_t CWidgetControl::elapsedTime(FAR const struct timespec *startTime)
 
 bool CWidgetControl::handleLeftClick(nxgl_coord_t x, nxgl_coord_t y,
                                      CNxWidget *widget)
+{
+  unsigned int tested = 0;
+
+#ifdef CONFIG_NXWIDGETS_DISPATCHSTATS
+  struct timespec start;
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool handled = dispatchLeftClick(x, y, widget, tested);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  uint32_t usec = (uint32_t)((end.tv_sec - start.tv_sec) * 1000000 +
+                             (end.tv_nsec - start.tv_nsec) / 1000);
+
+  m_dispatchStats.events++;
+  m_dispatchStats.tested    += tested;
+  m_dispatchStats.lastUsec   = usec;
+  m_dispatchStats.totalUsec += usec;
+
+  if (usec > m_dispatchStats.maxUsec)
+    {
+      m_dispatchStats.maxUsec = usec;
+    }
+
+  ginfo("Click (%d,%d): %u of %d widgets tested in %lu usec\n",
+        x, y, tested, m_widgets.size(), (unsigned long)usec);
+  return handled;
+#else
+  return dispatchLeftClick(x, y, widget, tested);
+#endif
+}
+
+/**
+ * Send a click to the widgets that may contain it, topmost first,
+ * until one responds.
+ *
+ * @param x Click xcoordinate.
+ * @param y Click ycoordinate.
+ * @param widget Pointer to a specific widget or NULL.
+ * @param tested Incremented for each widget sent the click.
+ * @return True if is a widget responds to the left click
+ */
+
+bool CWidgetControl::dispatchLeftClick(nxgl_coord_t x, nxgl_coord_t y,
+                                       CNxWidget *widget,
+                                       unsigned int &tested)
 {
   // Working with a specific widget or the whole structure?
 
-  if (widget == (CNxWidget *)NULL)
+  if (widget != (CNxWidget *)NULL)
     {
-      // All widgets
+      // One widget
 
-      for (int i = m_widgets.size() - 1; i > -1; i--)
+      tested++;
+      return widget->click(x, y);
+    }
+
+#ifdef CONFIG_NXWIDGETS_HITINDEX
+  // Only the widgets in the grid cell of the click can collide with it.
+  // Widgets that do not collide ignore the click, so skipping them does
+  // not change which widget receives it.
+
+  FAR const uint16_t *candidates;
+  int ncandidates;
+
+  if (m_hitIndex.isDirty())
+    {
+      m_hitIndex.rebuild(m_widgets, m_size.w, m_size.h);
+    }
+
+  if (m_hitIndex.lookup(x, y, &candidates, &ncandidates))
+    {
+      for (int i = ncandidates - 1; i > -1; i--)
         {
-          if (m_widgets[i]->click(x, y))
+          if (candidates[i] < m_widgets.size())
             {
-              return true;
+              tested++;
+              if (m_widgets[candidates[i]]->click(x, y))
+                {
+                  return true;
+                }
             }
         }
+
+      return false;
     }
-  else
-    {
-      // One widget
+#endif
 
-      return widget->click(x, y);
+  // All widgets
+
+  for (int i = m_widgets.size() - 1; i > -1; i--)
+    {
+      tested++;
+      if (m_widgets[i]->click(x, y))
+        {
+          return true;
+        }
     }
 
   return false;
 }
 
+#ifdef CONFIG_NXWIDGETS_DISPATCHSTATS
+/**
+ * Clear the click dispatch statistics of this window.
+ */
+
+void CWidgetControl::resetDispatchStats(void)
+{
+  memset(&m_dispatchStats, 0, sizeof(struct SDispatchStats));
+}
+#endif
+
 /**
  * Delete any widgets in the deletion queue.
  */
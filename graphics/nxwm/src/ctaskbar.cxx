@@ -47,6 +47,7 @@
 #include "graphics/nxwidgets/cwidgetcontrol.hxx"
 #include "graphics/nxwidgets/cnxtkwindow.hxx"
 #include "graphics/nxwidgets/cscaledbitmap.hxx"
+#include "graphics/nxwidgets/clzpalettebitmap.hxx"
 
 #include "graphics/nxwm/cwindowmessenger.hxx"
 #include "graphics/nxwm/ctaskbar.hxx"
@@ -1027,8 +1028,8 @@ bool CTaskbar::createBackgroundImage(void)
 
   // Create the bitmap object
 
-  NXWidgets::CRlePaletteBitmap *bitmap =
-    new NXWidgets::CRlePaletteBitmap(&CONFIG_NXWM_BACKGROUND_IMAGE);
+  NXWidgets::CNxLogoBitmap *bitmap =
+    new NXWidgets::CNxLogoBitmap(&CONFIG_NXWM_BACKGROUND_IMAGE);
 
   if (!bitmap)
     {
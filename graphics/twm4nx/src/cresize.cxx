@@ -61,6 +61,7 @@
 #include "graphics/twm4nx/cwindowevent.hxx"
 #include "graphics/twm4nx/cfonts.hxx"
 #include "graphics/twm4nx/cwindow.hxx"
+#include "graphics/twm4nx/cwindowfactory.hxx"
 #include "graphics/twm4nx/ctwm4nxevent.hxx"
 #include "graphics/twm4nx/twm4nx_events.hxx"
 #include "graphics/twm4nx/twm4nx_cursor.hxx"
@@ -107,6 +108,9 @@ CResize::CResize(CTwm4Nx *twm4nx)
   m_resized      = false;                            // The size has not changed
   m_mouseValid   = false;                            // The mouse position is not valid
   m_paused       = false;                            // The window was not un-clicked
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  m_bsSize       = 0;                                // No backing store yet
+#endif
 }
 
 /**
@@ -138,6 +142,17 @@ CResize::~CResize(void)
       delete m_sizeWindow;
       m_sizeWindow = (FAR NXWidgets::CNxTkWindow *)0;
     }
+
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  // Return the backing store to the budget
+
+  if (m_bsSize > 0)
+    {
+      FAR CWindowFactory *factory = m_twm4nx->getWindowFactory();
+      factory->releaseBackingStore(m_bsSize);
+      m_bsSize = 0;
+    }
+#endif
 }
 
 /**
@@ -276,7 +291,8 @@ bool CResize::createSizeWindow(void)
   FAR CWindowEvent *control =
     new CWindowEvent(m_twm4nx, (FAR void *)0, events);
 
-  // 4. Create the main window
+  // 4. Create the main window.  The size window has no redraw handler so it
+  //    is always RAM-backed.
 
   uint8_t wflags = (NXBE_WINDOW_RAMBACKED | NXBE_WINDOW_HIDDEN);
 
@@ -330,6 +346,12 @@ bool CResize::createSizeWindow(void)
       return false;
     }
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  // Account for the backing store of the size window
+
+  updateBackingStore(&size);
+#endif
+
   return true;
 }
 
@@ -396,6 +418,35 @@ bool CResize::createSizeLabel(void)
   return true;
 }
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+/**
+ * Update the backing store accounting for the RAM-backed size window
+ *
+ * @param size The new size of the size window
+ */
+
+void CResize::updateBackingStore(FAR const struct nxgl_size_s *size)
+{
+  struct nxgl_size_s frameSize;
+  frameSize.w = size->w + 2 * CONFIG_NXTK_BORDERWIDTH;
+  frameSize.h = size->h + 2 * CONFIG_NXTK_BORDERWIDTH;
+
+  FAR CWindowFactory *factory = m_twm4nx->getWindowFactory();
+  size_t bsSize = factory->backingStoreSize(&frameSize);
+
+  if (m_bsSize > 0)
+    {
+      factory->resizeBackingStore(m_bsSize, bsSize);
+    }
+  else
+    {
+      factory->addBackingStore(bsSize);
+    }
+
+  m_bsSize = bsSize;
+}
+#endif
+
 /**
  * Set the Window Size
  */
@@ -409,6 +460,10 @@ bool CResize::setWindowSize(FAR struct nxgl_size_s *size)
       return false;
     }
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  updateBackingStore(size);
+#endif
+
   // Set the label size to match
 
   if (!m_sizeLabel->resize(size->w, size->h))
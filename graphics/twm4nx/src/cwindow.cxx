@@ -146,6 +146,9 @@ CWindow::CWindow(CTwm4Nx *twm4nx)
   m_windowEvent           = (FAR CWindowEvent *)0;
   m_minWidth              = 1;
   m_modal                 = false;
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  m_bsSize                = 0;             // Not RAM-backed
+#endif
 
   // Events
 
@@ -487,6 +490,22 @@ bool CWindow::resizeFrame(FAR const struct nxgl_size_s *frameSize,
       return false;
     }
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  // NX reallocated the backing store for the new frame size
+
+  if (m_bsSize > 0)
+    {
+      struct nxgl_size_s newFrame;
+      newFrame.w = winsize.w + delta.w;
+      newFrame.h = winsize.h + delta.h;
+
+      FAR CWindowFactory *factory = m_twm4nx->getWindowFactory();
+      size_t bsSize = factory->backingStoreSize(&newFrame);
+      factory->resizeBackingStore(m_bsSize, bsSize);
+      m_bsSize = bsSize;
+    }
+#endif
+
   if (framePos != (FAR const struct nxgl_point_s *)0)
     {
       // Set the new frame position (in case it changed too)
@@ -782,6 +801,10 @@ bool CWindow::event(FAR struct SEventMsg *eventmsg)
         }
         break;
 
+      case EVENT_TOOLBAR_REDRAW: /* Toolbar of a window without backing store */
+        success = redrawToolbar();
+        break;
+
       case EVENT_TOOLBAR_GRAB:   /* Left click on title widget.  Start drag */
         success = toolbarGrab(eventmsg);
         break;
@@ -835,7 +858,47 @@ bool CWindow::createMainWindow(FAR const nxgl_size_s *winsize,
   //    are always created hidden and in the iconified state (although they
   //    have no icons)
 
-  uint8_t cflags = NXBE_WINDOW_RAMBACKED;
+  uint8_t cflags = 0;
+
+  // Menus and the Icon Manager have no redraw handler for their contents so
+  // they are always RAM-backed.  Only application windows, which must
+  // provide a redraw event via configureEvents(), are subject to the
+  // backing store option and budget.
+
+  bool appWindow = !WFLAGS_IS_MENU(flags) && !WFLAGS_IS_ICONMGR(flags);
+  if (!appWindow)
+    {
+      cflags |= NXBE_WINDOW_RAMBACKED;
+    }
+
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  // NX mirrors the entire frame, so include the border and the toolbar.
+
+  nxgl_coord_t tbHeight = 0;
+  if (WFLAGS_HAVE_TOOLBAR(flags) && getToolbarHeight(m_name))
+    {
+      tbHeight = m_tbHeight;
+    }
+
+  struct nxgl_size_s frameSize;
+  frameSize.w = winsize->w + 2 * CONFIG_NXTK_BORDERWIDTH;
+  frameSize.h = winsize->h + tbHeight + 2 * CONFIG_NXTK_BORDERWIDTH;
+
+  FAR CWindowFactory *factory = m_twm4nx->getWindowFactory();
+  size_t bsSize = factory->backingStoreSize(&frameSize);
+
+  if (!appWindow)
+    {
+      factory->addBackingStore(bsSize);
+      m_bsSize = bsSize;
+    }
+  else if (factory->reserveBackingStore(bsSize))
+    {
+      cflags  |= NXBE_WINDOW_RAMBACKED;
+      m_bsSize = bsSize;
+    }
+#endif
+
   if (WFLAGS_IS_HIDDEN(flags) | WFLAGS_IS_MENU(flags))
     {
       cflags |= NXBE_WINDOW_HIDDEN;
@@ -844,6 +907,14 @@ bool CWindow::createMainWindow(FAR const nxgl_size_s *winsize,
   m_nxWin = m_twm4nx->createFramedWindow(m_windowEvent, cflags);
   if (m_nxWin == (FAR NXWidgets::CNxTkWindow *)0)
     {
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+      if (m_bsSize > 0)
+        {
+          factory->releaseBackingStore(m_bsSize);
+          m_bsSize = 0;
+        }
+#endif
+
       delete m_windowEvent;
       m_windowEvent = (FAR CWindowEvent *)0;
       return false;
@@ -928,7 +999,7 @@ bool CWindow::createToolbar(void)
 
   struct SAppEvents events;
   events.eventObj    = (FAR void *)this;
-  events.redrawEvent = EVENT_SYSTEM_NOP;
+  events.redrawEvent = EVENT_TOOLBAR_REDRAW;
   events.resizeEvent = EVENT_SYSTEM_NOP;
   events.mouseEvent  = EVENT_TOOLBAR_XYINPUT;
   events.kbdEvent    = EVENT_SYSTEM_NOP;
@@ -998,6 +1069,43 @@ bool CWindow::fillToolbar(void)
   return true;
 }
 
+/**
+ * Redraw the toolbar background and widgets.  This is only needed for
+ * windows that are not RAM-backed.
+ */
+
+bool CWindow::redrawToolbar(void)
+{
+  if (m_toolbar == (FAR NXWidgets::CNxToolbar *)0)
+    {
+      return true;
+    }
+
+  if (!fillToolbar())
+    {
+      return false;
+    }
+
+  // Widgets with drawing disabled (e.g., during a layout update) are
+  // skipped here and redrawn when drawing is re-enabled.
+
+  for (int btindex = 0; btindex < NTOOLBAR_BUTTONS; btindex++)
+    {
+      FAR NXWidgets::CImage *cimage = m_tbButtons[btindex];
+      if (cimage != (FAR NXWidgets::CImage *)0)
+        {
+          cimage->redraw();
+        }
+    }
+
+  if (m_tbTitle != (FAR NXWidgets::CLabel *)0)
+    {
+      m_tbTitle->redraw();
+    }
+
+  return true;
+}
+
 /**
  * Update the toolbar layout, resizing the title text window and
  * repositioning all windows on the toolbar.
@@ -1660,11 +1768,12 @@ bool CWindow::toolbarGrab(FAR struct SEventMsg *eventmsg)
 
   // Override application mouse events while dragging.  This is necessary to
   // to handle cases where the drag that starts in the toolbar is moved
-  // into the application window area.
+  // into the application window area.  Redraw events are still needed if
+  // the window is not RAM-backed.
 
   struct SAppEvents events;
   events.eventObj    = (FAR void *)this;
-  events.redrawEvent = EVENT_SYSTEM_NOP;
+  events.redrawEvent = m_appEvents.redrawEvent;
   events.resizeEvent = EVENT_SYSTEM_NOP;
   events.mouseEvent  = EVENT_TOOLBAR_XYINPUT;
   events.kbdEvent    = EVENT_SYSTEM_NOP;
@@ -1894,6 +2003,17 @@ void CWindow::cleanup(void)
       m_nxWin  = (FAR NXWidgets::CNxTkWindow *)0;
     }
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  // Return the backing store to the budget
+
+  if (m_bsSize > 0)
+    {
+      FAR CWindowFactory *factory = m_twm4nx->getWindowFactory();
+      factory->releaseBackingStore(m_bsSize);
+      m_bsSize = 0;
+    }
+#endif
+
   // Delete the Icon
 
   if (m_iconWidget != (FAR CIconWidget *)0)
@@ -84,6 +84,10 @@ CWindowFactory::CWindowFactory(FAR CTwm4Nx *twm4nx)
 {
   m_twm4nx     = twm4nx;                  // Cached copy of the Twm4Nx session object
   m_windowHead = (FAR struct SWindow *)0; // List of all Windows
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+  m_bsUsage    = 0;                       // No backing store in use
+  m_bsPeak     = 0;
+#endif
 
   // Set up the position where we will create the initial window
 
@@ -530,6 +534,90 @@ bool CWindowFactory::checkCollision(FAR CWindow *cwin,
   return false;
 }
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+/**
+ * Reserve backing store memory for a new RAM-backed window.  The
+ * reservation fails if it would exceed CONFIG_TWM4NX_BACKINGSTORE_LIMIT.
+ *
+ * @param nbytes The size of the window frame buffer mirror in bytes
+ * @return True if the memory was reserved; false if the window
+ *   should be created without backing store.
+ */
+
+bool CWindowFactory::reserveBackingStore(size_t nbytes)
+{
+  if (CONFIG_TWM4NX_BACKINGSTORE_LIMIT > 0 &&
+      m_bsUsage + nbytes > (size_t)CONFIG_TWM4NX_BACKINGSTORE_LIMIT)
+    {
+      twmwarn("WARNING: Backing store limit reached: %lu + %lu > %lu\n",
+              (unsigned long)m_bsUsage, (unsigned long)nbytes,
+              (unsigned long)CONFIG_TWM4NX_BACKINGSTORE_LIMIT);
+      return false;
+    }
+
+  addBackingStore(nbytes);
+  return true;
+}
+
+/**
+ * Account for the backing store of a window that is always RAM-backed
+ * because it has no redraw handler.  Such windows are never refused, but
+ * their memory counts against the limit seen by later application windows.
+ *
+ * @param nbytes The size of the window frame buffer mirror in bytes
+ */
+
+void CWindowFactory::addBackingStore(size_t nbytes)
+{
+  m_bsUsage += nbytes;
+  if (m_bsUsage > m_bsPeak)
+    {
+      m_bsPeak = m_bsUsage;
+    }
+
+  twminfo("Reserved %lu bytes, %lu in use\n",
+          (unsigned long)nbytes, (unsigned long)m_bsUsage);
+}
+
+/**
+ * Update the backing store accounting after a RAM-backed window has
+ * been resized.
+ *
+ * @param oldBytes The previous size of the frame buffer mirror
+ * @param newBytes The new size of the frame buffer mirror
+ */
+
+void CWindowFactory::resizeBackingStore(size_t oldBytes, size_t newBytes)
+{
+  DEBUGASSERT(m_bsUsage >= oldBytes);
+
+  m_bsUsage = m_bsUsage - oldBytes + newBytes;
+  if (m_bsUsage > m_bsPeak)
+    {
+      m_bsPeak = m_bsUsage;
+    }
+
+  if (CONFIG_TWM4NX_BACKINGSTORE_LIMIT > 0 &&
+      m_bsUsage > (size_t)CONFIG_TWM4NX_BACKINGSTORE_LIMIT)
+    {
+      twmwarn("WARNING: Backing store over limit after resize: %lu\n",
+              (unsigned long)m_bsUsage);
+    }
+}
+
+/**
+ * Release backing store memory when a RAM-backed window is destroyed.
+ *
+ * @param nbytes The size of the window frame buffer mirror in bytes
+ */
+
+void CWindowFactory::releaseBackingStore(size_t nbytes)
+{
+  DEBUGASSERT(m_bsUsage >= nbytes);
+  m_bsUsage -= nbytes;
+}
+#endif
+
 /**
  * Handle WINDOW events.
  *
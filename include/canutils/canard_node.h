@@ -0,0 +1,248 @@
+/****************************************************************************
+ * apps/include/canutils/canard_node.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_CANUTILS_CANARD_NODE_H
+#define __APPS_INCLUDE_CANUTILS_CANARD_NODE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <nuttx/can/can.h>
+
+#include "canutils/canard.h"
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct canard_node_s;
+
+/* Periodic timer callback.  "now" is the monotonic time in microseconds. */
+
+typedef CODE void (*canard_node_timer_t)(FAR struct canard_node_s *node,
+                                         FAR void *arg, uint64_t now);
+
+/* Timer wheel entry.  The storage is provided by the caller. */
+
+struct canard_node_timer_s
+{
+  FAR struct canard_node_timer_s *flink; /* Next timer in the same slot     */
+  canard_node_timer_t callback;          /* Function to call on expiry     */
+  FAR void *arg;                         /* Argument of the callback       */
+  uint32_t ticks;                        /* Period in wheel ticks          */
+  uint32_t rounds;                       /* Full wheel turns before expiry */
+  uint16_t slot;                         /* Slot the timer is linked in    */
+  bool active;                           /* True if the timer is running   */
+};
+
+/* Runtime counters */
+
+struct canard_node_stats_s
+{
+  uint32_t rx_frames;        /* CAN frames received                         */
+  uint32_t rx_reads;         /* read() calls that returned frames           */
+  uint32_t rx_transfers;     /* Transfers delivered to the handler          */
+  uint32_t rx_errors;        /* Failed read() calls                         */
+  uint32_t rx_latency_max;   /* Max time from wakeup to handler (us)        */
+  uint64_t rx_latency_sum;   /* Sum of the RX-to-handler latencies (us)     */
+  uint32_t tx_frames;        /* CAN frames written                          */
+  uint32_t tx_writes;        /* write() calls                               */
+  uint32_t tx_errors;        /* Frames dropped on write errors              */
+  uint32_t tx_queue_hwm;     /* Max frames waiting in the TX batch buffer   */
+  uint32_t tx_full;          /* Times the TX batch buffer was full          */
+};
+
+/* Node runtime instance */
+
+struct canard_node_s
+{
+  CanardInstance canard;                 /* libcanard instance             */
+  int fd;                                /* CAN device                     */
+  volatile bool stop;                    /* Set by canard_node_stop()      */
+
+  /* Application callbacks and context */
+
+  CanardOnTransferReception onreception;
+  FAR void *arg;
+
+  /* Timer wheel */
+
+  FAR struct canard_node_timer_s *wheel[CONFIG_CANARDNODE_WHEEL_SLOTS];
+  uint32_t tick;                         /* Current wheel tick             */
+  uint64_t nexttick;                     /* Time of the next tick (us)     */
+  FAR struct canard_node_timer_s *expiring; /* Slot being expired        */
+  struct canard_node_timer_s cleanup;    /* Stale transfer cleanup         */
+
+  /* RX batch buffer and the time of the last wakeup */
+
+  uint64_t rxtime;
+  uint8_t rxbuf[CONFIG_CANARDNODE_RXBATCH * sizeof(struct can_msg_s)];
+
+  /* TX batch buffer */
+
+  size_t txlen;                          /* Bytes waiting in txbuf         */
+  uint16_t txcount;                      /* Frames waiting in txbuf        */
+  uint8_t txbuf[CONFIG_CANARDNODE_TXBATCH * sizeof(struct can_msg_s)];
+
+  struct canard_node_stats_s stats;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: canard_node_initialize
+ *
+ * Description:
+ *   Open the CAN device and initialize libcanard.  "onreception" and
+ *   "shouldaccept" are the usual libcanard callbacks; "arg" can be
+ *   retrieved from the callbacks with canard_node_getarg().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int canard_node_initialize(FAR struct canard_node_s *node,
+                           FAR const char *devpath,
+                           FAR void *mempool, size_t poolsize,
+                           uint8_t nodeid,
+                           CanardOnTransferReception onreception,
+                           CanardShouldAcceptTransfer shouldaccept,
+                           FAR void *arg);
+
+/****************************************************************************
+ * Name: canard_node_uninitialize
+ *
+ * Description:
+ *   Close the CAN device.
+ *
+ ****************************************************************************/
+
+void canard_node_uninitialize(FAR struct canard_node_s *node);
+
+/****************************************************************************
+ * Name: canard_node_getnode / canard_node_getarg
+ *
+ * Description:
+ *   Get the runtime instance or the application argument from the
+ *   libcanard instance passed to the callbacks.
+ *
+ ****************************************************************************/
+
+FAR struct canard_node_s *canard_node_getnode(FAR CanardInstance *ins);
+FAR void *canard_node_getarg(FAR CanardInstance *ins);
+
+/****************************************************************************
+ * Name: canard_node_timer_start
+ *
+ * Description:
+ *   Start a periodic timer.  The period is rounded up to the wheel tick
+ *   (CONFIG_CANARDNODE_TICK_MS).  The callback runs in the context of
+ *   canard_node_spin() and may queue transfers.
+ *
+ ****************************************************************************/
+
+int canard_node_timer_start(FAR struct canard_node_s *node,
+                            FAR struct canard_node_timer_s *timer,
+                            uint32_t period_ms,
+                            canard_node_timer_t callback, FAR void *arg);
+
+/****************************************************************************
+ * Name: canard_node_timer_stop
+ *
+ * Description:
+ *   Stop a periodic timer.  It is safe to call from the timer callback.
+ *
+ ****************************************************************************/
+
+void canard_node_timer_stop(FAR struct canard_node_s *node,
+                            FAR struct canard_node_timer_s *timer);
+
+/****************************************************************************
+ * Name: canard_node_spin
+ *
+ * Description:
+ *   Run one iteration of the event loop:  Wait up to "timeout_ms" (or until
+ *   the next timer tick) for the CAN device to become readable or, if
+ *   frames are waiting, writable; then receive, expire timers and transmit.
+ *   A negative timeout waits for events or timers only.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int canard_node_spin(FAR struct canard_node_s *node, int timeout_ms);
+
+/****************************************************************************
+ * Name: canard_node_run
+ *
+ * Description:
+ *   Run the event loop until canard_node_stop() is called.
+ *
+ ****************************************************************************/
+
+int canard_node_run(FAR struct canard_node_s *node);
+
+/****************************************************************************
+ * Name: canard_node_stop
+ *
+ * Description:
+ *   Make canard_node_run() return after the current iteration.
+ *
+ ****************************************************************************/
+
+void canard_node_stop(FAR struct canard_node_s *node);
+
+/****************************************************************************
+ * Name: canard_node_getstats / canard_node_resetstats
+ *
+ * Description:
+ *   Get or reset the runtime counters.
+ *
+ ****************************************************************************/
+
+void canard_node_getstats(FAR struct canard_node_s *node,
+                          FAR struct canard_node_stats_s *stats);
+void canard_node_resetstats(FAR struct canard_node_s *node);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APPS_INCLUDE_CANUTILS_CANARD_NODE_H */
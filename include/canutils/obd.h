@@ -35,6 +35,34 @@
 
 #include <nuttx/can/can.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Maximum number of PIDs that can be requested in a single query.  In
+ * mode 02 each PID is followed by a freeze frame number, so fewer fit.
+ */
+
+#define OBD_MAX_PIDS        6
+#define OBD_MAX_FF_PIDS     3
+
+/* Maximum number of ECUs whose responses to one query are collected:
+ * 0x7e8-0x7ef with 11-bit identifiers.
+ */
+
+#define OBD_MAX_ECUS        8
+
+/* Size of the reassembly buffer.  Without multi-frame support it is still
+ * large enough for the ISO-TP responses of all ECUs to a full six PID
+ * mode 01 query.
+ */
+
+#ifdef CONFIG_LIBOBD2_MULTIFRAME
+#  define OBD_DATA_SIZE     4096
+#else
+#  define OBD_DATA_SIZE     256
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -47,6 +75,17 @@ enum
   CAN_EXT,
 };
 
+/* The response of one ECU, reassembled in obd_dev_s data */
+
+struct obd_response_s
+{
+  uint32_t ecuid;                    /* CAN ID of the ECU                   */
+  uint16_t offset;                   /* Start of the payload in data        */
+  uint16_t len;                      /* Payload bytes received              */
+  uint16_t total;                    /* Payload bytes expected              */
+  uint8_t  seq;                      /* Next consecutive frame number       */
+};
+
 /* OBD-II structure */
 
 struct obd_dev_s
@@ -56,11 +95,24 @@ struct obd_dev_s
   struct  canioc_bittiming_s can_bt; /* Current bitrate                     */
   uint8_t can_mode;                  /* Current mode (Standard or Extended) */
   int     can_fd;                    /* File Descriptor of CAN Device       */
-#ifdef CONFIG_MULTIFRAME_SUPPORT
-  uint8_t data[4096];                /* Up to 4096 bytes                    */
-#else
-  uint8_t data[8];                   /* Single Frame = 8 bytes              */
-#endif
+  int     can_filter;                /* Installed filter ID or -1           */
+  uint16_t datalen;                  /* Bytes in data after reassembly      */
+  uint8_t data[OBD_DATA_SIZE];       /* Received frame or ISO-TP payloads   */
+  uint8_t nresp;                     /* Responses in resp                   */
+  struct obd_response_s resp[OBD_MAX_ECUS];
+  uint8_t necus;                     /* ECUs that answered before, or 0     */
+  uint32_t ecus[OBD_MAX_ECUS];       /* CAN IDs of these ECUs               */
+};
+
+/* Decoded value of one PID */
+
+struct obd_value_s
+{
+  uint32_t ecuid;                    /* CAN ID of the answering ECU         */
+  uint8_t  pid;                      /* The PID                             */
+  uint8_t  len;                      /* Number of data bytes (A, B, C, D)   */
+  uint32_t raw;                      /* Data bytes, A in the MSB position   */
+  float    value;                    /* Value in the PID's physical unit    */
 };
 
 /****************************************************************************
@@ -114,4 +166,130 @@ int obd_wait_response(FAR struct obd_dev_s *dev, uint8_t opmode, uint8_t pid,
 
 FAR char *obd_decode_pid(FAR struct obd_dev_s *dev, uint8_t pid);
 
+/****************************************************************************
+ * Name: obd_set_filters
+ *
+ * Description:
+ *   Install CAN ID filters in the driver so that only ECU responses are
+ *   received.  Drivers without filter support keep receiving all frames.
+ *
+ *   Returns OK or a negated errno value.
+ *
+ ****************************************************************************/
+
+int obd_set_filters(FAR struct obd_dev_s *dev);
+
+/****************************************************************************
+ * Name: obd_clear_filters
+ *
+ * Description:
+ *   Remove the filters installed by obd_set_filters(), if any.
+ *
+ ****************************************************************************/
+
+void obd_clear_filters(FAR struct obd_dev_s *dev);
+
+/****************************************************************************
+ * Name: obd_send_request_multi
+ *
+ * Description:
+ *   Send a "Request Message" for up to OBD_MAX_PIDS PIDs in one single
+ *   frame.  In mode 02, up to OBD_MAX_FF_PIDS PIDs of freeze frame 0 are
+ *   requested.
+ *
+ *   It will return an error case the message fails to be sent.
+ *
+ ****************************************************************************/
+
+int obd_send_request_multi(FAR struct obd_dev_s *dev, uint8_t opmode,
+                           FAR const uint8_t *pids, int npids);
+
+/****************************************************************************
+ * Name: obd_wait_response_multi
+ *
+ * Description:
+ *   Collect the responses of all ECUs to obd_send_request_multi().  Single
+ *   and multi-frame (ISO-TP) responses are supported; for multi-frame
+ *   responses the flow control frame is sent to each responding ECU.  The
+ *   payloads, starting at the response mode byte, are left in dev->data
+ *   and described by dev->resp.
+ *
+ *   The ECUs that answer are remembered in dev->ecus.  Once every one of
+ *   them has answered, it returns without waiting for the rest of
+ *   "timeout" milliseconds.  While no ECU is known, or if a known ECU
+ *   does not answer, responses are collected for the whole timeout.  Set
+ *   dev->necus to zero to discover the ECUs again.
+ *
+ *   Call obd_set_filters() beforehand to only wake up for ECU responses.
+ *
+ *   It will return the number of complete responses.  If there are none,
+ *   it returns -EPROTO if an ECU answered with a negative response or broke
+ *   the ISO-TP sequence, -E2BIG if a response did not fit in dev->data, or
+ *   -ETIMEDOUT.
+ *
+ ****************************************************************************/
+
+int obd_wait_response_multi(FAR struct obd_dev_s *dev, uint8_t opmode,
+                            int timeout);
+
+/****************************************************************************
+ * Name: obd_pid_datalen
+ *
+ * Description:
+ *   Return the number of data bytes of a mode 01/02 PID or a negated errno
+ *   value if the PID is not known.
+ *
+ ****************************************************************************/
+
+int obd_pid_datalen(uint8_t pid);
+
+/****************************************************************************
+ * Name: obd_decode_value
+ *
+ * Description:
+ *   Decode the data bytes of one mode 01/02 PID to a number.  Bit-encoded
+ *   PIDs report the raw data in both "raw" and "value".
+ *
+ *   It will return OK or a negated errno value if the PID is not known.
+ *
+ ****************************************************************************/
+
+int obd_decode_value(uint8_t pid, FAR const uint8_t *data,
+                     FAR struct obd_value_s *value);
+
+/****************************************************************************
+ * Name: obd_decode_response
+ *
+ * Description:
+ *   Decode all PIDs in the responses received by
+ *   obd_wait_response_multi(), in the order the ECUs started answering.
+ *
+ *   It will return the number of decoded values or a negated errno value.
+ *
+ ****************************************************************************/
+
+int obd_decode_response(FAR struct obd_dev_s *dev,
+                        FAR struct obd_value_s *values, int nvalues);
+
+/****************************************************************************
+ * Name: obd_poll_pids
+ *
+ * Description:
+ *   Read any number of PIDs.  The PIDs are requested in groups of
+ *   OBD_MAX_PIDS (OBD_MAX_FF_PIDS in mode 02) and the responses of all
+ *   ECUs are decoded into the "nvalues" entries of "values", in the order
+ *   they were reported.  Every group is requested even if "values" is
+ *   full.  Responses to each group are collected for up to "timeout"
+ *   milliseconds, see obd_wait_response_multi().  The response filters
+ *   are installed once for the whole poll.
+ *
+ *   It will return the number of decoded values or a negated errno value.
+ *
+ ****************************************************************************/
+
+int obd_poll_pids(FAR struct obd_dev_s *dev, uint8_t opmode,
+                  FAR const uint8_t *pids, int npids,
+                  FAR struct obd_value_s *values, int nvalues,
+                  int timeout);
+
 #endif /*__APPS_INCLUDE_CANUTILS_OBD_H */
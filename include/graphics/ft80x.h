@@ -29,6 +29,12 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_GRAPHICS_FT80X_STREAMING
+#  include <pthread.h>
+#  include <semaphore.h>
+#endif
 
 #ifdef CONFIG_GRAPHICS_FT80X
 
@@ -55,6 +61,57 @@ struct ft80x_dlbuffer_s
   uint32_t dlbuffer[FT80X_DL_BUFWORDS];
 };
 
+#ifdef CONFIG_GRAPHICS_FT80X_STREAMING
+/* Co-processor command streaming statistics */
+
+struct ft80x_streamstats_s
+{
+  uint32_t frames;      /* Number of completed frames */
+  uint32_t bytes;       /* Bytes written to RAM CMD in the current frame */
+  uint32_t stalls;      /* FIFO full stalls in the current frame */
+  uint32_t lastbytes;   /* Bytes written in the last completed frame */
+  uint32_t laststalls;  /* FIFO full stalls in the last completed frame */
+  uint32_t maxbytes;    /* Largest number of bytes in any frame */
+  uint32_t maxstalls;   /* Largest number of stalls in any frame */
+  uint32_t totalstalls; /* Total FIFO full stalls in all frames */
+  uint64_t totalbytes;  /* Total bytes written in all frames */
+};
+
+/* Device accessors used by the command stream.  Normally these are the
+ * FT80x driver accessors, but a test harness may replace them with a
+ * mocked device.
+ */
+
+struct ft80x_streamops_s
+{
+  CODE int (*getregs)(int fd, uint32_t addr, uint8_t nregs,
+                      FAR uint32_t *value);
+  CODE int (*putreg16)(int fd, uint32_t addr, uint16_t value);
+  CODE int (*putramcmd)(int fd, uint16_t offset, FAR const void *data,
+                        size_t len);
+};
+
+/* A double-buffered co-processor command stream.  Commands are constructed
+ * in one buffer while a transmitter thread streams the other to RAM CMD.
+ */
+
+struct ft80x_stream_s
+{
+  int fd;                        /* FT80x device file descriptor */
+  FAR const struct ft80x_streamops_s *ops; /* Device accessors */
+  pthread_t txthread;            /* The transmitter thread */
+  sem_t txsem;                   /* Counts buffers queued for transmission */
+  sem_t freesem;                 /* Counts buffers free for construction */
+  volatile bool stop;            /* Request transmitter thread to exit */
+  volatile int result;           /* First transmission error */
+  uint8_t fillndx;               /* Index of the buffer under construction */
+  uint8_t txndx;                 /* Index of the next buffer to transmit */
+  uint16_t buflen[2];            /* Bytes in each buffer */
+  struct ft80x_streamstats_s stats;
+  uint32_t buffer[2][FT80X_DL_BUFWORDS];
+};
+#endif
+
 /* Describes touch sample */
 
 union ft80x_touchpos_u
@@ -583,6 +640,122 @@ int ft80x_gpio_write(int fd, uint8_t gpio, bool value);
 
 bool ft80x_gpio_read(int fd, uint8_t gpio);
 
+#ifdef CONFIG_GRAPHICS_FT80X_STREAMING
+/****************************************************************************
+ * Name: ft80x_stream_initialize
+ *
+ * Description:
+ *   Initialize a double-buffered co-processor command stream and start its
+ *   transmitter thread.
+ *
+ * Input Parameters:
+ *   fd     - The file descriptor of the FT80x device.  Opened by the caller
+ *            with write access.
+ *   stream - An instance of struct ft80x_stream_s allocated by the caller.
+ *   ops    - Device accessors.  NULL selects the FT80x driver; a test may
+ *            provide accessors for a mocked device.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_initialize(int fd, FAR struct ft80x_stream_s *stream,
+                            FAR const struct ft80x_streamops_s *ops);
+
+/****************************************************************************
+ * Name: ft80x_stream_uninitialize
+ *
+ * Description:
+ *   Stop the transmitter thread and release resources.  Any data not yet
+ *   submitted is discarded.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_uninitialize(FAR struct ft80x_stream_s *stream);
+
+/****************************************************************************
+ * Name: ft80x_stream_data
+ *
+ * Description:
+ *   Add co-processor commands to the stream.  Whenever the buffer under
+ *   construction fills, it is handed to the transmitter thread and
+ *   construction continues in the other buffer.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *   data   - The data to be added
+ *   datlen - The length of the data.  If this is not an even multiple of 4
+ *            bytes, then the data will be padded with zero bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_data(FAR struct ft80x_stream_s *stream,
+                      FAR const void *data, size_t datlen);
+
+/****************************************************************************
+ * Name: ft80x_stream_flush
+ *
+ * Description:
+ *   Hand any buffered commands to the transmitter thread without waiting
+ *   for the co-processor to execute them.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_flush(FAR struct ft80x_stream_s *stream);
+
+/****************************************************************************
+ * Name: ft80x_stream_endframe
+ *
+ * Description:
+ *   Flush the stream, wait until the transmitter is idle and the
+ *   co-processor has consumed all commands, then close the per-frame
+ *   statistics.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ft80x_stream_endframe(FAR struct ft80x_stream_s *stream);
+
+/****************************************************************************
+ * Name: ft80x_stream_getstats
+ *
+ * Description:
+ *   Return a snapshot of the stream statistics.
+ *
+ * Input Parameters:
+ *   stream - The stream instance
+ *   stats  - The location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ft80x_stream_getstats(FAR struct ft80x_stream_s *stream,
+                           FAR struct ft80x_streamstats_s *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -55,10 +55,25 @@ namespace NXWidgets
   struct SBitmap;
 
   // Bitmaps used by NxWidgets
-  // Global RLE Paletted Bitmaps
+  // The NuttX logo, an LZ or an RLE Paletted Bitmap.  SNxLogoBitmap is the
+  // bitmap structure and CNxLogoBitmap the class that reads it.
+
+#ifdef CONFIG_NXGLYPHS_LZ_LOGO
+  struct SLzPaletteBitmap;
+  class CLzPaletteBitmap;
+
+  typedef struct SLzPaletteBitmap SNxLogoBitmap;
+  typedef CLzPaletteBitmap CNxLogoBitmap;
+#else
+  struct SRlePaletteBitmap;
+  class CRlePaletteBitmap;
+
+  typedef struct SRlePaletteBitmap SNxLogoBitmap;
+  typedef CRlePaletteBitmap CNxLogoBitmap;
+#endif
 
-  extern const struct SRlePaletteBitmap g_nuttxBitmap160x160;
-  extern const struct SRlePaletteBitmap g_nuttxBitmap320x320;
+  extern const SNxLogoBitmap g_nuttxBitmap160x160;
+  extern const SNxLogoBitmap g_nuttxBitmap320x320;
 
   // Global Simple Bitmaps
 
@@ -0,0 +1,249 @@
+/****************************************************************************
+ * apps/include/graphics/nxwidgets/cglyphatlas.hxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CGLYPHATLAS_HXX
+#define __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CGLYPHATLAS_HXX
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/**
+ * Number of character codes covered by the atlas.  Characters outside of
+ * this range (only possible with 16-bit characters) fall back to the
+ * normal NX font rendering path.
+ */
+
+#if CONFIG_NXFONTS_CHARBITS >= 8
+#  define GLYPHATLAS_NCODES 256
+#else
+#  define GLYPHATLAS_NCODES 128
+#endif
+
+/****************************************************************************
+ * Implementation Classes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+
+namespace NXWidgets
+{
+  struct SBitmap;
+
+  /**
+   * Precomputed description of one glyph in the atlas.
+   */
+
+  struct SGlyphAtlasEntry
+  {
+    uint8_t  stride;      /**< Stride of the source font bitmap (bytes) */
+    uint8_t  width;       /**< Width of the glyph bitmap (pixels) */
+    uint8_t  height;      /**< Height of the glyph bitmap (rows) */
+    uint8_t  xoffset;     /**< Top, left-hand corner X-offset (pixels) */
+    uint8_t  yoffset;     /**< Top, left-hand corner Y-offset (rows) */
+    uint8_t  advance;     /**< Horizontal advance: width + xoffset or the
+                           *   width of a space if there is no glyph */
+    bool     present;     /**< True if the font has a bitmap for the code */
+    uint32_t offset;      /**< Byte offset of the pre-rendered pixels */
+  };
+
+  /**
+   * A process-wide, reference counted cache of pre-rendered glyphs for one
+   * (font ID, font color) pair.  All CNxFont instances that use the same
+   * font and color share one atlas, regardless of whether they belong to
+   * NxWM, Twm4Nx or any other NxWidgets client.  Glyph metrics are kept in
+   * a table so that string widths are simple lookups and glyphs are drawn
+   * by copying the pre-rendered pixels rather than by running the NX font
+   * renderer for each character.
+   *
+   * Instances are only obtained through acquire() and returned through
+   * release().
+   */
+
+  class CGlyphAtlas
+  {
+  private:
+    FAR CGlyphAtlas *m_flink;              /**< Next atlas in the global list */
+    enum nx_fontid_e m_fontId;             /**< The font ID */
+    NXHANDLE m_fontHandle;                 /**< The font handle */
+    FAR const struct nx_font_s *m_pFontSet; /**< The font set metrics */
+    nxgl_mxpixel_t m_fontColor;            /**< Color the glyphs are rendered in */
+    nxgl_mxpixel_t m_keyColor;             /**< Color of unset glyph pixels */
+    unsigned int m_refs;                   /**< Number of references */
+    size_t m_poolSize;                     /**< Size of m_pool in bytes */
+    FAR uint8_t *m_pool;                   /**< Pre-rendered glyph pixels */
+    struct SGlyphAtlasEntry m_glyphs[GLYPHATLAS_NCODES];
+
+    /**
+     * Constructor.  Use acquire() to get an atlas instance.
+     *
+     * @param fontid The font ID to use.
+     * @param fontColor The color that the glyphs are rendered in.
+     */
+
+    CGlyphAtlas(enum nx_fontid_e fontid, nxgl_mxpixel_t fontColor);
+
+    /**
+     * Destructor.  Use release() to free an atlas instance.
+     */
+
+    ~CGlyphAtlas(void);
+
+    /**
+     * Build the metrics table and pre-render all glyphs.
+     *
+     * @return True if the atlas was successfully built.
+     */
+
+    bool build(void);
+
+    /**
+     * Copy constructor is private to prevent usage.
+     */
+
+    inline CGlyphAtlas(const CGlyphAtlas &atlas) { }
+
+  public:
+
+    /**
+     * Get a reference to the shared atlas for a font ID and color,
+     * creating and pre-rendering it on the first reference.
+     *
+     * @param fontid The font ID to use.
+     * @param fontColor The color that the glyphs are rendered in.
+     * @return The shared atlas or NULL if it could not be created.
+     */
+
+    static FAR CGlyphAtlas *acquire(enum nx_fontid_e fontid,
+                                    nxgl_mxpixel_t fontColor);
+
+    /**
+     * Release a reference obtained with acquire().  The atlas is freed when
+     * the last reference is released.
+     *
+     * @param atlas The atlas to release.
+     */
+
+    static void release(FAR CGlyphAtlas *atlas);
+
+    /**
+     * Get the total amount of memory currently used by all glyph atlases.
+     *
+     * @return The number of bytes allocated for atlases.
+     */
+
+    static size_t getMemoryUsage(void);
+
+    /**
+     * Gets the color that the glyphs of this atlas were rendered with.
+     *
+     * @return The font color of the atlas.
+     */
+
+    inline nxgl_mxpixel_t getColor(void) const
+    {
+      return m_fontColor;
+    }
+
+    /**
+     * Gets the font set metrics for this atlas.
+     *
+     * @return The font set metrics.
+     */
+
+    inline FAR const struct nx_font_s *getFontSet(void) const
+    {
+      return m_pFontSet;
+    }
+
+    /**
+     * Check if a character is covered by the atlas.
+     *
+     * @param letter The character to check.
+     * @return True if the atlas holds an entry for the character.
+     */
+
+    inline bool contains(nxwidget_char_t letter) const
+    {
+      return (unsigned int)letter < GLYPHATLAS_NCODES;
+    }
+
+    /**
+     * Get the precomputed entry for a character.  The caller must first
+     * verify that the character is covered using contains().
+     *
+     * @param letter The character of interest.
+     * @return The atlas entry for the character.
+     */
+
+    inline FAR const struct SGlyphAtlasEntry *
+    getEntry(nxwidget_char_t letter) const
+    {
+      return &m_glyphs[(unsigned int)letter];
+    }
+
+    /**
+     * Get the horizontal advance of a character.  The caller must first
+     * verify that the character is covered using contains().
+     *
+     * @param letter The character of interest.
+     * @return The width of the character in pixels.
+     */
+
+    inline nxgl_coord_t getCharWidth(nxwidget_char_t letter) const
+    {
+      return m_glyphs[(unsigned int)letter].advance;
+    }
+
+    /**
+     * Copy a pre-rendered glyph into a bitmap.  Only the pixels that belong
+     * to the glyph are copied; the remainder of the bitmap is left
+     * untouched so that the glyph is drawn on the existing background.
+     *
+     * @param bitmap The bitmap to draw to.  The caller should use the
+     *   character metrics to assure that the buffer will hold the glyph.
+     * @param letter The character to output.  Must be covered by the
+     *   atlas.
+     */
+
+    void blitChar(FAR SBitmap *bitmap, nxwidget_char_t letter) const;
+  };
+}
+
+#endif // __cplusplus
+#endif // CONFIG_NXWIDGETS_GLYPHATLAS
+#endif // __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CGLYPHATLAS_HXX
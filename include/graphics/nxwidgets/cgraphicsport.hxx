@@ -85,6 +85,20 @@ namespace NXWidgets
   class  CNxString;
   class  CRect;
   struct SBitmap;
+  struct SPixelRect;
+
+#ifdef CONFIG_NXWIDGETS_DRAWSTATS
+  /**
+   * Drawing statistics of one graphics port.
+   */
+
+  struct SDrawStats
+  {
+    uint32_t operations;   /**< Drawing requests sent to the window */
+    uint32_t allocations;  /**< Working buffers allocated while drawing */
+    uint64_t pixels;       /**< Pixels requested, before clipping */
+  };
+#endif
 
   /**
    * CGraphicsPort is the interface between a NXwidget and NX layer.
@@ -97,6 +111,38 @@ namespace NXWidgets
 #ifdef CONFIG_NX_WRITEONLY
     nxgl_mxpixel_t m_backColor;  /**< The background color to use */
 #endif
+#ifdef CONFIG_NXWIDGETS_DRAWSTATS
+    struct SDrawStats m_drawStats; /**< Drawing statistics */
+#endif
+
+    /**
+     * Account for one drawing request.
+     *
+     * @param rect The window-relative region drawn.
+     */
+
+    inline void countDraw(FAR const struct nxgl_rect_s *rect)
+    {
+#ifdef CONFIG_NXWIDGETS_DRAWSTATS
+      m_drawStats.operations++;
+      if (rect->pt2.x >= rect->pt1.x && rect->pt2.y >= rect->pt1.y)
+        {
+          m_drawStats.pixels += (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+                                (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+        }
+#endif
+    }
+
+    /**
+     * Account for one working buffer allocation.
+     */
+
+    inline void countAllocation(void)
+    {
+#ifdef CONFIG_NXWIDGETS_DRAWSTATS
+      m_drawStats.allocations++;
+#endif
+    }
 
     /**
      * The underlying implementation for drawText functions
@@ -115,6 +161,23 @@ namespace NXWidgets
                    const CNxString &string, int startIndex, int length,
                    nxgl_mxpixel_t background, bool transparent);
 
+    /**
+     * Read a region of graphics memory, transform it with a pixel kernel
+     * and write it back.  The region is handled in as few bands of rows as
+     * memory allows, ideally one read and one write for the whole region.
+     *
+     * @param x X coordinate of the region to change.
+     * @param y Y coordinate of the region to change.
+     * @param width Width of the region to change.
+     * @param height Height of the region to change.
+     * @param kernel The CPixelKernels operation to apply in place.
+     */
+
+    void transformRegion(nxgl_coord_t x, nxgl_coord_t y,
+                         nxgl_coord_t width, nxgl_coord_t height,
+                         CODE bool (*kernel)(FAR const struct SPixelRect *dest,
+                                             FAR const struct SPixelRect *src));
+
   public:
     /**
      * Constructor.
@@ -455,9 +518,9 @@ namespace NXWidgets
 
     /**
      * Invert colors in a region.  NOTE:  This allocates an in-memory
-     * buffer the size of one row in graphic memory.  So it may only be
-     * useful for inverting small regions and its only current use is for
-     * the inverted cursor text.
+     * buffer the size of the region (or of as many rows of it as memory
+     * allows).  So it is mostly useful for inverting small regions and its
+     * only current use is for the inverted cursor text.
      *
      * @param x X coordinate of the region to change.
      * @param y Y coordinate of the region to change.
@@ -468,6 +531,29 @@ namespace NXWidgets
     void invert(nxgl_coord_t x, nxgl_coord_t y,
                 nxgl_coord_t width, nxgl_coord_t height);
 
+#ifdef CONFIG_NXWIDGETS_DRAWSTATS
+    /**
+     * Get the drawing statistics of this port.
+     *
+     * @param stats Populated with the statistics.
+     */
+
+    inline void getDrawStats(FAR struct SDrawStats *stats) const
+    {
+      *stats = m_drawStats;
+    }
+
+    /**
+     * Clear the drawing statistics of this port.
+     */
+
+    inline void resetDrawStats(void)
+    {
+      m_drawStats.operations  = 0;
+      m_drawStats.allocations = 0;
+      m_drawStats.pixels      = 0;
+    }
+#endif
   };
 }
 
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * apps/include/graphics/nxwidgets/chitindex.hxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CHITINDEX_HXX
+#define __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CHITINDEX_HXX
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "graphics/nxwidgets/tnxarray.hxx"
+
+/****************************************************************************
+ * Implementation Classes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+
+namespace NXWidgets
+{
+  class CNxWidget;
+
+  /**
+   * Uniform grid over a window that maps each cell to the controlled
+   * widgets whose bounds overlap it.  Used by CWidgetControl to find the
+   * few widgets that can collide with a click instead of asking every
+   * widget in the window.
+   *
+   * Each cell is (1 << CONFIG_NXWIDGETS_HITINDEX_CELLSHIFT) pixels square.
+   * The cell lists are stored back to back in one array, each list
+   * holding indices into the controlled widget array in ascending order,
+   * so walking a list backwards visits the candidates in the same order
+   * as the full widget array.  Hidden widgets are left out.  The grid is
+   * not updated incrementally: any change to the widget geometry marks it
+   * dirty and it is rebuilt on the next lookup.
+   */
+
+  class CHitIndex
+  {
+  private:
+    FAR unsigned int *m_cellStart;  /**< Start of each cell in m_entries,
+                                         plus the end of the last cell */
+    FAR uint16_t     *m_entries;    /**< Widget indices of all cells */
+    unsigned int      m_maxEntries; /**< Allocated size of m_entries */
+    unsigned int      m_maxCells;   /**< Allocated size of m_cellStart - 1 */
+    nxgl_coord_t      m_cols;       /**< Number of cell columns */
+    nxgl_coord_t      m_rows;       /**< Number of cell rows */
+    bool              m_dirty;      /**< True: the grid must be rebuilt */
+    bool              m_valid;      /**< True: the last rebuild succeeded */
+
+    /**
+     * Get the range of cells overlapped by a widget.
+     *
+     * @param widget The widget.
+     * @param rect Populated with the first and last cell column (x) and
+     *   row (y).
+     * @return False if the widget is hidden or outside of the grid.
+     */
+
+    bool getCells(FAR const CNxWidget *widget,
+                  FAR struct nxgl_rect_s *rect) const;
+
+  public:
+
+    /**
+     * Constructor.
+     */
+
+    CHitIndex(void);
+
+    /**
+     * Destructor.
+     */
+
+    ~CHitIndex(void);
+
+    /**
+     * Mark the grid out of date.  Called whenever a widget is added,
+     * removed, moved, resized, shown or hidden, or the window is resized.
+     */
+
+    inline void invalidate(void)
+    {
+      m_dirty = true;
+    }
+
+    /**
+     * Check if the grid must be rebuilt before the next lookup.
+     *
+     * @return True if the grid is out of date.
+     */
+
+    inline bool isDirty(void) const
+    {
+      return m_dirty;
+    }
+
+    /**
+     * Rebuild the grid from the controlled widgets of a window.
+     *
+     * @param widgets The controlled widgets in the window.
+     * @param width The width of the window.
+     * @param height The height of the window.
+     * @return False if the grid could not be built, in which case all
+     *   lookups fail until the next successful rebuild.
+     */
+
+    bool rebuild(const TNxArray<CNxWidget*> &widgets,
+                 nxgl_coord_t width, nxgl_coord_t height);
+
+    /**
+     * Get the widgets that may contain a point.  The candidates are
+     * indices into the widget array passed to rebuild(), in ascending
+     * order.  Every visible widget containing the point is a candidate
+     * but not every candidate contains the point.
+     *
+     * @param x The x coordinate of the point.
+     * @param y The y coordinate of the point.
+     * @param candidates Populated with the first candidate.
+     * @param ncandidates Populated with the number of candidates.
+     * @return False if the grid is out of date or invalid or the point
+     *   is outside of it.  The caller must then check every widget.
+     */
+
+    bool lookup(nxgl_coord_t x, nxgl_coord_t y,
+                FAR const uint16_t **candidates,
+                FAR int *ncandidates) const;
+  };
+}
+
+#endif // __cplusplus
+#endif // __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CHITINDEX_HXX
@@ -0,0 +1,241 @@
+/****************************************************************************
+ * apps/include/graphics/nxwidgets/clzpalettebitmap.hxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CLZPALETTEBITMAP_HXX
+#define __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CLZPALETTEBITMAP_HXX
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+#include "graphics/nxwidgets/ibitmap.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* The compressed data is a sequence of tokens over the palette indices of
+ * the image, in raster order:
+ *
+ *   0lllllll                 Literal: the next l + 1 bytes are indices
+ *   10mmmmmm d               Match: copy m + 3 indices from d + 1 back
+ *   11mmmmmm d0 d1           Match: copy m + 3 indices from d + 1 back,
+ *                            d = d0 | d1 << 8
+ *
+ * If m is 63, a byte follows the token that is added to the length.
+ * Matches may overlap the indices that they produce, so that a run of one
+ * color is a match at distance 1.  No match reaches further back than the
+ * window size of the bitmap.
+ */
+
+#define LZBITMAP_LITERAL_MAX  128   /**< Longest literal */
+#define LZBITMAP_MATCH_MIN    3     /**< Shortest match */
+#define LZBITMAP_MATCH_EXT    63    /**< Length code followed by an extra byte */
+#define LZBITMAP_MATCH_MAX    (LZBITMAP_MATCH_MIN + LZBITMAP_MATCH_EXT + 255)
+#define LZBITMAP_WINDOW_MAX   32768 /**< Largest window */
+
+/****************************************************************************
+ * Implementation Classes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+
+namespace NXWidgets
+{
+  /**
+   * LZ-compressed, Paletted Bitmap Structure
+   */
+
+  struct SLzPaletteBitmap
+  {
+    uint8_t          bpp;     /**< Bits per pixel */
+    uint8_t          fmt;     /**< Color format */
+    uint8_t          nlut;    /**< Number of colors in the Look-Up Table (LUT) */
+    nxgl_coord_t     width;   /**< Width in pixels */
+    nxgl_coord_t     height;  /**< Height in rows */
+    FAR const void  *lut[2];  /**< Pointers to the beginning of the Look-Up Tables (LUTs) */
+    uint16_t         window;  /**< Longest match distance, a power of two */
+    uint32_t         size;    /**< Size of the compressed data in bytes */
+
+    /**
+     * The pointer to the beginning of the compressed data
+     */
+
+    FAR const uint8_t *data;
+  };
+
+  /**
+   * Class providing bitmap accessor for a bitmap represented by
+   * SLzPaletteBitmap.
+   *
+   * The image is decoded as it is read.  Only the last window of palette
+   * indices is kept in RAM, so reading the rows in order costs one pass
+   * over the compressed data, and seeking back restarts decoding at the
+   * beginning of the image.  A bitmap that is drawn repeatedly may instead
+   * keep all of its decoded indices, one byte per pixel, so that each run
+   * costs only the LUT lookups.
+   */
+
+  class CLzPaletteBitmap : public IBitmap
+  {
+  protected:
+    /**
+     * The bitmap that is being managed
+     */
+
+    FAR const struct SLzPaletteBitmap *m_bitmap;  /**< The bitmap that is being managed */
+
+    /**
+     * Accessor state data
+     */
+
+    FAR const void    *m_lut;      /**< The selected LUT */
+    FAR const uint8_t *m_src;      /**< Next byte of compressed data */
+    FAR uint8_t       *m_history;  /**< Decoded indices: the window, or the whole image */
+    uint32_t           m_mask;     /**< Position mask for m_history */
+    uint32_t           m_pos;      /**< Number of pixels decoded */
+    uint16_t           m_literal;  /**< Literal indices left in the current token */
+    uint16_t           m_match;    /**< Matched indices left in the current token */
+    uint16_t           m_distance; /**< Distance of the current match */
+    bool               m_cached;   /**< m_history holds the whole image */
+
+    /**
+     * Reset to the beginning of the image
+     */
+
+    void startOfImage(void);
+
+    /**
+     * Read the next token of the compressed data.
+     *
+     * @return False if the data is exhausted or corrupt
+     */
+
+    bool nextToken(void);
+
+    /**
+     * Decode pixels at the current position.
+     *
+     * @param npixels The number of pixels to decode
+     * @param data The memory location in which to return the colors of
+     *   the pixels, or NULL to skip them.
+     * @return False if this goes beyond the end of the image
+     */
+
+    bool decode(uint32_t npixels, FAR nxwidget_pixel_t *data);
+
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param bitmap The bitmap structure being wrapped.
+     * @param cache True: keep the whole decoded image, one byte per pixel.
+     *   If that memory is not available, the image is decoded as it is
+     *   read.
+     */
+
+    CLzPaletteBitmap(const struct SLzPaletteBitmap *bitmap,
+                     bool cache = false);
+
+    /**
+     * Destructor.
+     */
+
+    ~CLzPaletteBitmap(void);
+
+    /**
+     * Get the bitmap's color format.
+     *
+     * @return The bitmap's color format.
+     */
+
+    const uint8_t getColorFormat(void) const;
+
+    /**
+     * Get the bitmap's color depth.
+     *
+     * @return The bitmap's pixel depth.
+     */
+
+    const uint8_t getBitsPerPixel(void) const;
+
+    /**
+     * Get the bitmap's width (in pixels/columns).
+     *
+     * @return The bitmap's width.
+     */
+
+    const nxgl_coord_t getWidth(void) const;
+
+    /**
+     * Get the bitmap's height (in rows).
+     *
+     * @return The bitmap's height.
+     */
+
+    const nxgl_coord_t getHeight(void) const;
+
+    /**
+     * Get the bitmap's width (in bytes).
+     *
+     * @return The bitmap's width.
+     */
+
+    const size_t getStride(void) const;
+
+    /**
+     * Use the colors associated with a selected image.
+     *
+     * @param selected.  true: Use colors for a selected widget,
+     *   false: Use normal (default) colors.
+     */
+
+    void setSelected(bool selected);
+
+    /**
+     * Get one row from the bit map image using the selected colors.
+     *
+     * @param x The offset into the row to get
+     * @param y The row number to get
+     * @param width The number of pixels to get from the row
+     * @param data The memory location provided by the caller
+     *   in which to return the data.  This should be at least
+     *   (getWidth()*getBitsPerPixl() + 7)/8 bytes in length
+     *   and properly aligned for the pixel color format.
+     * @param True if the run was returned successfully.
+     */
+
+    bool getRun(nxgl_coord_t x, nxgl_coord_t y, nxgl_coord_t width,
+                FAR void *data);
+  };
+}
+
+#endif // __cplusplus
+
+#endif // __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CLZPALETTEBITMAP_HXX
@@ -48,6 +48,7 @@
 namespace NXWidgets
 {
   class CNxString;
+  class CGlyphAtlas;
   struct SBitmap;
 
   /**
@@ -62,6 +63,17 @@ namespace NXWidgets
     FAR const struct nx_font_s *m_pFontSet; /** < The font set metrics */
     nxgl_mxpixel_t m_fontColor;             /**< Color to draw the font with when rendering. */
     nxgl_mxpixel_t m_transparentColor;      /**< Background color that should not be rendered. */
+#ifdef CONFIG_NXWIDGETS_GLYPHATLAS
+    FAR CGlyphAtlas *m_atlas;               /**< Shared pre-rendered glyphs */
+#endif
+
+    /**
+     * Copy constructor and assignment operator are private and not
+     * implemented to prevent usage.  A copy would release the atlas twice.
+     */
+
+    CNxFont(const CNxFont &font);
+    CNxFont &operator=(const CNxFont &font);
 
   public:
 
@@ -81,7 +93,7 @@ namespace NXWidgets
      * CNxFont Destructor.
      */
 
-    ~CNxFont() { }
+    ~CNxFont();
 
     /**
      * Checks if supplied character is blank in the current font.
@@ -106,7 +118,9 @@ namespace NXWidgets
 
     /**
      * Sets the color to use as the drawing color.  If set, this overrides
-     * the colors present in a non-monochrome font.
+     * the colors present in a non-monochrome font.  If a glyph atlas is in
+     * use, it is only used while the drawing color matches the color given
+     * to the constructor; other colors are rendered directly.
      * @param color The new drawing color.
      */
 
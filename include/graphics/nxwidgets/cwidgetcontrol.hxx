@@ -35,6 +35,7 @@
 
 #include "graphics/nxwidgets/nxconfig.hxx"
 #include "graphics/nxwidgets/cgraphicsport.hxx"
+#include "graphics/nxwidgets/chitindex.hxx"
 #include "graphics/nxwidgets/cnxwidget.hxx"
 #include "graphics/nxwidgets/crect.hxx"
 #include "graphics/nxwidgets/cwidgetstyle.hxx"
@@ -53,6 +54,21 @@ namespace NXWidgets
   class INxWindow;
   class CNxWidget;
 
+#ifdef CONFIG_NXWIDGETS_DISPATCHSTATS
+  /**
+   * Click dispatch statistics of one window.
+   */
+
+  struct SDispatchStats
+  {
+    uint32_t events;     /**< Number of clicks dispatched */
+    uint32_t tested;     /**< Widgets asked to handle those clicks */
+    uint32_t lastUsec;   /**< Dispatch time of the last click */
+    uint32_t maxUsec;    /**< Longest dispatch time */
+    uint64_t totalUsec;  /**< Sum of all dispatch times */
+  };
+#endif
+
   /**
    * Class providing a top-level widget and an interface to the CWidgetControl
    * widget hierarchy.
@@ -156,6 +172,15 @@ namespace NXWidgets
                                                        awaiting deletion. */
     TNxArray<CNxWidget*>        m_widgets;        /**< List of controlled
                                                        widgets. */
+#ifdef CONFIG_NXWIDGETS_HITINDEX
+    CHitIndex                   m_hitIndex;       /**< Grid of the widgets
+                                                       that may be clicked
+                                                       at each point. */
+#endif
+#ifdef CONFIG_NXWIDGETS_DISPATCHSTATS
+    struct SDispatchStats       m_dispatchStats;  /**< Click dispatch
+                                                       statistics. */
+#endif
     volatile bool               m_haveGeometry;   /**< True: indicates that we
                                                        have valid geometry data. */
 #ifdef CONFIG_NXWIDGET_EVENTWAIT
@@ -235,6 +260,21 @@ namespace NXWidgets
 
     bool handleLeftClick(nxgl_coord_t x, nxgl_coord_t y, CNxWidget *widget);
 
+    /**
+     * Send a click to the widgets that may contain it, topmost first,
+     * until one responds.  Uses the hit index if it is enabled and covers
+     * the click.
+     *
+     * @param x Click xcoordinate.
+     * @param y Click ycoordinate.
+     * @param widget Pointer to a specific widget or NULL.
+     * @param tested Incremented for each widget sent the click.
+     * @return True if is a widget responds to the left click
+     */
+
+    bool dispatchLeftClick(nxgl_coord_t x, nxgl_coord_t y, CNxWidget *widget,
+                           unsigned int &tested);
+
     /**
      * Get the index of the specified controlled widget.
      *
@@ -441,6 +481,7 @@ namespace NXWidgets
     inline void addControlledWidget(CNxWidget* widget)
     {
       m_widgets.push_back(widget);
+      invalidateHitIndex();
     }
 
     /**
@@ -462,6 +503,38 @@ namespace NXWidgets
       return m_widgets.size();
     }
 
+    /**
+     * Notify the control that a widget was moved, resized, shown, hidden
+     * or re-parented so that the hit index is rebuilt before the next
+     * click.  Called by the widgets themselves.
+     */
+
+    inline void invalidateHitIndex(void)
+    {
+#ifdef CONFIG_NXWIDGETS_HITINDEX
+      m_hitIndex.invalidate();
+#endif
+    }
+
+#ifdef CONFIG_NXWIDGETS_DISPATCHSTATS
+    /**
+     * Get the click dispatch statistics of this window.
+     *
+     * @param stats Populated with the statistics.
+     */
+
+    inline void getDispatchStats(FAR struct SDispatchStats *stats) const
+    {
+      *stats = m_dispatchStats;
+    }
+
+    /**
+     * Clear the click dispatch statistics of this window.
+     */
+
+    void resetDispatchStats(void);
+#endif
+
     /**
      * Add a widget to the list of widgets to be deleted.
      * Must never be called by anything other than the framework itself.
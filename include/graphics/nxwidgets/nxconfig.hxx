@@ -71,6 +71,8 @@
  *   The smallest BPP configuration supported by NX.
  * CONFIG_NXWIDGETS_SIZEOFCHAR - Size of character {1 or 2 bytes}.  Default
  *   Determined by CONFIG_NXWIDGETS_SIZEOFCHAR
+ * CONFIG_NXWIDGETS_GLYPHATLAS - Share pre-rendered glyphs between all
+ *   CNxFont instances with the same font ID and color.  Default: n
  *
  * NXWidget Default Values
  *
@@ -83,6 +83,9 @@ namespace Twm4Nx
       bool                        m_resized;      /**< The size has changed */
       bool                        m_mouseValid;   /**< True: m_mousePos is valid */
       volatile bool               m_paused;       /**< The window was un-clicked */
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+      size_t                      m_bsSize;       /**< Size window backing store */
+#endif
 
       /**
        * Create the size window
@@ -96,6 +99,16 @@ namespace Twm4Nx
 
       bool createSizeLabel(void);
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+      /**
+       * Update the backing store accounting for the RAM-backed size window
+       *
+       * @param size The new size of the size window
+       */
+
+      void updateBackingStore(FAR const struct nxgl_size_s *size);
+#endif
+
       /**
        * Set the Window Size
        */
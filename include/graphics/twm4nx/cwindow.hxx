@@ -146,6 +146,9 @@ namespace Twm4Nx
       nxgl_coord_t                m_minWidth;    /**< The minimum width of the window */
       struct SAppEvents           m_appEvents;   /**< Application event information */
       bool                        m_modal;       /**< Window is in modal state */
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+      size_t                      m_bsSize;      /**< Backing store size (0: not RAM-backed) */
+#endif
 
       // Icon
 
@@ -230,6 +233,13 @@ namespace Twm4Nx
 
       bool fillToolbar(void);
 
+      /**
+       * Redraw the toolbar background and widgets.  This is only needed for
+       * windows that are not RAM-backed.
+       */
+
+      bool redrawToolbar(void);
+
       /**
        * Update the toolbar layout, resizing the title text window and
        * repositioning all windows on the toolbar.
@@ -435,6 +445,10 @@ namespace Twm4Nx
       /**
        * Configure application window events.
        *
+       * Application windows are not RAM-backed if CONFIG_TWM4NX_BACKINGSTORE
+       * is disabled or its limit is reached.  Such windows are blank after
+       * being exposed unless a redrawEvent is provided.
+       *
        * @param events Describes the application event configuration
        * @return True is returned on success
        */
@@ -783,6 +797,21 @@ namespace Twm4Nx
         return m_iconified;
       }
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+      /**
+       * Check if this window is RAM-backed.  RAM-backed windows are redrawn
+       * by NX from the backing store and do not receive redraw events.
+       *
+       * @return The size of the backing store in bytes; zero if the window
+       *   is not RAM-backed.
+       */
+
+      inline size_t getBackingStoreSize(void)
+      {
+        return m_bsSize;
+      }
+#endif
+
       /**
        * Check if this window has an Icon.  Menu windows, for examples, have
        * no icons.
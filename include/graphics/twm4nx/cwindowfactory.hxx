@@ -137,6 +137,10 @@ namespace Twm4Nx
       struct nxgl_point_s  m_winpos;      /**< Position of next window created */
       FAR struct SWindow  *m_windowHead;  /**< List of windows on the display */
       CDesktopItem         m_desktopItem; /**< For the "Desktop" Main Menu item */
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+      size_t               m_bsUsage;     /**< RAM committed to backing store */
+      size_t               m_bsPeak;      /**< Peak backing store usage */
+#endif
 
       /**
        * Add a window container to the window list.
@@ -280,6 +284,81 @@ namespace Twm4Nx
                           FAR const struct nxgl_rect_s &iconBounds,
                           FAR struct nxgl_rect_s &collision);
 
+#ifdef CONFIG_TWM4NX_BACKINGSTORE
+      /**
+       * Return the size of the NX frame buffer mirror of a RAM-backed window
+       *
+       * @param frameSize The size of the window frame, including borders
+       * @return The size of the backing store in bytes
+       */
+
+      inline size_t backingStoreSize(FAR const struct nxgl_size_s *frameSize)
+      {
+        size_t stride = ((size_t)frameSize->w * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+        return stride * (size_t)frameSize->h;
+      }
+
+      /**
+       * Reserve backing store memory for a new RAM-backed window.  The
+       * reservation fails if it would exceed
+       * CONFIG_TWM4NX_BACKINGSTORE_LIMIT.
+       *
+       * @param nbytes The size of the window frame buffer mirror in bytes
+       * @return True if the memory was reserved; false if the window
+       *   should be created without backing store.
+       */
+
+      bool reserveBackingStore(size_t nbytes);
+
+      /**
+       * Account for the backing store of a window that is always RAM-backed
+       * because it has no redraw handler.  Such windows are never refused,
+       * but their memory counts against the limit seen by later application
+       * windows.
+       *
+       * @param nbytes The size of the window frame buffer mirror in bytes
+       */
+
+      void addBackingStore(size_t nbytes);
+
+      /**
+       * Update the backing store accounting after a RAM-backed window has
+       * been resized.  NX has already reallocated the frame buffer mirror so
+       * this always succeeds, but a warning is issued if the limit is now
+       * exceeded.
+       *
+       * @param oldBytes The previous size of the frame buffer mirror
+       * @param newBytes The new size of the frame buffer mirror
+       */
+
+      void resizeBackingStore(size_t oldBytes, size_t newBytes);
+
+      /**
+       * Release backing store memory when a RAM-backed window is destroyed.
+       *
+       * @param nbytes The size of the window frame buffer mirror in bytes
+       */
+
+      void releaseBackingStore(size_t nbytes);
+
+      /**
+       * Return the amount of RAM currently committed to backing store.
+       *
+       * @param peak The location to return the peak usage.  May be NULL.
+       * @return The number of bytes currently in use.
+       */
+
+      inline size_t getBackingStoreUsage(FAR size_t *peak = (FAR size_t *)0)
+      {
+        if (peak != (FAR size_t *)0)
+          {
+            *peak = m_bsPeak;
+          }
+
+        return m_bsUsage;
+      }
+#endif
+
       /**
        * Handle WINDOW events.
        *
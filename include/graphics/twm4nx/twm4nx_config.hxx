@@ -86,6 +86,16 @@
 
 // Windows //////////////////////////////////////////////////////////////////
 
+/**
+ * CONFIG_TWM4NX_BACKINGSTORE - Create windows as RAM-backed NX windows.
+ * CONFIG_TWM4NX_BACKINGSTORE_LIMIT - Maximum RAM (in bytes) that may be
+ *   used for window backing store.  Zero means no limit.  Default: 0
+ */
+
+#ifndef CONFIG_TWM4NX_BACKINGSTORE_LIMIT
+#  define CONFIG_TWM4NX_BACKINGSTORE_LIMIT 0
+#endif
+
 // Toolbar /////////////////////////////////////////////////////////////////
 
 /**
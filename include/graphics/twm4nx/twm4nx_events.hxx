@@ -154,6 +154,7 @@ namespace Twm4Nx
     EVENT_TOOLBAR_MENU         = 0x7003,  /**< Toolbar menu button released */
     EVENT_TOOLBAR_MINIMIZE     = 0x7004,  /**< Toolbar minimize button released */
     EVENT_TOOLBAR_TERMINATE    = 0x7005,  /**< Toolbar delete button released */
+    EVENT_TOOLBAR_REDRAW       = 0x7806,  /**< Redraw the toolbar */
 
     // Recipient == BORDER
 
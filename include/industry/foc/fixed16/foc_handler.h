@@ -33,6 +33,10 @@
 #  include "industry/foc/fixed16/foc_cordic.h"
 #endif
 
+#ifdef CONFIG_INDUSTRY_FOC_TRIG
+#  include "industry/foc/fixed16/foc_trig.h"
+#endif
+
 /****************************************************************************
  * Public Type Definition
  ****************************************************************************/
@@ -0,0 +1,54 @@
+/****************************************************************************
+ * apps/include/industry/foc/fixed16/foc_trig.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INDUSTRY_FOC_FIXED16_FOC_TRIG_H
+#define __INDUSTRY_FOC_FIXED16_FOC_TRIG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <dspb16.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_trig_sincos_b16
+ ****************************************************************************/
+
+void foc_trig_sincos_b16(b16_t a, FAR b16_t *sin, FAR b16_t *cos);
+
+/****************************************************************************
+ * Name: foc_trig_angle_b16
+ ****************************************************************************/
+
+void foc_trig_angle_b16(FAR phase_angle_b16_t *angle, b16_t a);
+
+/****************************************************************************
+ * Name: foc_trig_dqsat_b16
+ ****************************************************************************/
+
+void foc_trig_dqsat_b16(FAR dq_frame_b16_t *dq, b16_t mag_max);
+
+#endif /* __INDUSTRY_FOC_FIXED16_FOC_TRIG_H */
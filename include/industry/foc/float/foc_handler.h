@@ -33,6 +33,10 @@
 #  include "industry/foc/float/foc_cordic.h"
 #endif
 
+#ifdef CONFIG_INDUSTRY_FOC_TRIG
+#  include "industry/foc/float/foc_trig.h"
+#endif
+
 /****************************************************************************
  * Public Type Definition
  ****************************************************************************/
@@ -0,0 +1,54 @@
+/****************************************************************************
+ * apps/include/industry/foc/float/foc_trig.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INDUSTRY_FOC_FLOAT_FOC_TRIG_H
+#define __INDUSTRY_FOC_FLOAT_FOC_TRIG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_trig_sincos_f32
+ ****************************************************************************/
+
+void foc_trig_sincos_f32(float a, FAR float *sin, FAR float *cos);
+
+/****************************************************************************
+ * Name: foc_trig_angle_f32
+ ****************************************************************************/
+
+void foc_trig_angle_f32(FAR phase_angle_f32_t *angle, float a);
+
+/****************************************************************************
+ * Name: foc_trig_dqsat_f32
+ ****************************************************************************/
+
+void foc_trig_dqsat_f32(FAR dq_frame_f32_t *dq, float mag_max);
+
+#endif /* __INDUSTRY_FOC_FLOAT_FOC_TRIG_H */
@@ -63,6 +63,8 @@ struct telnetd_config_s
   size_t      t_stacksize; /* The stack size needed by the spawned task */
   main_t      t_entry;     /* The entrypoint of the task to spawn when a new
                             * connection is accepted. */
+  uint8_t     t_poolsize;  /* The number of session tasks to create ahead
+                            * of the connections, zero for none. */
 };
 
 /****************************************************************************
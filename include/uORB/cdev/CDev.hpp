@@ -158,6 +158,17 @@ public:
 	virtual int	poll(file_t *filep, struct pollfd *fds, bool setup);
 
 protected:
+	/**
+	 * A poll waiter.  While a poll is set up, fds->priv points to its
+	 * waiter, so that it can be removed without searching.
+	 */
+	struct PollWaiter {
+		struct pollfd	*fds;
+		file_t		*filep;
+		PollWaiter	*next;
+		PollWaiter	*prev;
+	};
+
 	/**
 	 * Pointer to the default cdev file operations table; useful for
 	 * registering clone devices etc.
@@ -196,6 +207,17 @@ protected:
 	 */
 	virtual void	poll_notify_one(struct pollfd  *fds, pollevent_t events);
 
+	/**
+	 * Get the file of a poll waiter.
+	 *
+	 * @param fds		A poll waiter passed to poll_notify_one().
+	 * @return		The file that set up the poll.
+	 */
+	static file_t	*poll_filep(struct pollfd *fds)
+	{
+		return ((PollWaiter *)fds->priv)->filep;
+	}
+
 	/**
 	 * Notification of the first open.
 	 *
@@ -278,22 +300,25 @@ private:
 	const char	*_devname;		/**< device node name */
 	bool		_registered{false};		/**< true if device name was registered */
 
-	uint8_t		_max_pollwaiters{0}; /**< size of the _pollset array */
 	uint16_t	_open_count{0};		/**< number of successful opens */
 
-	struct pollfd	**_pollset{nullptr};
+	PollWaiter	*_pollwaiters{nullptr};	/**< list of active poll waiters */
+	PollWaiter	*_pollfree{nullptr};	/**< list of waiters kept for reuse */
 
 	/**
-	 * Store a pollwaiter in a slot where we can find it later.
+	 * Add a poll waiter to the active list and point fds->priv at it.
 	 *
-	 * Expands the pollset as required.  Must be called with the driver locked.
+	 * Reuses a waiter from the free list if there is one.  Must be called
+	 * with the driver locked.
 	 *
 	 * @return		OK, or -errno on error.
 	 */
-	int		store_poll_waiter(struct pollfd *fds);
+	int		store_poll_waiter(file_t *filep, struct pollfd *fds);
 
 	/**
-	 * Remove a poll waiter.
+	 * Remove a poll waiter from the active list and keep it for reuse.
+	 *
+	 * Must be called with the driver locked.
 	 *
 	 * @return		OK, or -errno on error.
 	 */
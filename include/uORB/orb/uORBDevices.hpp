@@ -35,6 +35,7 @@
 
 #include <stdint.h>
 #include "uORBCommon.hpp"
+#include "uORBTimerWheel.hpp"
 
 
 #include <string.h>
@@ -188,7 +189,7 @@ protected:
 private:
 	struct UpdateIntervalData {
 		unsigned  interval; /**< if nonzero minimum interval between updates */
-		struct hrt_call update_call;  /**< deferred wakeup call if update_period is nonzero */
+		TimerWheel::Entry update_entry;  /**< deferred wakeup entry if update_period is nonzero */
 		uint64_t last_update; /**< time at which the last update was provided, used when update_interval is nonzero */
 
 
@@ -215,6 +216,7 @@ private:
 	bool _published{false};  /**< has ever data been published */
 	uint8_t _queue_size; /**< maximum number of elements in the queue */
 	int8_t _subscriber_count{0};
+	unsigned _deferred_batch{0}; /**< last timer wheel batch that notified this node */
 
 	inline static SubscriberData    *filp_to_sd(device::file_t *filp);
 
@@ -231,11 +233,12 @@ private:
 	void      update_deferred();
 
 	/**
-	 * Bridge from hrt_call to update_deferred
+	 * Bridge from the timer wheel to update_deferred
 	 *
 	 * void *arg    ORBDevNode pointer for which the deferred update is performed.
+	 * unsigned batch  Timer wheel batch; the node is notified once per batch.
 	 */
-	static void   update_deferred_trampoline(void *arg);
+	static void   update_deferred_trampoline(void *arg, unsigned batch);
 
 	/**
 	 * Check whether a topic appears updated to a subscriber.
@@ -0,0 +1,108 @@
+/****************************************************************************
+ * apps/include/uORB/orb/uORBLog.hpp
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef _uORBLog_hpp_
+#define _uORBLog_hpp_
+
+#include <stdint.h>
+
+#include "uORBCommon.hpp"
+
+/*
+ * Binary topic log format.
+ *
+ * A log is a log_file_header_s followed by records.  Every record starts
+ * with a log_record_s and its size is a multiple of 8, so that all records
+ * and the fields in them are naturally aligned when the file is mapped to
+ * memory.  A format record describes one recorded topic instance and comes
+ * before the data records that refer to its msg_id.  A data record holds
+ * one sample without the padding at the end of the topic struct.  All
+ * values are in the byte order of the recording target.
+ */
+
+#define UORB_LOG_MAGIC		"uORBlog"	/**< 7 characters and the version */
+#define UORB_LOG_VERSION	1
+
+#define UORB_LOG_FORMAT		'F'
+#define UORB_LOG_DATA		'D'
+
+#define UORB_LOG_ALIGN(_size)	(((_size) + 7) & ~7)
+
+struct log_file_header_s {
+	char magic[7];
+	uint8_t version;
+	uint64_t start_time;	/**< hrt_absolute_time() at the start of the recording */
+};
+
+struct log_record_s {
+	uint16_t size;		/**< size of the record including this header */
+	uint8_t type;		/**< UORB_LOG_FORMAT or UORB_LOG_DATA */
+	uint8_t instance;	/**< topic instance (format records) */
+	uint16_t msg_id;	/**< topic instance identifier within the log */
+	uint16_t reserved;
+};
+
+struct log_format_s {
+	struct log_record_s header;
+	uint16_t size_no_padding;	/**< size of the samples in the data records */
+	uint16_t size;			/**< size of the topic struct */
+	uint32_t reserved;
+	char name[ORB_MAXNAME];		/**< topic name */
+	/* followed by the nul terminated field list of the topic */
+};
+
+struct log_data_s {
+	struct log_record_s header;
+	uint64_t time;		/**< hrt_absolute_time() when the sample was recorded */
+	/* followed by size_no_padding bytes of sample */
+};
+
+namespace uORB
+{
+class Log;
+}
+
+/**
+ * Recording and replay of topic logs, used by "uorb record" and
+ * "uorb replay".
+ */
+class uORB::Log
+{
+public:
+	/**
+	 * Record topics to a log until a time limit expires.
+	 *
+	 * uorb record -o <file> [-d <seconds>] <topic> [<topic> ...]
+	 *
+	 * @return OK, or -errno on error.
+	 */
+	static int record(int argc, char *argv[]);
+
+	/**
+	 * Republish the samples of a log.
+	 *
+	 * uorb replay [-s <speed>] [-k] <file>
+	 *
+	 * @return OK, or -errno on error.
+	 */
+	static int replay(int argc, char *argv[]);
+};
+
+#endif // _uORBLog_hpp_
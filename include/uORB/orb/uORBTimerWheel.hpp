@@ -0,0 +1,144 @@
+/****************************************************************************
+ * apps/include/uORB/orb/uORBTimerWheel.hpp
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef _uORBTimerWheel_hpp_
+#define _uORBTimerWheel_hpp_
+
+#include <stdint.h>
+
+#include <nuttx/timers/drv_hrt.h>
+
+namespace uORB
+{
+class TimerWheel;
+}
+
+/**
+ * Shared timer for the deferred notifications of rate-limited subscribers.
+ *
+ * All entries are kept on a two level hierarchical timer wheel driven by a
+ * single hrt_call that ticks every CONFIG_UORB_TIMERWHEEL_TICK microseconds,
+ * and only while at least one entry is scheduled.  Level 0 holds the entries
+ * that expire within the next WHEEL_SIZE ticks, one slot per tick, level 1
+ * the entries that expire within WHEEL_SPAN ticks, one slot per WHEEL_SIZE
+ * ticks, and anything further out waits on an overflow list.  Level 1 slots
+ * and the overflow list are cascaded down as the wheel turns, so scheduling,
+ * cancelling and expiring an entry are all constant time.
+ *
+ * Expiry is rounded up to the next tick: an entry never fires early and at
+ * most one tick late.  The callouts of all entries that expire in the same
+ * timer interrupt are called with the same batch number, so that a callout
+ * shared by several entries can act only once per batch.
+ *
+ * All methods may be called from interrupt context.  Callouts are called in
+ * interrupt context inside a critical section and may schedule or cancel
+ * any entry, but must not free one.
+ */
+class uORB::TimerWheel
+{
+public:
+	/**
+	 * Callout of an expired entry.
+	 *
+	 * @param arg	The argument passed to schedule().
+	 * @param batch	Number of the timer interrupt the entry expired in.
+	 *		Never zero.
+	 */
+	typedef void (*callout_t)(void *arg, unsigned batch);
+
+	/**
+	 * Timer entry, embedded in the object that needs the notification.
+	 * Must be zero-initialized before first use.
+	 */
+	struct Entry {
+		Entry *next;		/**< next entry in the same slot */
+		Entry **pprev;		/**< link to this entry; null if not scheduled */
+		Entry *fired_next;	/**< next entry expired in the same batch */
+		callout_t callout;
+		void *arg;
+		uint32_t expiry;	/**< tick at which the entry expires */
+
+		/**
+		 * @return true if the entry is scheduled and has not expired yet.
+		 */
+		bool pending() const { return pprev != nullptr; }
+	};
+
+	/**
+	 * (Re)schedule an entry.  An entry that is still pending is moved.
+	 *
+	 * @param entry		The entry.
+	 * @param delay		Minimum time until the callout, in microseconds.
+	 * @param callout	Called when the entry expires.
+	 * @param arg		Passed to the callout.
+	 */
+	static void schedule(Entry *entry, hrt_abstime delay, callout_t callout, void *arg);
+
+	/**
+	 * Cancel an entry.  Does nothing if the entry is not pending.
+	 *
+	 * @param entry		The entry.
+	 */
+	static void cancel(Entry *entry);
+
+private:
+	static const unsigned WHEEL_BITS = 6;
+	static const uint32_t WHEEL_SIZE = 1 << WHEEL_BITS;
+	static const uint32_t WHEEL_MASK = WHEEL_SIZE - 1;
+	static const uint32_t WHEEL_SPAN = WHEEL_SIZE * WHEEL_SIZE;
+
+	static Entry *_level0[WHEEL_SIZE];	/**< entries expiring at one tick */
+	static Entry *_level1[WHEEL_SIZE];	/**< entries expiring in one WHEEL_SIZE tick range */
+	static Entry *_overflow;		/**< entries expiring more than WHEEL_SPAN ticks out */
+	static Entry *_fired;			/**< entries expired in the current batch */
+	static unsigned _count;			/**< number of pending entries */
+	static unsigned _batch;			/**< number of the current batch */
+	static uint32_t _tick;			/**< last tick processed */
+	static hrt_abstime _next_tick_time;	/**< time at which the next tick is due */
+	static bool _running;			/**< true while the hrt_call is armed */
+	static struct hrt_call _call;
+
+	/**
+	 * Link an entry into the slot matching its expiry.
+	 */
+	static void insert(Entry *entry);
+
+	/**
+	 * Unlink an entry from its slot.
+	 */
+	static void unlink(Entry *entry);
+
+	/**
+	 * Re-insert all entries of a slot, moving them down a level.
+	 */
+	static void cascade(Entry **slot);
+
+	/**
+	 * Advance the wheel by one tick and collect the expired entries.
+	 */
+	static void advance();
+
+	/**
+	 * Process all ticks that are due and call the expired callouts.
+	 */
+	static void tick(void *arg);
+};
+
+#endif /* _uORBTimerWheel_hpp_ */
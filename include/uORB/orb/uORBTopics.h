@@ -34,17 +34,19 @@
 #ifndef MODULES_UORB_UORBTOPICS_H_
 #define MODULES_UORB_UORBTOPICS_H_
 
-#include <uORB/uORB.h>
+#include <stddef.h>
+
+#include "uORB/orb/uORB.h"
 
 /*
  * Returns count of all declared topics.
  * It is equal to size of array from orb_get_topics()
  */
-extern size_t orb_topics_count() __EXPORT;
+extern size_t orb_topics_count();
 
 /*
  * Returns array of topics metadata
  */
-extern const struct orb_metadata *const *orb_get_topics() __EXPORT;
+extern const struct orb_metadata *const *orb_get_topics();
 
 #endif /* MODULES_UORB_UORBTOPICS_H_ */
@@ -1,71 +1,34 @@
 /****************************************************************************
+ * apps/include/uORB/topic/adis16488_uorb.h
  *
- *   Copyright (C) 2013-2016 PX4 Development Team. All rights reserved.
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
  *
- * Redistribution and use in source and binary forms, with or without
- * modification, are permitted provided that the following conditions
- * are met:
+ *   http://www.apache.org/licenses/LICENSE-2.0
  *
- * 1. Redistributions of source code must retain the above copyright
- *    notice, this list of conditions and the following disclaimer.
- * 2. Redistributions in binary form must reproduce the above copyright
- *    notice, this list of conditions and the following disclaimer in
- *    the documentation and/or other materials provided with the
- *    distribution.
- * 3. Neither the name PX4 nor the names of its contributors may be
- *    used to endorse or promote products derived from this software
- *    without specific prior written permission.
- *
- * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
- * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
- * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
- * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
- * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
- * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
- * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
- * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
- * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
- * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
- * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
- * POSSIBILITY OF SUCH DAMAGE.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
  *
  ****************************************************************************/
- 
-#pragma once
- 
-#include <stdint.h>
-#ifdef __cplusplus
-#include <cstring>
-#else
-#include <string.h>
-#endif
- 
-#include "uORB/orb/uORB.h"
- 
-#ifndef __cplusplus
-#define RELATIVE_TIMESTAMP_INVALID 2147483647
- 
-#endif
- 
- 
-#ifdef __cplusplus
-struct __attribute__ ((visibility ("default"))) adis16488_uorb_s {
-#else
-struct adis16488_uorb_s {
-#endif
-	float acc[3];
-	float gyro[3];
-	float mag[3];
-	float angle[3];
-	float delta_v[3];
-	float alt;
-	float temp;
-#ifdef __cplusplus
-    static constexpr int32_t RELATIVE_TIMESTAMP_INVALID = 2147483647;
- 
-#endif
-};
 
-/* register this as object request broker structure */
-ORB_DECLARE(adis16488_uorb);
+#ifndef __APPS_INCLUDE_UORB_TOPIC_ADIS16488_UORB_H
+#define __APPS_INCLUDE_UORB_TOPIC_ADIS16488_UORB_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+/* The topic is generated from uORB/msg/adis16488_uorb.msg into
+ * uORB/topics/.  This header keeps the original include path.
+ */
+
+#include "uORB/topics/adis16488_uorb.h"
 
+#endif /* __APPS_INCLUDE_UORB_TOPIC_ADIS16488_UORB_H */
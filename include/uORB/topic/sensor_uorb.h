@@ -0,0 +1,36 @@
+/****************************************************************************
+ * apps/include/uORB/topic/sensor_uorb.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_UORB_TOPIC_SENSOR_UORB_H
+#define __APPS_INCLUDE_UORB_TOPIC_SENSOR_UORB_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+/* The sensorbridge topics are generated from uORB/msg/sensor_*_uorb.msg
+ * into uORB/topics/.  This header keeps the original include path.
+ */
+
+#include "uORB/topics/sensor_vec3_uorb.h"
+#include "uORB/topics/sensor_baro_uorb.h"
+#include "uORB/topics/sensor_scalar_uorb.h"
+
+#endif /* __APPS_INCLUDE_UORB_TOPIC_SENSOR_UORB_H */
@@ -70,6 +70,11 @@
 
 #define WAPI_PROC_LINE_SIZE  1024
 
+/* Post-processing options of the flat scan result parser. */
+
+#define WAPI_SCAN_DEDUPE     (1 << 0) /* Keep one entry per BSSID */
+#define WAPI_SCAN_SORT_RSSI  (1 << 1) /* Strongest signal first */
+
 /* Select options to successfully open a socket in this network
  * configuration.
  */
@@ -220,6 +225,32 @@ struct wapi_scan_info_s
   int rssi;
 };
 
+/* Flat array of scan results held in a single allocation.  The entries are
+ * also chained through "next", so the array can be walked like the list
+ * returned by wapi_scan_coll(), but it must be released with
+ * wapi_scan_results_free().
+ */
+
+struct wapi_scan_results_s
+{
+  FAR struct wapi_scan_info_s *aps;  /* Array of naps results */
+  int naps;
+};
+
+/* State of an asynchronous scan.  It must be zeroed before the first
+ * wapi_scan_async_start().  The size of the result buffer is remembered
+ * across scans so that it only grows once to the size the driver needs.
+ */
+
+struct wapi_scan_async_s
+{
+  int sock;
+  int flags;
+  char ifname[IFNAMSIZ];
+  FAR char *arena;                   /* Event and result buffer */
+  size_t arenalen;
+};
+
 /* Linked list container for routing table rows. */
 
 struct wapi_route_info_s
@@ -728,6 +759,94 @@ int wapi_scan_coll(int sock, FAR const char *ifname,
 
 void wapi_scan_coll_free(FAR struct wapi_list_s *aps);
 
+/****************************************************************************
+ * Name: wapi_scan_parse
+ *
+ * Description:
+ *   Parse a SIOCGIWSCAN event buffer (e.g. a recorded one) into a flat
+ *   array of results.
+ *
+ * Input Parameters:
+ *   buf     - The event stream.  Its contents are not modified.
+ *   len     - The length of the event stream.
+ *   flags   - WAPI_SCAN_DEDUPE and/or WAPI_SCAN_SORT_RSSI.
+ *   results - Receives the result array.
+ *
+ * Returned Value:
+ *   The number of results on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int wapi_scan_parse(FAR const char *buf, size_t len, int flags,
+                    FAR struct wapi_scan_results_s *results);
+
+/****************************************************************************
+ * Name: wapi_scan_coll_flat
+ *
+ * Description:
+ *   Collects the results of a scan process into a flat array.  The event
+ *   buffer and the results share one allocation.
+ *
+ * Returned Value:
+ *   The number of results on success; -EAGAIN if the scan has not yet
+ *   completed; another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int wapi_scan_coll_flat(int sock, FAR const char *ifname, int flags,
+                        FAR struct wapi_scan_results_s *results);
+
+/****************************************************************************
+ * Name: wapi_scan_results_free
+ *
+ * Description:
+ *   Free the results of wapi_scan_parse(), wapi_scan_coll_flat() or
+ *   wapi_scan_async_poll().
+ *
+ ****************************************************************************/
+
+void wapi_scan_results_free(FAR struct wapi_scan_results_s *results);
+
+/****************************************************************************
+ * Name: wapi_scan_async_start
+ *
+ * Description:
+ *   Starts a scan and returns immediately.  The results are then collected
+ *   with wapi_scan_async_poll().
+ *
+ ****************************************************************************/
+
+int wapi_scan_async_start(FAR struct wapi_scan_async_s *scan, int sock,
+                          FAR const char *ifname, FAR const char *essid,
+                          int flags);
+
+/****************************************************************************
+ * Name: wapi_scan_async_poll
+ *
+ * Description:
+ *   Checks for the results of a scan started with wapi_scan_async_start()
+ *   without blocking.
+ *
+ * Returned Value:
+ *   Zero if the results are available in "results"; 1 if the scan is still
+ *   running; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int wapi_scan_async_poll(FAR struct wapi_scan_async_s *scan,
+                         FAR struct wapi_scan_results_s *results);
+
+/****************************************************************************
+ * Name: wapi_scan_async_cancel
+ *
+ * Description:
+ *   Release the resources of an asynchronous scan that is no longer
+ *   polled.
+ *
+ ****************************************************************************/
+
+void wapi_scan_async_cancel(FAR struct wapi_scan_async_s *scan);
+
 /****************************************************************************
  * Name: wapi_set_country
  *
@@ -30,6 +30,7 @@
 #include <fcntl.h>
 #include <debug.h>
 #include <errno.h>
+#include <stdlib.h>
 
 #include <nuttx/math/cordic.h>
 #include <nuttx/math/math_ioctl.h>
@@ -68,19 +69,27 @@ int foc_cordic_dqsat_b16(int fd, FAR dq_frame_b16_t *dq, b16_t mag_max)
 
   DEBUGASSERT(dq);
 
-  /* Normalize DQ to [-1, 1] */
+  /* Nothing to do if the vector is within the limit */
 
-  if (dq->d > dq->q)
+  if ((int64_t)dq->d * dq->d + (int64_t)dq->q * dq->q <=
+      (int64_t)mag_max * mag_max)
     {
-      dqscale = b16divb16(b16ONE, dq->d);
+      return OK;
+    }
+
+  /* Normalize DQ to [-0.5, 0.5], so that the modulus is below 1 */
+
+  if (abs(dq->d) > abs(dq->q))
+    {
+      dqscale = 2 * abs(dq->d);
     }
   else
     {
-      dqscale = b16divb16(b16ONE, dq->q);
+      dqscale = 2 * abs(dq->q);
     }
 
-  dnorm = b16mulb16(dq->d, dqscale);
-  qnorm = b16mulb16(dq->d, dqscale);
+  dnorm = b16divb16(dq->d, dqscale);
+  qnorm = b16divb16(dq->q, dqscale);
 
   /* Get modulus */
 
@@ -99,7 +108,7 @@ int foc_cordic_dqsat_b16(int fd, FAR dq_frame_b16_t *dq, b16_t mag_max)
 
   /* Get real magnitude */
 
-  mag = b16mulb16(q31tof(io.res1), dqscale);
+  mag = b16mulb16(q31tob16(io.res1), dqscale);
 
   /* Magnitude bottom limit */
 
@@ -235,10 +235,12 @@ static void foc_control_input_set_b16(FAR foc_handler_b16_t *h,
 
   /* Update phase angle */
 
-#ifndef CONFIG_INDUSTRY_FOC_CORDIC_ANGLE
-  phase_angle_update_b16(&foc->angle, angle);
-#else
+#if defined(CONFIG_INDUSTRY_FOC_CORDIC_ANGLE)
   foc_cordic_angle_b16(h->fd, &foc->angle, angle);
+#elif defined(CONFIG_INDUSTRY_FOC_TRIG)
+  foc_trig_angle_b16(&foc->angle, angle);
+#else
+  phase_angle_update_b16(&foc->angle, angle);
 #endif
 
   /* Feed the controller with phase angle */
@@ -281,10 +283,12 @@ static void foc_control_voltage_run_b16(FAR foc_handler_b16_t *h,
 
   /* Saturate voltage DQ vector */
 
-#ifndef CONFIG_INDUSTRY_FOC_CORDIC_DQSAT
-  dq_saturate_b16(dq_ref, mag_max);
-#else
+#if defined(CONFIG_INDUSTRY_FOC_CORDIC_DQSAT)
   foc_cordic_dqsat_b16(h->fd, dq_ref, mag_max);
+#elif defined(CONFIG_INDUSTRY_FOC_TRIG)
+  foc_trig_dqsat_b16(dq_ref, mag_max);
+#else
+  dq_saturate_b16(dq_ref, mag_max);
 #endif
 
   /* Call FOC voltage controller */
@@ -343,10 +347,12 @@ static void foc_control_current_run_b16(FAR foc_handler_b16_t *h,
 
   /* Saturate voltage DQ vector */
 
-#ifndef CONFIG_INDUSTRY_FOC_CORDIC_DQSAT
-  dq_saturate_b16(dq_ref, mag_max);
-#else
+#if defined(CONFIG_INDUSTRY_FOC_CORDIC_DQSAT)
   foc_cordic_dqsat_b16(h->fd, dq_ref, mag_max);
+#elif defined(CONFIG_INDUSTRY_FOC_TRIG)
+  foc_trig_dqsat_b16(dq_ref, mag_max);
+#else
+  dq_saturate_b16(dq_ref, mag_max);
 #endif
 
   /* Call FOC voltage control */
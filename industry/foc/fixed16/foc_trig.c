@@ -0,0 +1,359 @@
+/****************************************************************************
+ * apps/industry/foc/fixed16/foc_trig.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include "industry/foc/fixed16/foc_trig.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The angle as a fraction of a turn, with 2^30 steps per turn.  Angles
+ * up to two turns convert to a signed 32-bit phase.
+ */
+
+#define TRIG_TURN_BITS     30
+#define TRIG_QUARTER       (1l << (TRIG_TURN_BITS - 2))
+
+/* 2^30 / (2 * PI), applied to b16 radians */
+
+#define TRIG_RAD2PHASE     170891319ll
+
+#if defined(CONFIG_INDUSTRY_FOC_TRIG_LUT)
+
+/* The table holds the first quarter of a sine wave in 256 segments, the
+ * other quarters are mirrored.
+ */
+
+#  define TRIG_LUT_BITS    8
+#  define TRIG_LUT_SIZE    (1 << TRIG_LUT_BITS)
+#  define TRIG_FRAC_BITS   (TRIG_TURN_BITS - 2 - TRIG_LUT_BITS)
+#  define TRIG_FRAC_MASK   ((1l << TRIG_FRAC_BITS) - 1)
+
+#elif defined(CONFIG_INDUSTRY_FOC_TRIG_POLY)
+
+/* The polynomials are evaluated in Q30 */
+
+#  define TRIG_Q           30
+#  define TRIG_ONE         (1ll << TRIG_Q)
+
+/* 2 * PI in Q28, turns the phase into radians in Q30 */
+
+#  define TRIG_2PI_Q28     1686629713ll
+
+/* Minimax polynomials on [-pi/4, pi/4] (Cephes sinf and cosf) in Q30 */
+
+#  define TRIG_SIN_1       (-178956841ll)
+#  define TRIG_SIN_2       8946590ll
+#  define TRIG_SIN_3       (-209544ll)
+
+#  define TRIG_COS_1       44739220ll
+#  define TRIG_COS_2       (-1491139ll)
+#  define TRIG_COS_3       26235ll
+
+#else
+#  error "No FOC fast trigonometry method selected"
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_INDUSTRY_FOC_TRIG_LUT
+/* sin(i * pi / 512) for i in [0, 256] */
+
+static const b16_t g_trig_sin_b16[TRIG_LUT_SIZE + 1] =
+{
+      0,   402,   804,  1206,  1608,  2010,  2412,  2814,  3216,  3617,
+   4019,  4420,  4821,  5222,  5623,  6023,  6424,  6824,  7224,  7623,
+   8022,  8421,  8820,  9218,  9616, 10014, 10411, 10808, 11204, 11600,
+  11996, 12391, 12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+  15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639, 19024, 19409,
+  19792, 20175, 20557, 20939, 21320, 21699, 22078, 22457, 22834, 23210,
+  23586, 23961, 24335, 24708, 25080, 25451, 25821, 26190, 26558, 26925,
+  27291, 27656, 28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+  30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347, 33692, 34037,
+  34380, 34721, 35062, 35401, 35738, 36075, 36410, 36744, 37076, 37407,
+  37736, 38064, 38391, 38716, 39040, 39362, 39683, 40002, 40320, 40636,
+  40951, 41264, 41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+  44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056, 46341, 46624,
+  46906, 47186, 47464, 47741, 48015, 48288, 48559, 48828, 49095, 49361,
+  49624, 49886, 50146, 50404, 50660, 50914, 51166, 51417, 51665, 51911,
+  52156, 52398, 52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+  54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004, 56212, 56418,
+  56621, 56823, 57022, 57219, 57414, 57607, 57798, 57986, 58172, 58356,
+  58538, 58718, 58896, 59071, 59244, 59415, 59583, 59750, 59914, 60075,
+  60235, 60392, 60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+  61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596, 62714, 62830,
+  62943, 63054, 63162, 63268, 63372, 63473, 63572, 63668, 63763, 63854,
+  63944, 64031, 64115, 64197, 64277, 64354, 64429, 64501, 64571, 64639,
+  64704, 64766, 64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+  65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436, 65457, 65476,
+  65492, 65505, 65516, 65525, 65531, 65535, 65536,
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_INDUSTRY_FOC_TRIG_LUT
+/****************************************************************************
+ * Name: foc_trig_lut_b16
+ *
+ * Description:
+ *   Interpolated sine of a phase (fixed16)
+ *
+ ****************************************************************************/
+
+static b16_t foc_trig_lut_b16(uint32_t phase)
+{
+  uint32_t quadrant = (phase >> (TRIG_TURN_BITS - 2)) & 3;
+  uint32_t pos      = phase & (TRIG_QUARTER - 1);
+  uint32_t i        = 0;
+  b16_t    val      = 0;
+
+  /* The second and fourth quarters run backwards through the table */
+
+  if (quadrant & 1)
+    {
+      pos = TRIG_QUARTER - pos;
+    }
+
+  i   = pos >> TRIG_FRAC_BITS;
+  val = g_trig_sin_b16[i];
+
+  if (i < TRIG_LUT_SIZE)
+    {
+      val += ((g_trig_sin_b16[i + 1] - val) *
+              (int32_t)(pos & TRIG_FRAC_MASK) +
+              (1 << (TRIG_FRAC_BITS - 1))) >> TRIG_FRAC_BITS;
+    }
+
+  /* The second half of the turn is negative */
+
+  return (quadrant & 2) ? -val : val;
+}
+#endif
+
+/****************************************************************************
+ * Name: foc_trig_isqrt64
+ *
+ * Description:
+ *   Integer square root, rounded down
+ *
+ ****************************************************************************/
+
+static uint32_t foc_trig_isqrt64(uint64_t x)
+{
+  uint64_t res = 0;
+  uint64_t bit = 1ull << 62;
+
+  while (bit > x)
+    {
+      bit >>= 2;
+    }
+
+  while (bit != 0)
+    {
+      if (x >= res + bit)
+        {
+          x   -= res + bit;
+          res  = (res >> 1) + bit;
+        }
+      else
+        {
+          res >>= 1;
+        }
+
+      bit >>= 2;
+    }
+
+  return (uint32_t)res;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_trig_sincos_b16
+ *
+ * Description:
+ *   Sine and cosine of an angle (fixed16)
+ *
+ * Input Parameter:
+ *   a   - angle in rad, within (-4PI, 4PI)
+ *   sin - (out) sine
+ *   cos - (out) cosine
+ *
+ ****************************************************************************/
+
+void foc_trig_sincos_b16(b16_t a, FAR b16_t *sin, FAR b16_t *cos)
+{
+  int32_t phase = 0;
+#ifdef CONFIG_INDUSTRY_FOC_TRIG_POLY
+  int32_t n     = 0;
+  int64_t r     = 0;
+  int64_t r2    = 0;
+  int64_t p     = 0;
+  b16_t   s     = 0;
+  b16_t   c     = 0;
+#endif
+
+  DEBUGASSERT(sin);
+  DEBUGASSERT(cos);
+
+  phase = (int32_t)(((int64_t)a * TRIG_RAD2PHASE) >> 16);
+
+#ifdef CONFIG_INDUSTRY_FOC_TRIG_LUT
+  *sin = foc_trig_lut_b16((uint32_t)phase);
+  *cos = foc_trig_lut_b16((uint32_t)phase + TRIG_QUARTER);
+#else
+  /* Reduce the phase to [-1/8, 1/8] turn and the quadrant n */
+
+  n     = (int32_t)(((int64_t)phase + (TRIG_QUARTER >> 1)) >>
+                    (TRIG_TURN_BITS - 2));
+  phase = phase - n * TRIG_QUARTER;
+
+  r  = ((int64_t)phase * TRIG_2PI_Q28) >> 28;
+  r2 = (r * r) >> TRIG_Q;
+
+  p = TRIG_SIN_2 + ((r2 * TRIG_SIN_3) >> TRIG_Q);
+  p = TRIG_SIN_1 + ((r2 * p) >> TRIG_Q);
+  p = r + ((((r * r2) >> TRIG_Q) * p) >> TRIG_Q);
+  s = (b16_t)((p + (1 << 13)) >> 14);
+
+  p = TRIG_COS_2 + ((r2 * TRIG_COS_3) >> TRIG_Q);
+  p = TRIG_COS_1 + ((r2 * p) >> TRIG_Q);
+  p = TRIG_ONE - (r2 >> 1) + ((((r2 * r2) >> TRIG_Q) * p) >> TRIG_Q);
+  c = (b16_t)((p + (1 << 13)) >> 14);
+
+  switch (n & 3)
+    {
+      case 0:
+        {
+          *sin = s;
+          *cos = c;
+          break;
+        }
+
+      case 1:
+        {
+          *sin = c;
+          *cos = -s;
+          break;
+        }
+
+      case 2:
+        {
+          *sin = -s;
+          *cos = -c;
+          break;
+        }
+
+      default:
+        {
+          *sin = -c;
+          *cos = s;
+          break;
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: foc_trig_angle_b16
+ *
+ * Description:
+ *   Phase angle update (fixed16), as phase_angle_update_b16()
+ *
+ * Input Parameter:
+ *   angle - phase angle data
+ *   a     - phase angle in rad
+ *
+ ****************************************************************************/
+
+void foc_trig_angle_b16(FAR phase_angle_b16_t *angle, b16_t a)
+{
+  DEBUGASSERT(angle);
+
+  /* Normalize angle to [0, 2PI] */
+
+  angle_norm_2pi_b16(&a, 0, b16TWOPI);
+
+  /* Fill phase angle struct */
+
+  angle->angle = a;
+  foc_trig_sincos_b16(a, &angle->sin, &angle->cos);
+}
+
+/****************************************************************************
+ * Name: foc_trig_dqsat_b16
+ *
+ * Description:
+ *   DQ-frame saturation (fixed16).  The magnitude is only computed when
+ *   the vector is saturated.
+ *
+ * Input Parameter:
+ *   dq      - DQ vector
+ *   mag_max - vector magnitude max
+ *
+ ****************************************************************************/
+
+void foc_trig_dqsat_b16(FAR dq_frame_b16_t *dq, b16_t mag_max)
+{
+  int64_t mag2 = 0;
+  b16_t   mag  = 0;
+  b16_t   tmp  = 0;
+
+  DEBUGASSERT(dq);
+
+  /* The squares in b32 */
+
+  mag2 = (int64_t)dq->d * dq->d + (int64_t)dq->q * dq->q;
+
+  if (mag2 > (int64_t)mag_max * mag_max)
+    {
+      /* The square root of a b32 is a b16 */
+
+      mag = (b16_t)foc_trig_isqrt64((uint64_t)mag2);
+
+      /* Magnitude bottom limit */
+
+      if (mag < 1)
+        {
+          mag = 1;
+        }
+
+      /* Saturate vector */
+
+      tmp = b16divb16(mag_max, mag);
+      dq->d = b16mulb16(dq->d, tmp);
+      dq->q = b16mulb16(dq->q, tmp);
+    }
+}
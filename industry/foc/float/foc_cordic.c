@@ -30,6 +30,7 @@
 #include <fcntl.h>
 #include <debug.h>
 #include <errno.h>
+#include <math.h>
 
 #include <nuttx/math/cordic.h>
 #include <nuttx/math/math_ioctl.h>
@@ -68,19 +69,26 @@ int foc_cordic_dqsat_f32(int fd, FAR dq_frame_f32_t *dq, float mag_max)
 
   DEBUGASSERT(dq);
 
-  /* Normalize DQ to [-1, 1] */
+  /* Nothing to do if the vector is within the limit */
 
-  if (dq->d > dq->q)
+  if (dq->d * dq->d + dq->q * dq->q <= mag_max * mag_max)
     {
-      dqscale = (1.0f / dq->d);
+      return OK;
+    }
+
+  /* Normalize DQ to [-0.5, 0.5], so that the modulus is below 1 */
+
+  if (fabsf(dq->d) > fabsf(dq->q))
+    {
+      dqscale = 2.0f * fabsf(dq->d);
     }
   else
     {
-      dqscale = (1.0f / dq->q);
+      dqscale = 2.0f * fabsf(dq->q);
     }
 
-  dnorm = dq->d * dqscale;
-  qnorm = dq->d * dqscale;
+  dnorm = dq->d / dqscale;
+  qnorm = dq->q / dqscale;
 
   /* Get modulus */
 
@@ -235,10 +235,12 @@ static void foc_control_input_set_f32(FAR foc_handler_f32_t *h,
 
   /* Update phase angle */
 
-#ifndef CONFIG_INDUSTRY_FOC_CORDIC_ANGLE
-  phase_angle_update(&foc->angle, angle);
-#else
+#if defined(CONFIG_INDUSTRY_FOC_CORDIC_ANGLE)
   foc_cordic_angle_f32(h->fd, &foc->angle, angle);
+#elif defined(CONFIG_INDUSTRY_FOC_TRIG)
+  foc_trig_angle_f32(&foc->angle, angle);
+#else
+  phase_angle_update(&foc->angle, angle);
 #endif
 
   /* Feed the controller with phase angle */
@@ -281,10 +283,12 @@ static void foc_control_voltage_run_f32(FAR foc_handler_f32_t *h,
 
   /* Saturate voltage DQ vector */
 
-#ifndef CONFIG_INDUSTRY_FOC_CORDIC_DQSAT
-  dq_saturate(dq_ref, mag_max);
-#else
+#if defined(CONFIG_INDUSTRY_FOC_CORDIC_DQSAT)
   foc_cordic_dqsat_f32(h->fd, dq_ref, mag_max);
+#elif defined(CONFIG_INDUSTRY_FOC_TRIG)
+  foc_trig_dqsat_f32(dq_ref, mag_max);
+#else
+  dq_saturate(dq_ref, mag_max);
 #endif
 
   /* Call FOC voltage controller */
@@ -344,10 +348,12 @@ static void foc_control_current_run_f32(FAR foc_handler_f32_t *h,
 
   /* Saturate voltage DQ vector */
 
-#ifndef CONFIG_INDUSTRY_FOC_CORDIC_DQSAT
-  dq_saturate(dq_ref, mag_max);
-#else
+#if defined(CONFIG_INDUSTRY_FOC_CORDIC_DQSAT)
   foc_cordic_dqsat_f32(h->fd, dq_ref, mag_max);
+#elif defined(CONFIG_INDUSTRY_FOC_TRIG)
+  foc_trig_dqsat_f32(dq_ref, mag_max);
+#else
+  dq_saturate(dq_ref, mag_max);
 #endif
 
   /* Call FOC voltage control */
@@ -25,83 +25,323 @@
 
 #include <nuttx/config.h>
 
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
 #include <string.h>
 
 #include <sys/socket.h>
+#include <sys/stat.h>
+#ifdef CONFIG_NETUTILS_NETCAT_SENDFILE
+#  include <sys/sendfile.h>
+#endif
 #include <arpa/inet.h>
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
 #ifndef NETCAT_PORT
 # define NETCAT_PORT 31337
 #endif
 
+#ifndef CONFIG_NETUTILS_NETCAT_BUFSIZE
+# define CONFIG_NETUTILS_NETCAT_BUFSIZE 4096
+#endif
+
 /****************************************************************************
- * Public Functions
+ * Private Types
+ ****************************************************************************/
+
+struct netcat_io_s
+{
+  FAR char *buf;                     /* Relay buffer */
+  bool verbose;                      /* Report bytes and throughput */
+  bool sendfile;                     /* The input is a regular file */
+  uint64_t sent;                     /* Bytes written to the socket */
+  uint64_t received;                 /* Bytes read from the socket */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netcat_write
+ *
+ * Description:
+ *   Write all of buf, returning 0 or -1 with errno set.
+ *
+ ****************************************************************************/
+
+static int netcat_write(int outfd, FAR const char *buf, size_t len)
+{
+  ssize_t written;
+
+  while (len > 0)
+    {
+      written = write(outfd, buf, len);
+      if (written == -1)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return -1;
+        }
+
+      buf += written;
+      len -= written;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: netcat_copy
+ *
+ * Description:
+ *   Move one buffer of data from infd to outfd.  Returns the number of
+ *   bytes moved, 0 at the end of the input, or a netcat error code.
+ *
+ ****************************************************************************/
+
+static ssize_t netcat_copy(FAR struct netcat_io_s *io, int infd, int outfd)
+{
+  ssize_t avail;
+
+  avail = read(infd, io->buf, CONFIG_NETUTILS_NETCAT_BUFSIZE);
+  if (avail == -1)
+    {
+      perror("do_io: read error");
+      return -5;
+    }
+
+  if (avail > 0 && netcat_write(outfd, io->buf, avail) == -1)
+    {
+      perror("do_io: write error");
+      return -6;
+    }
+
+  return avail;
+}
+
+/****************************************************************************
+ * Name: netcat_send
+ *
+ * Description:
+ *   Send one buffer of data from infd to the socket.  A regular file is
+ *   sent with sendfile() so that it need not be copied through the relay
+ *   buffer.  Returns as netcat_copy().
+ *
  ****************************************************************************/
 
-int do_io(int infd, int outfd)
+static ssize_t netcat_send(FAR struct netcat_io_s *io, int infd, int sock)
 {
-  size_t capacity = 256;
-  char buf[capacity];
+#ifdef CONFIG_NETUTILS_NETCAT_SENDFILE
+  ssize_t nsent;
 
-  while (true)
+  if (io->sendfile)
     {
-      ssize_t avail = read(infd, buf, capacity);
-      if (avail == 0)
+      nsent = sendfile(sock, infd, NULL, CONFIG_NETUTILS_NETCAT_BUFSIZE);
+      if (nsent >= 0)
         {
-          break;
+          return nsent;
         }
 
-      if (avail == -1)
+      if (errno != ENOSYS && errno != EINVAL)
         {
-          perror("do_io: read error");
+          perror("do_io: sendfile error");
+          return -6;
+        }
+
+      /* Not supported for this file, nothing was sent */
+
+      io->sendfile = false;
+    }
+#endif
+
+  return netcat_copy(io, infd, sock);
+}
+
+/****************************************************************************
+ * Name: do_io
+ *
+ * Description:
+ *   Relay the data between a connected socket and the input and output
+ *   files until both sides are done.  The end of the input is passed on
+ *   to the peer, but netcat keeps on receiving until the peer closes the
+ *   connection.  If infd is -1, data is only received.  If outfd is -1,
+ *   data is only sent and netcat ends at the end of the input.
+ *
+ ****************************************************************************/
+
+static int do_io(FAR struct netcat_io_s *io, int sock, int infd, int outfd)
+{
+  struct pollfd fds[2];
+  struct stat st;
+  ssize_t ret;
+
+  if (infd != -1)
+    {
+      io->sendfile = fstat(infd, &st) == 0 && S_ISREG(st.st_mode);
+    }
+
+  if (outfd == -1)
+    {
+      while ((ret = netcat_send(io, infd, sock)) > 0)
+        {
+          io->sent += ret;
+        }
+
+      return ret < 0 ? -ret : EXIT_SUCCESS;
+    }
+
+  memset(fds, 0, sizeof(fds));
+  fds[0].fd     = sock;
+  fds[0].events = POLLIN;
+  fds[1].fd     = infd;
+  fds[1].events = POLLIN;
+
+  /* Poll ignores the negative file descriptors of the finished
+   * directions.
+   */
+
+  while (fds[0].fd != -1 || fds[1].fd != -1)
+    {
+      if (poll(fds, 2, -1) == -1)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          perror("do_io: poll error");
           return 5;
         }
 
-      ssize_t written = write(outfd, buf, avail);
-      if (written == -1)
+      /* From the peer.  A hang-up is read as the end of the data.  The
+       * rest of the input is still sent unless it is typed in.
+       */
+
+      if ((fds[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0)
         {
-          perror("do_io: write error");
-          return 6;
+          ret = netcat_copy(io, sock, outfd);
+          if (ret < 0)
+            {
+              return -ret;
+            }
+          else if (ret == 0)
+            {
+              if (fds[1].fd == -1 || isatty(fds[1].fd))
+                {
+                  break;
+                }
+
+              fds[0].fd = -1;
+            }
+          else
+            {
+              io->received += ret;
+            }
+        }
+
+      /* To the peer.  At the end of the input, close the sending side
+       * of the connection only.
+       */
+
+      if ((fds[1].revents & (POLLIN | POLLHUP)) != 0)
+        {
+          ret = netcat_send(io, fds[1].fd, sock);
+          if (ret < 0)
+            {
+              return -ret;
+            }
+          else if (ret == 0)
+            {
+              shutdown(sock, SHUT_WR);
+              fds[1].fd = -1;
+            }
+          else
+            {
+              io->sent += ret;
+            }
         }
     }
 
   return EXIT_SUCCESS;
 }
 
-int netcat_server(int argc, char * argv[])
+/****************************************************************************
+ * Name: netcat_report
+ *
+ * Description:
+ *   Show the bytes relayed and the throughput for -v.
+ *
+ ****************************************************************************/
+
+static void netcat_report(FAR struct netcat_io_s *io,
+                          FAR const struct timespec *start)
+{
+  struct timespec end;
+  uint64_t msec;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  msec = (uint64_t)(end.tv_sec - start->tv_sec) * 1000 +
+         (end.tv_nsec - start->tv_nsec) / 1000000;
+
+  fprintf(stderr, "log: io: %llu bytes sent, %llu bytes received in "
+          "%llu.%03u s (%llu KiB/s)\n",
+          (unsigned long long)io->sent, (unsigned long long)io->received,
+          (unsigned long long)(msec / 1000), (unsigned int)(msec % 1000),
+          (unsigned long long)((io->sent + io->received) * 1000 /
+                               (msec > 0 ? msec : 1) / 1024));
+}
+
+/****************************************************************************
+ * Name: netcat_server
+ *
+ * Description:
+ *   netcat -l [port] [file]
+ *
+ ****************************************************************************/
+
+static int netcat_server(FAR struct netcat_io_s *io, int argc,
+                         FAR char *argv[])
 {
   int id = -1;
+  int infd = STDIN_FILENO;
   int outfd = STDOUT_FILENO;
   struct sockaddr_in server;
   struct sockaddr_in client;
+  struct timespec start;
   int port = NETCAT_PORT;
   int result = EXIT_SUCCESS;
 
-  if ((1 < argc) && (0 == strcmp("-l", argv[1])))
+  if (0 < argc)
     {
-      if (2 < argc)
-        {
-          port = atoi(argv[2]);
-        }
+      port = atoi(argv[0]);
+    }
+
+  if (1 < argc)
+    {
+      /* Only receive into the file */
 
-      if (3 < argc)
+      infd = -1;
+      outfd = open(argv[1], O_WRONLY | O_CREAT | O_TRUNC, 0777);
+      if (outfd == -1)
         {
-          outfd = open(argv[3], O_WRONLY | O_CREAT | O_TRUNC, 0777);
-          if (outfd == -1)
-            {
-              perror("error: io: Failed to create file");
-              outfd = STDOUT_FILENO;
-              result = 1;
-              goto out;
-            }
+          perror("error: io: Failed to create file");
+          outfd = STDOUT_FILENO;
+          result = 1;
+          goto out;
         }
     }
 
@@ -131,11 +371,18 @@ int netcat_server(int argc, char * argv[])
       goto out;
     }
 
-  socklen_t addrlen;
+  socklen_t addrlen = sizeof(client);
   int conn;
   if ((conn = accept(id, (struct sockaddr *)&client, &addrlen)) != -1)
     {
-      result = do_io(conn, outfd);
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      result = do_io(io, conn, infd, outfd);
+      close(conn);
+
+      if (io->verbose)
+        {
+          netcat_report(io, &start);
+        }
     }
 
   if (0 > conn)
@@ -159,27 +406,41 @@ out:
   return result;
 }
 
-int netcat_client(int argc, char * argv[])
+/****************************************************************************
+ * Name: netcat_client
+ *
+ * Description:
+ *   netcat <destination> [port] [file]
+ *
+ ****************************************************************************/
+
+static int netcat_client(FAR struct netcat_io_s *io, int argc,
+                         FAR char *argv[])
 {
   int id = -1;
   int infd = STDIN_FILENO;
-  char *host = "127.0.0.1";
+  int outfd = STDOUT_FILENO;
+  FAR char *host = "127.0.0.1";
+  struct timespec start;
   int port = NETCAT_PORT;
   int result = EXIT_SUCCESS;
 
-  if (argc > 1)
+  if (argc > 0)
     {
-      host = argv[1];
+      host = argv[0];
     }
 
-  if (argc > 2)
+  if (argc > 1)
     {
-      port = atoi(argv[2]);
+      port = atoi(argv[1]);
     }
 
-  if (argc > 3)
+  if (argc > 2)
     {
-      infd = open(argv[3], O_RDONLY);
+      /* Only send the file */
+
+      outfd = -1;
+      infd = open(argv[2], O_RDONLY);
       if (infd == -1)
         {
           perror("error: io: Failed to open file");
@@ -214,7 +475,13 @@ int netcat_client(int argc, char * argv[])
       goto out;
     }
 
-  result = do_io(infd, id);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  result = do_io(io, id, infd, outfd);
+
+  if (io->verbose)
+    {
+      netcat_report(io, &start);
+    }
 
 out:
   if (id != -1)
@@ -230,27 +497,65 @@ out:
   return result;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * netcat_main
  ****************************************************************************/
 
 int main(int argc, FAR char *argv[])
 {
+  struct netcat_io_s io;
+  bool server = false;
   int status = EXIT_SUCCESS;
-  if (2 > argc)
+  int option;
+
+  memset(&io, 0, sizeof(io));
+
+  while ((option = getopt(argc, argv, "lv")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'l':
+            server = true;
+            break;
+
+          case 'v':
+            io.verbose = true;
+            break;
+
+          default:
+            argc = 0;
+            break;
+        }
+    }
+
+  if (!server && optind >= argc)
     {
       fprintf(stderr,
-              "Usage: netcat <destination> [port] [file]\n"
-              "Usage: netcat -l [port] [file]\n");
+              "Usage: netcat [-v] <destination> [port] [file]\n"
+              "Usage: netcat [-v] -l [port] [file]\n");
+      return status;
     }
-  else if ((1 < argc) && (0 == strcmp("-l", argv[1])))
+
+  io.buf = malloc(CONFIG_NETUTILS_NETCAT_BUFSIZE);
+  if (io.buf == NULL)
+    {
+      perror("error: io: Failed to allocate buffer");
+      return 8;
+    }
+
+  if (server)
     {
-      status = netcat_server(argc, argv);
+      status = netcat_server(&io, argc - optind, &argv[optind]);
     }
   else
     {
-      status = netcat_client(argc, argv);
+      status = netcat_client(&io, argc - optind, &argv[optind]);
     }
 
+  free(io.buf);
   return status;
 }
@@ -66,12 +66,183 @@ struct telnetd_s
   size_t                stacksize; /* The stack size needed by the spawned task */
   main_t                entry;     /* The entrypoint of the task to spawn when a new
                                     * connection is accepted. */
+  uint8_t               poolsize;  /* Idle session tasks to keep ready */
+  uint8_t               npooled;   /* Pooled session tasks not handed a
+                                    * connection yet */
+  sem_t                 idle;      /* Counts the pooled tasks ready */
+  sem_t                 conn;      /* Posted when devpath is handed off */
+  sem_t                 taken;     /* Posted when devpath was copied */
+  char                  devpath[TELNET_DEVPATH_MAX];
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: telnetd_semwait
+ ****************************************************************************/
+
+static void telnetd_semwait(FAR sem_t *sem)
+{
+  while (sem_wait(sem) < 0)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: telnetd_nullio
+ *
+ * Description:
+ *   Point descriptors 0-2 at /dev/null.  The daemon keeps them open so that
+ *   the tasks it creates always inherit valid stdin, stdout and stderr.
+ *
+ ****************************************************************************/
+
+static void telnetd_nullio(void)
+{
+  int nullfd;
+
+  nullfd = open("/dev/null", O_RDWR);
+  if (nullfd < 0)
+    {
+      close(0);
+      close(1);
+      close(2);
+      return;
+    }
+
+  dup2(nullfd, 0);
+  dup2(nullfd, 1);
+  dup2(nullfd, 2);
+
+  if (nullfd > 2)
+    {
+      close(nullfd);
+    }
+}
+
+/****************************************************************************
+ * Name: telnetd_pooled
+ *
+ * Description:
+ *   A session task created before its connection.  It waits until the
+ *   daemon hands it the path of a telnet driver, makes that driver its
+ *   stdin, stdout and stderr and then becomes the session.  The task is
+ *   created while the daemon holds descriptors 0-2 open, so its stdio
+ *   streams are bound to them and follow the dup2() below.
+ *
+ * Parameters:
+ *   Standard task start up arguments.
+ *
+ * Return:
+ *   The return value of the session entrypoint.
+ *
+ ****************************************************************************/
+
+static int telnetd_pooled(int argc, FAR char *argv[])
+{
+  FAR struct telnetd_s *daemon;
+  char devpath[TELNET_DEVPATH_MAX];
+  main_t entry;
+  int drvrfd;
+
+  daemon = (FAR struct telnetd_s *)((uintptr_t)strtoul(argv[1], NULL, 0));
+  DEBUGASSERT(daemon != NULL);
+
+  /* Tell the daemon that we are ready and wait for a connection */
+
+  sem_post(&daemon->idle);
+  telnetd_semwait(&daemon->conn);
+
+  /* The daemon may be gone once the path was taken */
+
+  strlcpy(devpath, daemon->devpath, sizeof(devpath));
+  entry = daemon->entry;
+  sem_post(&daemon->taken);
+
+  /* An empty path means that the daemon is going away */
+
+  if (devpath[0] == '\0')
+    {
+      return 0;
+    }
+
+  ninfo("Opening the telnet driver at %s\n", devpath);
+  drvrfd = open(devpath, O_RDWR);
+  if (drvrfd < 0)
+    {
+      nerr("ERROR: Failed to open %s: %d\n", devpath, errno);
+      return 1;
+    }
+
+  dup2(drvrfd, 0);
+  dup2(drvrfd, 1);
+  dup2(drvrfd, 2);
+
+  if (drvrfd > 2)
+    {
+      close(drvrfd);
+    }
+
+  /* Run the session as if it was started for this connection */
+
+  argv[1] = NULL;
+  return entry(1, argv);
+}
+
+/****************************************************************************
+ * Name: telnetd_spawn
+ *
+ * Description:
+ *   Create one pooled session task.
+ *
+ ****************************************************************************/
+
+static void telnetd_spawn(FAR struct telnetd_s *daemon)
+{
+  FAR char *argv[2];
+  char arg0[sizeof("0x1234567812345678")];
+  pid_t pid;
+
+  snprintf(arg0, sizeof(arg0), "0x%" PRIxPTR, (uintptr_t)daemon);
+  argv[0] = arg0;
+  argv[1] = NULL;
+
+  pid = task_create("Telnet session", daemon->priority, daemon->stacksize,
+                    telnetd_pooled, argv);
+  if (pid < 0)
+    {
+      nerr("ERROR: Failed to create a pooled session: %d\n", errno);
+    }
+  else
+    {
+      daemon->npooled++;
+    }
+}
+
+/****************************************************************************
+ * Name: telnetd_handoff
+ *
+ * Description:
+ *   Hand the telnet driver at devpath to a pooled session task.  An empty
+ *   path makes the task exit.
+ *
+ ****************************************************************************/
+
+static void telnetd_handoff(FAR struct telnetd_s *daemon,
+                            FAR const char *devpath)
+{
+  strlcpy(daemon->devpath, devpath, sizeof(daemon->devpath));
+  sem_post(&daemon->conn);
+
+  /* Wait until the task has copied the path before reusing it */
+
+  telnetd_semwait(&daemon->taken);
+  daemon->npooled--;
+}
+
 /****************************************************************************
  * Name: telnetd_daemon
  *
@@ -118,7 +289,7 @@ static int telnetd_daemon(int argc, FAR char *argv[])
   int optval;
 #endif
   int ret;
-  int fd;
+  int fd = -1;
 
   /* Get daemon startup info */
 
@@ -220,14 +391,37 @@ static int telnetd_daemon(int argc, FAR char *argv[])
       goto errout_with_socket;
     }
 
-  /* Now go silent. */
+  /* Now go silent.  Pooled sessions are created with the daemon's
+   * descriptors 0-2, so they are left open on /dev/null rather than
+   * closed.
+   */
 
 #ifndef CONFIG_DEBUG_FEATURES
-  close(0);
-  close(1);
-  close(2);
+  telnetd_nullio();
 #endif
 
+  /* Open the Telnet factory once for all of the connections */
+
+  fd = open("/dev/telnet", O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    {
+      nerr("ERROR: open(/dev/telnet) failed: %d\n", errno);
+      goto errout_with_socket;
+    }
+
+  /* Create the pool of sessions that wait for connections */
+
+  while (daemon->npooled < daemon->poolsize)
+    {
+      uint8_t npooled = daemon->npooled;
+
+      telnetd_spawn(daemon);
+      if (daemon->npooled == npooled)
+        {
+          break;
+        }
+    }
+
   /* Begin accepting connections */
 
   for (; ; )
@@ -268,15 +462,6 @@ static int telnetd_daemon(int argc, FAR char *argv[])
         }
 #endif
 
-      /* Open the Telnet factory */
-
-      fd = open("/dev/telnet", O_RDONLY);
-      if (fd < 0)
-        {
-          nerr("ERROR: open(/dev/telnet) failed: %d\n", errno);
-          goto errout_with_acceptsd;
-        }
-
       /* Create a character device to "wrap" the accepted socket descriptor */
 
       ninfo("Creating the telnet driver\n");
@@ -285,14 +470,25 @@ static int telnetd_daemon(int argc, FAR char *argv[])
       session.ts_devpath[0] = '\0';
 
       ret = ioctl(fd, SIOCTELNET, (unsigned long)((uintptr_t)&session));
-      close(fd);
-
       if (ret < 0)
         {
           nerr("ERROR: open(/dev/telnet) failed: %d\n", errno);
           goto errout_with_acceptsd;
         }
 
+      /* Give the connection to a pooled session if one is ready and create
+       * its replacement while the session starts up.  Otherwise, start a
+       * session for it below.
+       */
+
+      if (daemon->npooled > 0 && sem_trywait(&daemon->idle) == 0)
+        {
+          ninfo("Handing %s to a pooled session\n", session.ts_devpath);
+          telnetd_handoff(daemon, session.ts_devpath);
+          telnetd_spawn(daemon);
+          continue;
+        }
+
       /* Open the driver */
 
       ninfo("Opening the telnet driver at %s\n", session.ts_devpath);
@@ -331,9 +527,7 @@ static int telnetd_daemon(int argc, FAR char *argv[])
 
       /* Forget about the connection. */
 
-      close(0);
-      close(1);
-      close(2);
+      telnetd_nullio();
     }
 
 errout_with_acceptsd:
@@ -341,7 +535,23 @@ errout_with_acceptsd:
 
 errout_with_socket:
   close(listensd);
+
+  /* Release the pooled sessions that still wait for a connection */
+
+  while (daemon->npooled > 0)
+    {
+      telnetd_handoff(daemon, "");
+    }
+
+  if (fd >= 0)
+    {
+      close(fd);
+    }
+
 errout_with_daemon:
+  sem_destroy(&daemon->idle);
+  sem_destroy(&daemon->conn);
+  sem_destroy(&daemon->taken);
   free(daemon);
   return 1;
 }
@@ -391,6 +601,12 @@ int telnetd_start(FAR struct telnetd_config_s *config)
   daemon->priority  = config->t_priority;
   daemon->stacksize = config->t_stacksize;
   daemon->entry     = config->t_entry;
+  daemon->poolsize  = config->t_poolsize;
+  daemon->npooled   = 0;
+
+  sem_init(&daemon->idle, 0, 0);
+  sem_init(&daemon->conn, 0, 0);
+  sem_init(&daemon->taken, 0, 0);
 
   /* Then start the new daemon */
 
@@ -403,6 +619,9 @@ int telnetd_start(FAR struct telnetd_config_s *config)
   if (pid < 0)
     {
       int errval = errno;
+      sem_destroy(&daemon->idle);
+      sem_destroy(&daemon->conn);
+      sem_destroy(&daemon->taken);
       free(daemon);
       nerr("ERROR: Failed to start the telnet daemon: %d\n", errval);
       return -errval;
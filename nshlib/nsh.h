@@ -276,6 +276,8 @@
  *   Default: SCHED_PRIORITY_DEFAULT
  * CONFIG_NSH_TELNETD_CLIENTSTACKSIZE - Stack size allocated for the
  *   Telnet client. Default: 2048
+ * CONFIG_NSH_TELNETD_POOLSIZE - Telnet sessions created ahead of their
+ *   connections.  Default: 0
  * CONFIG_NSH_TELNET_LOGIN - Support a simple Telnet login.
  *
  * If CONFIG_NSH_TELNET_LOGIN is defined, then these additional
@@ -307,6 +309,10 @@
 #  define CONFIG_NSH_TELNETD_CLIENTSTACKSIZE 2048
 #endif
 
+#ifndef CONFIG_NSH_TELNETD_POOLSIZE
+#  define CONFIG_NSH_TELNETD_POOLSIZE 0
+#endif
+
 #ifdef CONFIG_NSH_TELNET_LOGIN
 
 #  ifndef CONFIG_NSH_LOGIN_USERNAME
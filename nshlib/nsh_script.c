@@ -24,11 +24,219 @@
 
 #include <nuttx/config.h>
 
+#include <sys/stat.h>
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "nsh.h"
 #include "nsh_console.h"
 
 #if defined(CONFIG_FILE_STREAM) && !defined(CONFIG_NSH_DISABLESCRIPT)
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(CONFIG_NSH_ROMFSETC) && defined(CONFIG_NSH_ROMFSRC_CACHE)
+/* The login script split into NUL terminated lines, each with its
+ * newline, and ended by an empty line.  NULL until it is loaded.
+ */
+
+static FAR char *g_rcscript;
+
+/* True if the login script cannot be cached */
+
+static bool g_rcuncached;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if defined(CONFIG_NSH_ROMFSETC) && defined(CONFIG_NSH_ROMFSRC_CACHE)
+
+/****************************************************************************
+ * Name: nsh_rchasword
+ *
+ * Description:
+ *   Return true if the word appears in text on its own.
+ *
+ ****************************************************************************/
+
+static bool nsh_rchasword(FAR const char *text, FAR const char *word)
+{
+  FAR const char *ptr = text;
+  size_t len = strlen(word);
+
+  while ((ptr = strstr(ptr, word)) != NULL)
+    {
+      if ((ptr == text || (!isalnum(ptr[-1]) && ptr[-1] != '_')) &&
+          !isalnum(ptr[len]) && ptr[len] != '_')
+        {
+          return true;
+        }
+
+      ptr += len;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nsh_rcload
+ *
+ * Description:
+ *   Read the login script and split it into lines.  Returns NULL if the
+ *   script could not be read or, with *cacheable set to false, if it must
+ *   be read from the file for each session:  Loops seek back in the
+ *   script file, and fgets() would split the lines that are too long.
+ *
+ ****************************************************************************/
+
+static FAR char *nsh_rcload(FAR bool *cacheable)
+{
+  FAR const char *line;
+  FAR char *script = NULL;
+  FAR char *text;
+  FAR char *dest;
+  struct stat st;
+  ssize_t nread;
+  size_t nlines;
+  size_t len;
+  size_t i;
+  int fd;
+
+  fd = open(NSH_RCPATH, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+
+  if (fstat(fd, &st) < 0 || (text = malloc(st.st_size + 1)) == NULL)
+    {
+      close(fd);
+      return NULL;
+    }
+
+  for (len = 0; len < (size_t)st.st_size; len += nread)
+    {
+      nread = read(fd, &text[len], st.st_size - len);
+      if (nread <= 0)
+        {
+          break;
+        }
+    }
+
+  close(fd);
+  text[len] = '\0';
+
+  if (len < (size_t)st.st_size)
+    {
+      goto out;
+    }
+
+  /* Check that the text can be replayed one line at a time */
+
+  *cacheable = false;
+  if (strlen(text) != len || nsh_rchasword(text, "while") ||
+      nsh_rchasword(text, "until"))
+    {
+      goto out;
+    }
+
+  for (nlines = 1, line = text; line < &text[len]; nlines++)
+    {
+      FAR const char *eol = strchr(line, '\n');
+
+      eol = eol != NULL ? eol + 1 : &text[len];
+      if (eol - line >= CONFIG_NSH_LINELEN)
+        {
+          goto out;
+        }
+
+      line = eol;
+    }
+
+  *cacheable = true;
+
+  /* Each line gains a terminator, and the script an empty line */
+
+  script = malloc(len + nlines + 1);
+  if (script != NULL)
+    {
+      for (i = 0, dest = script; i < len; i++)
+        {
+          *dest++ = text[i];
+          if (text[i] == '\n')
+            {
+              *dest++ = '\0';
+            }
+        }
+
+      if (len > 0 && text[len - 1] != '\n')
+        {
+          *dest++ = '\0';
+        }
+
+      *dest = '\0';
+    }
+
+out:
+  free(text);
+  return script;
+}
+
+/****************************************************************************
+ * Name: nsh_rcreplay
+ *
+ * Description:
+ *   Execute the cached login script as nsh_script() executes the file.
+ *
+ ****************************************************************************/
+
+static int nsh_rcreplay(FAR struct nsh_vtbl_s *vtbl, FAR const char *script)
+{
+  FAR FILE *savestream;
+  FAR char *buffer;
+  int ret = OK;
+
+  buffer = nsh_linebuffer(vtbl);
+  if (!buffer)
+    {
+      return ERROR;
+    }
+
+  /* There is no script stream to seek in, so loops are refused */
+
+  savestream = vtbl->np.np_stream;
+  vtbl->np.np_stream = NULL;
+
+  while (*script != '\0' &&
+         (ret == OK || (vtbl->np.np_flags & NSH_PFLAG_IGNORE)))
+    {
+      /* Flush any output generated by the previous line */
+
+      fflush(stdout);
+
+      strlcpy(buffer, script, CONFIG_NSH_LINELEN);
+      script += strlen(script) + 1;
+
+      if ((vtbl->np.np_flags & NSH_PFLAG_SILENT) == 0)
+        {
+          nsh_output(vtbl, "%s", buffer);
+        }
+
+      ret = nsh_parse(vtbl, buffer);
+    }
+
+  vtbl->np.np_stream = savestream;
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -191,13 +399,46 @@ int nsh_initscript(FAR struct nsh_vtbl_s *vtbl)
  *
  * Description:
  *   Attempt to execute the configured login script.  This script
- *   should be executed when each NSH session starts.
+ *   should be executed when each NSH session starts.  With
+ *   CONFIG_NSH_ROMFSRC_CACHE, the first session reads the script into
+ *   memory and the later ones execute it from there.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NSH_ROMFSRC
 int nsh_loginscript(FAR struct nsh_vtbl_s *vtbl)
 {
+#ifdef CONFIG_NSH_ROMFSRC_CACHE
+  FAR char *script;
+  bool cacheable = true;
+
+  if (g_rcscript == NULL && !g_rcuncached)
+    {
+      script = nsh_rcload(&cacheable);
+
+      /* Keep the first copy if sessions raced to load it */
+
+      sched_lock();
+      if (!cacheable)
+        {
+          g_rcuncached = true;
+        }
+      else if (g_rcscript == NULL)
+        {
+          g_rcscript = script;
+          script     = NULL;
+        }
+
+      sched_unlock();
+      free(script);
+    }
+
+  if (g_rcscript != NULL)
+    {
+      return nsh_rcreplay(vtbl, g_rcscript);
+    }
+#endif
+
   return nsh_script(vtbl, "login", NSH_RCPATH);
 }
 #endif
@@ -278,6 +278,7 @@ int nsh_telnetstart(sa_family_t family)
       config.t_priority  = CONFIG_NSH_TELNETD_CLIENTPRIO;
       config.t_stacksize = CONFIG_NSH_TELNETD_CLIENTSTACKSIZE;
       config.t_entry     = nsh_telnetmain;
+      config.t_poolsize  = CONFIG_NSH_TELNETD_POOLSIZE;
 
       /* Start the telnet daemon */
 
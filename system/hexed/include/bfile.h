@@ -39,36 +39,71 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <stdio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* Buffer size/alignment */
+/* Page cache */
+
+#ifndef CONFIG_SYSTEM_HEXED_PAGESIZE
+#  define CONFIG_SYSTEM_HEXED_PAGESIZE  1024
+#endif
+
+#ifndef CONFIG_SYSTEM_HEXED_NPAGES
+#  define CONFIG_SYSTEM_HEXED_NPAGES    16
+#endif
 
-#define BFILE_BUF_MIN  0x1000
-#define BFILE_BUF_ALIGN(sz) \
-  ((sz + BFILE_BUF_MIN - 1) / BFILE_BUF_MIN * BFILE_BUF_MIN)
+#ifndef CONFIG_SYSTEM_HEXED_READAHEAD
+#  define CONFIG_SYSTEM_HEXED_READAHEAD 2
+#endif
+
+#if CONFIG_SYSTEM_HEXED_READAHEAD >= CONFIG_SYSTEM_HEXED_NPAGES
+#  error "Read-ahead must be less than the number of cached pages"
+#endif
+
+#define BFILE_PAGE_SZ  CONFIG_SYSTEM_HEXED_PAGESIZE
+#define BFILE_PAGE_CNT CONFIG_SYSTEM_HEXED_NPAGES
+#define BFILE_PAGE_ALIGN(off) \
+  ((off) / BFILE_PAGE_SZ * BFILE_PAGE_SZ)
 
 /* Buffered File flags */
 
 #define BFILE_FL_DIRTY 0x00000001
 
+/* Page flags */
+
+#define BFILE_PG_DIRTY 0x00000001
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* Cached page of a Buffered File */
+
+struct bfpage_s
+{
+  long off;                   /* File offset, -1 if unused */
+  int flags;
+  unsigned long age;          /* Time of last use */
+  FAR char *data;
+};
+
 /* Buffered File */
 
 struct bfile_s
 {
   FAR FILE *fp;
   FAR char *name;
-  long size;
+  long size;                  /* Size with the changes */
+  long disksz;                /* Size of the file on disk */
   int flags;
-  long bufsz;
-  FAR char *buf;
+  unsigned long clock;        /* Page use counter */
+  FAR char *tmp;              /* Two pages to move data through */
+  struct bfpage_s pages[BFILE_PAGE_CNT];
 };
 
 /****************************************************************************
@@ -81,6 +116,10 @@ struct bfile_s *bfopen(FAR char *name, FAR char *mode);
 int    bfclose(FAR struct bfile_s *bf);
 long   bfclip(FAR struct bfile_s *bf, long off, long sz);
 long   bfcopy(FAR struct bfile_s *bf, long dest, long src, long sz);
+long   bfcopyover(FAR struct bfile_s *bf, long dest, long src, long sz);
+long   bffind(FAR struct bfile_s *bf, long off, FAR const void *mem,
+              long sz);
+long   bfget(FAR struct bfile_s *bf, long off, FAR void *mem, long sz);
 long   bfinsert(FAR struct bfile_s *bf, long off, FAR void *mem, long sz);
 long   bfmove(FAR struct bfile_s *bf, long dest, long src, long sz);
 long   bfread(FAR struct bfile_s *bf);
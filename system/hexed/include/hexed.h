@@ -138,6 +138,7 @@ void hexed_fatal(FAR const char *fmt, ...);
 int  hexcopy(FAR struct command_s *cmd, int optc, FAR char *opt);
 int  hexdump(FAR struct command_s *cmd, int optc, FAR char *opt);
 int  hexenter(FAR struct command_s *cmd, int optc, FAR char *opt);
+int  hexfind(FAR struct command_s *cmd, int optc, FAR char *opt);
 int  hexhelp(FAR struct command_s *cmd, int optc, FAR char *opt);
 int  hexinsert(FAR struct command_s *cmd, int optc, FAR char *opt);
 int  hexmove(FAR struct command_s *cmd, int optc, FAR char *opt);
@@ -36,63 +36,444 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <errno.h>
 
 #include "bfile.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Written to fill holes in the file */
+
+static const char g_zeroes[64];
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-/* Allocate file buffer */
+/* Write zeroes to the file from off up to end */
 
-static FAR void *bfallocbuf(FAR struct bfile_s *bf, long sz)
+static int bfzero(FAR struct bfile_s *bf, long off, long end)
 {
-  FAR char *buf;
+  long len;
 
-  if (bf == NULL)
+  if (fseek(bf->fp, off, SEEK_SET) < 0)
+    {
+      return -errno;
+    }
+
+  for (; off < end; off += len)
+    {
+      len = end - off < (long)sizeof(g_zeroes) ?
+            end - off : (long)sizeof(g_zeroes);
+      if (fwrite(g_zeroes, 1, len, bf->fp) != (size_t)len)
+        {
+          return -EIO;
+        }
+    }
+
+  return 0;
+}
+
+/* Write a dirty page back to the file
+ *
+ * Only the part of the page inside the file is written.  Not every file
+ * system can seek past the end of a file, so a hole before the page is
+ * filled first.
+ */
+
+static int bfsyncpage(FAR struct bfile_s *bf, FAR struct bfpage_s *pg)
+{
+  long len;
+  int ret;
+
+  if ((pg->flags & BFILE_PG_DIRTY) == 0)
+    {
+      return 0;
+    }
+
+  len = bf->size - pg->off;
+  if (len > BFILE_PAGE_SZ)
+    {
+      len = BFILE_PAGE_SZ;
+    }
+
+  if (len > 0)
+    {
+      if (pg->off > bf->disksz)
+        {
+          ret = bfzero(bf, bf->disksz, pg->off);
+          if (ret < 0)
+            {
+              fprintf(stderr, "ERROR: Write to file failed: %d\n", ret);
+              return ret;
+            }
+
+          bf->disksz = pg->off;
+        }
+
+      if (fseek(bf->fp, pg->off, SEEK_SET) < 0 ||
+          fwrite(pg->data, 1, len, bf->fp) != (size_t)len)
+        {
+          fprintf(stderr, "ERROR: Write to file failed: %d\n", errno);
+          return -EIO;
+        }
+
+      if (pg->off + len > bf->disksz)
+        {
+          bf->disksz = pg->off + len;
+        }
+    }
+
+  pg->flags &= ~BFILE_PG_DIRTY;
+  return 0;
+}
+
+/* Find a page in the cache */
+
+static FAR struct bfpage_s *bffindpage(FAR struct bfile_s *bf, long off)
+{
+  int i;
+
+  for (i = 0; i < BFILE_PAGE_CNT; i++)
+    {
+      if (bf->pages[i].off == off)
+        {
+          return &bf->pages[i];
+        }
+    }
+
+  return NULL;
+}
+
+/* Load a page into the cache
+ *
+ * Takes an unused page or writes back and reuses the least recently used
+ * one.  What is past the end of the file on disk reads as zeroes.
+ */
+
+static FAR struct bfpage_s *bfloadpage(FAR struct bfile_s *bf, long off)
+{
+  FAR struct bfpage_s *pg = NULL;
+  long len;
+  int i;
+
+  for (i = 0; i < BFILE_PAGE_CNT; i++)
+    {
+      if (bf->pages[i].off < 0)
+        {
+          pg = &bf->pages[i];
+          break;
+        }
+
+      if (pg == NULL || bf->pages[i].age < pg->age)
+        {
+          pg = &bf->pages[i];
+        }
+    }
+
+  if (pg->off >= 0 && bfsyncpage(bf, pg) < 0)
     {
       return NULL;
     }
 
-  /* Allocate buffer */
+  pg->off = -1;
+
+  /* Allocate the page on first use */
 
-  sz = BFILE_BUF_ALIGN(sz);
-  if ((buf = realloc(bf->buf, sz)) == NULL)
+  if (pg->data == NULL && (pg->data = malloc(BFILE_PAGE_SZ)) == NULL)
     {
       return NULL;
     }
 
-  bf->buf = buf;
+  len = (bf->disksz < bf->size ? bf->disksz : bf->size) - off;
+  if (len > BFILE_PAGE_SZ)
+    {
+      len = BFILE_PAGE_SZ;
+    }
+  else if (len < 0)
+    {
+      len = 0;
+    }
+
+  if (len > 0)
+    {
+      if (fseek(bf->fp, off, SEEK_SET) < 0)
+        {
+          return NULL;
+        }
+
+      len = fread(pg->data, 1, len, bf->fp);
+    }
+
+  memset(pg->data + len, 0, BFILE_PAGE_SZ - len);
+
+  pg->off   = off;
+  pg->flags = 0;
+  pg->age   = bf->clock;
+  return pg;
+}
+
+/* Get the page at off, reading ahead the pages after it */
+
+static FAR struct bfpage_s *bfgetpage(FAR struct bfile_s *bf, long off)
+{
+  FAR struct bfpage_s *pg;
+  long next;
+  int i;
+
+  bf->clock++;
+
+  pg = bffindpage(bf, off);
+  if (pg == NULL)
+    {
+      pg = bfloadpage(bf, off);
+      if (pg == NULL)
+        {
+          return NULL;
+        }
+
+      for (i = 1; i <= CONFIG_SYSTEM_HEXED_READAHEAD; i++)
+        {
+          next = off + i * BFILE_PAGE_SZ;
+          if (next >= bf->disksz || next >= bf->size)
+            {
+              break;
+            }
+
+          if (bffindpage(bf, next) == NULL &&
+              bfloadpage(bf, next) == NULL)
+            {
+              break;
+            }
+        }
+    }
+
+  pg->age = bf->clock;
+  return pg;
+}
+
+/* Read from or write to the pages
+ *
+ * Writes zeroes if mem is NULL.  Does not change the file size.
+ */
 
-  /* Clear new memory */
+static long bfaccess(FAR struct bfile_s *bf, long off, FAR void *mem,
+                     long sz, bool write)
+{
+  FAR struct bfpage_s *pg;
+  FAR char *ptr = mem;
+  long base;
+  long pos;
+  long len;
+  long cnt;
 
-  if (sz > bf->bufsz)
+  for (cnt = sz; cnt > 0; cnt -= len, off += len)
     {
-      memset(bf->buf + bf->bufsz, 0, sz - bf->bufsz);
+      base = BFILE_PAGE_ALIGN(off);
+      pos  = off - base;
+      len  = BFILE_PAGE_SZ - pos < cnt ? BFILE_PAGE_SZ - pos : cnt;
+
+      if ((pg = bfgetpage(bf, base)) == NULL)
+        {
+          return EOF;
+        }
+
+      if (!write)
+        {
+          memcpy(ptr, pg->data + pos, len);
+        }
+      else
+        {
+          if (ptr != NULL)
+            {
+              memcpy(pg->data + pos, ptr, len);
+            }
+          else
+            {
+              memset(pg->data + pos, 0, len);
+            }
+
+          pg->flags |= BFILE_PG_DIRTY;
+        }
+
+      if (ptr != NULL)
+        {
+          ptr += len;
+        }
     }
 
-  bf->bufsz = sz;
-  return bf->buf;
+  return sz;
+}
+
+/* Move bytes inside the file like memmove()
+ *
+ * Moves data a page at a time, from the end if dest is after src.
+ */
+
+static long bfmemmove(FAR struct bfile_s *bf, long dest, long src, long sz)
+{
+  long len;
+  long cnt;
+
+  if (dest == src || sz <= 0)
+    {
+      return 0;
+    }
+
+  for (cnt = sz; cnt > 0; cnt -= len)
+    {
+      len = cnt < BFILE_PAGE_SZ ? cnt : BFILE_PAGE_SZ;
+
+      if (dest > src)
+        {
+          if (bfaccess(bf, src + cnt - len, bf->tmp, len, false) < 0 ||
+              bfaccess(bf, dest + cnt - len, bf->tmp, len, true) < 0)
+            {
+              return EOF;
+            }
+        }
+      else
+        {
+          if (bfaccess(bf, src + sz - cnt, bf->tmp, len, false) < 0 ||
+              bfaccess(bf, dest + sz - cnt, bf->tmp, len, true) < 0)
+            {
+              return EOF;
+            }
+        }
+    }
+
+  bf->flags |= BFILE_FL_DIRTY;
+  return sz;
+}
+
+/* Reverse the bytes from off up to end */
+
+static long bfreverse(FAR struct bfile_s *bf, long off, long end)
+{
+  FAR char *lo = bf->tmp;
+  FAR char *hi = bf->tmp + BFILE_PAGE_SZ;
+  char c;
+  long len;
+  long i;
+
+  while (end - off > 1)
+    {
+      len = (end - off) / 2;
+      if (len > BFILE_PAGE_SZ)
+        {
+          len = BFILE_PAGE_SZ;
+        }
+
+      if (bfaccess(bf, off, lo, len, false) < 0 ||
+          bfaccess(bf, end - len, hi, len, false) < 0)
+        {
+          return EOF;
+        }
+
+      for (i = 0; i < len / 2; i++)
+        {
+          c               = lo[i];
+          lo[i]           = lo[len - 1 - i];
+          lo[len - 1 - i] = c;
+          c               = hi[i];
+          hi[i]           = hi[len - 1 - i];
+          hi[len - 1 - i] = c;
+        }
+
+      if (bfaccess(bf, off, hi, len, true) < 0 ||
+          bfaccess(bf, end - len, lo, len, true) < 0)
+        {
+          return EOF;
+        }
+
+      off += len;
+      end -= len;
+    }
+
+  return 0;
+}
+
+/* Change the size of the file
+ *
+ * What is cut off is dropped from the cache and from the file on disk, so
+ * that the file reads as zeroes there if it grows again.
+ */
+
+static int bfresize(FAR struct bfile_s *bf, long sz)
+{
+  FAR struct bfpage_s *pg;
+  int i;
+
+  if (sz < bf->size)
+    {
+      for (i = 0; i < BFILE_PAGE_CNT; i++)
+        {
+          pg = &bf->pages[i];
+          if (pg->off >= sz)
+            {
+              pg->off   = -1;
+              pg->flags = 0;
+            }
+          else if (pg->off >= 0 && pg->off + BFILE_PAGE_SZ > sz)
+            {
+              memset(pg->data + sz - pg->off, 0,
+                     pg->off + BFILE_PAGE_SZ - sz);
+            }
+        }
+
+      if (bf->disksz > sz)
+        {
+          if (ftruncate(fileno(bf->fp), sz) < 0)
+            {
+              return -errno;
+            }
+
+          bf->disksz = sz;
+        }
+    }
+
+  if (sz != bf->size)
+    {
+      bf->size   = sz;
+      bf->flags |= BFILE_FL_DIRTY;
+    }
+
+  return 0;
 }
 
 /* Free a buffered file */
 
 static int bffree(FAR struct bfile_s *bf)
 {
+  int i;
+
   if (bf == NULL)
     {
       return -EBADF;
     }
 
-  /* Free buffer */
+  /* Free pages */
 
-  if (bf->buf != NULL)
+  for (i = 0; i < BFILE_PAGE_CNT; i++)
     {
-      free(bf->buf);
+      if (bf->pages[i].data != NULL)
+        {
+          free(bf->pages[i].data);
+        }
+    }
+
+  if (bf->tmp != NULL)
+    {
+      free(bf->tmp);
     }
 
   /* Free file name */
@@ -130,25 +511,36 @@ long fsize(FILE * fp)
   return sz;
 }
 
+/* Set the file size and write the changes to the file */
+
 long bftruncate(FAR struct bfile_s *bf, long sz)
 {
+  int ret;
+
   if (bf == NULL)
     {
       return -EBADF;
     }
 
-  /* Reopen file with truncate */
+  ret = bfresize(bf, sz);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-  bf->fp = freopen(bf->name, "w+", bf->fp);
   return bfflush(bf);
 }
 
-/* Flush buffer data to the file */
+/* Flush buffer data to the file
+ *
+ * Only the dirty pages are written, in the order of their offsets.
+ */
 
 int bfflush(FAR struct bfile_s *bf)
 {
-  ssize_t nread;
+  FAR struct bfpage_s *pg;
   int ret = OK;
+  int i;
 
   if (bf == NULL)
     {
@@ -162,25 +554,45 @@ int bfflush(FAR struct bfile_s *bf)
       return 0;
     }
 
-  /* Write file */
+  /* Write the dirty pages */
 
-  fseek(bf->fp, 0, SEEK_SET);
-  nread = fwrite(bf->buf, 1, bf->size, bf->fp);
-  if (nread < 0)
+  do
     {
-      int errcode = errno;
-      fprintf(stderr, "ERROR: Write to file failed: %d\n", errcode);
-      ret = -errcode;
+      pg = NULL;
+      for (i = 0; i < BFILE_PAGE_CNT; i++)
+        {
+          if ((bf->pages[i].flags & BFILE_PG_DIRTY) != 0 &&
+              (pg == NULL || bf->pages[i].off < pg->off))
+            {
+              pg = &bf->pages[i];
+            }
+        }
+
+      if (pg != NULL)
+        {
+          ret = bfsyncpage(bf, pg);
+        }
     }
-  else if (fwrite(bf->buf, 1, bf->size, bf->fp) == bf->size)
+  while (pg != NULL && ret == OK);
+
+  /* Zeroes at the end that were never written */
+
+  if (ret == OK && bf->disksz < bf->size)
     {
-      fprintf(stderr, "ERROR: Bad write size\n");
-      ret = -EIO;
+      ret = bfzero(bf, bf->disksz, bf->size);
+      if (ret < 0)
+        {
+          fprintf(stderr, "ERROR: Write to file failed: %d\n", ret);
+        }
+      else
+        {
+          bf->disksz = bf->size;
+        }
     }
-  else
+
+  if (ret == OK)
     {
       bf->flags &= ~BFILE_FL_DIRTY;
-      ret = OK;
     }
 
   fflush(bf->fp);
@@ -192,6 +604,7 @@ int bfflush(FAR struct bfile_s *bf)
 FAR struct bfile_s *bfopen(char *name, char *mode)
 {
   FAR struct bfile_s *bf;
+  int i;
 
   /* NULL file name */
 
@@ -209,6 +622,11 @@ FAR struct bfile_s *bfopen(char *name, char *mode)
 
   memset(bf, 0, sizeof(struct bfile_s));
 
+  for (i = 0; i < BFILE_PAGE_CNT; i++)
+    {
+      bf->pages[i].off = -1;
+    }
+
   /* Set file name */
 
   if ((bf->name = malloc(strlen(name) + 1)) == NULL)
@@ -219,24 +637,26 @@ FAR struct bfile_s *bfopen(char *name, char *mode)
 
   strcpy(bf->name, name);
 
-  /* Open file */
+  /* Allocate the buffer that data is moved through */
 
-  if ((bf->fp = fopen(bf->name, mode)) == NULL)
+  if ((bf->tmp = malloc(2 * BFILE_PAGE_SZ)) == NULL)
     {
       bffree(bf);
       return NULL;
     }
 
-  /* Set file buffer */
+  /* Open file.  The pages are the buffer, so stdio need not keep one. */
 
-  bf->buf = NULL;
-  bf->size = fsize(bf->fp);
-  if (bfallocbuf(bf, bf->size) == NULL)
+  if ((bf->fp = fopen(bf->name, mode)) == NULL)
     {
-      bfclose(bf);
+      bffree(bf);
       return NULL;
     }
 
+  setvbuf(bf->fp, NULL, _IONBF, 0);
+
+  bf->size   = fsize(bf->fp);
+  bf->disksz = bf->size;
   return bf;
 }
 
@@ -262,7 +682,7 @@ int bfclose(FAR struct bfile_s *bf)
 
 /* Remove bytes from the Buffered File
  *
- * Moves the data from the end of the buffer, then shrinks the file
+ * Moves the data from the end of the file, then shrinks the file
  * size.
  */
 
@@ -299,12 +719,12 @@ long bfclip(FAR struct bfile_s *bf, long off, long sz)
   /* Remove from file */
 
   cnt = bf->size - (off + sz);
-  memmove(bf->buf + off, bf->buf + off + sz, cnt);
-
-  bf->size  -= sz;
-  bf->flags |= BFILE_FL_DIRTY;
+  if (bfmemmove(bf, off, off + sz, cnt) < 0 ||
+      bfresize(bf, bf->size - sz) < 0)
+    {
+      return EOF;
+    }
 
-  memset(bf->buf + bf->size, 0, sz);
   return cnt;
 }
 
@@ -330,34 +750,27 @@ long bfinsert(FAR struct bfile_s *bf, long off, void *mem, long sz)
       return EOF;
     }
 
-  /* Increase buffer size */
+  /* Increase file size, filling a gap with zeroes */
 
-  if (bf->bufsz < (bf->size + off + sz))
+  if (off > bf->size && bfresize(bf, off) < 0)
     {
-      if (bfallocbuf(bf, bf->size + off + sz) == NULL)
-        {
-          return EOF;
-        }
+      return EOF;
     }
 
-  /* Move data */
-
-  if (off < bf->size)
+  cnt = bf->size - off;
+  if (bfresize(bf, bf->size + sz) < 0)
     {
-      cnt = bf->size - off;
-      memmove(bf->buf + off + sz, bf->buf + off, cnt);
+      return EOF;
     }
 
-  memmove(bf->buf + off, mem, sz);
-
-  /* Increase file size */
+  /* Move data */
 
-  if (off > bf->size)
+  if (bfmemmove(bf, off + sz, off, cnt) < 0 ||
+      bfaccess(bf, off, mem, sz, true) < 0)
     {
-      bf->size += off - bf->size;
+      return EOF;
     }
 
-  bf->size += sz;
   bf->flags |= BFILE_FL_DIRTY;
   return sz;
 }
@@ -366,6 +779,9 @@ long bfinsert(FAR struct bfile_s *bf, long off, void *mem, long sz)
 
 long bfcopy(FAR struct bfile_s *bf, long off, long src, long sz)
 {
+  long cnt;
+  long len;
+
   if (bf == NULL)
     {
       return EOF;
@@ -373,44 +789,94 @@ long bfcopy(FAR struct bfile_s *bf, long off, long src, long sz)
 
   /* Error: Source past EOF */
 
-  if (src > bf->size)
+  if (src > bf->size || off < 0 || sz <= 0)
     {
       return EOF;
     }
 
   /* Adjust sz to EOF */
 
-  if ((src > off) && (src + sz > bf->size))
+  if (src + sz > bf->size)
     {
       sz = bf->size - src;
     }
 
-  /* Adjust source/length for insert */
+  /* Make room at off */
+
+  if (off > bf->size && bfresize(bf, off) < 0)
+    {
+      return EOF;
+    }
+
+  cnt = bf->size - off;
+  if (bfresize(bf, bf->size + sz) < 0 ||
+      bfmemmove(bf, off + sz, off, cnt) < 0)
+    {
+      return EOF;
+    }
+
+  /* Fill it from the source, which moved along if it was after off */
 
   if (src >= off)
     {
-      if (src + sz > bf->size)
-        {
-          sz = bf->size - src;
-        }
+      return bfmemmove(bf, off, src + sz, sz);
+    }
 
-      src += sz;
+  len = off - src < sz ? off - src : sz;
+  if (bfmemmove(bf, off, src, len) < 0 ||
+      bfmemmove(bf, off + len, off + sz, sz - len) < 0)
+    {
+      return EOF;
     }
 
-  return bfinsert(bf, off, bf->buf + src, sz);
+  return sz;
+}
+
+/* Copies bytes from src over the bytes at off */
+
+long bfcopyover(FAR struct bfile_s *bf, long off, long src, long sz)
+{
+  if (bf == NULL)
+    {
+      return EOF;
+    }
+
+  /* Error: Source past EOF */
+
+  if (src > bf->size || off < 0 || sz <= 0)
+    {
+      return EOF;
+    }
+
+  /* Adjust sz to EOF */
+
+  if (src + sz > bf->size)
+    {
+      sz = bf->size - src;
+    }
+
+  /* Increase file size */
+
+  if (off + sz > bf->size && bfresize(bf, off + sz) < 0)
+    {
+      return EOF;
+    }
+
+  return bfmemmove(bf, off, src, sz);
 }
 
 /* Moves bytes from src to off
  *
- * Moves the data from src to off then removes the data from the original src
- * Moves data in chunks to save memory allocation
+ * Moves the data from src to off then removes the data from the original
+ * src.  off is where the data ends up.  The data is rotated into place a
+ * page at a time, so only the bytes between src and off are touched.
  */
 
 long bfmove(FAR struct bfile_s *bf, long off, long src, long sz)
 {
-  long adj;
-  long cnt;
-  long len;
+  long start;
+  long end;
+  long mid;
 
   if (bf == NULL)
     {
@@ -419,118 +885,178 @@ long bfmove(FAR struct bfile_s *bf, long off, long src, long sz)
 
   /* Error: source past EOF */
 
-  if (src > bf->size)
+  if (src > bf->size || off < 0 || sz < 0)
     {
       return EOF;
     }
 
-  /* Edjust sz to EOF */
+  /* Adjust sz and off to EOF */
 
-  if ((src > off) && (src + sz > bf->size))
+  if (src + sz > bf->size)
     {
       sz = bf->size - src;
     }
 
-  /* Adjust source/offset */
+  if (off + sz > bf->size)
+    {
+      off = bf->size - sz;
+    }
 
-  len = BFILE_BUF_MIN > sz ? sz : BFILE_BUF_MIN;
-  if (src > off)
+  if (sz == 0 || off == src)
     {
-      src += len;
-      adj = len;
+      return sz;
+    }
+
+  /* Rotate the range so that the data at mid comes first */
+
+  if (src < off)
+    {
+      start = src;
+      mid   = src + sz;
+      end   = off + sz;
     }
   else
     {
-      off += sz;
-      adj = 0;
+      start = off;
+      mid   = src;
+      end   = src + sz;
     }
 
-  /* Move data in chunks */
+  if (bfreverse(bf, start, mid) < 0 || bfreverse(bf, mid, end) < 0 ||
+      bfreverse(bf, start, end) < 0)
+    {
+      return EOF;
+    }
 
-  for (cnt = sz; cnt; cnt -= len)
+  bf->flags |= BFILE_FL_DIRTY;
+  return sz;
+}
+
+/* Find bytes in the Buffered File
+ *
+ * Streams through the file from off, two pages at a time, and returns the
+ * offset of the first match or EOF.
+ */
+
+long bffind(FAR struct bfile_s *bf, long off, FAR const void *mem, long sz)
+{
+  FAR const char *ptr = mem;
+  FAR char *cur;
+  FAR char *last;
+  long len;
+
+  if (bf == NULL || off < 0 || sz <= 0 || sz > BFILE_PAGE_SZ)
     {
-      /* End of count? */
+      return EOF;
+    }
+
+  while (off + sz <= bf->size)
+    {
+      len = bf->size - off;
+      if (len > 2 * BFILE_PAGE_SZ)
+        {
+          len = 2 * BFILE_PAGE_SZ;
+        }
 
-      if (cnt < len)
+      if (bfaccess(bf, off, bf->tmp, len, false) < 0)
         {
-          len = cnt;
+          return EOF;
         }
 
-      /* Move data */
+      /* Look for the first byte, then compare the rest */
+
+      cur  = bf->tmp;
+      last = bf->tmp + len - sz;
 
-      bfinsert(bf, off, bf->buf + src, len);
-      bfclip(bf, src, len);
-      off += adj;
+      while (cur <= last &&
+             (cur = memchr(cur, *ptr, last - cur + 1)) != NULL)
+        {
+          if (memcmp(cur, ptr, sz) == 0)
+            {
+              return off + (cur - bf->tmp);
+            }
+
+          cur++;
+        }
+
+      /* The next window overlaps this one by less than the pattern */
+
+      off += len - sz + 1;
     }
 
-  return sz;
+  return EOF;
 }
 
-/* Read Buffered File
+/* Get bytes from the Buffered File
  *
- * Reads an entire file to the buffer.
+ * Reads up to sz bytes at off and returns how many there were.
  */
 
-long bfread(FAR struct bfile_s *bf)
+long bfget(FAR struct bfile_s *bf, long off, FAR void *mem, long sz)
 {
-  long r;
-
-  if (bf == NULL)
+  if (bf == NULL || off < 0 || off > bf->size)
     {
       return EOF;
     }
 
-  /* Check buffer size */
-
-  bf->size = fsize(bf->fp);
-  if (bf->size > bf->bufsz)
+  if (off + sz > bf->size)
     {
-      if (bfallocbuf(bf, bf->size) == NULL)
-        {
-          return EOF;
-        }
+      sz = bf->size - off;
     }
 
-  /* Read whole file into the buffer */
+  return sz > 0 ? bfaccess(bf, off, mem, sz, false) : 0;
+}
 
-  if ((r = fread(bf->buf, 1, bf->size, bf->fp)) == bf->size)
+/* Read Buffered File
+ *
+ * Drops the cached pages and their changes.  The pages are read from the
+ * file as they are needed.
+ */
+
+long bfread(FAR struct bfile_s *bf)
+{
+  int i;
+
+  if (bf == NULL)
     {
-      bf->flags &= ~BFILE_FL_DIRTY;
+      return EOF;
     }
 
-  return r;
+  for (i = 0; i < BFILE_PAGE_CNT; i++)
+    {
+      bf->pages[i].off   = -1;
+      bf->pages[i].flags = 0;
+    }
+
+  bf->size   = fsize(bf->fp);
+  bf->disksz = bf->size;
+  bf->flags &= ~BFILE_FL_DIRTY;
+  return bf->size;
 }
 
 /* Write Buffered File
  *
- * Writes data to the buffer, the buffer still needs to be flushed
+ * Writes data to the pages, the pages still need to be flushed
  * to the file before closing or reading.
  */
 
 long bfwrite(FAR struct bfile_s *bf, long off, void *mem, long sz)
 {
-  if (bf == NULL)
+  if (bf == NULL || off < 0 || sz <= 0)
     {
       return EOF;
     }
 
-  /* Increase buffer size */
+  /* Increase file size */
 
-  if (bf->bufsz < off + sz)
+  if (bf->size < off + sz && bfresize(bf, off + sz) < 0)
     {
-      if (bfallocbuf(bf, off + sz) == NULL)
-        {
-          return EOF;
-        }
+      return EOF;
     }
 
-  memmove(bf->buf + off, mem, sz);
-
-  /* Increase file size */
-
-  if (bf->size < off + sz)
+  if (bfaccess(bf, off, mem, sz, true) < 0)
     {
-      bf->size = off + sz;
+      return EOF;
     }
 
   bf->flags |= BFILE_FL_DIRTY;
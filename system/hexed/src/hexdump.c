@@ -51,6 +51,7 @@
 
 static int rundump(FAR struct command_s *cmd)
 {
+  uint64_t line[2];
   unsigned char *cur;
   int x, i;
   long off, last;
@@ -76,14 +77,19 @@ static int rundump(FAR struct command_s *cmd)
       cmd->opts.bytes = g_hexfile->size - cmd->opts.src;
     }
 
-  /* Show file */
+  /* Show file, reading one line at a time */
 
-  cur  = (unsigned char *)(g_hexfile->buf + cmd->opts.src);
+  cur  = (unsigned char *)line;
   off  = cmd->opts.src;
   last = cmd->opts.src + cmd->opts.bytes;
 
-  for (; off < last; off += 0x10, cur += 0x10)
+  for (; off < last; off += 0x10)
     {
+      if (bfget(g_hexfile, off, cur, 0x10) == EOF)
+        {
+          return EOF;
+        }
+
       printf("%08lx ", off);
 
       /* Print hex values */
@@ -163,7 +163,7 @@ int hexcmd(FAR struct command_s *cmd, int optc, FAR char *opt)
       break;
 
     case CMD_FIND:
-      optc = 0;
+      optc = hexfind(cmd, optc, opt);
       break;
 
     case CMD_HELP:
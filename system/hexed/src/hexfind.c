@@ -0,0 +1,168 @@
+/****************************************************************************
+ * apps/system/hexed/src/hexfind.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bfile.h"
+#include "hexed.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Show the offset of each match of the values from src */
+
+static int runfind(FAR struct command_s *cmd)
+{
+  long off;
+
+  if (cmd->opts.bytes == 0)
+    {
+      fprintf(stderr, "ERROR: No values to find\n");
+      return -EINVAL;
+    }
+
+  off = cmd->opts.src;
+  while ((off = bffind(g_hexfile, off, cmd->opts.buf,
+                       cmd->opts.bytes)) != EOF)
+    {
+      printf("%08lx\n", off);
+      off++;
+    }
+
+  return 0;
+}
+
+/* Set the find command */
+
+static int setfind(FAR struct command_s *cmd, int optc, FAR char *opt)
+{
+  FAR char *s;
+  FAR int64_t *hx;
+  int64_t v;
+
+  /* Set defaults */
+
+  if (optc == 0)
+    {
+      cmd->flags |= CMD_FL_QUIT;
+    }
+
+  /* NULL option */
+
+  if (opt == NULL)
+    {
+      return -EINVAL;
+    }
+
+  v = strtoll(opt, &s, 0x10);
+
+  /* No value set in option */
+
+  if (s == opt)
+    {
+      return -EINVAL;
+    }
+
+  /* Set source */
+
+  if (optc == 0)
+    {
+      cmd->opts.src = v;
+      optc++;
+
+      /* Set values */
+    }
+  else if (optc > 0 && cmd->opts.cnt < OPT_BUF_SZ)
+    {
+      hx = cmd->opts.buf;
+      switch (cmd->opts.word)
+        {
+        case WORD_64:
+          *(hx + cmd->opts.cnt) = v;
+          break;
+
+        case WORD_32:
+          *((int32_t *)hx + cmd->opts.cnt) = v;
+          break;
+
+        case WORD_16:
+          *((int16_t *)hx + cmd->opts.cnt) = v;
+          break;
+
+        case WORD_8:
+          *((int8_t *)hx + cmd->opts.cnt) = v;
+          break;
+
+        default:
+          break;
+        }
+
+      cmd->opts.cnt++;
+      cmd->opts.bytes = cmd->opts.cnt * cmd->opts.word;
+      optc++;
+    }
+
+  /* Buffer overflow */
+
+  else
+    {
+      fprintf(stderr, "ERROR: too many values set\n");
+      return -E2BIG;
+    }
+
+  return optc;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Find command */
+
+int hexfind(FAR struct command_s *cmd, int optc, char *opt)
+{
+  /* Invalid command */
+
+  if (cmd == NULL || cmd->id != CMD_FIND)
+    {
+      return -EINVAL;
+    }
+
+  /* Set/run find */
+
+  if (optc >= 0)
+    {
+      optc = setfind(cmd, optc, opt);
+    }
+  else
+    {
+      optc = runfind(cmd);
+    }
+
+  return optc;
+}
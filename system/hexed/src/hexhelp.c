@@ -55,7 +55,7 @@ static const char *helpmsg[] =
   "  -c [src] [dest] [len]         Copy data from src to dest for len words\n",
   "  -d [src] [len]                Display data from src for len words\n",
   "  -e [dest] [...]               Enter hex values [...] at dest\n",
-  NULL,
+  "  -f [src] [...]                Find hex values [...] from src\n",
   "  -i [dest] [cnt] [...]         Insert hex values [...] at dest repeating cnt"
   "\n                                times. Defaults to 0 for empty hex values.\n",
   "  -mo [src] [dest] [len]        Move data from src overwriting dest for len\n"
@@ -93,6 +93,7 @@ static int runhelp(FAR struct command_s *cmd)
   printf("%s", helpmsg[CMD_COPY_OVER]);
   printf("%s", helpmsg[CMD_DUMP]);
   printf("%s", helpmsg[CMD_ENTER]);
+  printf("%s", helpmsg[CMD_FIND]);
   printf("%s", helpmsg[CMD_INSERT]);
   printf("%s", helpmsg[CMD_MOVE]);
   printf("%s", helpmsg[CMD_MOVE_OVER]);
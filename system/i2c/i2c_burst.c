@@ -0,0 +1,133 @@
+/****************************************************************************
+ * apps/system/i2c/i2c_burst.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include <nuttx/i2c/i2c_master.h>
+
+#include "i2ctool.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2ctool_burst_get
+ *
+ * Description:
+ *   Read "nbytes" consecutive bytes starting at "regaddr" in a single
+ *   I2CIOC_TRANSFER.  The device must auto-increment its register index.
+ *
+ ****************************************************************************/
+
+int i2ctool_burst_get(FAR struct i2ctool_s *i2ctool, int fd,
+                      uint8_t regaddr, FAR uint8_t *buf, int nbytes)
+{
+  struct i2c_msg_s msg[2];
+  int ret;
+
+  if (i2ctool->hasregindx)
+    {
+      msg[0].frequency = i2ctool->freq;
+      msg[0].addr      = i2ctool->addr;
+      msg[0].flags     = I2C_M_NOSTOP;
+      msg[0].buffer    = &regaddr;
+      msg[0].length    = 1;
+
+      msg[1].frequency = i2ctool->freq;
+      msg[1].addr      = i2ctool->addr;
+      msg[1].flags     = I2C_M_READ;
+      msg[1].buffer    = buf;
+      msg[1].length    = nbytes;
+
+      if (i2ctool->start)
+        {
+          ret = i2cdev_transfer(fd, &msg[0], 1);
+          if (ret == OK)
+            {
+              ret = i2cdev_transfer(fd, &msg[1], 1);
+            }
+        }
+      else
+        {
+          ret = i2cdev_transfer(fd, msg, 2);
+        }
+    }
+  else
+    {
+      /* no register index "-r" has been specified so
+       * we do a pure read (no write of index)
+       */
+
+      msg[0].frequency = i2ctool->freq;
+      msg[0].addr      = i2ctool->addr;
+      msg[0].flags     = I2C_M_READ;
+      msg[0].buffer    = buf;
+      msg[0].length    = nbytes;
+
+      ret = i2cdev_transfer(fd, msg, 1);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: i2ctool_burst_set
+ *
+ * Description:
+ *   Write "nbytes" bytes to consecutive registers starting at "regaddr".
+ *   The register index and all of the data go out in one message so that
+ *   the whole block costs a single START/STOP.
+ *
+ ****************************************************************************/
+
+int i2ctool_burst_set(FAR struct i2ctool_s *i2ctool, int fd,
+                      uint8_t regaddr, FAR const uint8_t *buf, int nbytes)
+{
+  uint8_t block[MAX_DUMP_CNT + 1];
+  struct i2c_msg_s msg;
+  int offset = 0;
+
+  if (nbytes < 1 || nbytes > MAX_DUMP_CNT)
+    {
+      return -EINVAL;
+    }
+
+  if (i2ctool->hasregindx)
+    {
+      block[offset++] = regaddr;
+    }
+
+  memcpy(&block[offset], buf, nbytes);
+
+  msg.frequency = i2ctool->freq;
+  msg.addr      = i2ctool->addr;
+  msg.flags     = 0;
+  msg.buffer    = block;
+  msg.length    = offset + nbytes;
+
+  return i2cdev_transfer(fd, &msg, 1);
+}
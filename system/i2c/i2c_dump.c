@@ -34,65 +34,6 @@
  * Public Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: i2ctool_dump
- ****************************************************************************/
-
-static int i2ctool_dump(FAR struct i2ctool_s *i2ctool, int fd,
-                        uint8_t regaddr, FAR uint8_t *buf, int nbytes)
-{
-  struct i2c_msg_s msg[2];
-  int ret;
-
-  /* Set up data structures */
-
-  if (i2ctool->hasregindx)
-    {
-      msg[0].frequency = i2ctool->freq;
-      msg[0].addr      = i2ctool->addr;
-      msg[0].flags     = I2C_M_NOSTOP;
-      msg[0].buffer    = &regaddr;
-      msg[0].length    = 1;
-
-      msg[1].frequency = i2ctool->freq;
-      msg[1].addr      = i2ctool->addr;
-      msg[1].flags     = I2C_M_READ;
-
-      msg[1].buffer = buf;
-      msg[1].length = nbytes;
-
-      if (i2ctool->start)
-        {
-          ret = i2cdev_transfer(fd, &msg[0], 1);
-          if (ret == OK)
-            {
-              ret = i2cdev_transfer(fd, &msg[1], 1);
-            }
-        }
-      else
-        {
-          ret = i2cdev_transfer(fd, msg, 2);
-        }
-    }
-  else
-    {
-      /* no register index "-r" has been specified so
-       * we do a pure read (no write of index)
-       */
-
-      msg[0].frequency = i2ctool->freq;
-      msg[0].addr      = i2ctool->addr;
-      msg[0].flags     = I2C_M_READ;
-
-      msg[0].buffer = buf;
-      msg[0].length = nbytes;
-
-      ret = i2cdev_transfer(fd, msg, 1);
-    }
-
-  return ret;
-}
-
 /****************************************************************************
  * Name: i2ccmd_dump
  ****************************************************************************/
@@ -174,9 +115,9 @@ int i2ccmd_dump(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv)
       goto errout_with_fildes;
     }
 
-  /* Read from the I2C bus */
+  /* Read from the I2C bus in a single burst */
 
-  ret = i2ctool_dump(i2ctool, fd, regaddr, buf, dumpcnt);
+  ret = i2ctool_burst_get(i2ctool, fd, regaddr, buf, dumpcnt);
 
   /* Display the result */
 
@@ -30,6 +30,57 @@
 
 #include "i2ctool.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2ctool_getblock
+ *
+ * Description:
+ *   Read "nregs" auto-incremented 8-bit registers with as few transfers as
+ *   possible (one per MAX_DUMP_CNT bytes) and display them.
+ *
+ ****************************************************************************/
+
+static int i2ctool_getblock(FAR struct i2ctool_s *i2ctool, int fd,
+                            FAR const char *cmd, long nregs)
+{
+  uint8_t buf[MAX_DUMP_CNT];
+  uint8_t regaddr = i2ctool->regaddr;
+  int chunk;
+  int ret = OK;
+  int i;
+
+  while (nregs > 0)
+    {
+      chunk = MAX_DUMP_CNT;
+      if (chunk > nregs)
+        {
+          chunk = nregs;
+        }
+
+      ret = i2ctool_burst_get(i2ctool, fd, regaddr, buf, chunk);
+      if (ret != OK)
+        {
+          i2ctool_printf(i2ctool, g_i2cxfrerror, cmd, -ret);
+          break;
+        }
+
+      for (i = 0; i < chunk; i++, regaddr++)
+        {
+          i2ctool_printf(i2ctool,
+                         "READ Bus: %d Addr: %02x Subaddr: %02x Value: "
+                         "%02x\n",
+                         i2ctool->bus, i2ctool->addr, regaddr, buf[i]);
+        }
+
+      nregs -= chunk;
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,6 +156,20 @@ int i2ccmd_get(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv)
       return ERROR;
     }
 
+  /* Auto-incremented 8-bit registers are read in bursts rather than with
+   * one transfer per register.  16-bit values are left to the loop below:
+   * It reads each value at the next register address, which a contiguous
+   * burst does not reproduce.
+   */
+
+  if (i2ctool->autoincr && i2ctool->hasregindx && i2ctool->width == 8 &&
+      repetitions > 1)
+    {
+      ret = i2ctool_getblock(i2ctool, fd, argv[0], repetitions);
+      close(fd);
+      return ret;
+    }
+
   /* Loop for the requested number of repetitions */
 
   regaddr = i2ctool->regaddr;
@@ -62,6 +62,10 @@ static const struct cmdmap_s g_i2ccmds[] =
   { "get",   i2ccmd_get,   "Read register ", "[OPTIONS] [<repetitions>]" },
   { "dump",  i2ccmd_dump,  "Dump register ", "[OPTIONS] [<num bytes>]" },
   { "help",  i2ccmd_help,  "Show help     ", NULL },
+  {
+    "sample", i2ccmd_sample, "Time register ",
+      "[OPTIONS] <count> [<interval us>]"
+  },
   {
     "set",   i2ccmd_set,   "Write register",
       "[OPTIONS] <value> [<repetitions>]"
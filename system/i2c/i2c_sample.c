@@ -0,0 +1,261 @@
+/****************************************************************************
+ * apps/system/i2c/i2c_sample.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <nuttx/i2c/i2c_master.h>
+
+#include "i2ctool.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One recorded sample.  The time is relative to the first read. */
+
+struct i2c_sample_s
+{
+  uint32_t usec;
+  uint16_t value;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2ctool_usec
+ ****************************************************************************/
+
+static uint64_t i2ctool_usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2ccmd_sample
+ *
+ * Description:
+ *   Read the same register "count" times, optionally paced at "interval"
+ *   microseconds, and record each value with its time stamp.  Nothing is
+ *   printed until sampling is done so that console output does not
+ *   disturb the timing.
+ *
+ ****************************************************************************/
+
+int i2ccmd_sample(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv)
+{
+  FAR struct i2c_sample_s *samples;
+  FAR char *ptr;
+  struct timespec deadline;
+  uint64_t start;
+  uint64_t next;
+  uint32_t period;
+  uint32_t minperiod;
+  uint32_t maxperiod;
+  long interval;
+  long count;
+  int nargs;
+  int argndx;
+  int ret;
+  int fd;
+  int i;
+
+  /* Parse any command line arguments */
+
+  for (argndx = 1; argndx < argc; )
+    {
+      /* Break out of the loop when the last option has been parsed */
+
+      ptr = argv[argndx];
+      if (*ptr != '-')
+        {
+          break;
+        }
+
+      /* Otherwise, check for common options */
+
+      nargs = i2ctool_common_args(i2ctool, &argv[argndx]);
+      if (nargs < 0)
+        {
+          return ERROR;
+        }
+
+      argndx += nargs;
+    }
+
+  /* The sample count is required; the interval is optional */
+
+  if (argndx >= argc)
+    {
+      i2ctool_printf(i2ctool, g_i2cargrequired, argv[0]);
+      return ERROR;
+    }
+
+  count = strtol(argv[argndx++], NULL, 10);
+  if (count < 1 || count > MAX_SAMPLE_CNT)
+    {
+      i2ctool_printf(i2ctool, g_i2cargrange, argv[0]);
+      return ERROR;
+    }
+
+  interval = 0;
+  if (argndx < argc)
+    {
+      interval = strtol(argv[argndx++], NULL, 10);
+      if (interval < 0)
+        {
+          i2ctool_printf(i2ctool, g_i2cargrange, argv[0]);
+          return ERROR;
+        }
+    }
+
+  if (argndx != argc)
+    {
+      i2ctool_printf(i2ctool, g_i2ctoomanyargs, argv[0]);
+      return ERROR;
+    }
+
+  samples = malloc(count * sizeof(struct i2c_sample_s));
+  if (samples == NULL)
+    {
+      i2ctool_printf(i2ctool, g_i2ccmdfailed, argv[0], "malloc", ENOMEM);
+      return ERROR;
+    }
+
+  /* Get a handle to the I2C bus */
+
+  fd = i2cdev_open(i2ctool->bus);
+  if (fd < 0)
+    {
+      i2ctool_printf(i2ctool, "Failed to get bus %d\n", i2ctool->bus);
+      free(samples);
+      return ERROR;
+    }
+
+  /* Sample against absolute deadlines so that the transfer time does not
+   * accumulate into the period.
+   */
+
+  ret   = OK;
+  start = i2ctool_usec();
+  next  = start;
+
+  for (i = 0; i < count; i++)
+    {
+      if (interval > 0 && i > 0)
+        {
+          next += interval;
+          deadline.tv_sec  = next / 1000000;
+          deadline.tv_nsec = (next % 1000000) * 1000;
+          clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+        }
+
+      samples[i].usec = (uint32_t)(i2ctool_usec() - start);
+
+      ret = i2ctool_get(i2ctool, fd, i2ctool->regaddr, &samples[i].value);
+      if (ret != OK)
+        {
+          i2ctool_printf(i2ctool, g_i2cxfrerror, argv[0], -ret);
+          break;
+        }
+    }
+
+  close(fd);
+
+  /* Display the recorded samples and the achieved rate */
+
+  count = i;
+  if (count > 0)
+    {
+      i2ctool_printf(i2ctool, "SAMPLE Bus: %d Addr: %02x Subaddr: ",
+                     i2ctool->bus, i2ctool->addr);
+
+      if (i2ctool->hasregindx)
+        {
+          i2ctool_printf(i2ctool, "%02x\n", i2ctool->regaddr);
+        }
+      else
+        {
+          i2ctool_printf(i2ctool, "--\n");
+        }
+
+      minperiod = UINT32_MAX;
+      maxperiod = 0;
+
+      for (i = 0; i < count; i++)
+        {
+          if (i2ctool->width == 8)
+            {
+              i2ctool_printf(i2ctool, "%10lu us: %02x\n",
+                             (unsigned long)samples[i].usec,
+                             samples[i].value);
+            }
+          else
+            {
+              i2ctool_printf(i2ctool, "%10lu us: %04x\n",
+                             (unsigned long)samples[i].usec,
+                             samples[i].value);
+            }
+
+          if (i > 0)
+            {
+              period = samples[i].usec - samples[i - 1].usec;
+              if (period < minperiod)
+                {
+                  minperiod = period;
+                }
+
+              if (period > maxperiod)
+                {
+                  maxperiod = period;
+                }
+            }
+        }
+
+      if (count > 1)
+        {
+          period = samples[count - 1].usec / (count - 1);
+          i2ctool_printf(i2ctool,
+                         "%ld samples, period min/avg/max: %lu/%lu/%lu us, "
+                         "rate: %lu Hz\n",
+                         count, (unsigned long)minperiod,
+                         (unsigned long)period, (unsigned long)maxperiod,
+                         period > 0 ? 1000000ul / period : 0ul);
+        }
+    }
+
+  free(samples);
+  return ret;
+}
@@ -25,11 +25,63 @@
 #include <nuttx/config.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <nuttx/i2c/i2c_master.h>
 
 #include "i2ctool.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2ctool_setblock
+ *
+ * Description:
+ *   Write "value" to "nregs" auto-incremented 8-bit registers with as few
+ *   transfers as possible (one per MAX_DUMP_CNT bytes).
+ *
+ ****************************************************************************/
+
+static int i2ctool_setblock(FAR struct i2ctool_s *i2ctool, int fd,
+                            FAR const char *cmd, uint8_t value, long nregs)
+{
+  uint8_t buf[MAX_DUMP_CNT];
+  uint8_t regaddr = i2ctool->regaddr;
+  int chunk;
+  int ret = OK;
+
+  chunk = MAX_DUMP_CNT;
+  memset(buf, value, chunk);
+
+  while (nregs > 0)
+    {
+      if (chunk > nregs)
+        {
+          chunk = nregs;
+        }
+
+      ret = i2ctool_burst_set(i2ctool, fd, regaddr, buf, chunk);
+      if (ret != OK)
+        {
+          i2ctool_printf(i2ctool, g_i2cxfrerror, cmd, -ret);
+          break;
+        }
+
+      i2ctool_printf(i2ctool,
+                     "WROTE Bus: %d Addr: %02x Subaddr: %02x-%02x Value: "
+                     "%02x\n",
+                     i2ctool->bus, i2ctool->addr, regaddr,
+                     (uint8_t)(regaddr + chunk - 1), value);
+
+      regaddr += chunk;
+      nregs   -= chunk;
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -134,6 +186,21 @@ int i2ccmd_set(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv)
       return ERROR;
     }
 
+  /* Auto-incremented 8-bit registers are written in bursts rather than
+   * with one transfer per register.  16-bit values are left to the loop
+   * below:  It writes each value at the next register address, which a
+   * contiguous burst does not reproduce.
+   */
+
+  if (i2ctool->autoincr && i2ctool->hasregindx && i2ctool->width == 8 &&
+      repetitions > 1)
+    {
+      ret = i2ctool_setblock(i2ctool, fd, argv[0], (uint8_t)value,
+                             repetitions);
+      close(fd);
+      return ret;
+    }
+
   /* Loop for the requested number of repetitions */
 
   regaddr = i2ctool->regaddr;
@@ -88,6 +88,10 @@
 
 #define MAX_DUMP_CNT  256
 
+/* Maximum number of samples recorded by the sample command */
+
+#define MAX_SAMPLE_CNT 4096
+
 /* Maximum size of one command line */
 
 #define MAX_LINELEN 80
@@ -180,6 +184,8 @@ int i2ccmd_bus(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv);
 int i2ccmd_dev(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv);
 int i2ccmd_get(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv);
 int i2ccmd_dump(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv);
+int i2ccmd_sample(FAR struct i2ctool_s *i2ctool, int argc,
+                  FAR char **argv);
 int i2ccmd_set(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv);
 int i2ccmd_verf(FAR struct i2ctool_s *i2ctool, int argc, FAR char **argv);
 
@@ -193,6 +199,10 @@ int i2ctool_get(FAR struct i2ctool_s *i2ctool, int fd, uint8_t regaddr,
                 FAR uint16_t *result);
 int i2ctool_set(FAR struct i2ctool_s *i2ctool, int fd, uint8_t regaddr,
                 uint16_t value);
+int i2ctool_burst_get(FAR struct i2ctool_s *i2ctool, int fd,
+                      uint8_t regaddr, FAR uint8_t *buf, int nbytes);
+int i2ctool_burst_set(FAR struct i2ctool_s *i2ctool, int fd,
+                      uint8_t regaddr, FAR const uint8_t *buf, int nbytes);
 
 /* Common logic */
 
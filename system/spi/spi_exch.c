@@ -25,6 +25,8 @@
 #include <nuttx/config.h>
 
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include <ctype.h>
 
@@ -185,3 +187,233 @@ int spicmd_exch(FAR struct spitool_s *spitool, int argc, FAR char **argv)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: spicmd_bulk
+ *
+ * Description:
+ *   Exchange "ntrans" blocks of "nwords" words each in a single
+ *   SPIIOC_TRANSFER so that large or repeated exchanges are not dominated
+ *   by the per-ioctl overhead.  The transmit data is the optional hex
+ *   pattern repeated over the whole buffer.
+ *
+ ****************************************************************************/
+
+int spicmd_bulk(FAR struct spitool_s *spitool, int argc, FAR char **argv)
+{
+  FAR struct spi_trans_s *trans;
+  FAR uint8_t *txdata;
+  FAR uint8_t *rxdata;
+  FAR char *ptr;
+  struct spi_sequence_s seq;
+  struct timespec start;
+  struct timespec end;
+  uint8_t pattern[MAX_XDATA];
+  size_t npattern;
+  size_t blksize;
+  size_t nbytes;
+  uint64_t usec;
+  size_t nwords;
+  size_t ntrans;
+  long value;
+  int wordsize;
+  int nargs;
+  int argndx;
+  int ret;
+  int fd;
+  size_t i;
+
+  /* Parse any command line arguments */
+
+  for (argndx = 1; argndx < argc; )
+    {
+      /* Break out of the loop when the last option has been parsed */
+
+      ptr = argv[argndx];
+      if (*ptr != '-')
+        {
+          break;
+        }
+
+      /* Otherwise, check for common options */
+
+      nargs = spitool_common_args(spitool, &argv[argndx]);
+      if (nargs < 0)
+        {
+          return ERROR;
+        }
+
+      argndx += nargs;
+    }
+
+  /* The number of words per transfer is required */
+
+  if (argndx >= argc)
+    {
+      spitool_printf(spitool, g_spiargrequired, argv[0]);
+      return ERROR;
+    }
+
+  value = strtol(argv[argndx++], NULL, 10);
+  if (value < 1 || value > MAX_BULK_WORDS)
+    {
+      spitool_printf(spitool, g_spiargrange, argv[0]);
+      return ERROR;
+    }
+
+  nwords = value;
+
+  /* Then the optional number of transfers in the sequence */
+
+  ntrans = 1;
+  if (argndx < argc)
+    {
+      value = strtol(argv[argndx++], NULL, 10);
+      if (value < 1 || value > MAX_BULK_TRANS)
+        {
+          spitool_printf(spitool, g_spiargrange, argv[0]);
+          return ERROR;
+        }
+
+      ntrans = value;
+    }
+
+  /* And the optional hex pattern (default: all ones) */
+
+  pattern[0] = 0xff;
+  npattern   = 1;
+
+  if (argndx < argc)
+    {
+      FAR uint8_t *a = (FAR uint8_t *)argv[argndx++];
+
+      npattern = 0;
+      while (*a)
+        {
+          if ((*(a + 1) == 0) || !ISHEX(*a) || !ISHEX(*(a + 1)) ||
+              npattern >= MAX_XDATA)
+            {
+              spitool_printf(spitool, g_spiincompleteparam, argv[0]);
+              return ERROR;
+            }
+
+          pattern[npattern++] = (HTOI(*a) << 4) | HTOI(*(a + 1));
+          a += 2;
+        }
+
+      if (npattern == 0)
+        {
+          spitool_printf(spitool, g_spiincompleteparam, argv[0]);
+          return ERROR;
+        }
+    }
+
+  if (argndx != argc)
+    {
+      spitool_printf(spitool, g_spitoomanyargs, argv[0]);
+      return ERROR;
+    }
+
+  /* Allocate the transfer descriptors and both data buffers at once */
+
+  wordsize = spitool->width <= 8 ? 1 : 2;
+  blksize  = nwords * wordsize;
+  nbytes   = blksize * ntrans;
+
+  trans = malloc(ntrans * sizeof(struct spi_trans_s) + 2 * nbytes);
+  if (trans == NULL)
+    {
+      spitool_printf(spitool, g_spicmdfailed, argv[0], "malloc", ENOMEM);
+      return ERROR;
+    }
+
+  txdata = (FAR uint8_t *)&trans[ntrans];
+  rxdata = txdata + nbytes;
+
+  for (i = 0; i < nbytes; i += npattern)
+    {
+      memcpy(&txdata[i], pattern,
+             nbytes - i < npattern ? nbytes - i : npattern);
+    }
+
+  memset(rxdata, 0, nbytes);
+
+  /* Get a handle to the SPI bus */
+
+  fd = spidev_open(spitool->bus);
+  if (fd < 0)
+    {
+      spitool_printf(spitool, "Failed to get bus %d\n", spitool->bus);
+      free(trans);
+      return ERROR;
+    }
+
+  /* Set up the transfer profile.  Chip select is released between the
+   * blocks just as it would be for separate exchanges.
+   */
+
+  seq.dev = SPIDEV_ID(spitool->devtype, spitool->csn);
+  seq.mode = spitool->mode;
+  seq.nbits = spitool->width;
+  seq.frequency = spitool->freq;
+  seq.ntrans = ntrans;
+  seq.trans = trans;
+
+  for (i = 0; i < ntrans; i++)
+    {
+      trans[i].deselect = true;
+#ifdef CONFIG_SPI_CMDDATA
+      trans[i].cmd = spitool->command;
+#endif
+      trans[i].delay = spitool->udelay;
+      trans[i].nwords = nwords;
+      trans[i].txbuffer = &txdata[i * blksize];
+      trans[i].rxbuffer = &rxdata[i * blksize];
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ret = spidev_transfer(fd, &seq);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  close(fd);
+
+  if (ret)
+    {
+      free(trans);
+      return ret;
+    }
+
+  /* Show the beginning of the received data and the throughput */
+
+  spitool_printf(spitool, "Received:\t");
+  for (i = 0; i < nwords * ntrans && i < MAX_XDATA; i++)
+    {
+      if (spitool->width <= 8)
+        {
+          spitool_printf(spitool, "%02X ", rxdata[i]);
+        }
+      else
+        {
+          spitool_printf(spitool, "%04X ", ((FAR uint16_t *)rxdata)[i]);
+        }
+    }
+
+  spitool_printf(spitool, "%s\n", i < nwords * ntrans ? "..." : "");
+
+  usec = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000 +
+         (end.tv_nsec - start.tv_nsec) / 1000;
+
+  spitool_printf(spitool, "%lu bytes in %lu transfers, %lu us",
+                 (unsigned long)nbytes, (unsigned long)ntrans,
+                 (unsigned long)usec);
+  if (usec > 0)
+    {
+      spitool_printf(spitool, ", %lu KiB/s",
+                     (unsigned long)(nbytes * 1000000ull / usec / 1024));
+    }
+
+  spitool_printf(spitool, "\n");
+
+  free(trans);
+  return ret;
+}
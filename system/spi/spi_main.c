@@ -54,6 +54,8 @@ static struct spitool_s g_spitool;
 static const struct cmdmap_s g_spicmds[] =
 {
   { "?",    spicmd_help,  "Show help     ",  NULL },
+  { "bulk", spicmd_bulk,  "Bulk exchange ",
+    "[OPTIONS] <words> [<transfers> [<hex pattern>]]" },
   { "bus",  spicmd_bus,   "List buses    ",  NULL },
   { "exch",  spicmd_exch, "SPI Exchange  ", "[OPTIONS] [<hex senddata>]" },
   { "help", spicmd_help,  "Show help     ", NULL },
@@ -95,6 +95,11 @@
 #define MAX_LINELEN 80
 #define MAX_XDATA  (MAX_LINELEN/2)
 
+/* Limits of the bulk exchange command */
+
+#define MAX_BULK_WORDS 4096
+#define MAX_BULK_TRANS 64
+
 /* Are we using the NuttX console for I/O?  Or some other character device? */
 
 #ifdef CONFIG_SPITOOL_INDEV
@@ -181,6 +186,7 @@ void spitool_flush(FAR struct spitool_s *spitool);
 
 /* Command handlers */
 
+int spicmd_bulk(FAR struct spitool_s *spitool, int argc, FAR char **argv);
 int spicmd_bus(FAR struct spitool_s *spitool, int argc, FAR char **argv);
 int spicmd_exch(FAR struct spitool_s *spitool, int argc, FAR char **argv);
 
@@ -0,0 +1,285 @@
+/****************************************************************************
+ * apps/testing/ft80xstream/ft80xstream_main.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/lcd/ft80x.h>
+
+#include "graphics/ft80x.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MOCK_FIFO_MASK     (FT80X_CMDFIFO_SIZE - 1)
+
+/* The mock co-processor sleeps after consuming this many words so that the
+ * FIFO fills and the stream has to wait for partial drains.
+ */
+
+#define MOCK_BURST_WORDS   64
+#define MOCK_BURST_DELAY   200
+
+#define TEST_NFRAMES       8
+#define TEST_FRAME_WORDS   3000
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The emulated command FIFO and its read/write registers */
+
+static uint8_t g_fifo[FT80X_CMDFIFO_SIZE];
+static volatile uint32_t g_cmdread;
+static volatile uint32_t g_cmdwrite;
+static volatile bool g_stop;
+
+/* Verification state of the emulated co-processor */
+
+static uint32_t g_expected;
+static uint32_t g_consumed;
+static unsigned int g_errors;
+
+static struct ft80x_stream_s g_stream;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mock_getregs / mock_putreg16 / mock_putramcmd
+ *
+ * Description:
+ *   Device accessors for the emulated FT80x.
+ *
+ ****************************************************************************/
+
+static int mock_getregs(int fd, uint32_t addr, uint8_t nregs,
+                        FAR uint32_t *value)
+{
+  if (addr != FT80X_REG_CMD_READ || nregs != 2)
+    {
+      return -EINVAL;
+    }
+
+  value[0] = g_cmdread;
+  value[1] = g_cmdwrite;
+  return OK;
+}
+
+static int mock_putreg16(int fd, uint32_t addr, uint16_t value)
+{
+  if (addr != FT80X_REG_CMD_WRITE || (value & ~MOCK_FIFO_MASK) != 0)
+    {
+      return -EINVAL;
+    }
+
+  g_cmdwrite = value;
+  return OK;
+}
+
+static int mock_putramcmd(int fd, uint16_t offset, FAR const void *data,
+                          size_t len)
+{
+  /* Writes must never run past the end of RAM CMD */
+
+  if ((size_t)offset + len > FT80X_CMDFIFO_SIZE)
+    {
+      printf("ERROR: Write of %u bytes at %u wraps the FIFO\n",
+             (unsigned int)len, offset);
+      g_errors++;
+      return -EINVAL;
+    }
+
+  memcpy(&g_fifo[offset], data, len);
+  return OK;
+}
+
+static const struct ft80x_streamops_s g_mockops =
+{
+  mock_getregs,
+  mock_putreg16,
+  mock_putramcmd
+};
+
+/****************************************************************************
+ * Name: mock_coproc
+ *
+ * Description:
+ *   Emulate the co-processor:  Consume words from the FIFO and check that
+ *   they arrive in sequence.
+ *
+ ****************************************************************************/
+
+static FAR void *mock_coproc(FAR void *arg)
+{
+  unsigned int burst = 0;
+  uint32_t word;
+
+  while (!g_stop)
+    {
+      if (g_cmdread == g_cmdwrite)
+        {
+          usleep(MOCK_BURST_DELAY);
+          continue;
+        }
+
+      memcpy(&word, &g_fifo[g_cmdread], sizeof(uint32_t));
+      if (word != g_expected)
+        {
+          if (g_errors++ < 8)
+            {
+              printf("ERROR: Expected %08lx, got %08lx\n",
+                     (unsigned long)g_expected, (unsigned long)word);
+            }
+
+          g_expected = word;
+        }
+
+      g_expected++;
+      g_consumed += sizeof(uint32_t);
+      g_cmdread   = (g_cmdread + sizeof(uint32_t)) & MOCK_FIFO_MASK;
+
+      if (++burst >= MOCK_BURST_WORDS)
+        {
+          burst = 0;
+          usleep(MOCK_BURST_DELAY);
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct ft80x_streamstats_s stats;
+  pthread_t coproc;
+  uint32_t word;
+  int frame;
+  int i;
+  int ret;
+
+  g_cmdread  = 0;
+  g_cmdwrite = 0;
+  g_stop     = false;
+  g_expected = 0;
+  g_consumed = 0;
+  g_errors   = 0;
+
+  ret = pthread_create(&coproc, NULL, mock_coproc, NULL);
+  if (ret != 0)
+    {
+      printf("ERROR: pthread_create failed: %d\n", ret);
+      return EXIT_FAILURE;
+    }
+
+  ret = ft80x_stream_initialize(-1, &g_stream, &g_mockops);
+  if (ret < 0)
+    {
+      printf("ERROR: ft80x_stream_initialize failed: %d\n", ret);
+      g_stop = true;
+      pthread_join(coproc, NULL);
+      return EXIT_FAILURE;
+    }
+
+  /* Build frames word-by-word.  Each frame is several times larger than
+   * the FIFO so it must stream through it.
+   */
+
+  word = 0;
+  for (frame = 0; frame < TEST_NFRAMES && ret >= 0; frame++)
+    {
+      for (i = 0; i < TEST_FRAME_WORDS; i++, word++)
+        {
+          ret = ft80x_stream_data(&g_stream, &word, sizeof(uint32_t));
+          if (ret < 0)
+            {
+              printf("ERROR: ft80x_stream_data failed: %d\n", ret);
+              break;
+            }
+        }
+
+      if (ret >= 0)
+        {
+          ret = ft80x_stream_endframe(&g_stream);
+          if (ret < 0)
+            {
+              printf("ERROR: ft80x_stream_endframe failed: %d\n", ret);
+            }
+        }
+
+      ft80x_stream_getstats(&g_stream, &stats);
+      printf("Frame %d: %lu bytes, %lu stalls\n", frame,
+             (unsigned long)stats.lastbytes,
+             (unsigned long)stats.laststalls);
+    }
+
+  ft80x_stream_uninitialize(&g_stream);
+
+  g_stop = true;
+  pthread_join(coproc, NULL);
+
+  ft80x_stream_getstats(&g_stream, &stats);
+  printf("Frames: %lu Bytes: %llu Stalls: %lu Max frame: %lu bytes, "
+         "%lu stalls\n",
+         (unsigned long)stats.frames,
+         (unsigned long long)stats.totalbytes,
+         (unsigned long)stats.totalstalls,
+         (unsigned long)stats.maxbytes,
+         (unsigned long)stats.maxstalls);
+
+  if (g_consumed != word * sizeof(uint32_t))
+    {
+      printf("ERROR: Co-processor consumed %lu of %lu bytes\n",
+             (unsigned long)g_consumed,
+             (unsigned long)(word * sizeof(uint32_t)));
+      g_errors++;
+    }
+
+  if (ret < 0 || g_errors > 0)
+    {
+      printf("FAILED: %u errors\n", g_errors);
+      return EXIT_FAILURE;
+    }
+
+  printf("PASSED\n");
+  return EXIT_SUCCESS;
+}
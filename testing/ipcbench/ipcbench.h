@@ -0,0 +1,155 @@
+/****************************************************************************
+ * apps/testing/ipcbench/ipcbench.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_TESTING_IPCBENCH_IPCBENCH_H
+#define __APPS_TESTING_IPCBENCH_IPCBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#ifdef CONFIG_NET_LOCAL
+#  include <sys/un.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <semaphore.h>
+#include <mqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_TESTING_IPCBENCH_MAXSIZE
+#  define CONFIG_TESTING_IPCBENCH_MAXSIZE 65536
+#endif
+
+#ifndef CONFIG_TESTING_IPCBENCH_MAXPAIRS
+#  define CONFIG_TESTING_IPCBENCH_MAXPAIRS 4
+#endif
+
+#ifndef CONFIG_TESTING_IPCBENCH_PATH
+#  define CONFIG_TESTING_IPCBENCH_PATH "/dev/ipcbench"
+#endif
+
+/* A receiver that has seen nothing for this long gives up */
+
+#define IPCBENCH_TIMEOUTMS  5000
+
+/* The smallest message holds the header */
+
+#define IPCBENCH_MINSIZE    sizeof(struct ipcbench_msg_s)
+
+/* The sequence number of a message that is not part of the run, such as
+ * the initial value of a uORB topic.
+ */
+
+#define IPCBENCH_SEQ_NONE   0xffffffff
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The header at the start of each message */
+
+struct ipcbench_msg_s
+{
+  uint32_t seq;                      /* Message number, from 0 */
+  uint32_t reserved;
+  uint64_t stamp;                    /* Send time (us) */
+};
+
+/* How the senders are driven */
+
+enum ipcbench_mode_e
+{
+  IPCBENCH_PACED = 0,                /* Send after the previous arrived */
+  IPCBENCH_STREAM                    /* Send as fast as possible */
+};
+
+/* One sender and one receiver thread and the channel between them */
+
+struct ipcbench_pair_s
+{
+  FAR const struct ipcbench_transport_s *transport;
+  int id;
+  size_t size;                       /* Message size */
+  uint32_t count;                    /* Messages to send */
+  enum ipcbench_mode_e mode;
+
+  /* Channel state, used as the transport needs */
+
+  int txfd;
+  int rxfd;
+  int listenfd;
+  mqd_t txmq;
+  mqd_t rxmq;
+  FAR void *advert;                  /* uORB advertiser handle */
+  FAR const void *meta;              /* uORB topic metadata */
+#ifdef CONFIG_NET_LOCAL
+  struct sockaddr_un addr;           /* Local socket address */
+#endif
+
+  sem_t pace;                        /* Posted by the receiver (paced) */
+  FAR uint8_t *txbuf;
+  FAR uint8_t *rxbuf;
+
+  /* Results */
+
+  FAR uint32_t *lat;                 /* Latency samples (us) */
+  uint32_t nlat;
+  uint32_t lost;                     /* Messages never received */
+  uint64_t bytes;
+  uint64_t done;                     /* Time of the last message (us) */
+  int rxresult;                      /* 0 or a negated errno */
+  int txresult;
+};
+
+/* A message transport.  setup() and teardown() run in the main thread,
+ * rxopen() and txopen(), if any, in the receiver and sender threads
+ * before the clock starts.  recv() returns when a whole message has
+ * arrived or after IPCBENCH_TIMEOUTMS.  All return 0 or a negated errno.
+ */
+
+struct ipcbench_transport_s
+{
+  FAR const char *name;
+  size_t maxsize;                    /* Largest message */
+  CODE int (*setup)(FAR struct ipcbench_pair_s *pair);
+  CODE int (*rxopen)(FAR struct ipcbench_pair_s *pair);
+  CODE int (*txopen)(FAR struct ipcbench_pair_s *pair);
+  CODE int (*send)(FAR struct ipcbench_pair_s *pair);
+  CODE int (*recv)(FAR struct ipcbench_pair_s *pair);
+  CODE void (*teardown)(FAR struct ipcbench_pair_s *pair);
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern const struct ipcbench_transport_s g_ipcbench_transports[];
+extern const int g_ipcbench_ntransports;
+
+#endif /* __APPS_TESTING_IPCBENCH_IPCBENCH_H */
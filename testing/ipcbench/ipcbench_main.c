@@ -0,0 +1,663 @@
+/****************************************************************************
+ * apps/testing/ipcbench/ipcbench_main.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+
+#include "ipcbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPCBENCH_DEFCOUNT   1000
+
+/* The message sizes of the sweep, up to CONFIG_TESTING_IPCBENCH_MAXSIZE */
+
+#define IPCBENCH_SWEEPMIN   16
+#define IPCBENCH_SWEEPSTEP  4
+
+/* Bits of ipcbench_s::modes */
+
+#define IPCBENCH_MODE(m)    (1 << (m))
+#define IPCBENCH_ALLMODES   (IPCBENCH_MODE(IPCBENCH_PACED) | \
+                             IPCBENCH_MODE(IPCBENCH_STREAM))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ipcbench_s
+{
+  size_t size;                       /* Message size, 0 for the sweep */
+  uint32_t count;                    /* Messages per pair */
+  int maxpairs;                      /* Upper bound of the pairs */
+  int modes;                         /* IPCBENCH_MODE() bits */
+  bool csv;                          /* Print results as CSV */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_ipcbench_modes[] =
+{
+  "paced", "stream"
+};
+
+/* The threads of a run report that their channel is open on "ready" and
+ * wait on "start" for the clock to start, or for "go" to stay false if
+ * the run is abandoned.
+ */
+
+static sem_t g_ipcbench_ready;
+static sem_t g_ipcbench_start;
+static volatile bool g_ipcbench_go;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipcbench_usec
+ ****************************************************************************/
+
+static uint64_t ipcbench_usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: ipcbench_compare
+ ****************************************************************************/
+
+static int ipcbench_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: ipcbench_rxthread
+ ****************************************************************************/
+
+static FAR void *ipcbench_rxthread(FAR void *arg)
+{
+  FAR struct ipcbench_pair_s *pair = arg;
+  FAR const struct ipcbench_transport_s *transport = pair->transport;
+  FAR struct ipcbench_msg_s *msg = (FAR struct ipcbench_msg_s *)pair->rxbuf;
+  uint32_t next = 0;
+  uint64_t now;
+  int ret = 0;
+
+  if (transport->rxopen != NULL)
+    {
+      ret = transport->rxopen(pair);
+    }
+
+  pair->rxresult = ret;
+  sem_post(&g_ipcbench_ready);
+  sem_wait(&g_ipcbench_start);
+
+  if (!g_ipcbench_go)
+    {
+      return NULL;
+    }
+
+  while (next < pair->count)
+    {
+      ret = transport->recv(pair);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      now = ipcbench_usec();
+
+      if (msg->seq < next || msg->seq >= pair->count)
+        {
+          ret = -EPROTO;
+          break;
+        }
+
+      /* Only uORB may skip messages, by overwriting them */
+
+      pair->lost += msg->seq - next;
+      next = msg->seq + 1;
+
+      pair->lat[pair->nlat++] = (uint32_t)(now - msg->stamp);
+      pair->bytes += pair->size;
+
+      if (pair->mode == IPCBENCH_PACED)
+        {
+          sem_post(&pair->pace);
+        }
+    }
+
+  pair->done     = ipcbench_usec();
+  pair->rxresult = ret;
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipcbench_txthread
+ ****************************************************************************/
+
+static FAR void *ipcbench_txthread(FAR void *arg)
+{
+  FAR struct ipcbench_pair_s *pair = arg;
+  FAR const struct ipcbench_transport_s *transport = pair->transport;
+  FAR struct ipcbench_msg_s *msg = (FAR struct ipcbench_msg_s *)pair->txbuf;
+  struct timespec abstime;
+  uint32_t seq;
+  int ret = 0;
+
+  if (transport->txopen != NULL)
+    {
+      ret = transport->txopen(pair);
+    }
+
+  pair->txresult = ret;
+  sem_post(&g_ipcbench_ready);
+  sem_wait(&g_ipcbench_start);
+
+  if (!g_ipcbench_go)
+    {
+      return NULL;
+    }
+
+  for (seq = 0; seq < pair->count; seq++)
+    {
+      /* Paced: wait for the previous message to arrive */
+
+      if (pair->mode == IPCBENCH_PACED && seq > 0)
+        {
+          clock_gettime(CLOCK_REALTIME, &abstime);
+          abstime.tv_sec += IPCBENCH_TIMEOUTMS / 1000;
+
+          if (sem_timedwait(&pair->pace, &abstime) < 0)
+            {
+              ret = -errno;
+              break;
+            }
+        }
+
+      msg->seq   = seq;
+      msg->stamp = ipcbench_usec();
+
+      ret = transport->send(pair);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  pair->txresult = ret;
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipcbench_report
+ *
+ * Description:
+ *   Print one result line.  Sorts the latency samples in place.
+ *
+ ****************************************************************************/
+
+static void ipcbench_report(FAR const struct ipcbench_s *bench,
+                            FAR const char *transport,
+                            enum ipcbench_mode_e mode, int npairs,
+                            size_t size, FAR uint32_t *lat, uint32_t nlat,
+                            uint64_t bytes, uint64_t elapsed, uint32_t lost)
+{
+  uint64_t usec = elapsed > 0 ? elapsed : 1;
+  uint32_t p50 = 0;
+  uint32_t p90 = 0;
+  uint32_t p99 = 0;
+  uint32_t max = 0;
+
+  if (nlat > 0)
+    {
+      qsort(lat, nlat, sizeof(uint32_t), ipcbench_compare);
+      p50 = lat[(uint64_t)(nlat - 1) * 50 / 100];
+      p90 = lat[(uint64_t)(nlat - 1) * 90 / 100];
+      p99 = lat[(uint64_t)(nlat - 1) * 99 / 100];
+      max = lat[nlat - 1];
+    }
+
+  printf(bench->csv ? "%s,%s,%d,%lu,%lu,%llu,%llu,%llu,%lu,%lu,%lu,%lu,"
+                      "%lu\n" :
+                      "%-9s %-6s %5d %6lu %8lu %10llu %9llu %8llu "
+                      "%7lu %7lu %7lu %7lu %7lu\n",
+         transport, g_ipcbench_modes[mode], npairs, (unsigned long)size,
+         (unsigned long)nlat, (unsigned long long)elapsed,
+         (unsigned long long)(bytes * 1000000 / usec / 1024),
+         (unsigned long long)((uint64_t)nlat * 1000000 / usec),
+         (unsigned long)p50, (unsigned long)p90, (unsigned long)p99,
+         (unsigned long)max, (unsigned long)lost);
+}
+
+/****************************************************************************
+ * Name: ipcbench_run
+ *
+ * Description:
+ *   Move "count" messages of "size" bytes over each of "npairs" channels
+ *   of one transport at once, and report the result.
+ *
+ ****************************************************************************/
+
+static int ipcbench_run(FAR const struct ipcbench_s *bench,
+                        FAR const struct ipcbench_transport_s *transport,
+                        enum ipcbench_mode_e mode, int npairs, size_t size)
+{
+  FAR struct ipcbench_pair_s *pairs;
+  FAR struct ipcbench_pair_s *pair;
+  pthread_t rxthreads[CONFIG_TESTING_IPCBENCH_MAXPAIRS];
+  pthread_t txthreads[CONFIG_TESTING_IPCBENCH_MAXPAIRS];
+  FAR uint32_t *lat;
+  uint32_t nlat = 0;
+  uint32_t lost = 0;
+  uint64_t bytes = 0;
+  uint64_t start = 0;
+  uint64_t end = 0;
+  int nsetup = 0;
+  int nrx = 0;
+  int ntx = 0;
+  int ret = 0;
+  int i;
+
+  pairs = calloc(npairs, sizeof(struct ipcbench_pair_s));
+  lat   = malloc((size_t)npairs * bench->count * sizeof(uint32_t));
+  if (pairs == NULL || lat == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  for (i = 0; i < npairs; i++)
+    {
+      pair = &pairs[i];
+
+      pair->transport = transport;
+      pair->id        = i;
+      pair->size      = size;
+      pair->count     = bench->count;
+      pair->mode      = mode;
+      pair->txfd      = -1;
+      pair->rxfd      = -1;
+      pair->listenfd  = -1;
+      pair->txmq      = (mqd_t)-1;
+      pair->rxmq      = (mqd_t)-1;
+      pair->lat       = &lat[(size_t)i * bench->count];
+      pair->txbuf     = malloc(size);
+      pair->rxbuf     = malloc(size);
+
+      sem_init(&pair->pace, 0, 0);
+      nsetup++;
+
+      if (pair->txbuf == NULL || pair->rxbuf == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      memset(pair->txbuf, 0, size);
+
+      ret = transport->setup(pair);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  /* Start the threads and wait for all of them to open their ends */
+
+  sem_init(&g_ipcbench_ready, 0, 0);
+  sem_init(&g_ipcbench_start, 0, 0);
+  g_ipcbench_go = false;
+
+  for (i = 0; i < npairs; i++)
+    {
+      ret = pthread_create(&rxthreads[i], NULL, ipcbench_rxthread,
+                           &pairs[i]);
+      if (ret != 0)
+        {
+          ret = -ret;
+          break;
+        }
+
+      nrx++;
+
+      ret = pthread_create(&txthreads[i], NULL, ipcbench_txthread,
+                           &pairs[i]);
+      if (ret != 0)
+        {
+          ret = -ret;
+          break;
+        }
+
+      ntx++;
+    }
+
+  for (i = 0; i < nrx + ntx; i++)
+    {
+      sem_wait(&g_ipcbench_ready);
+    }
+
+  for (i = 0; i < npairs && ret == 0; i++)
+    {
+      ret = pairs[i].rxresult < 0 ? pairs[i].rxresult : pairs[i].txresult;
+    }
+
+  g_ipcbench_go = ret == 0;
+  start = ipcbench_usec();
+
+  for (i = 0; i < nrx + ntx; i++)
+    {
+      sem_post(&g_ipcbench_start);
+    }
+
+  for (i = 0; i < nrx; i++)
+    {
+      pthread_join(rxthreads[i], NULL);
+    }
+
+  for (i = 0; i < ntx; i++)
+    {
+      pthread_join(txthreads[i], NULL);
+    }
+
+  sem_destroy(&g_ipcbench_ready);
+  sem_destroy(&g_ipcbench_start);
+
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Gather the samples of all pairs at the start of the array */
+
+  for (i = 0; i < npairs; i++)
+    {
+      pair = &pairs[i];
+
+      if (ret == 0)
+        {
+          ret = pair->rxresult < 0 ? pair->rxresult : pair->txresult;
+        }
+
+      memmove(&lat[nlat], pair->lat, pair->nlat * sizeof(uint32_t));
+      nlat  += pair->nlat;
+      lost  += pair->lost;
+      bytes += pair->bytes;
+      end    = pair->done > end ? pair->done : end;
+    }
+
+  if (ret == 0)
+    {
+      ipcbench_report(bench, transport->name, mode, npairs, size, lat,
+                      nlat, bytes, end - start, lost);
+    }
+
+errout:
+  if (ret < 0)
+    {
+      fprintf(stderr, "ERROR: %s %s, %d pairs, %lu bytes: %d\n",
+              transport->name, g_ipcbench_modes[mode], npairs,
+              (unsigned long)size, ret);
+    }
+
+  for (i = 0; i < nsetup; i++)
+    {
+      pair = &pairs[i];
+
+      transport->teardown(pair);
+      sem_destroy(&pair->pace);
+      free(pair->txbuf);
+      free(pair->rxbuf);
+    }
+
+  free(pairs);
+  free(lat);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipcbench_showusage
+ ****************************************************************************/
+
+static void ipcbench_showusage(FAR const char *progname, int exitcode)
+{
+  int i;
+
+  fprintf(stderr, "USAGE: %s [OPTIONS] [<transport> ...]\n", progname);
+  fprintf(stderr, "Where OPTIONS are:\n");
+  fprintf(stderr, "  -l <bytes>  Message size (%u-%u).  Default: %u, "
+          "%u ... %u\n", (unsigned)IPCBENCH_MINSIZE,
+          CONFIG_TESTING_IPCBENCH_MAXSIZE, IPCBENCH_SWEEPMIN,
+          IPCBENCH_SWEEPMIN * IPCBENCH_SWEEPSTEP,
+          CONFIG_TESTING_IPCBENCH_MAXSIZE);
+  fprintf(stderr, "  -n <count>  Messages per pair.  Default: %u\n",
+          IPCBENCH_DEFCOUNT);
+  fprintf(stderr, "  -c <pairs>  Most concurrent pairs (1-%u), run as "
+          "1, 2, 4 ...  Default: %u\n", CONFIG_TESTING_IPCBENCH_MAXPAIRS,
+          CONFIG_TESTING_IPCBENCH_MAXPAIRS);
+  fprintf(stderr, "  -m <mode>   paced: send when the previous message "
+          "arrived (latency)\n");
+  fprintf(stderr, "              stream: send as fast as possible "
+          "(throughput).  Default: both\n");
+  fprintf(stderr, "  -C          Print the results as CSV\n");
+  fprintf(stderr, "Sizes beyond the largest message of a transport are "
+          "skipped.\n");
+  fprintf(stderr, "Transports (default: all):");
+
+  for (i = 0; i < g_ipcbench_ntransports; i++)
+    {
+      fprintf(stderr, " %s", g_ipcbench_transports[i].name);
+    }
+
+  fprintf(stderr, "\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  FAR const struct ipcbench_transport_s *transport;
+  struct ipcbench_s bench;
+  int failures = 0;
+  int option;
+  int npairs;
+  size_t size;
+  int mode;
+  int i;
+  int j;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.count    = IPCBENCH_DEFCOUNT;
+  bench.maxpairs = CONFIG_TESTING_IPCBENCH_MAXPAIRS;
+  bench.modes    = IPCBENCH_ALLMODES;
+
+  while ((option = getopt(argc, argv, "l:n:c:m:Ch")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'l':
+            bench.size = strtoul(optarg, NULL, 0);
+            if (bench.size < IPCBENCH_MINSIZE)
+              {
+                ipcbench_showusage(argv[0], EXIT_FAILURE);
+              }
+            break;
+
+          case 'n':
+            bench.count = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'c':
+            bench.maxpairs = atoi(optarg);
+            break;
+
+          case 'm':
+            for (mode = 0; mode <= IPCBENCH_STREAM; mode++)
+              {
+                if (strcmp(optarg, g_ipcbench_modes[mode]) == 0)
+                  {
+                    break;
+                  }
+              }
+
+            if (mode > IPCBENCH_STREAM)
+              {
+                ipcbench_showusage(argv[0], EXIT_FAILURE);
+              }
+
+            bench.modes = IPCBENCH_MODE(mode);
+            break;
+
+          case 'C':
+            bench.csv = true;
+            break;
+
+          case 'h':
+            ipcbench_showusage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            ipcbench_showusage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (bench.size > CONFIG_TESTING_IPCBENCH_MAXSIZE || bench.count < 1 ||
+      bench.maxpairs < 1 ||
+      bench.maxpairs > CONFIG_TESTING_IPCBENCH_MAXPAIRS)
+    {
+      ipcbench_showusage(argv[0], EXIT_FAILURE);
+    }
+
+  for (j = optind; j < argc; j++)
+    {
+      for (i = 0; i < g_ipcbench_ntransports; i++)
+        {
+          if (strcmp(argv[j], g_ipcbench_transports[i].name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (i == g_ipcbench_ntransports)
+        {
+          fprintf(stderr, "ERROR: Unknown transport %s\n", argv[j]);
+          ipcbench_showusage(argv[0], EXIT_FAILURE);
+        }
+    }
+
+  printf(bench.csv ? "transport,mode,pairs,size,msgs,usec,kib_s,msgs_s,"
+                     "p50_us,p90_us,p99_us,max_us,lost\n" :
+                     "Transport Mode   Pairs   Size     Msgs       Usec"
+                     "     KiB/s    Msg/s     p50     p90     p99     max"
+                     "    Lost\n");
+
+  for (i = 0; i < g_ipcbench_ntransports; i++)
+    {
+      transport = &g_ipcbench_transports[i];
+
+      /* Run the transports named on the command line, or all of them */
+
+      for (j = optind; j < argc; j++)
+        {
+          if (strcmp(argv[j], transport->name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (optind < argc && j == argc)
+        {
+          continue;
+        }
+
+      for (mode = 0; mode <= IPCBENCH_STREAM; mode++)
+        {
+          if ((bench.modes & IPCBENCH_MODE(mode)) == 0)
+            {
+              continue;
+            }
+
+          npairs = 1;
+          for (; ; )
+            {
+              size = bench.size > 0 ? bench.size : IPCBENCH_SWEEPMIN;
+
+              while (size <= CONFIG_TESTING_IPCBENCH_MAXSIZE &&
+                     size <= transport->maxsize)
+                {
+                  if (ipcbench_run(&bench, transport, mode, npairs,
+                                   size) < 0)
+                    {
+                      failures++;
+                    }
+
+                  if (bench.size > 0)
+                    {
+                      break;
+                    }
+
+                  size *= IPCBENCH_SWEEPSTEP;
+                }
+
+              if (npairs >= bench.maxpairs)
+                {
+                  break;
+                }
+
+              npairs = npairs * 2 > bench.maxpairs ?
+                       bench.maxpairs : npairs * 2;
+            }
+        }
+    }
+
+  return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
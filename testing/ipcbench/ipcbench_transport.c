@@ -0,0 +1,742 @@
+/****************************************************************************
+ * apps/testing/ipcbench/ipcbench_transport.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+
+#ifdef CONFIG_UORB
+#  include "uORB/orb/uORB.h"
+#endif
+
+#include "ipcbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Messages a queue holds before the sender blocks */
+
+#define IPCBENCH_MQ_MAXMSG  8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_UORB
+/* uORB keeps the metadata of a topic for as long as the system runs and
+ * refuses publications with other metadata, so each topic is created once
+ * per message size and pair and is never freed.
+ */
+
+struct ipcbench_topic_s
+{
+  FAR struct ipcbench_topic_s *flink;
+  struct orb_metadata meta;
+  char name[1];
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_UORB
+static FAR struct ipcbench_topic_s *g_ipcbench_topics;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if defined(CONFIG_PIPES) || defined(CONFIG_NET_LOCAL_STREAM)
+
+/****************************************************************************
+ * Name: ipcbench_readall
+ *
+ * Description:
+ *   Read one message from a byte stream.
+ *
+ ****************************************************************************/
+
+static int ipcbench_readall(int fd, FAR uint8_t *buf, size_t len)
+{
+  struct pollfd pfd;
+  ssize_t nread;
+  int ret;
+
+  pfd.fd     = fd;
+  pfd.events = POLLIN;
+
+  while (len > 0)
+    {
+      ret = poll(&pfd, 1, IPCBENCH_TIMEOUTMS);
+      if (ret <= 0)
+        {
+          return ret < 0 ? -errno : -ETIMEDOUT;
+        }
+
+      nread = read(fd, buf, len);
+      if (nread <= 0)
+        {
+          if (nread < 0 && errno == EINTR)
+            {
+              continue;
+            }
+
+          return nread < 0 ? -errno : -EPIPE;
+        }
+
+      buf += nread;
+      len -= nread;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_writeall
+ ****************************************************************************/
+
+static int ipcbench_writeall(int fd, FAR const uint8_t *buf, size_t len)
+{
+  ssize_t nwritten;
+
+  while (len > 0)
+    {
+      nwritten = write(fd, buf, len);
+      if (nwritten < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return -errno;
+        }
+
+      buf += nwritten;
+      len -= nwritten;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_fdsend and ipcbench_fdrecv
+ ****************************************************************************/
+
+static int ipcbench_fdsend(FAR struct ipcbench_pair_s *pair)
+{
+  return ipcbench_writeall(pair->txfd, pair->txbuf, pair->size);
+}
+
+static int ipcbench_fdrecv(FAR struct ipcbench_pair_s *pair)
+{
+  return ipcbench_readall(pair->rxfd, pair->rxbuf, pair->size);
+}
+#endif
+
+#if defined(CONFIG_PIPES) || defined(CONFIG_NET_LOCAL)
+
+/****************************************************************************
+ * Name: ipcbench_fdclose
+ ****************************************************************************/
+
+static void ipcbench_fdclose(FAR struct ipcbench_pair_s *pair)
+{
+  if (pair->txfd >= 0)
+    {
+      close(pair->txfd);
+      pair->txfd = -1;
+    }
+
+  if (pair->rxfd >= 0)
+    {
+      close(pair->rxfd);
+      pair->rxfd = -1;
+    }
+
+  if (pair->listenfd >= 0)
+    {
+      close(pair->listenfd);
+      pair->listenfd = -1;
+    }
+}
+#endif
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Name: ipcbench_pipe_setup
+ ****************************************************************************/
+
+static int ipcbench_pipe_setup(FAR struct ipcbench_pair_s *pair)
+{
+  int fds[2];
+
+  if (pipe(fds) < 0)
+    {
+      return -errno;
+    }
+
+  pair->rxfd = fds[0];
+  pair->txfd = fds[1];
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_fifo_path
+ ****************************************************************************/
+
+static void ipcbench_fifo_path(FAR struct ipcbench_pair_s *pair,
+                               FAR char *path, size_t len)
+{
+  snprintf(path, len, "%s.fifo%d", CONFIG_TESTING_IPCBENCH_PATH, pair->id);
+}
+
+/****************************************************************************
+ * Name: ipcbench_fifo_setup
+ ****************************************************************************/
+
+static int ipcbench_fifo_setup(FAR struct ipcbench_pair_s *pair)
+{
+  char path[64];
+
+  ipcbench_fifo_path(pair, path, sizeof(path));
+  if (mkfifo(path, 0666) < 0 && errno != EEXIST)
+    {
+      return -errno;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_fifo_rxopen and ipcbench_fifo_txopen
+ *
+ * Description:
+ *   Each open blocks until the other end is opened too.
+ *
+ ****************************************************************************/
+
+static int ipcbench_fifo_rxopen(FAR struct ipcbench_pair_s *pair)
+{
+  char path[64];
+
+  ipcbench_fifo_path(pair, path, sizeof(path));
+  pair->rxfd = open(path, O_RDONLY);
+  return pair->rxfd < 0 ? -errno : 0;
+}
+
+static int ipcbench_fifo_txopen(FAR struct ipcbench_pair_s *pair)
+{
+  char path[64];
+
+  ipcbench_fifo_path(pair, path, sizeof(path));
+  pair->txfd = open(path, O_WRONLY);
+  return pair->txfd < 0 ? -errno : 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_fifo_teardown
+ ****************************************************************************/
+
+static void ipcbench_fifo_teardown(FAR struct ipcbench_pair_s *pair)
+{
+  char path[64];
+
+  ipcbench_fdclose(pair);
+  ipcbench_fifo_path(pair, path, sizeof(path));
+  unlink(path);
+}
+#endif /* CONFIG_PIPES */
+
+#ifdef CONFIG_NET_LOCAL
+
+/****************************************************************************
+ * Name: ipcbench_local_addr
+ ****************************************************************************/
+
+static void ipcbench_local_addr(FAR struct ipcbench_pair_s *pair,
+                                FAR const char *kind)
+{
+  memset(&pair->addr, 0, sizeof(pair->addr));
+  pair->addr.sun_family = AF_LOCAL;
+  snprintf(pair->addr.sun_path, sizeof(pair->addr.sun_path), "%s.%s%d",
+           CONFIG_TESTING_IPCBENCH_PATH, kind, pair->id);
+}
+#endif
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+
+/****************************************************************************
+ * Name: ipcbench_ustream_setup
+ ****************************************************************************/
+
+static int ipcbench_ustream_setup(FAR struct ipcbench_pair_s *pair)
+{
+  ipcbench_local_addr(pair, "stream");
+
+  pair->listenfd = socket(AF_LOCAL, SOCK_STREAM, 0);
+  if (pair->listenfd < 0)
+    {
+      return -errno;
+    }
+
+  if (bind(pair->listenfd, (FAR struct sockaddr *)&pair->addr,
+           sizeof(pair->addr)) < 0 ||
+      listen(pair->listenfd, 1) < 0)
+    {
+      return -errno;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_ustream_rxopen
+ ****************************************************************************/
+
+static int ipcbench_ustream_rxopen(FAR struct ipcbench_pair_s *pair)
+{
+  struct pollfd pfd;
+  int ret;
+
+  /* Do not wait forever for a sender that failed to start */
+
+  pfd.fd     = pair->listenfd;
+  pfd.events = POLLIN;
+
+  ret = poll(&pfd, 1, IPCBENCH_TIMEOUTMS);
+  if (ret <= 0)
+    {
+      return ret < 0 ? -errno : -ETIMEDOUT;
+    }
+
+  pair->rxfd = accept(pair->listenfd, NULL, NULL);
+  return pair->rxfd < 0 ? -errno : 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_ustream_txopen
+ ****************************************************************************/
+
+static int ipcbench_ustream_txopen(FAR struct ipcbench_pair_s *pair)
+{
+  pair->txfd = socket(AF_LOCAL, SOCK_STREAM, 0);
+  if (pair->txfd < 0)
+    {
+      return -errno;
+    }
+
+  if (connect(pair->txfd, (FAR struct sockaddr *)&pair->addr,
+              sizeof(pair->addr)) < 0)
+    {
+      return -errno;
+    }
+
+  return 0;
+}
+#endif /* CONFIG_NET_LOCAL_STREAM */
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+
+/****************************************************************************
+ * Name: ipcbench_udgram_setup
+ ****************************************************************************/
+
+static int ipcbench_udgram_setup(FAR struct ipcbench_pair_s *pair)
+{
+  ipcbench_local_addr(pair, "dgram");
+
+  pair->rxfd = socket(AF_LOCAL, SOCK_DGRAM, 0);
+  if (pair->rxfd < 0)
+    {
+      return -errno;
+    }
+
+  if (bind(pair->rxfd, (FAR struct sockaddr *)&pair->addr,
+           sizeof(pair->addr)) < 0)
+    {
+      return -errno;
+    }
+
+  pair->txfd = socket(AF_LOCAL, SOCK_DGRAM, 0);
+  return pair->txfd < 0 ? -errno : 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_udgram_send
+ ****************************************************************************/
+
+static int ipcbench_udgram_send(FAR struct ipcbench_pair_s *pair)
+{
+  ssize_t nsent;
+
+  nsent = sendto(pair->txfd, pair->txbuf, pair->size, 0,
+                 (FAR struct sockaddr *)&pair->addr, sizeof(pair->addr));
+  if (nsent < 0)
+    {
+      return -errno;
+    }
+
+  return (size_t)nsent == pair->size ? 0 : -EMSGSIZE;
+}
+
+/****************************************************************************
+ * Name: ipcbench_udgram_recv
+ ****************************************************************************/
+
+static int ipcbench_udgram_recv(FAR struct ipcbench_pair_s *pair)
+{
+  struct pollfd pfd;
+  ssize_t nrecvd;
+  int ret;
+
+  pfd.fd     = pair->rxfd;
+  pfd.events = POLLIN;
+
+  ret = poll(&pfd, 1, IPCBENCH_TIMEOUTMS);
+  if (ret <= 0)
+    {
+      return ret < 0 ? -errno : -ETIMEDOUT;
+    }
+
+  nrecvd = recv(pair->rxfd, pair->rxbuf, pair->size, 0);
+  if (nrecvd < 0)
+    {
+      return -errno;
+    }
+
+  return (size_t)nrecvd == pair->size ? 0 : -EMSGSIZE;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+#ifdef CONFIG_NET_LOCAL
+
+/****************************************************************************
+ * Name: ipcbench_local_teardown
+ ****************************************************************************/
+
+static void ipcbench_local_teardown(FAR struct ipcbench_pair_s *pair)
+{
+  ipcbench_fdclose(pair);
+  unlink(pair->addr.sun_path);
+}
+#endif
+
+#ifndef CONFIG_DISABLE_MQUEUE
+
+/****************************************************************************
+ * Name: ipcbench_mq_name
+ ****************************************************************************/
+
+static void ipcbench_mq_name(FAR struct ipcbench_pair_s *pair,
+                             FAR char *name, size_t len)
+{
+  snprintf(name, len, "/ipcbench%d", pair->id);
+}
+
+/****************************************************************************
+ * Name: ipcbench_mq_setup
+ ****************************************************************************/
+
+static int ipcbench_mq_setup(FAR struct ipcbench_pair_s *pair)
+{
+  struct mq_attr attr;
+  char name[32];
+
+  ipcbench_mq_name(pair, name, sizeof(name));
+
+  memset(&attr, 0, sizeof(attr));
+  attr.mq_maxmsg  = IPCBENCH_MQ_MAXMSG;
+  attr.mq_msgsize = pair->size;
+
+  pair->rxmq = mq_open(name, O_RDONLY | O_CREAT, 0666, &attr);
+  if (pair->rxmq == (mqd_t)-1)
+    {
+      return -errno;
+    }
+
+  pair->txmq = mq_open(name, O_WRONLY);
+  return pair->txmq == (mqd_t)-1 ? -errno : 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_mq_send
+ ****************************************************************************/
+
+static int ipcbench_mq_send(FAR struct ipcbench_pair_s *pair)
+{
+  if (mq_send(pair->txmq, (FAR const char *)pair->txbuf, pair->size, 0) < 0)
+    {
+      return -errno;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_mq_recv
+ ****************************************************************************/
+
+static int ipcbench_mq_recv(FAR struct ipcbench_pair_s *pair)
+{
+  struct timespec abstime;
+  ssize_t nrecvd;
+
+  clock_gettime(CLOCK_REALTIME, &abstime);
+  abstime.tv_sec += IPCBENCH_TIMEOUTMS / 1000;
+
+  nrecvd = mq_timedreceive(pair->rxmq, (FAR char *)pair->rxbuf, pair->size,
+                           NULL, &abstime);
+  if (nrecvd < 0)
+    {
+      return -errno;
+    }
+
+  return (size_t)nrecvd == pair->size ? 0 : -EMSGSIZE;
+}
+
+/****************************************************************************
+ * Name: ipcbench_mq_teardown
+ ****************************************************************************/
+
+static void ipcbench_mq_teardown(FAR struct ipcbench_pair_s *pair)
+{
+  char name[32];
+
+  if (pair->txmq != (mqd_t)-1)
+    {
+      mq_close(pair->txmq);
+      pair->txmq = (mqd_t)-1;
+    }
+
+  if (pair->rxmq != (mqd_t)-1)
+    {
+      mq_close(pair->rxmq);
+      pair->rxmq = (mqd_t)-1;
+    }
+
+  ipcbench_mq_name(pair, name, sizeof(name));
+  mq_unlink(name);
+}
+#endif /* CONFIG_DISABLE_MQUEUE */
+
+#ifdef CONFIG_UORB
+
+/****************************************************************************
+ * Name: ipcbench_uorb_topic
+ *
+ * Description:
+ *   Return the topic of a message size and pair, creating it on first use.
+ *
+ ****************************************************************************/
+
+static FAR const struct orb_metadata *
+ipcbench_uorb_topic(FAR struct ipcbench_pair_s *pair)
+{
+  FAR struct ipcbench_topic_s *topic;
+  char name[32];
+
+  snprintf(name, sizeof(name), "ipcbench_%lu_%d",
+           (unsigned long)pair->size, pair->id);
+
+  for (topic = g_ipcbench_topics; topic != NULL; topic = topic->flink)
+    {
+      if (strcmp(topic->name, name) == 0)
+        {
+          return &topic->meta;
+        }
+    }
+
+  topic = malloc(sizeof(*topic) + strlen(name));
+  if (topic != NULL)
+    {
+      struct orb_metadata meta =
+      {
+        topic->name, pair->size, pair->size, NULL
+      };
+
+      strcpy(topic->name, name);
+      memcpy(&topic->meta, &meta, sizeof(meta));
+      topic->flink      = g_ipcbench_topics;
+      g_ipcbench_topics = topic;
+      return &topic->meta;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipcbench_uorb_setup
+ ****************************************************************************/
+
+static int ipcbench_uorb_setup(FAR struct ipcbench_pair_s *pair)
+{
+  FAR const struct orb_metadata *meta;
+  FAR struct ipcbench_msg_s *msg = (FAR struct ipcbench_msg_s *)pair->txbuf;
+
+  meta = ipcbench_uorb_topic(pair);
+  if (meta == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  pair->meta = meta;
+  pair->rxfd = orb_subscribe(meta);
+  if (pair->rxfd < 0)
+    {
+      return -errno;
+    }
+
+  /* The subscriber may see the initial value as an update */
+
+  msg->seq     = IPCBENCH_SEQ_NONE;
+  pair->advert = orb_advertise(meta, pair->txbuf);
+  return pair->advert == NULL ? -ENODEV : 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_uorb_send
+ ****************************************************************************/
+
+static int ipcbench_uorb_send(FAR struct ipcbench_pair_s *pair)
+{
+  return orb_publish(pair->meta, pair->advert, pair->txbuf) == 0 ? 0 : -EIO;
+}
+
+/****************************************************************************
+ * Name: ipcbench_uorb_recv
+ *
+ * Description:
+ *   Wait for the next publication.  A slow receiver only sees the latest
+ *   one, the caller counts the others as lost.
+ *
+ ****************************************************************************/
+
+static int ipcbench_uorb_recv(FAR struct ipcbench_pair_s *pair)
+{
+  FAR struct ipcbench_msg_s *msg = (FAR struct ipcbench_msg_s *)pair->rxbuf;
+  struct pollfd pfd;
+  int ret;
+
+  pfd.fd     = pair->rxfd;
+  pfd.events = POLLIN;
+
+  do
+    {
+      ret = poll(&pfd, 1, IPCBENCH_TIMEOUTMS);
+      if (ret <= 0)
+        {
+          return ret < 0 ? -errno : -ETIMEDOUT;
+        }
+
+      if (orb_copy(pair->meta, pair->rxfd, pair->rxbuf) != 0)
+        {
+          return -EIO;
+        }
+    }
+  while (msg->seq == IPCBENCH_SEQ_NONE);
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipcbench_uorb_teardown
+ ****************************************************************************/
+
+static void ipcbench_uorb_teardown(FAR struct ipcbench_pair_s *pair)
+{
+  if (pair->rxfd >= 0)
+    {
+      orb_unsubscribe(pair->rxfd);
+      pair->rxfd = -1;
+    }
+
+  if (pair->advert != NULL)
+    {
+      orb_unadvertise(pair->advert);
+      pair->advert = NULL;
+    }
+}
+#endif /* CONFIG_UORB */
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct ipcbench_transport_s g_ipcbench_transports[] =
+{
+#ifdef CONFIG_PIPES
+  {
+    "pipe", SIZE_MAX, ipcbench_pipe_setup, NULL, NULL,
+    ipcbench_fdsend, ipcbench_fdrecv, ipcbench_fdclose
+  },
+  {
+    "fifo", SIZE_MAX, ipcbench_fifo_setup, ipcbench_fifo_rxopen,
+    ipcbench_fifo_txopen, ipcbench_fdsend, ipcbench_fdrecv,
+    ipcbench_fifo_teardown
+  },
+#endif
+#ifdef CONFIG_NET_LOCAL_STREAM
+  {
+    "ustream", SIZE_MAX, ipcbench_ustream_setup, ipcbench_ustream_rxopen,
+    ipcbench_ustream_txopen, ipcbench_fdsend, ipcbench_fdrecv,
+    ipcbench_local_teardown
+  },
+#endif
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  {
+    "udgram", UINT16_MAX, ipcbench_udgram_setup, NULL, NULL,
+    ipcbench_udgram_send, ipcbench_udgram_recv, ipcbench_local_teardown
+  },
+#endif
+#ifndef CONFIG_DISABLE_MQUEUE
+  {
+    "mqueue", CONFIG_MQ_MAXMSGSIZE, ipcbench_mq_setup, NULL, NULL,
+    ipcbench_mq_send, ipcbench_mq_recv, ipcbench_mq_teardown
+  },
+#endif
+#ifdef CONFIG_UORB
+  {
+    "uorb", UINT16_MAX, ipcbench_uorb_setup, NULL, NULL,
+    ipcbench_uorb_send, ipcbench_uorb_recv, ipcbench_uorb_teardown
+  },
+#endif
+};
+
+const int g_ipcbench_ntransports =
+  sizeof(g_ipcbench_transports) / sizeof(g_ipcbench_transports[0]);
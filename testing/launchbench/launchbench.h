@@ -0,0 +1,80 @@
+/****************************************************************************
+ * apps/testing/launchbench/launchbench.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_TESTING_LAUNCHBENCH_LAUNCHBENCH_H
+#define __APPS_TESTING_LAUNCHBENCH_LAUNCHBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <time.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* What a launched program writes back to launchbench on entry to main() */
+
+struct launchbench_report_s
+{
+  uint64_t stamp;                    /* CLOCK_MONOTONIC time (us) */
+  uint32_t heap;                     /* Heap in use (bytes) */
+  uint32_t reserved;
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: launchbench_child
+ *
+ * Description:
+ *   Called first thing in main() of each program that launchbench starts.
+ *   The last argument is the number of the write end of a pipe that the
+ *   program inherited from launchbench.  This is inline so that the ELF test
+ *   programs need nothing but the symbol table of launchbench.
+ *
+ ****************************************************************************/
+
+static inline void launchbench_child(int argc, FAR char *argv[])
+{
+  struct launchbench_report_s report;
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  if (argc > 1)
+    {
+      report.stamp    = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+      report.heap     = mallinfo().uordblks;
+      report.reserved = 0;
+      write(atoi(argv[argc - 1]), &report, sizeof(report));
+    }
+}
+
+#endif /* __APPS_TESTING_LAUNCHBENCH_LAUNCHBENCH_H */
@@ -0,0 +1,729 @@
+/****************************************************************************
+ * apps/testing/launchbench/launchbench_main.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/boardctl.h>
+#include <sys/mount.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/symtab.h>
+#ifndef CONFIG_BINFMT_DISABLE
+#  include <nuttx/binfmt/binfmt.h>
+#endif
+
+#ifdef CONFIG_BUILTIN
+#  include "builtin/builtin.h"
+#endif
+
+#include "launchbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LAUNCHBENCH_DEFRUNS   100
+
+/* The ELF test programs and the -f files */
+
+#define LAUNCHBENCH_MAXFILES  8
+
+/* Passes over the symbol table when timing the lookups */
+
+#define LAUNCHBENCH_SYMLOOPS  100
+
+#define LAUNCHBENCH_MOUNTPT   "/mnt/launchbench"
+
+#ifdef CONFIG_TESTING_LAUNCHBENCH_ELF
+#  define SECTORSIZE          512
+#  define NSECTORS(b)         (((b) + SECTORSIZE - 1) / SECTORSIZE)
+#endif
+
+/* The ways of launching a program that are available */
+
+#ifndef CONFIG_BINFMT_DISABLE
+#  define LAUNCHBENCH_HAVE_EXEC 1
+#endif
+
+#ifdef CONFIG_LIBC_EXECFUNCS
+#  define LAUNCHBENCH_HAVE_SPAWN 1
+#  ifdef CONFIG_ARCH_HAVE_VFORK
+#    define LAUNCHBENCH_HAVE_VFORK 1
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct launchbench_s
+{
+  uint32_t runs;                     /* Timed launches per program */
+  bool csv;                          /* Print results as CSV */
+  int nfiles;
+  FAR const char *files[LAUNCHBENCH_MAXFILES];
+  FAR const struct symtab_s *exports;
+  int nexports;
+  int rxfd;                          /* Read end of the report pipe */
+  char txfd[12];                     /* Write end, as the last argument */
+};
+
+/* A way of launching a program.  launch() returns 0 or a negated errno. */
+
+struct launchbench_loader_s
+{
+  FAR const char *name;
+  FAR const char *program;           /* Launched, NULL: the program files */
+  CODE int (*launch)(FAR const struct launchbench_s *bench,
+                     FAR const char *path, FAR char * const argv[],
+                     FAR pid_t *pid);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILTIN
+static int launchbench_builtin(FAR const struct launchbench_s *bench,
+                               FAR const char *path,
+                               FAR char * const argv[], FAR pid_t *pid);
+#endif
+#ifdef LAUNCHBENCH_HAVE_EXEC
+static int launchbench_exec(FAR const struct launchbench_s *bench,
+                            FAR const char *path, FAR char * const argv[],
+                            FAR pid_t *pid);
+#endif
+#ifdef LAUNCHBENCH_HAVE_SPAWN
+static int launchbench_spawn(FAR const struct launchbench_s *bench,
+                             FAR const char *path, FAR char * const argv[],
+                             FAR pid_t *pid);
+#endif
+#ifdef LAUNCHBENCH_HAVE_VFORK
+static int launchbench_vfork(FAR const struct launchbench_s *bench,
+                             FAR const char *path, FAR char * const argv[],
+                             FAR pid_t *pid);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct launchbench_loader_s g_launchbench_loaders[] =
+{
+#ifdef CONFIG_BUILTIN
+  { "builtin", CONFIG_TESTING_LAUNCHBENCH_CHILD_PROGNAME,
+    launchbench_builtin },
+#endif
+#ifdef LAUNCHBENCH_HAVE_EXEC
+  { "exec",    NULL, launchbench_exec  },
+#endif
+#ifdef LAUNCHBENCH_HAVE_SPAWN
+  { "spawn",   NULL, launchbench_spawn },
+#endif
+#ifdef LAUNCHBENCH_HAVE_VFORK
+  { "vfork",   NULL, launchbench_vfork },
+#endif
+};
+
+#define LAUNCHBENCH_NLOADERS \
+  (int)(sizeof(g_launchbench_loaders) / sizeof(g_launchbench_loaders[0]))
+
+/****************************************************************************
+ * External Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_TESTING_LAUNCHBENCH_ELF
+extern const unsigned char romfs_img[];
+extern const unsigned int romfs_img_len;
+
+extern const struct symtab_s g_launchbench_exports[];
+extern const int g_launchbench_nexports;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: launchbench_usec
+ ****************************************************************************/
+
+static uint64_t launchbench_usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: launchbench_compare
+ ****************************************************************************/
+
+static int launchbench_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: launchbench_builtin
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILTIN
+static int launchbench_builtin(FAR const struct launchbench_s *bench,
+                               FAR const char *path,
+                               FAR char * const argv[], FAR pid_t *pid)
+{
+  int ret;
+
+  ret = exec_builtin(path, argv, NULL, 0);
+  if (ret < 0)
+    {
+      return -errno;
+    }
+
+  *pid = ret;
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: launchbench_exec
+ *
+ * Description:
+ *   Load a program file with the binary loader that claims it, resolving
+ *   its imports against the symbol table of launchbench.
+ *
+ ****************************************************************************/
+
+#ifdef LAUNCHBENCH_HAVE_EXEC
+static int launchbench_exec(FAR const struct launchbench_s *bench,
+                            FAR const char *path, FAR char * const argv[],
+                            FAR pid_t *pid)
+{
+  int ret;
+
+  ret = exec(path, argv, bench->exports, bench->nexports);
+  if (ret < 0)
+    {
+      return -errno;
+    }
+
+  *pid = ret;
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: launchbench_spawn
+ ****************************************************************************/
+
+#ifdef LAUNCHBENCH_HAVE_SPAWN
+static int launchbench_spawn(FAR const struct launchbench_s *bench,
+                             FAR const char *path, FAR char * const argv[],
+                             FAR pid_t *pid)
+{
+  return -posix_spawn(pid, path, NULL, NULL, argv, NULL);
+}
+#endif
+
+/****************************************************************************
+ * Name: launchbench_vfork
+ ****************************************************************************/
+
+#ifdef LAUNCHBENCH_HAVE_VFORK
+static int launchbench_vfork(FAR const struct launchbench_s *bench,
+                             FAR const char *path, FAR char * const argv[],
+                             FAR pid_t *pid)
+{
+  pid_t child;
+
+  child = vfork();
+  if (child == 0)
+    {
+      execv(path, argv);
+      _exit(EXIT_FAILURE);
+    }
+  else if (child < 0)
+    {
+      return -errno;
+    }
+
+  *pid = child;
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: launchbench_stats
+ *
+ * Description:
+ *   Print the p50, p99 and max of the samples.  Sorts them in place.
+ *
+ ****************************************************************************/
+
+static void launchbench_stats(FAR const struct launchbench_s *bench,
+                              FAR uint32_t *lat, uint32_t nlat)
+{
+  if (nlat == 0)
+    {
+      printf(bench->csv ? ",,," : "       -       -       -");
+      return;
+    }
+
+  qsort(lat, nlat, sizeof(uint32_t), launchbench_compare);
+  printf(bench->csv ? ",%lu,%lu,%lu" : " %7lu %7lu %7lu",
+         (unsigned long)lat[(uint64_t)(nlat - 1) * 50 / 100],
+         (unsigned long)lat[(uint64_t)(nlat - 1) * 99 / 100],
+         (unsigned long)lat[nlat - 1]);
+}
+
+/****************************************************************************
+ * Name: launchbench_run
+ *
+ * Description:
+ *   Launch one program "runs" times, after one launch that is not counted,
+ *   and wait for it to exit each time.  Report the time from the launch to
+ *   main() of the program and to its exit, the most heap that it held in
+ *   main() and what was not freed when it exited.
+ *
+ ****************************************************************************/
+
+static int launchbench_run(FAR const struct launchbench_s *bench,
+                           FAR const struct launchbench_loader_s *loader,
+                           FAR const char *path)
+{
+  struct launchbench_report_s report;
+  FAR const char *name;
+  FAR char *argv[3];
+  FAR uint32_t *mainlat;
+  FAR uint32_t *exitlat;
+  uint32_t nmain = 0;
+  uint32_t nexit = 0;
+  int32_t heap = 0;
+  int32_t leak = 0;
+  uint32_t before;
+  uint64_t start;
+  uint64_t end;
+  uint32_t i;
+  pid_t pid;
+  int status;
+  int ret = 0;
+
+  name = strrchr(path, '/');
+  name = name != NULL ? name + 1 : path;
+
+  mainlat = malloc(2 * sizeof(uint32_t) * bench->runs);
+  if (mainlat == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  exitlat = mainlat + bench->runs;
+
+  argv[0] = (FAR char *)name;
+  argv[1] = (FAR char *)bench->txfd;
+  argv[2] = NULL;
+
+  for (i = 0; i <= bench->runs; i++)
+    {
+      /* Drop a report that a failed launch left behind */
+
+      while (read(bench->rxfd, &report, sizeof(report)) > 0);
+
+      before = mallinfo().uordblks;
+      start  = launchbench_usec();
+
+      ret = loader->launch(bench, path, argv, &pid);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = waitpid(pid, &status, 0);
+      end = launchbench_usec();
+
+      if (ret < 0)
+        {
+          ret = -errno;
+          break;
+        }
+
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+          ret = -ECHILD;
+          break;
+        }
+
+      ret = 0;
+
+      /* The first launch fills the caches and is not counted */
+
+      if (i == 0)
+        {
+          continue;
+        }
+
+      exitlat[nexit++] = end - start;
+      leak = (int32_t)(mallinfo().uordblks - before);
+
+      /* Only programs that call launchbench_child() report back */
+
+      if (read(bench->rxfd, &report, sizeof(report)) == sizeof(report))
+        {
+          mainlat[nmain++] = report.stamp - start;
+          if ((int32_t)(report.heap - before) > heap)
+            {
+              heap = (int32_t)(report.heap - before);
+            }
+        }
+    }
+
+  if (ret >= 0)
+    {
+      printf(bench->csv ? "%s,%s,%lu" : "%-8s %-12s %6lu",
+             loader->name, name, (unsigned long)nexit);
+      launchbench_stats(bench, mainlat, nmain);
+      launchbench_stats(bench, exitlat, nexit);
+      printf(bench->csv ? ",%ld,%ld\n" : " %8ld %6ld\n",
+             nmain > 0 ? (long)heap : 0, (long)leak);
+    }
+
+  free(mainlat);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: launchbench_symtab
+ *
+ * Description:
+ *   Time the lookup of each symbol of the symbol table, as the binary
+ *   loaders do for every undefined symbol of a program.
+ *
+ ****************************************************************************/
+
+static void launchbench_symtab(FAR const struct launchbench_s *bench)
+{
+  FAR const struct symtab_s *symbol;
+  uint32_t misses = 0;
+  uint64_t elapsed;
+  uint64_t nlookups;
+  int loop;
+  int i;
+
+  if (bench->nexports == 0)
+    {
+      return;
+    }
+
+  elapsed = launchbench_usec();
+
+  for (loop = 0; loop < LAUNCHBENCH_SYMLOOPS; loop++)
+    {
+      for (i = 0; i < bench->nexports; i++)
+        {
+          symbol = symtab_findbyname(bench->exports,
+                                     bench->exports[i].sym_name,
+                                     bench->nexports);
+          if (symbol != &bench->exports[i])
+            {
+              misses++;
+            }
+        }
+    }
+
+  elapsed  = launchbench_usec() - elapsed;
+  nlookups = (uint64_t)LAUNCHBENCH_SYMLOOPS * bench->nexports;
+
+  printf(bench->csv ? "\nsymbols,ordered,lookups,usec,ns_lookup,us_table,"
+                      "misses\n%d,%s,%llu,%llu,%llu,%llu,%lu\n" :
+                      "\nSymbols Ordered  Lookups       Usec ns/Lookup "
+                      "us/Table  Misses\n%7d %-7s %8llu %10llu %9llu "
+                      "%8llu %7lu\n",
+         bench->nexports,
+#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+         "yes",
+#else
+         "no",
+#endif
+         (unsigned long long)nlookups, (unsigned long long)elapsed,
+         (unsigned long long)(elapsed * 1000 / nlookups),
+         (unsigned long long)(elapsed / LAUNCHBENCH_SYMLOOPS),
+         (unsigned long)misses);
+}
+
+/****************************************************************************
+ * Name: launchbench_mount
+ *
+ * Description:
+ *   Register the ROMFS image of the ELF test programs as a RAM disk and
+ *   mount it, unless an earlier run already did.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TESTING_LAUNCHBENCH_ELF
+static int launchbench_mount(void)
+{
+  struct boardioc_romdisk_s desc;
+  char devpath[16];
+  int ret;
+
+  if (access(LAUNCHBENCH_MOUNTPT "/trivial", F_OK) == 0)
+    {
+      return 0;
+    }
+
+  desc.minor    = CONFIG_TESTING_LAUNCHBENCH_DEVMINOR;
+  desc.nsectors = NSECTORS(romfs_img_len);
+  desc.sectsize = SECTORSIZE;
+  desc.image    = (FAR uint8_t *)romfs_img;
+
+  ret = boardctl(BOARDIOC_ROMDISK, (uintptr_t)&desc);
+  if (ret < 0)
+    {
+      return -errno;
+    }
+
+  snprintf(devpath, sizeof(devpath), "/dev/ram%d",
+           CONFIG_TESTING_LAUNCHBENCH_DEVMINOR);
+
+  ret = mount(devpath, LAUNCHBENCH_MOUNTPT, "romfs", MS_RDONLY, NULL);
+  if (ret < 0)
+    {
+      return -errno;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: launchbench_showusage
+ ****************************************************************************/
+
+static void launchbench_showusage(FAR const char *progname, int exitcode)
+{
+  int i;
+
+  fprintf(stderr, "USAGE: %s [OPTIONS] [<loader> ...]\n", progname);
+  fprintf(stderr, "Where OPTIONS are:\n");
+  fprintf(stderr, "  -n <runs>   Launches of each program.  Default: %u\n",
+          LAUNCHBENCH_DEFRUNS);
+  fprintf(stderr, "  -f <path>   Also launch this program file, such as "
+          "an NXFLAT binary\n");
+  fprintf(stderr, "  -C          Print the results as CSV\n");
+  fprintf(stderr, "Programs get the number of a pipe as their last "
+          "argument.  Those that do not\n");
+  fprintf(stderr, "call launchbench_child() with it have no times to "
+          "main() and no heap.\n");
+  fprintf(stderr, "Loaders (default: all):");
+
+  for (i = 0; i < LAUNCHBENCH_NLOADERS; i++)
+    {
+      fprintf(stderr, " %s", g_launchbench_loaders[i].name);
+    }
+
+  fprintf(stderr, "\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  FAR const struct launchbench_loader_s *loader;
+#ifdef CONFIG_BOARDCTL_APP_SYMTAB
+  struct boardioc_symtab_s symdesc;
+#endif
+  struct launchbench_s bench;
+  FAR const char *path;
+  int failures = 0;
+  int fds[2];
+  int option;
+  int ret;
+  int i;
+  int j;
+  int k;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.runs = LAUNCHBENCH_DEFRUNS;
+
+#ifdef CONFIG_TESTING_LAUNCHBENCH_ELF
+  bench.files[bench.nfiles++] = LAUNCHBENCH_MOUNTPT "/trivial";
+  bench.files[bench.nfiles++] = LAUNCHBENCH_MOUNTPT "/large";
+  bench.exports  = g_launchbench_exports;
+  bench.nexports = g_launchbench_nexports;
+#endif
+
+  while ((option = getopt(argc, argv, "n:f:Ch")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'n':
+            bench.runs = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'f':
+            if (bench.nfiles >= LAUNCHBENCH_MAXFILES)
+              {
+                launchbench_showusage(argv[0], EXIT_FAILURE);
+              }
+
+            bench.files[bench.nfiles++] = optarg;
+            break;
+
+          case 'C':
+            bench.csv = true;
+            break;
+
+          case 'h':
+            launchbench_showusage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            launchbench_showusage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (bench.runs < 1)
+    {
+      launchbench_showusage(argv[0], EXIT_FAILURE);
+    }
+
+  for (j = optind; j < argc; j++)
+    {
+      for (i = 0; i < LAUNCHBENCH_NLOADERS; i++)
+        {
+          if (strcmp(argv[j], g_launchbench_loaders[i].name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (i == LAUNCHBENCH_NLOADERS)
+        {
+          fprintf(stderr, "ERROR: Unknown loader %s\n", argv[j]);
+          launchbench_showusage(argv[0], EXIT_FAILURE);
+        }
+    }
+
+#ifdef CONFIG_TESTING_LAUNCHBENCH_ELF
+  ret = launchbench_mount();
+  if (ret < 0)
+    {
+      fprintf(stderr, "ERROR: Failed to mount %s: %d\n",
+              LAUNCHBENCH_MOUNTPT, ret);
+      return EXIT_FAILURE;
+    }
+
+#ifdef CONFIG_BOARDCTL_APP_SYMTAB
+  /* posix_spawn() and execv() use the symbol table of the OS */
+
+  symdesc.symtab   = (FAR struct symtab_s *)g_launchbench_exports;
+  symdesc.nsymbols = g_launchbench_nexports;
+  boardctl(BOARDIOC_APP_SYMTAB, (uintptr_t)&symdesc);
+#endif
+#endif
+
+  /* The programs report on a pipe that is read once they have exited */
+
+  if (pipe(fds) < 0)
+    {
+      fprintf(stderr, "ERROR: pipe failed: %d\n", errno);
+      return EXIT_FAILURE;
+    }
+
+  fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+  bench.rxfd = fds[0];
+  snprintf(bench.txfd, sizeof(bench.txfd), "%d", fds[1]);
+
+  printf(bench.csv ? "loader,program,runs,main_p50_us,main_p99_us,"
+                     "main_max_us,exit_p50_us,exit_p99_us,exit_max_us,"
+                     "heap,leak\n" :
+                     "Loader   Program        Runs"
+                     " MainP50 MainP99 MainMax ExitP50 ExitP99 ExitMax"
+                     "     Heap   Leak\n");
+
+  for (i = 0; i < LAUNCHBENCH_NLOADERS; i++)
+    {
+      loader = &g_launchbench_loaders[i];
+
+      /* Run the loaders named on the command line, or all of them */
+
+      for (j = optind; j < argc; j++)
+        {
+          if (strcmp(argv[j], loader->name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (optind < argc && j == argc)
+        {
+          continue;
+        }
+
+      for (k = 0; k < (loader->program ? 1 : bench.nfiles); k++)
+        {
+          path = loader->program ? loader->program : bench.files[k];
+
+          ret = launchbench_run(&bench, loader, path);
+          if (ret < 0)
+            {
+              fprintf(stderr, "ERROR: %s %s: %d\n", loader->name, path,
+                      ret);
+              failures++;
+            }
+        }
+    }
+
+  launchbench_symtab(&bench);
+
+  close(fds[0]);
+  close(fds[1]);
+  return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
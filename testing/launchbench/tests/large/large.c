@@ -0,0 +1,112 @@
+/****************************************************************************
+ * apps/testing/launchbench/tests/large/large.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../launchbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* 32 KiB of each of read-only and initialized data */
+
+#define LARGE_NWORDS 8192
+
+#define IMPORT(f)    (FAR const void *)(f)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Only partly initialized, the tables still take their full size in the
+ * file and must be copied in or mapped by the loader.
+ */
+
+static const uint32_t g_large_rodata[LARGE_NWORDS] =
+{
+  0x6c61756e, 0x63686265, 0x6e636820, 0x6c617267
+};
+
+static uint32_t g_large_data[LARGE_NWORDS] =
+{
+  0x6c617267, 0x65206461, 0x74612e2e
+};
+
+/* Each entry is an undefined symbol for the loader to look up and a
+ * relocation for it to apply.
+ */
+
+static FAR const void * const g_large_imports[] =
+{
+  IMPORT(memchr),    IMPORT(memcmp),    IMPORT(memcpy),    IMPORT(memmove),
+  IMPORT(memset),    IMPORT(strcat),    IMPORT(strchr),    IMPORT(strcmp),
+  IMPORT(strcpy),    IMPORT(strdup),    IMPORT(strlen),    IMPORT(strncat),
+  IMPORT(strncmp),   IMPORT(strncpy),   IMPORT(strrchr),   IMPORT(strstr),
+  IMPORT(strtok_r),  IMPORT(strerror),  IMPORT(malloc),    IMPORT(calloc),
+  IMPORT(realloc),   IMPORT(free),      IMPORT(atoi),      IMPORT(atol),
+  IMPORT(strtol),    IMPORT(strtoul),   IMPORT(qsort),     IMPORT(bsearch),
+  IMPORT(abs),       IMPORT(labs),      IMPORT(rand),      IMPORT(srand),
+  IMPORT(getenv),    IMPORT(setenv),    IMPORT(printf),    IMPORT(fprintf),
+  IMPORT(sprintf),   IMPORT(snprintf),  IMPORT(vsnprintf), IMPORT(sscanf),
+  IMPORT(puts),      IMPORT(fputs),     IMPORT(fgets),     IMPORT(fopen),
+  IMPORT(fclose),    IMPORT(fread),     IMPORT(fwrite),    IMPORT(fseek),
+  IMPORT(ftell),     IMPORT(fflush),    IMPORT(open),      IMPORT(close),
+  IMPORT(read),      IMPORT(lseek),     IMPORT(ioctl),     IMPORT(stat),
+  IMPORT(unlink),    IMPORT(usleep),    IMPORT(sleep),     IMPORT(time),
+  IMPORT(gmtime_r),  IMPORT(mktime),    IMPORT(strftime),  IMPORT(getpid),
+  IMPORT(kill),      IMPORT(sem_init),  IMPORT(sem_wait),  IMPORT(sem_post),
+  IMPORT(sem_destroy), IMPORT(sched_yield)
+};
+
+#define LARGE_NIMPORTS (sizeof(g_large_imports) / sizeof(g_large_imports[0]))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  /* Report back to launchbench first, so that the time spent in main()
+   * does not count.
+   */
+
+  launchbench_child(argc, argv);
+
+  /* Keep the tables in the program */
+
+  return g_large_imports[argc % LARGE_NIMPORTS] == NULL ||
+         g_large_rodata[argc] == g_large_data[argc + 1];
+}
@@ -0,0 +1,667 @@
+/****************************************************************************
+ * apps/testing/mtdbench/mtdbench_main.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/mtd/mtd.h>
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+/* The default is to use the RAM MTD device at drivers/mtd/rammtd.c.  But
+ * an architecture-specific MTD driver can be used instead by defining
+ * CONFIG_TESTING_MTDBENCH_ARCHINIT.  In this case, the initialization logic
+ * will call mtdbench_archinitialize() to obtain the MTD driver instance.
+ */
+
+#ifndef CONFIG_TESTING_MTDBENCH_ARCHINIT
+
+/* Make sure that the RAM MTD driver is enabled */
+
+#  ifndef CONFIG_RAMMTD
+#    error "CONFIG_RAMMTD is required without CONFIG_TESTING_MTDBENCH_ARCHINIT"
+#  endif
+
+/* This must exactly match the default configuration in
+ * drivers/mtd/rammtd.c
+ */
+
+#  ifndef CONFIG_RAMMTD_ERASESIZE
+#    define CONFIG_RAMMTD_ERASESIZE 4096
+#  endif
+
+#  ifndef CONFIG_TESTING_MTDBENCH_NEBLOCKS
+#    define CONFIG_TESTING_MTDBENCH_NEBLOCKS 64
+#  endif
+
+#  define MTDBENCH_BUFSIZE \
+    (CONFIG_RAMMTD_ERASESIZE * CONFIG_TESTING_MTDBENCH_NEBLOCKS)
+
+#endif
+
+#if defined(CONFIG_MTD_WRBUFFER) || defined(CONFIG_MTD_READAHEAD)
+#  define HAVE_MTD_RWB 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* An MTD that forwards to the device under test and counts what really
+ * reaches it.  The R/W buffer layer is stacked on top of this shim so that
+ * its erase and write amplification can be measured.
+ */
+
+struct mtdbench_shim_s
+{
+  struct mtd_dev_s mtd;              /* Must be first */
+  FAR struct mtd_dev_s *lower;       /* Device under test */
+  uint32_t blocksize;                /* Read/write block size */
+  uint32_t erases;                   /* Erase blocks erased */
+  uint64_t rdbytes;                  /* Bytes read from the device */
+  uint64_t wrbytes;                  /* Bytes written to the device */
+};
+
+enum mtdbench_pattern_e
+{
+  MTDBENCH_ERASE = 0,
+  MTDBENCH_SEQWRITE,
+  MTDBENCH_SEQREAD,
+  MTDBENCH_RANDWRITE,
+  MTDBENCH_RANDREAD,
+  MTDBENCH_NPATTERNS
+};
+
+struct mtdbench_s
+{
+  FAR struct mtdbench_shim_s *shim;  /* Counting shim over the device */
+  struct mtd_geometry_s geo;         /* Geometry of the device */
+  off_t nblocks;                     /* Read/write blocks on the device */
+  uint32_t iosize;                   /* Blocks per operation */
+  uint32_t nrandom;                  /* Operations of the random patterns */
+  unsigned int seed;                 /* Seed of the random patterns */
+  FAR uint8_t *buffer;               /* I/O buffer of iosize blocks */
+  FAR uint32_t *latency;             /* Per-operation latencies (us) */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_patterns[MTDBENCH_NPATTERNS] =
+{
+  "erase",
+  "seqwrite",
+  "seqread",
+  "randwrite",
+  "randread"
+};
+
+/* The device stack is created on the first run and kept for later ones
+ * since the MTD layers cannot be torn down.
+ */
+
+#ifndef CONFIG_TESTING_MTDBENCH_ARCHINIT
+static uint8_t g_simflash[MTDBENCH_BUFSIZE];
+#endif
+
+static struct mtdbench_shim_s g_shim;
+#ifdef HAVE_MTD_RWB
+static FAR struct mtd_dev_s *g_rwb;
+#endif
+
+/****************************************************************************
+ * External Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_TESTING_MTDBENCH_ARCHINIT
+extern FAR struct mtd_dev_s *mtdbench_archinitialize(void);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shim_*
+ *
+ * Description:
+ *   Counting MTD methods.
+ *
+ ****************************************************************************/
+
+static int shim_erase(FAR struct mtd_dev_s *dev, off_t startblock,
+                      size_t nblocks)
+{
+  FAR struct mtdbench_shim_s *shim = (FAR struct mtdbench_shim_s *)dev;
+
+  shim->erases += nblocks;
+  return MTD_ERASE(shim->lower, startblock, nblocks);
+}
+
+static ssize_t shim_bread(FAR struct mtd_dev_s *dev, off_t startblock,
+                          size_t nblocks, FAR uint8_t *buffer)
+{
+  FAR struct mtdbench_shim_s *shim = (FAR struct mtdbench_shim_s *)dev;
+
+  shim->rdbytes += (uint64_t)nblocks * shim->blocksize;
+  return MTD_BREAD(shim->lower, startblock, nblocks, buffer);
+}
+
+static ssize_t shim_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
+                           size_t nblocks, FAR const uint8_t *buffer)
+{
+  FAR struct mtdbench_shim_s *shim = (FAR struct mtdbench_shim_s *)dev;
+
+  shim->wrbytes += (uint64_t)nblocks * shim->blocksize;
+  return MTD_BWRITE(shim->lower, startblock, nblocks, buffer);
+}
+
+static ssize_t shim_read(FAR struct mtd_dev_s *dev, off_t offset,
+                         size_t nbytes, FAR uint8_t *buffer)
+{
+  FAR struct mtdbench_shim_s *shim = (FAR struct mtdbench_shim_s *)dev;
+
+  shim->rdbytes += nbytes;
+  return MTD_READ(shim->lower, offset, nbytes, buffer);
+}
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t shim_write(FAR struct mtd_dev_s *dev, off_t offset,
+                          size_t nbytes, FAR const uint8_t *buffer)
+{
+  FAR struct mtdbench_shim_s *shim = (FAR struct mtdbench_shim_s *)dev;
+
+  shim->wrbytes += nbytes;
+  return MTD_WRITE(shim->lower, offset, nbytes, buffer);
+}
+#endif
+
+static int shim_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
+{
+  FAR struct mtdbench_shim_s *shim = (FAR struct mtdbench_shim_s *)dev;
+
+  return MTD_IOCTL(shim->lower, cmd, arg);
+}
+
+/****************************************************************************
+ * Name: mtdbench_initialize
+ *
+ * Description:
+ *   Create the device under test, the counting shim and, if available, the
+ *   R/W buffer layer on top of the shim.
+ *
+ ****************************************************************************/
+
+static int mtdbench_initialize(void)
+{
+  FAR struct mtd_dev_s *lower;
+
+  if (g_shim.lower != NULL)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_TESTING_MTDBENCH_ARCHINIT
+  lower = mtdbench_archinitialize();
+#else
+  lower = rammtd_initialize(g_simflash, MTDBENCH_BUFSIZE);
+#endif
+  if (lower == NULL)
+    {
+      printf("ERROR: Failed to create the MTD instance\n");
+      return -ENODEV;
+    }
+
+  g_shim.mtd.erase  = shim_erase;
+  g_shim.mtd.bread  = shim_bread;
+  g_shim.mtd.bwrite = shim_bwrite;
+  g_shim.mtd.read   = lower->read != NULL ? shim_read : NULL;
+#ifdef CONFIG_MTD_BYTE_WRITE
+  g_shim.mtd.write  = lower->write != NULL ? shim_write : NULL;
+#endif
+  g_shim.mtd.ioctl  = shim_ioctl;
+  g_shim.lower      = lower;
+
+#ifdef HAVE_MTD_RWB
+  g_rwb = mtd_rwb_initialize(&g_shim.mtd);
+  if (g_rwb == NULL)
+    {
+      printf("WARNING: Failed to create the R/W buffer layer\n");
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mtdbench_usec
+ ****************************************************************************/
+
+static uint64_t mtdbench_usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: mtdbench_compare
+ ****************************************************************************/
+
+static int mtdbench_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t la = *(FAR const uint32_t *)a;
+  uint32_t lb = *(FAR const uint32_t *)b;
+
+  return la < lb ? -1 : la > lb ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: mtdbench_rate
+ *
+ * Description:
+ *   Format "nbytes" in "usec" as MB/s with two decimals without relying on
+ *   floating point support in printf.
+ *
+ ****************************************************************************/
+
+static FAR const char *mtdbench_rate(FAR char *buf, size_t len,
+                                     uint64_t nbytes, uint64_t usec)
+{
+  uint64_t rate;
+
+  if (usec == 0)
+    {
+      usec = 1;
+    }
+
+  /* Hundredths of MB/s (1 MB = 1048576 bytes) */
+
+  rate = nbytes * 100 * 1000000 / usec / 1048576;
+  snprintf(buf, len, "%lu.%02lu", (unsigned long)(rate / 100),
+           (unsigned long)(rate % 100));
+  return buf;
+}
+
+/****************************************************************************
+ * Name: mtdbench_report
+ ****************************************************************************/
+
+static void mtdbench_report(FAR struct mtdbench_s *bench,
+                            FAR const char *layer, int pattern,
+                            uint32_t nops, uint64_t nbytes, uint64_t usec,
+                            uint64_t devbytes, uint32_t erases)
+{
+  FAR uint32_t *lat = bench->latency;
+  char rate[16];
+  uint64_t amp;
+
+  qsort(lat, nops, sizeof(uint32_t), mtdbench_compare);
+
+  /* Amplification in hundredths: device bytes per requested byte */
+
+  amp = nbytes > 0 ? devbytes * 100 / nbytes : 0;
+
+  printf("%-5s %-9s %8s %6lu %7lu %7lu %7lu %7lu %3lu.%02lu %6lu\n",
+         layer, g_patterns[pattern],
+         mtdbench_rate(rate, sizeof(rate), nbytes, usec),
+         (unsigned long)nops,
+         (unsigned long)lat[(nops - 1) * 50 / 100],
+         (unsigned long)lat[(nops - 1) * 90 / 100],
+         (unsigned long)lat[(nops - 1) * 99 / 100],
+         (unsigned long)lat[nops - 1],
+         (unsigned long)(amp / 100), (unsigned long)(amp % 100),
+         (unsigned long)erases);
+}
+
+/****************************************************************************
+ * Name: mtdbench_run
+ *
+ * Description:
+ *   Run one access pattern through "dev" and report it.
+ *
+ ****************************************************************************/
+
+static int mtdbench_run(FAR struct mtdbench_s *bench,
+                        FAR struct mtd_dev_s *dev, FAR const char *layer,
+                        int pattern)
+{
+  FAR struct mtdbench_shim_s *shim = bench->shim;
+  uint32_t blkpererase = bench->geo.erasesize / bench->geo.blocksize;
+  uint32_t iobytes = bench->iosize * bench->geo.blocksize;
+  uint64_t rdbytes;
+  uint64_t wrbytes;
+  uint32_t erases;
+  uint32_t nops;
+  uint64_t start;
+  uint64_t begin;
+  uint64_t end;
+  uint64_t nbytes;
+  off_t block;
+  ssize_t nxfrd;
+  uint32_t i;
+  int ret = OK;
+
+  if (pattern == MTDBENCH_ERASE)
+    {
+      nops   = bench->geo.neraseblocks;
+      nbytes = (uint64_t)nops * bench->geo.erasesize;
+    }
+  else if (pattern == MTDBENCH_SEQWRITE || pattern == MTDBENCH_SEQREAD)
+    {
+      nops   = bench->nblocks / bench->iosize;
+      nbytes = (uint64_t)nops * iobytes;
+    }
+  else
+    {
+      nops   = bench->nrandom;
+      nbytes = (uint64_t)nops * iobytes;
+    }
+
+  srand(bench->seed);
+
+  rdbytes = shim->rdbytes;
+  wrbytes = shim->wrbytes;
+  erases  = shim->erases;
+
+  begin = mtdbench_usec();
+  for (i = 0; i < nops; i++)
+    {
+      if (pattern == MTDBENCH_RANDWRITE || pattern == MTDBENCH_RANDREAD)
+        {
+          block = (off_t)(rand() % (bench->nblocks / bench->iosize)) *
+                  bench->iosize;
+        }
+      else
+        {
+          block = (off_t)i * bench->iosize;
+        }
+
+      start = mtdbench_usec();
+
+      switch (pattern)
+        {
+          case MTDBENCH_ERASE:
+            nxfrd = MTD_ERASE(dev, i, 1);
+            nxfrd = nxfrd < 0 ? nxfrd : blkpererase;
+            break;
+
+          case MTDBENCH_SEQWRITE:
+          case MTDBENCH_RANDWRITE:
+            memset(bench->buffer, (uint8_t)i, iobytes);
+            nxfrd = MTD_BWRITE(dev, block, bench->iosize, bench->buffer);
+            break;
+
+          default:
+            nxfrd = MTD_BREAD(dev, block, bench->iosize, bench->buffer);
+            break;
+        }
+
+      bench->latency[i] = (uint32_t)(mtdbench_usec() - start);
+
+      if (nxfrd < 0)
+        {
+          printf("ERROR: %s %s failed at block %ld: %d\n", layer,
+                 g_patterns[pattern], (long)block, (int)nxfrd);
+          ret = (int)nxfrd;
+          break;
+        }
+    }
+
+  /* Buffered writes are only done once they reach the device */
+
+  if (pattern == MTDBENCH_SEQWRITE || pattern == MTDBENCH_RANDWRITE)
+    {
+      MTD_IOCTL(dev, BIOC_FLUSH, 0);
+    }
+
+  end = mtdbench_usec();
+
+  if (ret >= 0)
+    {
+      if (pattern == MTDBENCH_SEQREAD || pattern == MTDBENCH_RANDREAD)
+        {
+          mtdbench_report(bench, layer, pattern, nops, nbytes, end - begin,
+                          shim->rdbytes - rdbytes, shim->erases - erases);
+        }
+      else if (pattern == MTDBENCH_ERASE)
+        {
+          mtdbench_report(bench, layer, pattern, nops, nbytes, end - begin,
+                          (uint64_t)(shim->erases - erases) *
+                          bench->geo.erasesize, shim->erases - erases);
+        }
+      else
+        {
+          mtdbench_report(bench, layer, pattern, nops, nbytes, end - begin,
+                          shim->wrbytes - wrbytes, shim->erases - erases);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtdbench_layer
+ *
+ * Description:
+ *   Run all patterns through one layer.  The device is erased before each
+ *   write pattern so that every write lands on erased flash.
+ *
+ ****************************************************************************/
+
+static int mtdbench_layer(FAR struct mtdbench_s *bench,
+                          FAR struct mtd_dev_s *dev, FAR const char *layer)
+{
+  int pattern;
+  int ret = OK;
+
+  for (pattern = 0; pattern < MTDBENCH_NPATTERNS && ret >= 0; pattern++)
+    {
+      if (pattern == MTDBENCH_RANDWRITE)
+        {
+          ret = MTD_IOCTL(dev, MTDIOC_BULKERASE, 0);
+          if (ret < 0)
+            {
+              printf("ERROR: %s MTDIOC_BULKERASE failed: %d\n", layer, ret);
+              break;
+            }
+        }
+
+      ret = mtdbench_run(bench, dev, layer, pattern);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtdbench_showusage
+ ****************************************************************************/
+
+static void mtdbench_showusage(FAR const char *progname, int exitcode)
+{
+  printf("USAGE: %s [-b <blocks>] [-n <ops>] [-s <seed>] [-r]\n", progname);
+  printf("Where:\n");
+  printf("  -b <blocks> Read/write blocks per operation.  Default: 1\n");
+  printf("  -n <ops>    Operations of the random patterns.  "
+         "Default: device size / operation size\n");
+  printf("  -s <seed>   Seed of the random patterns.  Default: 1\n");
+#ifdef HAVE_MTD_RWB
+  printf("  -r          Skip the runs through the R/W buffer layer\n");
+#endif
+  printf("\nAll data on the device is destroyed.\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct mtdbench_s bench;
+  bool skiprwb = false;
+  uint32_t maxops;
+  int option;
+  int ret;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.iosize = 1;
+  bench.seed   = 1;
+
+  while ((option = getopt(argc, argv, "b:n:s:rh")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'b':
+            bench.iosize = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'n':
+            bench.nrandom = strtoul(optarg, NULL, 0);
+            break;
+
+          case 's':
+            bench.seed = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'r':
+            skiprwb = true;
+            break;
+
+          case 'h':
+            mtdbench_showusage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            mtdbench_showusage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  ret = mtdbench_initialize();
+  if (ret < 0)
+    {
+      return EXIT_FAILURE;
+    }
+
+  bench.shim = &g_shim;
+
+  ret = MTD_IOCTL(g_shim.lower, MTDIOC_GEOMETRY,
+                  (unsigned long)((uintptr_t)&bench.geo));
+  if (ret < 0)
+    {
+      printf("ERROR: MTDIOC_GEOMETRY failed: %d\n", ret);
+      return EXIT_FAILURE;
+    }
+
+  g_shim.blocksize = bench.geo.blocksize;
+  bench.nblocks    = (off_t)bench.geo.neraseblocks *
+                     (bench.geo.erasesize / bench.geo.blocksize);
+
+  if (bench.iosize < 1 || bench.iosize > bench.nblocks)
+    {
+      printf("ERROR: Operation size must be 1-%ld blocks\n",
+             (long)bench.nblocks);
+      return EXIT_FAILURE;
+    }
+
+  if (bench.nrandom == 0)
+    {
+      bench.nrandom = bench.nblocks / bench.iosize;
+    }
+
+  maxops = bench.geo.neraseblocks;
+  if (maxops < bench.nblocks / bench.iosize)
+    {
+      maxops = bench.nblocks / bench.iosize;
+    }
+
+  if (maxops < bench.nrandom)
+    {
+      maxops = bench.nrandom;
+    }
+
+  bench.buffer  = malloc(bench.iosize * bench.geo.blocksize);
+  bench.latency = malloc(maxops * sizeof(uint32_t));
+  if (bench.buffer == NULL || bench.latency == NULL)
+    {
+      printf("ERROR: Failed to allocate the buffers\n");
+      free(bench.buffer);
+      free(bench.latency);
+      return EXIT_FAILURE;
+    }
+
+  printf("MTD geometry: blocksize %lu erasesize %lu neraseblocks %lu "
+         "(%lu KiB)\n",
+         (unsigned long)bench.geo.blocksize,
+         (unsigned long)bench.geo.erasesize,
+         (unsigned long)bench.geo.neraseblocks,
+         (unsigned long)((uint64_t)bench.geo.erasesize *
+                         bench.geo.neraseblocks / 1024));
+  printf("Operation size: %lu blocks (%lu bytes), random operations: %lu, "
+         "seed: %u\n\n",
+         (unsigned long)bench.iosize,
+         (unsigned long)(bench.iosize * bench.geo.blocksize),
+         (unsigned long)bench.nrandom, bench.seed);
+
+  /* "Amp" is the number of bytes that reached the device per byte
+   * requested: write amplification for the write patterns, read
+   * amplification for the read patterns.
+   */
+
+  printf("Layer Pattern       MB/s    Ops  p50 us  p90 us  p99 us  max us"
+         "    Amp Erases\n");
+
+  ret = mtdbench_layer(&bench, &g_shim.mtd, "raw");
+
+#ifdef HAVE_MTD_RWB
+  if (ret >= 0 && !skiprwb && g_rwb != NULL)
+    {
+      ret = mtdbench_layer(&bench, g_rwb, "rwb");
+    }
+#else
+  UNUSED(skiprwb);
+#endif
+
+  free(bench.buffer);
+  free(bench.latency);
+  return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/****************************************************************************
+ * apps/testing/netbench/netbench.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_TESTING_NETBENCH_NETBENCH_H
+#define __APPS_TESTING_NETBENCH_NETBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <netinet/in.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_TESTING_NETBENCH_PORT
+#  define CONFIG_TESTING_NETBENCH_PORT 5471
+#endif
+
+#ifndef CONFIG_TESTING_NETBENCH_MAXBUF
+#  define CONFIG_TESTING_NETBENCH_MAXBUF 8192
+#endif
+
+#ifndef CONFIG_TESTING_NETBENCH_MAXCONN
+#  define CONFIG_TESTING_NETBENCH_MAXCONN 8
+#endif
+
+#ifdef CONFIG_NSH_PROMPT_STRING
+#  define NETBENCH_TELNET_PROMPT CONFIG_NSH_PROMPT_STRING
+#else
+#  define NETBENCH_TELNET_PROMPT "nsh> "
+#endif
+
+/* What the server does with a TCP connection, sent by the client as the
+ * first word of the connection.
+ */
+
+#define NETBENCH_TCP_SINK   1        /* Discard everything until EOF */
+#define NETBENCH_TCP_ECHO   2        /* Echo messages of a fixed size */
+
+/* The UDP sequence number that asks the server how many datagrams it has
+ * counted since the previous query.
+ */
+
+#define NETBENCH_UDP_QUERY  0xffffffff
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The header at the start of each TCP connection (network byte order) */
+
+struct netbench_hdr_s
+{
+  uint32_t mode;                     /* NETBENCH_TCP_* */
+  uint32_t msgsize;                  /* Echo message size */
+};
+
+/* The header at the start of each UDP datagram (network byte order) */
+
+struct netbench_udp_s
+{
+  uint32_t seq;                      /* Sequence number or query */
+  uint32_t count;                    /* Datagrams counted (query reply) */
+};
+
+/* Options shared by all of the tests */
+
+struct netbench_s
+{
+  struct sockaddr_in addr;           /* Server address */
+  size_t bufsize;                    /* Send or message size */
+  uint32_t count;                    /* Iterations of the counted tests */
+  uint32_t seconds;                  /* Duration of the stream tests */
+  int maxconn;                       /* Upper bound of the scaling test */
+  bool csv;                          /* Print results as CSV */
+
+  /* The telnet test */
+
+  uint16_t telnetport;               /* Telnet server port */
+  FAR const char *user;              /* Login user name, or NULL */
+  FAR const char *password;          /* Login password, or NULL */
+  FAR const char *prompt;            /* Shell prompt to wait for */
+};
+
+/* The outcome of one test run */
+
+struct netbench_result_s
+{
+  FAR const char *test;
+  int conns;                         /* Concurrent connections */
+  uint32_t ops;                      /* Sends, messages or connections */
+  uint32_t lost;                     /* UDP datagrams not received */
+  uint64_t bytes;                    /* Payload bytes moved */
+  uint64_t usec;                     /* Elapsed time */
+  FAR uint32_t *lat;                 /* Latency samples (us), or NULL */
+  uint32_t nlat;
+};
+
+/* The server sockets, opened before any client can connect */
+
+struct netbench_server_s
+{
+  int listenfd;
+  int udpfd;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+uint64_t netbench_usec(void);
+void netbench_report(FAR const struct netbench_s *bench,
+                     FAR struct netbench_result_s *result);
+
+int netbench_server_open(FAR struct netbench_server_s *server,
+                         uint16_t port);
+int netbench_server_run(FAR struct netbench_server_s *server,
+                        FAR volatile bool *stop);
+void netbench_server_close(FAR struct netbench_server_s *server);
+
+int netbench_stream(FAR const struct netbench_s *bench);
+int netbench_udp(FAR const struct netbench_s *bench);
+int netbench_rr(FAR const struct netbench_s *bench);
+int netbench_crr(FAR const struct netbench_s *bench);
+int netbench_multi(FAR const struct netbench_s *bench);
+int netbench_telnet(FAR const struct netbench_s *bench);
+
+#endif /* __APPS_TESTING_NETBENCH_NETBENCH_H */
@@ -0,0 +1,620 @@
+/****************************************************************************
+ * apps/testing/netbench/netbench_client.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "netbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* How long to let queued datagrams drain, and to wait for a query reply */
+
+#define NETBENCH_UDP_DRAINMS  200
+#define NETBENCH_UDP_REPLYMS  1000
+#define NETBENCH_UDP_RETRIES  3
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_connect
+ *
+ * Description:
+ *   Connect to the server and tell it what to do with the connection.
+ *
+ ****************************************************************************/
+
+static int netbench_connect(FAR const struct netbench_s *bench,
+                            uint32_t mode)
+{
+  struct netbench_hdr_s hdr;
+  int optval;
+  int ret;
+  int fd;
+
+  fd = socket(PF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    {
+      ret = -errno;
+      fprintf(stderr, "ERROR: socket failed: %d\n", ret);
+      return ret;
+    }
+
+  if (connect(fd, (FAR const struct sockaddr *)&bench->addr,
+              sizeof(bench->addr)) < 0)
+    {
+      ret = -errno;
+      fprintf(stderr, "ERROR: connect failed: %d\n", ret);
+      close(fd);
+      return ret;
+    }
+
+#ifdef TCP_NODELAY
+  /* Small echo messages must not wait for Nagle's algorithm */
+
+  if (mode == NETBENCH_TCP_ECHO)
+    {
+      optval = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval));
+    }
+#else
+  UNUSED(optval);
+#endif
+
+  hdr.mode    = htonl(mode);
+  hdr.msgsize = htonl(bench->bufsize);
+
+  if (send(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr))
+    {
+      ret = -errno;
+      fprintf(stderr, "ERROR: send failed: %d\n", ret);
+      close(fd);
+      return ret;
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: netbench_sendall / netbench_recvall
+ ****************************************************************************/
+
+static int netbench_sendall(int fd, FAR const uint8_t *buf, size_t len)
+{
+  ssize_t nsent;
+
+  while (len > 0)
+    {
+      nsent = send(fd, buf, len, 0);
+      if (nsent < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return -errno;
+        }
+
+      buf += nsent;
+      len -= nsent;
+    }
+
+  return OK;
+}
+
+static int netbench_recvall(int fd, FAR uint8_t *buf, size_t len)
+{
+  ssize_t nrecvd;
+
+  while (len > 0)
+    {
+      nrecvd = recv(fd, buf, len, 0);
+      if (nrecvd <= 0)
+        {
+          if (nrecvd < 0 && errno == EINTR)
+            {
+              continue;
+            }
+
+          return nrecvd < 0 ? -errno : -ECONNRESET;
+        }
+
+      buf += nrecvd;
+      len -= nrecvd;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_drain
+ *
+ * Description:
+ *   Half-close a sink connection and wait for the server to close its
+ *   side, which it does only after it has read everything.
+ *
+ ****************************************************************************/
+
+static void netbench_drain(int fd)
+{
+  uint8_t dummy;
+  ssize_t nrecvd;
+
+  shutdown(fd, SHUT_WR);
+  do
+    {
+      nrecvd = recv(fd, &dummy, 1, 0);
+    }
+  while (nrecvd > 0 || (nrecvd < 0 && errno == EINTR));
+}
+
+/****************************************************************************
+ * Name: netbench_streams
+ *
+ * Description:
+ *   Stream to the server over "nconns" connections at once for the
+ *   configured duration.  The connections are fed from one poll() loop
+ *   with non-blocking sends, so the aggregate rate reflects the stack and
+ *   not the scheduling of client threads.
+ *
+ ****************************************************************************/
+
+static int netbench_streams(FAR const struct netbench_s *bench,
+                            FAR const char *test, int nconns)
+{
+  struct pollfd fds[CONFIG_TESTING_NETBENCH_MAXCONN];
+  struct netbench_result_s result;
+  FAR uint8_t *buf;
+  uint64_t start;
+  uint64_t end;
+  ssize_t nsent;
+  int ret = OK;
+  int i;
+
+  buf = malloc(bench->bufsize);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < bench->bufsize; i++)
+    {
+      buf[i] = (uint8_t)i;
+    }
+
+  for (i = 0; i < nconns; i++)
+    {
+      fds[i].fd = netbench_connect(bench, NETBENCH_TCP_SINK);
+      if (fds[i].fd < 0)
+        {
+          ret = fds[i].fd;
+          nconns = i;
+          goto out;
+        }
+
+      fds[i].events = POLLOUT;
+    }
+
+  memset(&result, 0, sizeof(result));
+  result.test  = test;
+  result.conns = nconns;
+
+  start = netbench_usec();
+  end   = start + (uint64_t)bench->seconds * 1000000;
+
+  while (netbench_usec() < end)
+    {
+      if (poll(fds, nconns, 100) < 0 && errno != EINTR)
+        {
+          ret = -errno;
+          break;
+        }
+
+      for (i = 0; i < nconns; i++)
+        {
+          if ((fds[i].revents & POLLOUT) == 0)
+            {
+              continue;
+            }
+
+          nsent = send(fds[i].fd, buf, bench->bufsize, MSG_DONTWAIT);
+          if (nsent > 0)
+            {
+              result.ops++;
+              result.bytes += nsent;
+            }
+          else if (nsent < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+                   errno != EINTR)
+            {
+              ret = -errno;
+              fprintf(stderr, "ERROR: send failed: %d\n", ret);
+              goto out;
+            }
+        }
+    }
+
+  /* The time only counts once the server has read all of the data */
+
+  for (i = 0; i < nconns; i++)
+    {
+      netbench_drain(fds[i].fd);
+    }
+
+  result.usec = netbench_usec() - start;
+  netbench_report(bench, &result);
+
+out:
+  for (i = 0; i < nconns; i++)
+    {
+      close(fds[i].fd);
+    }
+
+  free(buf);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_exchange
+ *
+ * Description:
+ *   Send one message on an echo connection and wait for it to come back.
+ *
+ ****************************************************************************/
+
+static int netbench_exchange(FAR const struct netbench_s *bench, int fd,
+                             FAR uint8_t *buf)
+{
+  int ret;
+
+  ret = netbench_sendall(fd, buf, bench->bufsize);
+  if (ret == OK)
+    {
+      ret = netbench_recvall(fd, buf, bench->bufsize);
+    }
+
+  if (ret < 0)
+    {
+      fprintf(stderr, "ERROR: exchange failed: %d\n", ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_stream
+ *
+ * Description:
+ *   Bulk TCP throughput over one connection.
+ *
+ ****************************************************************************/
+
+int netbench_stream(FAR const struct netbench_s *bench)
+{
+  return netbench_streams(bench, "stream", 1);
+}
+
+/****************************************************************************
+ * Name: netbench_multi
+ *
+ * Description:
+ *   Aggregate TCP throughput over 1, 2, 4, ... up to the configured number
+ *   of concurrent connections.
+ *
+ ****************************************************************************/
+
+int netbench_multi(FAR const struct netbench_s *bench)
+{
+  int nconns;
+  int ret;
+
+  for (nconns = 1; ; nconns *= 2)
+    {
+      if (nconns > bench->maxconn)
+        {
+          nconns = bench->maxconn;
+        }
+
+      ret = netbench_streams(bench, "multi", nconns);
+      if (ret < 0 || nconns == bench->maxconn)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: netbench_udp
+ *
+ * Description:
+ *   Send datagrams as fast as possible, then ask the server how many it
+ *   received.  Reports the packet rate offered and the loss.
+ *
+ ****************************************************************************/
+
+int netbench_udp(FAR const struct netbench_s *bench)
+{
+  struct netbench_result_s result;
+  struct netbench_udp_s udp;
+  struct pollfd pfd;
+  FAR uint8_t *buf;
+  uint32_t received = 0;
+  uint32_t seq;
+  int ret = OK;
+  int retry;
+  int fd;
+
+  if (bench->bufsize < sizeof(udp))
+    {
+      fprintf(stderr, "ERROR: UDP needs at least %u bytes\n",
+              (unsigned int)sizeof(udp));
+      return -EINVAL;
+    }
+
+  buf = calloc(1, bench->bufsize);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fd = socket(PF_INET, SOCK_DGRAM, 0);
+  if (fd < 0 ||
+      connect(fd, (FAR const struct sockaddr *)&bench->addr,
+              sizeof(bench->addr)) < 0)
+    {
+      ret = -errno;
+      fprintf(stderr, "ERROR: UDP socket failed: %d\n", ret);
+      goto out;
+    }
+
+  /* Clear whatever a previous run left counted */
+
+  udp.seq   = htonl(NETBENCH_UDP_QUERY);
+  udp.count = 0;
+  send(fd, &udp, sizeof(udp), 0);
+
+  pfd.fd     = fd;
+  pfd.events = POLLIN;
+  if (poll(&pfd, 1, NETBENCH_UDP_REPLYMS) > 0)
+    {
+      recv(fd, &udp, sizeof(udp), 0);
+    }
+
+  memset(&result, 0, sizeof(result));
+  result.test  = "udp";
+  result.conns = 1;
+
+  result.usec = netbench_usec();
+  for (seq = 0; seq < bench->count; seq++)
+    {
+      udp.seq = htonl(seq);
+      memcpy(buf, &udp, sizeof(udp));
+
+      if (send(fd, buf, bench->bufsize, 0) < 0)
+        {
+          /* A full send queue is part of what is being measured */
+
+          if (errno == ENOBUFS || errno == EAGAIN || errno == ECONNREFUSED)
+            {
+              continue;
+            }
+
+          ret = -errno;
+          fprintf(stderr, "ERROR: send failed: %d\n", ret);
+          goto out;
+        }
+
+      result.ops++;
+      result.bytes += bench->bufsize;
+    }
+
+  result.usec = netbench_usec() - result.usec;
+
+  /* Let the last datagrams arrive, then collect the count */
+
+  usleep(NETBENCH_UDP_DRAINMS * 1000);
+
+  for (retry = 0; retry < NETBENCH_UDP_RETRIES; retry++)
+    {
+      udp.seq = htonl(NETBENCH_UDP_QUERY);
+      send(fd, &udp, sizeof(udp), 0);
+
+      if (poll(&pfd, 1, NETBENCH_UDP_REPLYMS) > 0 &&
+          recv(fd, &udp, sizeof(udp), 0) == sizeof(udp))
+        {
+          received = ntohl(udp.count);
+          break;
+        }
+    }
+
+  if (retry == NETBENCH_UDP_RETRIES)
+    {
+      fprintf(stderr, "ERROR: No reply from the UDP server\n");
+      ret = -ETIMEDOUT;
+      goto out;
+    }
+
+  result.lost = bench->count > received ? bench->count - received : 0;
+  netbench_report(bench, &result);
+
+out:
+  if (fd >= 0)
+    {
+      close(fd);
+    }
+
+  free(buf);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_rr
+ *
+ * Description:
+ *   Request/response round trips over one connection.  Every round trip
+ *   is timed for the latency percentiles.
+ *
+ ****************************************************************************/
+
+int netbench_rr(FAR const struct netbench_s *bench)
+{
+  struct netbench_result_s result;
+  FAR uint8_t *buf;
+  uint64_t start;
+  uint64_t now;
+  int ret;
+  int fd;
+
+  memset(&result, 0, sizeof(result));
+  result.test  = "rr";
+  result.conns = 1;
+
+  buf = calloc(1, bench->bufsize);
+  result.lat = malloc(bench->count * sizeof(uint32_t));
+  if (buf == NULL || result.lat == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  fd = netbench_connect(bench, NETBENCH_TCP_ECHO);
+  if (fd < 0)
+    {
+      ret = fd;
+      goto out;
+    }
+
+  start = netbench_usec();
+  for (ret = OK; result.ops < bench->count; result.ops++)
+    {
+      now = netbench_usec();
+      ret = netbench_exchange(bench, fd, buf);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      result.lat[result.nlat++] = (uint32_t)(netbench_usec() - now);
+      result.bytes += 2 * bench->bufsize;
+    }
+
+  result.usec = netbench_usec() - start;
+  close(fd);
+
+  if (ret == OK)
+    {
+      netbench_report(bench, &result);
+    }
+
+out:
+  free(result.lat);
+  free(buf);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_crr
+ *
+ * Description:
+ *   Connect, one request/response and close, repeated.  Reports the
+ *   connection rate and the latency of the whole sequence.
+ *
+ ****************************************************************************/
+
+int netbench_crr(FAR const struct netbench_s *bench)
+{
+  struct netbench_result_s result;
+  FAR uint8_t *buf;
+  uint64_t start;
+  uint64_t now;
+  int ret = OK;
+  int fd;
+
+  memset(&result, 0, sizeof(result));
+  result.test  = "crr";
+  result.conns = 1;
+
+  buf = calloc(1, bench->bufsize);
+  result.lat = malloc(bench->count * sizeof(uint32_t));
+  if (buf == NULL || result.lat == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  start = netbench_usec();
+  for (; result.ops < bench->count; result.ops++)
+    {
+      now = netbench_usec();
+
+      fd = netbench_connect(bench, NETBENCH_TCP_ECHO);
+      if (fd < 0)
+        {
+          ret = fd;
+          break;
+        }
+
+      ret = netbench_exchange(bench, fd, buf);
+      close(fd);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      result.lat[result.nlat++] = (uint32_t)(netbench_usec() - now);
+      result.bytes += 2 * bench->bufsize;
+    }
+
+  result.usec = netbench_usec() - start;
+
+  if (ret == OK)
+    {
+      netbench_report(bench, &result);
+    }
+
+out:
+  free(result.lat);
+  free(buf);
+  return ret;
+}
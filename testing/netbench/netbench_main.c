@@ -0,0 +1,412 @@
+/****************************************************************************
+ * apps/testing/netbench/netbench_main.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "netbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NETBENCH_DEFBUF     1024
+#define NETBENCH_DEFCOUNT   1000
+#define NETBENCH_DEFSECONDS 5
+#define NETBENCH_DEFTELNET  23
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct netbench_test_s
+{
+  FAR const char *name;
+  CODE int (*run)(FAR const struct netbench_s *bench);
+  bool all;                          /* Run when no test is named */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct netbench_test_s g_netbench_tests[] =
+{
+  { "stream", netbench_stream, true  },
+  { "udp",    netbench_udp,    true  },
+  { "rr",     netbench_rr,     true  },
+  { "crr",    netbench_crr,    true  },
+  { "multi",  netbench_multi,  true  },
+  { "telnet", netbench_telnet, false },
+};
+
+#define NETBENCH_NTESTS \
+  (sizeof(g_netbench_tests) / sizeof(g_netbench_tests[0]))
+
+static volatile bool g_netbench_stop;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_compare
+ ****************************************************************************/
+
+static int netbench_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: netbench_percentile
+ *
+ * Description:
+ *   Return the "pct" percentile of the sorted samples.
+ *
+ ****************************************************************************/
+
+static uint32_t netbench_percentile(FAR const struct netbench_result_s *res,
+                                    unsigned int pct)
+{
+  return res->lat[(uint64_t)(res->nlat - 1) * pct / 100];
+}
+
+/****************************************************************************
+ * Name: netbench_serverthread
+ ****************************************************************************/
+
+static FAR void *netbench_serverthread(FAR void *arg)
+{
+  netbench_server_run(arg, &g_netbench_stop);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netbench_showusage
+ ****************************************************************************/
+
+static void netbench_showusage(FAR const char *progname, int exitcode)
+{
+  int i;
+
+  fprintf(stderr, "USAGE: %s -S [-p <port>]\n", progname);
+  fprintf(stderr, "       %s [OPTIONS] [<test> ...]\n", progname);
+  fprintf(stderr, "Where OPTIONS are:\n");
+  fprintf(stderr, "  -S          Run as the server until killed\n");
+  fprintf(stderr, "  -a <addr>   Server address.  Default: a server thread "
+          "on loopback\n");
+  fprintf(stderr, "  -p <port>   Server port.  Default: %u\n",
+          CONFIG_TESTING_NETBENCH_PORT);
+  fprintf(stderr, "  -l <bytes>  Send and message size (1-%u).  "
+          "Default: %u\n", CONFIG_TESTING_NETBENCH_MAXBUF, NETBENCH_DEFBUF);
+  fprintf(stderr, "  -n <count>  Datagrams, round trips or connections.  "
+          "Default: %u\n", NETBENCH_DEFCOUNT);
+  fprintf(stderr, "  -t <secs>   Duration of the stream tests.  "
+          "Default: %u\n", NETBENCH_DEFSECONDS);
+  fprintf(stderr, "  -c <conns>  Connections of the multi test (1-%u).  "
+          "Default: %u\n", CONFIG_TESTING_NETBENCH_MAXCONN,
+          CONFIG_TESTING_NETBENCH_MAXCONN);
+  fprintf(stderr, "  -T <port>   Telnet server port.  Default: %u\n",
+          NETBENCH_DEFTELNET);
+  fprintf(stderr, "  -u <user>   Telnet login user name\n");
+  fprintf(stderr, "  -w <passwd> Telnet login password\n");
+  fprintf(stderr, "  -P <prompt> Telnet shell prompt.  Default: \"%s\"\n",
+          NETBENCH_TELNET_PROMPT);
+  fprintf(stderr, "  -C          Print the results as CSV\n");
+  fprintf(stderr, "Tests (default: all but telnet):");
+
+  for (i = 0; i < NETBENCH_NTESTS; i++)
+    {
+      fprintf(stderr, " %s", g_netbench_tests[i].name);
+    }
+
+  fprintf(stderr, "\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_usec
+ ****************************************************************************/
+
+uint64_t netbench_usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: netbench_report
+ *
+ * Description:
+ *   Print one result line.  Sorts the latency samples in place.
+ *
+ ****************************************************************************/
+
+void netbench_report(FAR const struct netbench_s *bench,
+                     FAR struct netbench_result_s *result)
+{
+  uint64_t usec = result->usec > 0 ? result->usec : 1;
+  uint32_t p50 = 0;
+  uint32_t p90 = 0;
+  uint32_t p99 = 0;
+  uint32_t max = 0;
+
+  if (result->nlat > 0)
+    {
+      qsort(result->lat, result->nlat, sizeof(uint32_t), netbench_compare);
+      p50 = netbench_percentile(result, 50);
+      p90 = netbench_percentile(result, 90);
+      p99 = netbench_percentile(result, 99);
+      max = result->lat[result->nlat - 1];
+    }
+
+  printf(bench->csv ? "%s,%d,%lu,%lu,%llu,%llu,%llu,%llu,%lu,%lu,%lu,%lu,"
+                      "%lu\n" :
+                      "%-7s %5d %6lu %8lu %11llu %9llu %9llu %8llu "
+                      "%7lu %7lu %7lu %7lu %7lu\n",
+         result->test, result->conns, (unsigned long)bench->bufsize,
+         (unsigned long)result->ops,
+         (unsigned long long)result->bytes,
+         (unsigned long long)result->usec,
+         (unsigned long long)(result->bytes * 1000000 / usec / 1024),
+         (unsigned long long)((uint64_t)result->ops * 1000000 / usec),
+         (unsigned long)p50, (unsigned long)p90, (unsigned long)p99,
+         (unsigned long)max, (unsigned long)result->lost);
+}
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct netbench_server_s server;
+  struct netbench_s bench;
+  pthread_t thread;
+  uint16_t port = CONFIG_TESTING_NETBENCH_PORT;
+  bool local = true;
+  bool serve = false;
+  int failures = 0;
+  int option;
+  int ret;
+  int i;
+  int j;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.addr.sin_family      = AF_INET;
+  bench.addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bench.bufsize              = NETBENCH_DEFBUF;
+  bench.count                = NETBENCH_DEFCOUNT;
+  bench.seconds              = NETBENCH_DEFSECONDS;
+  bench.maxconn              = CONFIG_TESTING_NETBENCH_MAXCONN;
+  bench.telnetport           = NETBENCH_DEFTELNET;
+  bench.prompt               = NETBENCH_TELNET_PROMPT;
+
+  while ((option = getopt(argc, argv, "Sa:p:l:n:t:c:T:u:w:P:Ch")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'S':
+            serve = true;
+            break;
+
+          case 'a':
+            if (inet_pton(AF_INET, optarg, &bench.addr.sin_addr) != 1)
+              {
+                netbench_showusage(argv[0], EXIT_FAILURE);
+              }
+
+            local = false;
+            break;
+
+          case 'p':
+            port = atoi(optarg);
+            break;
+
+          case 'l':
+            bench.bufsize = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'n':
+            bench.count = strtoul(optarg, NULL, 0);
+            break;
+
+          case 't':
+            bench.seconds = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'c':
+            bench.maxconn = atoi(optarg);
+            break;
+
+          case 'T':
+            bench.telnetport = atoi(optarg);
+            break;
+
+          case 'u':
+            bench.user = optarg;
+            break;
+
+          case 'w':
+            bench.password = optarg;
+            break;
+
+          case 'P':
+            bench.prompt = optarg;
+            break;
+
+          case 'C':
+            bench.csv = true;
+            break;
+
+          case 'h':
+            netbench_showusage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            netbench_showusage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (bench.bufsize < 1 || bench.bufsize > CONFIG_TESTING_NETBENCH_MAXBUF ||
+      bench.count < 1 || bench.maxconn < 1 ||
+      bench.maxconn > CONFIG_TESTING_NETBENCH_MAXCONN)
+    {
+      netbench_showusage(argv[0], EXIT_FAILURE);
+    }
+
+  bench.addr.sin_port = htons(port);
+
+  for (j = optind; j < argc; j++)
+    {
+      for (i = 0; i < NETBENCH_NTESTS; i++)
+        {
+          if (strcmp(argv[j], g_netbench_tests[i].name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (i == NETBENCH_NTESTS)
+        {
+          fprintf(stderr, "ERROR: Unknown test %s\n", argv[j]);
+          netbench_showusage(argv[0], EXIT_FAILURE);
+        }
+    }
+
+  if (serve)
+    {
+      ret = netbench_server_open(&server, port);
+      if (ret < 0)
+        {
+          return EXIT_FAILURE;
+        }
+
+      printf("Serving on port %u\n", port);
+      ret = netbench_server_run(&server, NULL);
+      netbench_server_close(&server);
+      return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+  /* Without a peer, serve ourselves over the loopback device */
+
+  if (local)
+    {
+      ret = netbench_server_open(&server, port);
+      if (ret < 0)
+        {
+          return EXIT_FAILURE;
+        }
+
+      g_netbench_stop = false;
+      ret = pthread_create(&thread, NULL, netbench_serverthread, &server);
+      if (ret != 0)
+        {
+          fprintf(stderr, "ERROR: pthread_create failed: %d\n", ret);
+          netbench_server_close(&server);
+          return EXIT_FAILURE;
+        }
+    }
+
+  printf(bench.csv ? "test,conns,size,ops,bytes,usec,kib_s,ops_s,"
+                     "p50_us,p90_us,p99_us,max_us,lost\n" :
+                     "Test    Conns   Size      Ops       Bytes      Usec"
+                     "     KiB/s    Ops/s     p50     p90     p99     max"
+                     "    Lost\n");
+
+  for (i = 0; i < NETBENCH_NTESTS; i++)
+    {
+      /* Run the tests named on the command line, or all of them but
+       * those that need another server.
+       */
+
+      for (j = optind; j < argc; j++)
+        {
+          if (strcmp(argv[j], g_netbench_tests[i].name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (optind < argc ? j == argc : !g_netbench_tests[i].all)
+        {
+          continue;
+        }
+
+      if (g_netbench_tests[i].run(&bench) < 0)
+        {
+          failures++;
+        }
+    }
+
+  if (local)
+    {
+      g_netbench_stop = true;
+      pthread_join(thread, NULL);
+      netbench_server_close(&server);
+    }
+
+  return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,416 @@
+/****************************************************************************
+ * apps/testing/netbench/netbench_server.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "netbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* poll() slots ahead of the connections */
+
+#define NETBENCH_LISTENFD   0
+#define NETBENCH_UDPFD      1
+#define NETBENCH_NFIXED     2
+
+/* How often the stop flag is checked */
+
+#define NETBENCH_POLLMS     100
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct netbench_conn_s
+{
+  struct netbench_hdr_s hdr;         /* Header as received */
+  size_t hdrlen;                     /* Header bytes received so far */
+  uint32_t mode;                     /* NETBENCH_TCP_*, 0 until known */
+  uint32_t msgsize;                  /* Echo message size */
+  size_t fill;                       /* Echo message bytes received */
+  FAR uint8_t *buf;                  /* Echo message buffer */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_sendall
+ ****************************************************************************/
+
+static int netbench_sendall(int fd, FAR const uint8_t *buf, size_t len)
+{
+  ssize_t nsent;
+
+  while (len > 0)
+    {
+      nsent = send(fd, buf, len, 0);
+      if (nsent < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return -errno;
+        }
+
+      buf += nsent;
+      len -= nsent;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_conn_input
+ *
+ * Description:
+ *   Consume the data available on one connection.  Only as much as the
+ *   current header or message needs is read so that nothing of the next
+ *   one is lost.
+ *
+ * Returned Value:
+ *   OK while the connection stays open, a negated errno value or -ENOTCONN
+ *   once it should be closed.
+ *
+ ****************************************************************************/
+
+static int netbench_conn_input(int fd, FAR struct netbench_conn_s *conn,
+                               FAR uint8_t *scratch)
+{
+  ssize_t nrecvd;
+
+  if (conn->mode == 0)
+    {
+      nrecvd = recv(fd, (FAR uint8_t *)&conn->hdr + conn->hdrlen,
+                    sizeof(conn->hdr) - conn->hdrlen, 0);
+      if (nrecvd <= 0)
+        {
+          return nrecvd < 0 ? -errno : -ENOTCONN;
+        }
+
+      conn->hdrlen += nrecvd;
+      if (conn->hdrlen < sizeof(conn->hdr))
+        {
+          return OK;
+        }
+
+      conn->mode    = ntohl(conn->hdr.mode);
+      conn->msgsize = ntohl(conn->hdr.msgsize);
+
+      if (conn->mode == NETBENCH_TCP_ECHO)
+        {
+          if (conn->msgsize < 1 ||
+              conn->msgsize > CONFIG_TESTING_NETBENCH_MAXBUF)
+            {
+              return -EINVAL;
+            }
+
+          conn->buf = malloc(conn->msgsize);
+          if (conn->buf == NULL)
+            {
+              return -ENOMEM;
+            }
+        }
+      else if (conn->mode != NETBENCH_TCP_SINK)
+        {
+          return -EINVAL;
+        }
+
+      return OK;
+    }
+
+  if (conn->mode == NETBENCH_TCP_SINK)
+    {
+      nrecvd = recv(fd, scratch, CONFIG_TESTING_NETBENCH_MAXBUF, 0);
+      if (nrecvd <= 0)
+        {
+          return nrecvd < 0 ? -errno : -ENOTCONN;
+        }
+
+      return OK;
+    }
+
+  nrecvd = recv(fd, &conn->buf[conn->fill], conn->msgsize - conn->fill, 0);
+  if (nrecvd <= 0)
+    {
+      return nrecvd < 0 ? -errno : -ENOTCONN;
+    }
+
+  conn->fill += nrecvd;
+  if (conn->fill == conn->msgsize)
+    {
+      conn->fill = 0;
+      return netbench_sendall(fd, conn->buf, conn->msgsize);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_udp_input
+ *
+ * Description:
+ *   Count one datagram, or answer a query with the count so far.
+ *
+ ****************************************************************************/
+
+static void netbench_udp_input(int fd, FAR uint8_t *scratch,
+                               FAR uint32_t *count)
+{
+  struct netbench_udp_s udp;
+  struct sockaddr_in from;
+  socklen_t fromlen = sizeof(from);
+  ssize_t nrecvd;
+
+  nrecvd = recvfrom(fd, scratch, CONFIG_TESTING_NETBENCH_MAXBUF, 0,
+                    (FAR struct sockaddr *)&from, &fromlen);
+  if (nrecvd < (ssize_t)sizeof(udp))
+    {
+      return;
+    }
+
+  memcpy(&udp, scratch, sizeof(udp));
+  if (ntohl(udp.seq) != NETBENCH_UDP_QUERY)
+    {
+      (*count)++;
+      return;
+    }
+
+  udp.count = htonl(*count);
+  *count    = 0;
+
+  sendto(fd, &udp, sizeof(udp), 0, (FAR struct sockaddr *)&from, fromlen);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_server_open
+ *
+ * Description:
+ *   Bind the TCP listener and the UDP socket to "port" on all interfaces.
+ *
+ ****************************************************************************/
+
+int netbench_server_open(FAR struct netbench_server_s *server,
+                         uint16_t port)
+{
+  struct sockaddr_in addr;
+  int optval;
+  int ret;
+
+  server->listenfd = -1;
+  server->udpfd    = -1;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  server->listenfd = socket(PF_INET, SOCK_STREAM, 0);
+  if (server->listenfd < 0)
+    {
+      goto errout;
+    }
+
+  optval = 1;
+  setsockopt(server->listenfd, SOL_SOCKET, SO_REUSEADDR, &optval,
+             sizeof(optval));
+
+  if (bind(server->listenfd, (FAR struct sockaddr *)&addr,
+           sizeof(addr)) < 0 ||
+      listen(server->listenfd, CONFIG_TESTING_NETBENCH_MAXCONN) < 0)
+    {
+      goto errout;
+    }
+
+  server->udpfd = socket(PF_INET, SOCK_DGRAM, 0);
+  if (server->udpfd < 0 ||
+      bind(server->udpfd, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  ret = -errno;
+  fprintf(stderr, "ERROR: Failed to open the server on port %u: %d\n",
+          port, ret);
+  netbench_server_close(server);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_server_run
+ *
+ * Description:
+ *   Serve clients until "*stop" becomes true, or forever if "stop" is
+ *   NULL.  Every connection and the UDP socket are served from a single
+ *   poll() loop, so the scaling test does not depend on the number of
+ *   threads the target can afford.
+ *
+ ****************************************************************************/
+
+int netbench_server_run(FAR struct netbench_server_s *server,
+                        FAR volatile bool *stop)
+{
+  struct pollfd fds[NETBENCH_NFIXED + CONFIG_TESTING_NETBENCH_MAXCONN];
+  struct netbench_conn_s conns[CONFIG_TESTING_NETBENCH_MAXCONN];
+  FAR uint8_t *scratch;
+  uint32_t udpcount = 0;
+  int nconns = 0;
+  int ret;
+  int fd;
+  int i;
+
+  scratch = malloc(CONFIG_TESTING_NETBENCH_MAXBUF);
+  if (scratch == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(fds, 0, sizeof(fds));
+  fds[NETBENCH_LISTENFD].fd     = server->listenfd;
+  fds[NETBENCH_LISTENFD].events = POLLIN;
+  fds[NETBENCH_UDPFD].fd        = server->udpfd;
+  fds[NETBENCH_UDPFD].events    = POLLIN;
+
+  while (stop == NULL || !*stop)
+    {
+      ret = poll(fds, NETBENCH_NFIXED + nconns, NETBENCH_POLLMS);
+      if (ret < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          ret = -errno;
+          fprintf(stderr, "ERROR: poll failed: %d\n", ret);
+          goto out;
+        }
+
+      if (fds[NETBENCH_UDPFD].revents & POLLIN)
+        {
+          netbench_udp_input(server->udpfd, scratch, &udpcount);
+        }
+
+      /* Serve the connections from the last so that closing one can move
+       * the last slot into its place.
+       */
+
+      for (i = nconns - 1; i >= 0; i--)
+        {
+          if ((fds[NETBENCH_NFIXED + i].revents &
+               (POLLIN | POLLHUP | POLLERR)) == 0)
+            {
+              continue;
+            }
+
+          ret = netbench_conn_input(fds[NETBENCH_NFIXED + i].fd, &conns[i],
+                                    scratch);
+          if (ret < 0)
+            {
+              close(fds[NETBENCH_NFIXED + i].fd);
+              free(conns[i].buf);
+
+              nconns--;
+              fds[NETBENCH_NFIXED + i] = fds[NETBENCH_NFIXED + nconns];
+              conns[i] = conns[nconns];
+            }
+        }
+
+      if (fds[NETBENCH_LISTENFD].revents & POLLIN)
+        {
+          fd = accept(server->listenfd, NULL, NULL);
+          if (fd < 0)
+            {
+              continue;
+            }
+
+          if (nconns >= CONFIG_TESTING_NETBENCH_MAXCONN)
+            {
+              close(fd);
+              continue;
+            }
+
+          memset(&conns[nconns], 0, sizeof(conns[nconns]));
+          fds[NETBENCH_NFIXED + nconns].fd      = fd;
+          fds[NETBENCH_NFIXED + nconns].events  = POLLIN;
+          fds[NETBENCH_NFIXED + nconns].revents = 0;
+          nconns++;
+        }
+    }
+
+  ret = OK;
+
+out:
+  for (i = 0; i < nconns; i++)
+    {
+      close(fds[NETBENCH_NFIXED + i].fd);
+      free(conns[i].buf);
+    }
+
+  free(scratch);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_server_close
+ ****************************************************************************/
+
+void netbench_server_close(FAR struct netbench_server_s *server)
+{
+  if (server->listenfd >= 0)
+    {
+      close(server->listenfd);
+      server->listenfd = -1;
+    }
+
+  if (server->udpfd >= 0)
+    {
+      close(server->udpfd);
+      server->udpfd = -1;
+    }
+}
@@ -0,0 +1,267 @@
+/****************************************************************************
+ * apps/testing/netbench/netbench_telnet.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "netbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* How long to wait for each part of the session set up */
+
+#define NETBENCH_TELNET_TIMEOUTMS 10000
+
+/* The size of the window of received text that prompts are matched in */
+
+#define NETBENCH_TELNET_TAIL      64
+
+/* Telnet "interpret as command" byte, which starts a 3 byte option */
+
+#define NETBENCH_TELNET_IAC       255
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_endswith
+ ****************************************************************************/
+
+static bool netbench_endswith(FAR const char *text, size_t len,
+                              FAR const char *suffix)
+{
+  size_t slen = strlen(suffix);
+
+  return len >= slen && memcmp(&text[len - slen], suffix, slen) == 0;
+}
+
+/****************************************************************************
+ * Name: netbench_sendline
+ ****************************************************************************/
+
+static int netbench_sendline(int fd, FAR const char *text)
+{
+  char line[NETBENCH_TELNET_TAIL];
+  int len;
+
+  len = snprintf(line, sizeof(line), "%s\r\n", text);
+  if ((size_t)len >= sizeof(line))
+    {
+      return -E2BIG;
+    }
+
+  return send(fd, line, len, 0) == len ? OK : -errno;
+}
+
+/****************************************************************************
+ * Name: netbench_session
+ *
+ * Description:
+ *   Connect to the Telnet server, log in if asked to and wait for the
+ *   shell prompt.  Option negotiation is not answered, which the NuttX
+ *   server does not need.
+ *
+ ****************************************************************************/
+
+static int netbench_session(FAR const struct netbench_s *bench,
+                            FAR uint64_t *bytes)
+{
+  struct sockaddr_in addr;
+  struct pollfd pfd;
+  char tail[NETBENCH_TELNET_TAIL];
+  uint8_t buf[64];
+  size_t ntail = 0;
+  ssize_t nrecvd;
+  int skip = 0;
+  int ret;
+  int fd;
+  int i;
+
+  fd = socket(PF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    {
+      ret = -errno;
+      fprintf(stderr, "ERROR: socket failed: %d\n", ret);
+      return ret;
+    }
+
+  addr          = bench->addr;
+  addr.sin_port = htons(bench->telnetport);
+
+  if (connect(fd, (FAR const struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+      ret = -errno;
+      fprintf(stderr, "ERROR: connect failed: %d\n", ret);
+      goto out;
+    }
+
+  for (; ; )
+    {
+      pfd.fd     = fd;
+      pfd.events = POLLIN;
+
+      ret = poll(&pfd, 1, NETBENCH_TELNET_TIMEOUTMS);
+      if (ret <= 0)
+        {
+          ret = ret < 0 ? -errno : -ETIMEDOUT;
+          fprintf(stderr, "ERROR: No prompt: %d\n", ret);
+          goto out;
+        }
+
+      nrecvd = recv(fd, buf, sizeof(buf), 0);
+      if (nrecvd <= 0)
+        {
+          ret = nrecvd < 0 ? -errno : -ECONNRESET;
+          fprintf(stderr, "ERROR: recv failed: %d\n", ret);
+          goto out;
+        }
+
+      *bytes += nrecvd;
+
+      /* Keep the tail of the text, without the Telnet options */
+
+      for (i = 0; i < nrecvd; i++)
+        {
+          if (skip > 0)
+            {
+              skip--;
+              continue;
+            }
+          else if (buf[i] == NETBENCH_TELNET_IAC)
+            {
+              skip = 2;
+              continue;
+            }
+
+          if (ntail == sizeof(tail))
+            {
+              memmove(tail, &tail[1], --ntail);
+            }
+
+          tail[ntail++] = buf[i];
+        }
+
+      if (netbench_endswith(tail, ntail, bench->prompt))
+        {
+          break;
+        }
+
+      if (bench->user != NULL && netbench_endswith(tail, ntail, "login: "))
+        {
+          ret = netbench_sendline(fd, bench->user);
+          ntail = 0;
+        }
+      else if (bench->password != NULL &&
+               netbench_endswith(tail, ntail, "password: "))
+        {
+          ret = netbench_sendline(fd, bench->password);
+          ntail = 0;
+        }
+
+      if (ret < 0)
+        {
+          fprintf(stderr, "ERROR: send failed: %d\n", ret);
+          goto out;
+        }
+    }
+
+  /* Leave so that the session ends at once */
+
+  ret = netbench_sendline(fd, "exit");
+
+out:
+  close(fd);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_telnet
+ *
+ * Description:
+ *   Open Telnet sessions one after the other and measure the time from
+ *   connect() to the shell prompt.  Bytes are those received before the
+ *   prompt, including the login.
+ *
+ ****************************************************************************/
+
+int netbench_telnet(FAR const struct netbench_s *bench)
+{
+  struct netbench_result_s result;
+  uint64_t start;
+  uint64_t now;
+  int ret = OK;
+
+  memset(&result, 0, sizeof(result));
+  result.test  = "telnet";
+  result.conns = 1;
+
+  result.lat = malloc(bench->count * sizeof(uint32_t));
+  if (result.lat == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  start = netbench_usec();
+  for (; result.ops < bench->count; result.ops++)
+    {
+      now = netbench_usec();
+
+      ret = netbench_session(bench, &result.bytes);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      result.lat[result.nlat++] = (uint32_t)(netbench_usec() - now);
+    }
+
+  result.usec = netbench_usec() - start;
+
+  if (ret == OK)
+    {
+      netbench_report(bench, &result);
+    }
+
+  free(result.lat);
+  return ret;
+}
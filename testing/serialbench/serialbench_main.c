@@ -0,0 +1,664 @@
+/****************************************************************************
+ * apps/testing/serialbench/serialbench_main.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <crc32.h>
+
+#ifdef CONFIG_SERIAL_TERMIOS
+#  include <termios.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_TESTING_SERIALBENCH_DEVPATH
+#  define CONFIG_TESTING_SERIALBENCH_DEVPATH "/dev/ttyS1"
+#endif
+
+#ifndef CONFIG_TESTING_SERIALBENCH_MAXBLOCK
+#  define CONFIG_TESTING_SERIALBENCH_MAXBLOCK 4096
+#endif
+
+#define SERIALBENCH_MAGIC    0x534e4253  /* "SBNS" */
+#define SERIALBENCH_HDRLEN   sizeof(struct serialbench_hdr_s)
+#define SERIALBENCH_CRCLEN   sizeof(uint32_t)
+#define SERIALBENCH_MINBLOCK (SERIALBENCH_HDRLEN + SERIALBENCH_CRCLEN)
+
+#define SERIALBENCH_DEFBLOCK 256
+#define SERIALBENCH_DEFCOUNT 1000
+#define SERIALBENCH_DEFIDLE  2000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Every block starts with this header and ends with the CRC-32 of all of
+ * the bytes before it.
+ */
+
+begin_packed_struct struct serialbench_hdr_s
+{
+  uint32_t magic;                    /* SERIALBENCH_MAGIC */
+  uint32_t seq;                      /* Block sequence number */
+  uint32_t len;                      /* Block length including the CRC */
+  uint64_t timestamp;                /* Send time (CLOCK_MONOTONIC, us) */
+} end_packed_struct;
+
+struct serialbench_s
+{
+  /* Options */
+
+  FAR const char *txpath;
+  FAR const char *rxpath;
+  uint32_t blksize;                  /* Block size in bytes */
+  uint32_t count;                    /* Blocks to send / expect */
+  int idlems;                        /* Receiver idle timeout */
+  bool latency;                      /* Transmitter shares our clock */
+  int rxfd;
+
+  /* Receiver statistics */
+
+  uint32_t blocks;                   /* Good blocks received */
+  uint32_t expected;                 /* Next expected sequence number */
+  uint32_t dropped;                  /* Sequence numbers never seen */
+  uint32_t reordered;                /* Blocks older than expected */
+  uint32_t crcerrors;                /* Framed blocks with a bad CRC */
+  uint64_t bytes;                    /* Bytes of good blocks */
+  uint64_t skipped;                  /* Bytes discarded while resyncing */
+  uint64_t first;                    /* Arrival of the first good block */
+  uint64_t last;                     /* Arrival of the last good block */
+  uint64_t latsum;
+  uint32_t latmin;
+  uint32_t latmax;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: serialbench_usec
+ ****************************************************************************/
+
+static uint64_t serialbench_usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: serialbench_open
+ *
+ * Description:
+ *   Open a serial device and, if supported, put it in raw mode at the
+ *   requested baud rate.
+ *
+ ****************************************************************************/
+
+static int serialbench_open(FAR const char *path, int oflags, long baud)
+{
+  int fd;
+
+  fd = open(path, oflags);
+  if (fd < 0)
+    {
+      fprintf(stderr, "ERROR: open %s failed: %d\n", path, errno);
+      return -1;
+    }
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  struct termios tio;
+
+  if (tcgetattr(fd, &tio) == 0)
+    {
+      cfmakeraw(&tio);
+      if (baud > 0)
+        {
+          cfsetspeed(&tio, baud);
+        }
+
+      if (tcsetattr(fd, TCSANOW, &tio) < 0)
+        {
+          fprintf(stderr, "WARNING: tcsetattr %s failed: %d\n", path, errno);
+        }
+    }
+#endif
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: serialbench_rate
+ *
+ * Description:
+ *   Print "nbytes" in "usec" as bytes/s.
+ *
+ ****************************************************************************/
+
+static void serialbench_rate(FAR const char *what, uint64_t nbytes,
+                             uint64_t usec)
+{
+  printf("%s: %llu bytes in %llu.%03llu s, %llu bytes/s\n", what,
+         (unsigned long long)nbytes,
+         (unsigned long long)(usec / 1000000),
+         (unsigned long long)(usec % 1000000 / 1000),
+         (unsigned long long)(usec > 0 ? nbytes * 1000000 / usec : 0));
+}
+
+/****************************************************************************
+ * Name: serialbench_tx
+ *
+ * Description:
+ *   Send the blocks as fast as the device accepts them.  Each block is
+ *   handed to the driver with a single write() where possible.
+ *
+ ****************************************************************************/
+
+static int serialbench_tx(FAR struct serialbench_s *bench, int fd)
+{
+  struct serialbench_hdr_s hdr;
+  FAR uint8_t *block;
+  uint64_t start;
+  uint64_t end;
+  uint32_t crc;
+  uint32_t seq;
+  size_t off;
+  ssize_t nwritten;
+  uint32_t i;
+  int ret = OK;
+
+  block = malloc(bench->blksize);
+  if (block == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to allocate the TX block\n");
+      return -ENOMEM;
+    }
+
+  start = serialbench_usec();
+
+  for (seq = 0; seq < bench->count; seq++)
+    {
+      /* The payload changes with every block so that stale data in a
+       * driver buffer cannot pass for a new block.
+       */
+
+      for (i = SERIALBENCH_HDRLEN;
+           i < bench->blksize - SERIALBENCH_CRCLEN; i++)
+        {
+          block[i] = (uint8_t)(seq + i);
+        }
+
+      hdr.magic     = SERIALBENCH_MAGIC;
+      hdr.seq       = seq;
+      hdr.len       = bench->blksize;
+      hdr.timestamp = serialbench_usec();
+      memcpy(block, &hdr, SERIALBENCH_HDRLEN);
+
+      crc = crc32(block, bench->blksize - SERIALBENCH_CRCLEN);
+      memcpy(&block[bench->blksize - SERIALBENCH_CRCLEN], &crc,
+             SERIALBENCH_CRCLEN);
+
+      for (off = 0; off < bench->blksize; off += nwritten)
+        {
+          nwritten = write(fd, &block[off], bench->blksize - off);
+          if (nwritten < 0)
+            {
+              if (errno == EINTR)
+                {
+                  nwritten = 0;
+                  continue;
+                }
+
+              ret = -errno;
+              fprintf(stderr, "ERROR: write failed: %d\n", errno);
+              goto out;
+            }
+        }
+    }
+
+out:
+  end = serialbench_usec();
+  serialbench_rate("TX", (uint64_t)seq * bench->blksize, end - start);
+  free(block);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: serialbench_accept
+ *
+ * Description:
+ *   Account for one good block.
+ *
+ ****************************************************************************/
+
+static void serialbench_accept(FAR struct serialbench_s *bench,
+                               FAR const struct serialbench_hdr_s *hdr,
+                               uint64_t now)
+{
+  uint32_t latency;
+
+  if (bench->blocks == 0)
+    {
+      bench->first = now;
+    }
+
+  bench->blocks++;
+  bench->bytes += hdr->len;
+  bench->last   = now;
+
+  if (hdr->seq >= bench->expected)
+    {
+      bench->dropped  += hdr->seq - bench->expected;
+      bench->expected  = hdr->seq + 1;
+    }
+  else
+    {
+      bench->reordered++;
+    }
+
+  if (bench->latency)
+    {
+      latency = (uint32_t)(now - hdr->timestamp);
+      bench->latsum += latency;
+      if (bench->blocks == 1 || latency < bench->latmin)
+        {
+          bench->latmin = latency;
+        }
+
+      if (latency > bench->latmax)
+        {
+          bench->latmax = latency;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: serialbench_parse
+ *
+ * Description:
+ *   Extract the complete blocks from "buf".  Bytes that cannot start a
+ *   valid block are skipped one at a time until the stream is in sync
+ *   again.
+ *
+ * Returned Value:
+ *   The number of bytes consumed.
+ *
+ ****************************************************************************/
+
+static size_t serialbench_parse(FAR struct serialbench_s *bench,
+                                FAR const uint8_t *buf, size_t len,
+                                uint64_t now)
+{
+  struct serialbench_hdr_s hdr;
+  uint32_t crc;
+  size_t pos = 0;
+
+  while (len - pos >= SERIALBENCH_HDRLEN)
+    {
+      memcpy(&hdr, &buf[pos], SERIALBENCH_HDRLEN);
+      if (hdr.magic != SERIALBENCH_MAGIC ||
+          hdr.len < SERIALBENCH_MINBLOCK ||
+          hdr.len > CONFIG_TESTING_SERIALBENCH_MAXBLOCK)
+        {
+          bench->skipped++;
+          pos++;
+          continue;
+        }
+
+      if (len - pos < hdr.len)
+        {
+          break;
+        }
+
+      memcpy(&crc, &buf[pos + hdr.len - SERIALBENCH_CRCLEN],
+             SERIALBENCH_CRCLEN);
+      if (crc != crc32(&buf[pos], hdr.len - SERIALBENCH_CRCLEN))
+        {
+          bench->crcerrors++;
+          bench->skipped++;
+          pos++;
+          continue;
+        }
+
+      serialbench_accept(bench, &hdr, now);
+      pos += hdr.len;
+    }
+
+  return pos;
+}
+
+/****************************************************************************
+ * Name: serialbench_rx
+ *
+ * Description:
+ *   Receive until all blocks are accounted for or the line has been idle
+ *   for the idle timeout.
+ *
+ ****************************************************************************/
+
+static int serialbench_rx(FAR struct serialbench_s *bench, int fd)
+{
+  struct pollfd pfd;
+  FAR uint8_t *buf;
+  size_t bufsize = 2 * CONFIG_TESTING_SERIALBENCH_MAXBLOCK;
+  size_t len = 0;
+  size_t used;
+  ssize_t nread;
+  int ret = OK;
+
+  buf = malloc(bufsize);
+  if (buf == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to allocate the RX buffer\n");
+      return -ENOMEM;
+    }
+
+  pfd.fd     = fd;
+  pfd.events = POLLIN;
+
+  while (bench->blocks + bench->dropped < bench->count)
+    {
+      ret = poll(&pfd, 1, bench->idlems);
+      if (ret == 0)
+        {
+          break;
+        }
+      else if (ret < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          ret = -errno;
+          fprintf(stderr, "ERROR: poll failed: %d\n", errno);
+          break;
+        }
+
+      nread = read(fd, &buf[len], bufsize - len);
+      if (nread <= 0)
+        {
+          if (nread < 0 && errno == EINTR)
+            {
+              continue;
+            }
+
+          ret = nread < 0 ? -errno : OK;
+          break;
+        }
+
+      len += nread;
+      used = serialbench_parse(bench, buf, len, serialbench_usec());
+      len -= used;
+      memmove(buf, &buf[used], len);
+      ret = OK;
+    }
+
+  free(buf);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: serialbench_rxthread
+ ****************************************************************************/
+
+static FAR void *serialbench_rxthread(FAR void *arg)
+{
+  FAR struct serialbench_s *bench = arg;
+
+  return (FAR void *)(intptr_t)serialbench_rx(bench, bench->rxfd);
+}
+
+/****************************************************************************
+ * Name: serialbench_report
+ ****************************************************************************/
+
+static void serialbench_report(FAR struct serialbench_s *bench)
+{
+  uint32_t missing = 0;
+
+  if (bench->blocks + bench->dropped < bench->count)
+    {
+      missing = bench->count - bench->blocks - bench->dropped;
+    }
+
+  serialbench_rate("RX", bench->bytes, bench->last - bench->first);
+  printf("RX: %lu blocks, %lu dropped, %lu missing at the end, "
+         "%lu reordered\n",
+         (unsigned long)bench->blocks, (unsigned long)bench->dropped,
+         (unsigned long)missing, (unsigned long)bench->reordered);
+  printf("RX: %lu CRC errors, %llu bytes skipped to resync\n",
+         (unsigned long)bench->crcerrors,
+         (unsigned long long)bench->skipped);
+
+  if (bench->latency && bench->blocks > 0)
+    {
+      printf("Latency: min %lu us, avg %lu us, max %lu us\n",
+             (unsigned long)bench->latmin,
+             (unsigned long)(bench->latsum / bench->blocks),
+             (unsigned long)bench->latmax);
+    }
+}
+
+/****************************************************************************
+ * Name: serialbench_showusage
+ ****************************************************************************/
+
+static void serialbench_showusage(FAR const char *progname, int exitcode)
+{
+  fprintf(stderr, "USAGE: %s [OPTIONS] tx|rx [<dev>]\n", progname);
+  fprintf(stderr, "       %s [OPTIONS] loop [<txdev> [<rxdev>]]\n",
+          progname);
+  fprintf(stderr, "Where OPTIONS are:\n");
+  fprintf(stderr, "  -s <bytes>  Block size (%u-%u).  Default: %u\n",
+          (unsigned int)SERIALBENCH_MINBLOCK,
+          CONFIG_TESTING_SERIALBENCH_MAXBLOCK, SERIALBENCH_DEFBLOCK);
+  fprintf(stderr, "  -n <count>  Number of blocks.  Default: %u\n",
+          SERIALBENCH_DEFCOUNT);
+  fprintf(stderr, "  -i <ms>     Receiver idle timeout.  Default: %u\n",
+          SERIALBENCH_DEFIDLE);
+#ifdef CONFIG_SERIAL_TERMIOS
+  fprintf(stderr, "  -b <baud>   Baud rate.  Default: unchanged\n");
+#endif
+  fprintf(stderr, "The default device is %s.  In loop mode the receiver "
+          "runs in a\nthread, e.g. over a loopback cable or a pty pair, "
+          "and the one-way\nlatency is measured.\n",
+          CONFIG_TESTING_SERIALBENCH_DEVPATH);
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct serialbench_s bench;
+  FAR const char *mode;
+  pthread_t rxthread;
+  FAR void *value;
+  long baud = 0;
+  int option;
+  int txfd;
+  int ret;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.blksize = SERIALBENCH_DEFBLOCK;
+  bench.count   = SERIALBENCH_DEFCOUNT;
+  bench.idlems  = SERIALBENCH_DEFIDLE;
+
+  while ((option = getopt(argc, argv, "s:n:i:b:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 's':
+            bench.blksize = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'n':
+            bench.count = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'i':
+            bench.idlems = atoi(optarg);
+            break;
+
+          case 'b':
+            baud = strtol(optarg, NULL, 0);
+            break;
+
+          case 'h':
+            serialbench_showusage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            serialbench_showusage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (optind >= argc || bench.count == 0 ||
+      bench.blksize < SERIALBENCH_MINBLOCK ||
+      bench.blksize > CONFIG_TESTING_SERIALBENCH_MAXBLOCK)
+    {
+      serialbench_showusage(argv[0], EXIT_FAILURE);
+    }
+
+  mode = argv[optind++];
+  bench.txpath = optind < argc ? argv[optind++] :
+                                 CONFIG_TESTING_SERIALBENCH_DEVPATH;
+  bench.rxpath = optind < argc ? argv[optind++] : bench.txpath;
+
+  if (strcmp(mode, "tx") == 0)
+    {
+      txfd = serialbench_open(bench.txpath, O_WRONLY, baud);
+      if (txfd < 0)
+        {
+          return EXIT_FAILURE;
+        }
+
+      ret = serialbench_tx(&bench, txfd);
+      close(txfd);
+    }
+  else if (strcmp(mode, "rx") == 0)
+    {
+      bench.rxfd = serialbench_open(bench.txpath, O_RDONLY, baud);
+      if (bench.rxfd < 0)
+        {
+          return EXIT_FAILURE;
+        }
+
+      printf("Waiting for %lu blocks on %s\n",
+             (unsigned long)bench.count, bench.txpath);
+      ret = serialbench_rx(&bench, bench.rxfd);
+      serialbench_report(&bench);
+      close(bench.rxfd);
+    }
+  else if (strcmp(mode, "loop") == 0)
+    {
+      bench.latency = true;
+
+      txfd = serialbench_open(bench.txpath, O_RDWR, baud);
+      if (txfd < 0)
+        {
+          return EXIT_FAILURE;
+        }
+
+      bench.rxfd = txfd;
+      if (strcmp(bench.rxpath, bench.txpath) != 0)
+        {
+          bench.rxfd = serialbench_open(bench.rxpath, O_RDONLY, baud);
+          if (bench.rxfd < 0)
+            {
+              close(txfd);
+              return EXIT_FAILURE;
+            }
+        }
+
+      ret = pthread_create(&rxthread, NULL, serialbench_rxthread, &bench);
+      if (ret != 0)
+        {
+          fprintf(stderr, "ERROR: pthread_create failed: %d\n", ret);
+          ret = -ret;
+        }
+      else
+        {
+          ret = serialbench_tx(&bench, txfd);
+          pthread_join(rxthread, &value);
+          if (ret >= 0)
+            {
+              ret = (int)(intptr_t)value;
+            }
+
+          serialbench_report(&bench);
+        }
+
+      if (bench.rxfd != txfd)
+        {
+          close(bench.rxfd);
+        }
+
+      close(txfd);
+    }
+  else
+    {
+      serialbench_showusage(argv[0], EXIT_FAILURE);
+      return EXIT_FAILURE;
+    }
+
+  if (ret < 0)
+    {
+      return EXIT_FAILURE;
+    }
+
+  /* Anything lost or corrupted is a failure of the link */
+
+  if (strcmp(mode, "tx") != 0 &&
+      (bench.blocks != bench.count || bench.crcerrors > 0))
+    {
+      return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,302 @@
+/****************************************************************************
+ * apps/testing/wapiscan/wapiscan_main.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/wireless/wireless.h>
+
+#include "wireless/wapi.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TEST_BUFSIZE   2048
+#define TEST_DENSE_APS 200
+
+#define EVENT_HDRLEN   offsetof(struct iw_event, u)
+#define EVENT_ALIGN(n) (((n) + sizeof(FAR void *) - 1) & \
+                        ~(sizeof(FAR void *) - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A scan cell as the driver would report it */
+
+struct test_cell_s
+{
+  uint8_t bssid[6];
+  FAR const char *essid;
+  int channel;
+  int rssi;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* A capture of a scan in which one AP was seen twice, once through a weak
+ * beacon with a hidden ESSID and once through a strong probe response.
+ */
+
+static const struct test_cell_s g_cells[] =
+{
+  { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x01 }, "alpha",   1, -70 },
+  { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x02 }, "",        6, -85 },
+  { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x03 }, "gamma",  11, -40 },
+  { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x02 }, "beta",    6, -55 },
+  { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x04 }, "delta",  13, -60 },
+};
+
+static char g_buffer[TEST_BUFSIZE];
+static unsigned int g_errors;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: record_event / record_cell
+ *
+ * Description:
+ *   Append events to a buffer in the SIOCGIWSCAN stream format.  Pointer
+ *   payloads follow the iw_point and are referenced by their offset from
+ *   the start of the event union.  Events are padded to keep the next one
+ *   aligned, as drivers do.
+ *
+ ****************************************************************************/
+
+static size_t record_event(FAR char *buf, size_t len,
+                           FAR struct iw_event *iwe, size_t paylen,
+                           FAR const void *payload)
+{
+  size_t hdrlen = EVENT_HDRLEN + paylen;
+
+  if (payload != NULL)
+    {
+      hdrlen = EVENT_HDRLEN + sizeof(struct iw_point);
+      memcpy(&buf[len + hdrlen], payload, iwe->u.data.length);
+      iwe->len = EVENT_ALIGN(hdrlen + iwe->u.data.length);
+    }
+  else
+    {
+      iwe->len = EVENT_ALIGN(hdrlen);
+    }
+
+  memcpy(&buf[len], iwe, hdrlen);
+  return len + iwe->len;
+}
+
+static size_t record_cell(FAR char *buf, size_t len,
+                          FAR const struct test_cell_s *cell)
+{
+  struct iw_event iwe;
+
+  memset(&iwe, 0, sizeof(iwe));
+  iwe.cmd = SIOCGIWAP;
+  memcpy(iwe.u.ap_addr.sa_data, cell->bssid, 6);
+  len = record_event(buf, len, &iwe, sizeof(struct sockaddr), NULL);
+
+  memset(&iwe, 0, sizeof(iwe));
+  iwe.cmd = SIOCGIWESSID;
+  iwe.u.data.flags   = 1;
+  iwe.u.data.length  = strlen(cell->essid);
+  iwe.u.data.pointer = (FAR void *)sizeof(struct iw_point);
+  len = record_event(buf, len, &iwe, 0, cell->essid);
+
+  memset(&iwe, 0, sizeof(iwe));
+  iwe.cmd = SIOCGIWFREQ;
+  iwe.u.freq.m = cell->channel;
+  len = record_event(buf, len, &iwe, sizeof(struct iw_freq), NULL);
+
+  memset(&iwe, 0, sizeof(iwe));
+  iwe.cmd = IWEVQUAL;
+  iwe.u.qual.updated = IW_QUAL_DBM;
+  iwe.u.qual.level   = (uint8_t)cell->rssi;
+  len = record_event(buf, len, &iwe, sizeof(struct iw_quality), NULL);
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: check
+ ****************************************************************************/
+
+static void check(bool cond, FAR const char *what)
+{
+  if (!cond)
+    {
+      printf("ERROR: %s\n", what);
+      g_errors++;
+    }
+}
+
+/****************************************************************************
+ * Name: test_capture
+ ****************************************************************************/
+
+static void test_capture(void)
+{
+  struct wapi_scan_results_s results;
+  FAR struct wapi_scan_info_s *info;
+  size_t len = 0;
+  int ret;
+  int i;
+
+  for (i = 0; i < sizeof(g_cells) / sizeof(g_cells[0]); i++)
+    {
+      len = record_cell(g_buffer, len, &g_cells[i]);
+    }
+
+  /* Without options every cell is reported in capture order */
+
+  ret = wapi_scan_parse(g_buffer, len, 0, &results);
+  check(ret == 5 && results.naps == 5, "plain parse count");
+  if (ret == 5)
+    {
+      check(strcmp(results.aps[0].essid, "alpha") == 0, "plain order");
+      check(results.aps[2].freq == 2462, "channel to frequency");
+      check(results.aps[2].rssi == -40, "signal level");
+      check(results.aps[4].next == NULL, "list termination");
+
+      for (i = 0, info = results.aps; info; info = info->next)
+        {
+          i++;
+        }
+
+      check(i == 5, "list chaining");
+    }
+
+  wapi_scan_results_free(&results);
+
+  /* Deduplicated and sorted by signal level */
+
+  ret = wapi_scan_parse(g_buffer, len,
+                        WAPI_SCAN_DEDUPE | WAPI_SCAN_SORT_RSSI, &results);
+  check(ret == 4, "dedupe count");
+  if (ret == 4)
+    {
+      check(strcmp(results.aps[0].essid, "gamma") == 0, "strongest first");
+      check(strcmp(results.aps[1].essid, "beta") == 0, "duplicate kept");
+      check(results.aps[1].rssi == -55, "strongest duplicate kept");
+      check(strcmp(results.aps[3].essid, "alpha") == 0, "weakest last");
+
+      for (i = 1; i < ret; i++)
+        {
+          check(results.aps[i - 1].rssi >= results.aps[i].rssi,
+                "rssi ordering");
+        }
+    }
+
+  wapi_scan_results_free(&results);
+
+  /* A capture truncated in the middle of an event is rejected */
+
+  ret = wapi_scan_parse(g_buffer, len - 3, 0, &results);
+  check(ret == -EINVAL && results.aps == NULL, "truncated capture");
+
+  /* An empty capture has no results */
+
+  ret = wapi_scan_parse(g_buffer, 0, 0, &results);
+  check(ret == 0 && results.aps == NULL, "empty capture");
+}
+
+/****************************************************************************
+ * Name: test_dense
+ ****************************************************************************/
+
+static void test_dense(void)
+{
+  struct wapi_scan_results_s results;
+  struct test_cell_s cell;
+  FAR char *buf;
+  size_t len = 0;
+  int ret;
+  int i;
+
+  /* Every AP is heard twice, as in a busy environment */
+
+  buf = malloc(2 * TEST_DENSE_APS * 128);
+  if (buf == NULL)
+    {
+      check(false, "dense buffer allocation");
+      return;
+    }
+
+  for (i = 0; i < 2 * TEST_DENSE_APS; i++)
+    {
+      memset(&cell, 0, sizeof(cell));
+      cell.bssid[4] = (i % TEST_DENSE_APS) >> 8;
+      cell.bssid[5] = (i % TEST_DENSE_APS) & 0xff;
+      cell.essid    = "dense";
+      cell.channel  = 1 + i % 13;
+      cell.rssi     = -30 - (i * 7) % 60;
+      len = record_cell(buf, len, &cell);
+    }
+
+  ret = wapi_scan_parse(buf, len, WAPI_SCAN_DEDUPE | WAPI_SCAN_SORT_RSSI,
+                        &results);
+  check(ret == TEST_DENSE_APS, "dense dedupe count");
+
+  for (i = 1; i < ret; i++)
+    {
+      check(results.aps[i - 1].rssi >= results.aps[i].rssi,
+            "dense rssi ordering");
+    }
+
+  wapi_scan_results_free(&results);
+  free(buf);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  g_errors = 0;
+
+  test_capture();
+  test_dense();
+
+  if (g_errors > 0)
+    {
+      printf("FAILED: %u errors\n", g_errors);
+      return EXIT_FAILURE;
+    }
+
+  printf("PASSED\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,523 @@
+/****************************************************************************
+ * apps/uORB/bridge/sensorbridge.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * @file sensorbridge.cxx
+ *
+ * Sensor framework to uORB bridge.
+ *
+ * All sensors found under /dev/sensor are opened with hardware batching
+ * enabled and serviced from a single poll loop.  Each wakeup drains the
+ * whole driver FIFO with one read() and every sample is republished on the
+ * matching sensor_*_uorb topic with the driver timestamp preserved.
+ */
+
+#include <nuttx/config.h>
+#include <nuttx/sensors/sensor.h>
+
+#include <sys/ioctl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <syslog.h>
+#include <time.h>
+
+#include "uORB/orb/uORB.h"
+#include "uORB/topics/sensor_vec3_uorb.h"
+#include "uORB/topics/sensor_baro_uorb.h"
+#include "uORB/topics/sensor_scalar_uorb.h"
+
+#define SENSORBRIDGE_DEVDIR	"/dev/sensor"
+#define SENSORBRIDGE_MAX	CONFIG_UORB_SENSORBRIDGE_MAXSENSORS
+#define SENSORBRIDGE_NEVENTS	CONFIG_UORB_SENSORBRIDGE_NEVENTS
+#define SENSORBRIDGE_QUEUE	CONFIG_UORB_SENSORBRIDGE_QUEUE
+
+extern "C" { int sensorbridge_main(int argc, char *argv[]); }
+
+/**
+ * How a sensor event is converted into its uORB topic.
+ */
+enum bridge_kind_e {
+	BRIDGE_VEC3,		/* sensor_event_accel/gyro/mag -> sensor_vec3_uorb_s */
+	BRIDGE_BARO,		/* sensor_event_baro -> sensor_baro_uorb_s */
+	BRIDGE_TEMP,		/* sensor_event_temp -> sensor_scalar_uorb_s */
+	BRIDGE_HUMI,		/* sensor_event_humi -> sensor_scalar_uorb_s */
+	BRIDGE_LIGHT		/* sensor_event_light -> sensor_scalar_uorb_s */
+};
+
+struct bridge_type_s {
+	const char *prefix;		/* Device node prefix, e.g. "accel" */
+	size_t esize;			/* Size of one sensor event */
+	enum bridge_kind_e kind;
+	const struct orb_metadata *meta;
+};
+
+struct bridge_stats_s {
+	uint64_t samples;		/* Samples published */
+	uint32_t wakeups;		/* Reads that returned data */
+	uint32_t maxbatch;		/* Largest number of samples in one read */
+	uint32_t dropped;		/* Samples that failed to publish */
+	uint64_t first;			/* Timestamp of the first sample */
+	uint64_t last;			/* Timestamp of the last sample */
+	uint64_t latsum;		/* Sum of the sample latencies */
+	uint64_t latmax;		/* Largest sample latency */
+};
+
+struct bridge_sensor_s {
+	char name[NAME_MAX];
+	const struct bridge_type_s *type;
+	int fd;
+	int instance;
+	orb_advert_t advert;
+	uint8_t *buffer;		/* SENSORBRIDGE_NEVENTS events */
+	struct bridge_stats_s stats;
+};
+
+static const struct bridge_type_s g_bridge_types[] = {
+	{"accel", sizeof(struct sensor_event_accel), BRIDGE_VEC3,  ORB_ID(sensor_accel_uorb)},
+	{"gyro",  sizeof(struct sensor_event_gyro),  BRIDGE_VEC3,  ORB_ID(sensor_gyro_uorb)},
+	{"mag",   sizeof(struct sensor_event_mag),   BRIDGE_VEC3,  ORB_ID(sensor_mag_uorb)},
+	{"baro",  sizeof(struct sensor_event_baro),  BRIDGE_BARO,  ORB_ID(sensor_baro_uorb)},
+	{"temp",  sizeof(struct sensor_event_temp),  BRIDGE_TEMP,  ORB_ID(sensor_temp_uorb)},
+	{"humi",  sizeof(struct sensor_event_humi),  BRIDGE_HUMI,  ORB_ID(sensor_humi_uorb)},
+	{"light", sizeof(struct sensor_event_light), BRIDGE_LIGHT, ORB_ID(sensor_light_uorb)},
+};
+
+static struct bridge_sensor_s g_sensors[SENSORBRIDGE_MAX];
+static int g_nsensors;
+static volatile bool g_running;
+static volatile bool g_should_exit;
+static unsigned int g_interval = CONFIG_UORB_SENSORBRIDGE_INTERVAL;
+static unsigned int g_latency = CONFIG_UORB_SENSORBRIDGE_LATENCY;
+
+static void usage()
+{
+	printf("Usage: sensorbridge start [-i <interval us>] [-b <batch latency us>]\n");
+	printf("       sensorbridge stop\n");
+	printf("       sensorbridge status\n");
+}
+
+static uint64_t bridge_now()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static const struct bridge_type_s *bridge_find_type(const char *name)
+{
+	for (size_t i = 0; i < sizeof(g_bridge_types) / sizeof(g_bridge_types[0]); i++) {
+		const struct bridge_type_s *type = &g_bridge_types[i];
+
+		if (!strncmp(name, type->prefix, strlen(type->prefix))) {
+			return type;
+		}
+	}
+
+	return nullptr;
+}
+
+/**
+ * Convert one sensor event to its topic and publish it.  The first sample
+ * of a sensor also advertises the topic.
+ */
+static int bridge_publish(struct bridge_sensor_s *sensor, const uint8_t *event, uint64_t *timestamp)
+{
+	union {
+		struct sensor_vec3_uorb_s vec3;
+		struct sensor_baro_uorb_s baro;
+		struct sensor_scalar_uorb_s scalar;
+	} topic;
+
+	switch (sensor->type->kind) {
+	case BRIDGE_VEC3: {
+			/* accel, gyro and mag events share the same layout */
+			const struct sensor_event_accel *e = (const struct sensor_event_accel *)event;
+			topic.vec3.timestamp = e->timestamp;
+			topic.vec3.x = e->x;
+			topic.vec3.y = e->y;
+			topic.vec3.z = e->z;
+			topic.vec3.temp = e->temperature;
+			break;
+		}
+
+	case BRIDGE_BARO: {
+			const struct sensor_event_baro *e = (const struct sensor_event_baro *)event;
+			topic.baro.timestamp = e->timestamp;
+			topic.baro.pressure = e->pressure;
+			topic.baro.temp = e->temperature;
+			break;
+		}
+
+	case BRIDGE_TEMP: {
+			const struct sensor_event_temp *e = (const struct sensor_event_temp *)event;
+			topic.scalar.timestamp = e->timestamp;
+			topic.scalar.value = e->temperature;
+			break;
+		}
+
+	case BRIDGE_HUMI: {
+			const struct sensor_event_humi *e = (const struct sensor_event_humi *)event;
+			topic.scalar.timestamp = e->timestamp;
+			topic.scalar.value = e->humidity;
+			break;
+		}
+
+	case BRIDGE_LIGHT: {
+			const struct sensor_event_light *e = (const struct sensor_event_light *)event;
+			topic.scalar.timestamp = e->timestamp;
+			topic.scalar.value = e->light;
+			break;
+		}
+
+	default:
+		return -EINVAL;
+	}
+
+	/* The timestamp is the first member of every topic structure */
+
+	*timestamp = topic.scalar.timestamp;
+
+	if (sensor->advert == nullptr) {
+		/* Queue a full batch so that subscribers woken once per batch do
+		 * not lose samples.
+		 */
+
+		sensor->advert = orb_advertise_multi_queue(sensor->type->meta, &topic, &sensor->instance,
+				 ORB_PRIO_DEFAULT, SENSORBRIDGE_QUEUE);
+		return sensor->advert != nullptr ? OK : -ENOMEM;
+	}
+
+	return orb_publish(sensor->type->meta, sensor->advert, &topic);
+}
+
+/**
+ * Drain the driver FIFO of one sensor.
+ */
+static void bridge_service(struct bridge_sensor_s *sensor)
+{
+	size_t esize = sensor->type->esize;
+	struct bridge_stats_s *stats = &sensor->stats;
+
+	for (; ; ) {
+		ssize_t nbytes = read(sensor->fd, sensor->buffer, esize * SENSORBRIDGE_NEVENTS);
+
+		if (nbytes < (ssize_t)esize) {
+			break;
+		}
+
+		uint32_t nevents = nbytes / esize;
+		uint64_t now = bridge_now();
+
+		for (uint32_t i = 0; i < nevents; i++) {
+			uint64_t timestamp;
+
+			if (bridge_publish(sensor, sensor->buffer + i * esize, &timestamp) < 0) {
+				stats->dropped++;
+				continue;
+			}
+
+			if (stats->samples++ == 0) {
+				stats->first = timestamp;
+			}
+
+			stats->last = timestamp;
+
+			if (now > timestamp) {
+				uint64_t latency = now - timestamp;
+				stats->latsum += latency;
+
+				if (latency > stats->latmax) {
+					stats->latmax = latency;
+				}
+			}
+		}
+
+		stats->wakeups++;
+
+		if (nevents > stats->maxbatch) {
+			stats->maxbatch = nevents;
+		}
+
+		/* A short read means that the FIFO is empty */
+
+		if (nevents < SENSORBRIDGE_NEVENTS) {
+			break;
+		}
+	}
+}
+
+static int bridge_open(struct bridge_sensor_s *sensor)
+{
+	char devname[PATH_MAX];
+	int ret;
+
+	snprintf(devname, sizeof(devname), SENSORBRIDGE_DEVDIR "/%s", sensor->name);
+	sensor->fd = open(devname, O_RDONLY | O_NONBLOCK);
+
+	if (sensor->fd < 0) {
+		ret = -errno;
+		syslog(LOG_ERR, "sensorbridge: open %s failed: %d\n", devname, ret);
+		return ret;
+	}
+
+	/* Sensors that do not support an ioctl are used with their defaults */
+
+	ret = ioctl(sensor->fd, SNIOC_SET_INTERVAL, &g_interval);
+
+	if (ret < 0 && errno != ENOTTY) {
+		syslog(LOG_WARNING, "sensorbridge: %s interval failed: %d\n", devname, -errno);
+	}
+
+	ret = ioctl(sensor->fd, SNIOC_BATCH, &g_latency);
+
+	if (ret < 0 && errno != ENOTTY) {
+		syslog(LOG_WARNING, "sensorbridge: %s batch failed: %d\n", devname, -errno);
+	}
+
+	ret = ioctl(sensor->fd, SNIOC_ACTIVATE, 1);
+
+	if (ret < 0 && errno != ENOTTY) {
+		ret = -errno;
+		syslog(LOG_ERR, "sensorbridge: %s activate failed: %d\n", devname, ret);
+		close(sensor->fd);
+		sensor->fd = -1;
+		return ret;
+	}
+
+	sensor->buffer = (uint8_t *)malloc(sensor->type->esize * SENSORBRIDGE_NEVENTS);
+
+	if (sensor->buffer == nullptr) {
+		ioctl(sensor->fd, SNIOC_ACTIVATE, 0);
+		close(sensor->fd);
+		sensor->fd = -1;
+		return -ENOMEM;
+	}
+
+	return OK;
+}
+
+static void bridge_close(struct bridge_sensor_s *sensor)
+{
+	if (sensor->fd >= 0) {
+		ioctl(sensor->fd, SNIOC_ACTIVATE, 0);
+		close(sensor->fd);
+		sensor->fd = -1;
+	}
+
+	if (sensor->advert != nullptr) {
+		orb_unadvertise(sensor->advert);
+		sensor->advert = nullptr;
+	}
+
+	free(sensor->buffer);
+	sensor->buffer = nullptr;
+}
+
+/**
+ * Find and open all supported sensors.
+ */
+static int bridge_scan()
+{
+	DIR *dir = opendir(SENSORBRIDGE_DEVDIR);
+
+	if (dir == nullptr) {
+		return -errno;
+	}
+
+	struct dirent *entry;
+	g_nsensors = 0;
+
+	while ((entry = readdir(dir)) != nullptr && g_nsensors < SENSORBRIDGE_MAX) {
+		const struct bridge_type_s *type = bridge_find_type(entry->d_name);
+
+		if (type == nullptr) {
+			continue;
+		}
+
+		struct bridge_sensor_s *sensor = &g_sensors[g_nsensors];
+		memset(sensor, 0, sizeof(*sensor));
+		strncpy(sensor->name, entry->d_name, sizeof(sensor->name) - 1);
+		sensor->type = type;
+
+		if (bridge_open(sensor) == OK) {
+			g_nsensors++;
+		}
+	}
+
+	closedir(dir);
+	return g_nsensors > 0 ? OK : -ENODEV;
+}
+
+static int bridge_daemon(int argc, char *argv[])
+{
+	struct pollfd fds[SENSORBRIDGE_MAX];
+	int ret = bridge_scan();
+
+	if (ret < 0) {
+		syslog(LOG_ERR, "sensorbridge: no sensors found: %d\n", ret);
+		g_running = false;
+		return EXIT_FAILURE;
+	}
+
+	for (int i = 0; i < g_nsensors; i++) {
+		fds[i].fd = g_sensors[i].fd;
+		fds[i].events = POLLIN;
+	}
+
+	syslog(LOG_INFO, "sensorbridge: bridging %d sensors, interval %uus, latency %uus\n",
+	       g_nsensors, g_interval, g_latency);
+
+	/* One loop services all sensors.  With batching the driver only wakes
+	 * us once per batch latency, so each wakeup reads a whole FIFO.
+	 */
+
+	while (!g_should_exit) {
+		ret = poll(fds, g_nsensors, 1000);
+
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			syslog(LOG_ERR, "sensorbridge: poll failed: %d\n", -errno);
+			break;
+		}
+
+		for (int i = 0; i < g_nsensors && ret > 0; i++) {
+			if (fds[i].revents & POLLIN) {
+				bridge_service(&g_sensors[i]);
+				ret--;
+			}
+		}
+	}
+
+	for (int i = 0; i < g_nsensors; i++) {
+		bridge_close(&g_sensors[i]);
+	}
+
+	g_running = false;
+	return EXIT_SUCCESS;
+}
+
+static void bridge_status()
+{
+	printf("%-10s %5s %10s %8s %8s %6s %10s %10s %6s\n",
+	       "SENSOR", "INST", "SAMPLES", "RATE", "BATCH", "MAX", "LAT(us)", "MAX(us)", "DROP");
+
+	for (int i = 0; i < g_nsensors; i++) {
+		const struct bridge_sensor_s *sensor = &g_sensors[i];
+		const struct bridge_stats_s *stats = &sensor->stats;
+		uint64_t span = stats->last - stats->first;
+		uint32_t rate = 0;
+		uint32_t batch = 0;
+		uint64_t latency = 0;
+
+		if (stats->samples > 1 && span > 0) {
+			rate = (uint32_t)((stats->samples - 1) * 1000000ull / span);
+		}
+
+		if (stats->wakeups > 0) {
+			batch = (uint32_t)(stats->samples / stats->wakeups);
+		}
+
+		if (stats->samples > 0) {
+			latency = stats->latsum / stats->samples;
+		}
+
+		printf("%-10s %5d %10" PRIu64 " %6" PRIu32 "Hz %8" PRIu32 " %6" PRIu32
+		       " %10" PRIu64 " %10" PRIu64 " %6" PRIu32 "\n",
+		       sensor->name, sensor->instance, stats->samples, rate, batch,
+		       stats->maxbatch, latency, stats->latmax, stats->dropped);
+	}
+}
+
+int sensorbridge_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return -EINVAL;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+		if (g_running) {
+			printf("sensorbridge already running\n");
+			return OK;
+		}
+
+		int ch;
+		optind = 2;
+
+		while ((ch = getopt(argc, argv, "i:b:")) != EOF) {
+			switch (ch) {
+			case 'i':
+				g_interval = strtoul(optarg, nullptr, 0);
+				break;
+
+			case 'b':
+				g_latency = strtoul(optarg, nullptr, 0);
+				break;
+
+			default:
+				usage();
+				return -EINVAL;
+			}
+		}
+
+		g_should_exit = false;
+		g_running = true;
+
+		int pid = task_create("sensorbridge", CONFIG_UORB_SENSORBRIDGE_PRIORITY,
+				      CONFIG_UORB_SENSORBRIDGE_STACKSIZE, bridge_daemon, nullptr);
+
+		if (pid < 0) {
+			g_running = false;
+			return -errno;
+		}
+
+		return OK;
+	}
+
+	if (!strcmp(argv[1], "stop")) {
+		g_should_exit = true;
+		return OK;
+	}
+
+	if (!strcmp(argv[1], "status")) {
+		if (!g_running) {
+			printf("sensorbridge is not running\n");
+			return OK;
+		}
+
+		bridge_status();
+		return OK;
+	}
+
+	usage();
+	return -EINVAL;
+}
@@ -78,8 +78,16 @@ CDev::~CDev()
 		unregister_driver(_devname);
 	}
 
-	if (_pollset) {
-		delete[](_pollset);
+	while (_pollfree != nullptr) {
+		PollWaiter *waiter = _pollfree;
+		_pollfree = waiter->next;
+		delete waiter;
+	}
+
+	while (_pollwaiters != nullptr) {
+		PollWaiter *waiter = _pollwaiters;
+		_pollwaiters = waiter->next;
+		delete waiter;
 	}
 
 	nxsem_destroy(&_lock);
@@ -288,16 +296,10 @@ CDev::poll(file_t *filep, struct pollfd *fds, bool setup)
 
 	if (setup) {
 		/*
-		 * Save the file pointer in the pollfd for the subclass'
-		 * benefit.
+		 * Handle setup requests.  The file pointer is kept in the
+		 * waiter for the subclass' benefit, see poll_filep().
 		 */
-		fds->priv = (void *)filep;
-		cdevinfo("[%s] CDev::poll: fds->priv = %p\n",_name , filep);
-
-		/*
-		 * Handle setup requests.
-		 */
-		ret = store_poll_waiter(fds);
+		ret = store_poll_waiter(filep, fds);
 
 		if (ret == OK) {
 
@@ -336,10 +338,8 @@ CDev::poll_notify(pollevent_t events)
 	/* lock against poll() as well as other wakeups */
 	ATOMIC_ENTER;
 
-	for (unsigned i = 0; i < _max_pollwaiters; i++) {
-		if (nullptr != _pollset[i]) {
-			poll_notify_one(_pollset[i], events);
-		}
+	for (PollWaiter *waiter = _pollwaiters; waiter != nullptr; waiter = waiter->next) {
+		poll_notify_one(waiter->fds, events);
 	}
 
 	ATOMIC_LEAVE;
@@ -374,45 +374,41 @@ CDev::poll_state(file_t *filep)
 }
 
 int
-CDev::store_poll_waiter(struct pollfd *fds)
+CDev::store_poll_waiter(file_t *filep, struct pollfd *fds)
 {
-	/*
-	 * Look for a free slot.
-	 */
 	cdevinfo("[%s] CDev::store_poll_waiter\n",_name);
 
-	for (unsigned i = 0; i < _max_pollwaiters; i++) {
-		if (nullptr == _pollset[i]) {
+	PollWaiter *waiter = _pollfree;
+
+	if (waiter != nullptr) {
+		_pollfree = waiter->next;
 
-			/* save the pollfd */
-			_pollset[i] = fds;
+	} else {
+		waiter = new PollWaiter;
 
-			return OK;
+		if (waiter == nullptr) {
+			return -ENOMEM;
 		}
 	}
 
-	/* No free slot found. Resize the pollset */
+	waiter->fds = fds;
+	waiter->filep = filep;
+	waiter->prev = nullptr;
+	fds->priv = (void *)waiter;
 
-	if (_max_pollwaiters >= 256 / 2) { //_max_pollwaiters is uint8_t
-		return -ENOMEM;
-	}
+	/* lock against poll_notify(), which may be called from interrupt context */
+	ATOMIC_ENTER;
 
-	const uint8_t new_count = _max_pollwaiters > 0 ? _max_pollwaiters * 2 : 1;
-	struct pollfd **new_pollset = new struct pollfd *[new_count];
+	waiter->next = _pollwaiters;
 
-	if (!new_pollset) {
-		return -ENOMEM;
+	if (_pollwaiters != nullptr) {
+		_pollwaiters->prev = waiter;
 	}
 
-	if (_max_pollwaiters > 0) {
-		memset(new_pollset + _max_pollwaiters, 0, sizeof(struct pollfd *) * (new_count - _max_pollwaiters));
-		memcpy(new_pollset, _pollset, sizeof(struct pollfd *) * _max_pollwaiters);
-		delete[](_pollset);
-	}
+	_pollwaiters = waiter;
+
+	ATOMIC_LEAVE;
 
-	_pollset = new_pollset;
-	_pollset[_max_pollwaiters] = fds;
-	_max_pollwaiters = new_count;
 	return OK;
 }
 
@@ -421,17 +417,34 @@ CDev::remove_poll_waiter(struct pollfd *fds)
 {
 	cdevinfo("[%s] CDev::remove_poll_waiter\n",_name);
 
-	for (unsigned i = 0; i < _max_pollwaiters; i++) {
-		if (fds == _pollset[i]) {
+	PollWaiter *waiter = (PollWaiter *)fds->priv;
 
-			_pollset[i] = nullptr;
-			return OK;
+	if (waiter == nullptr || waiter->fds != fds) {
+		cdeverr("[%s] poll: bad fd state\n",_name);
+		return -EINVAL;
+	}
 
-		}
+	ATOMIC_ENTER;
+
+	if (waiter->prev != nullptr) {
+		waiter->prev->next = waiter->next;
+
+	} else {
+		_pollwaiters = waiter->next;
+	}
+
+	if (waiter->next != nullptr) {
+		waiter->next->prev = waiter->prev;
 	}
 
-	cdeverr("[%s] poll: bad fd state\n",_name);
-	return -EINVAL;
+	ATOMIC_LEAVE;
+
+	waiter->fds = nullptr;
+	waiter->next = _pollfree;
+	_pollfree = waiter;
+	fds->priv = nullptr;
+
+	return OK;
 }
 
 } // namespace device
@@ -175,7 +175,7 @@ uORB::DeviceNode::close(device::file_t *filp)
 
 		if (sd != nullptr) {
 			if (sd->update_interval) {
-				hrt_cancel(&sd->update_interval->update_call);
+				TimerWheel::cancel(&sd->update_interval->update_entry);
 			}
 
 			remove_internal_subscriber();
@@ -326,6 +326,7 @@ uORB::DeviceNode::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 
 			if (arg == 0) {
 				if (sd->update_interval) {
+					TimerWheel::cancel(&sd->update_interval->update_entry);
 					delete (sd->update_interval);
 					sd->update_interval = nullptr;
 				}
@@ -339,7 +340,7 @@ uORB::DeviceNode::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 					sd->update_interval = new UpdateIntervalData();
 
 					if (sd->update_interval) {
-						memset(&sd->update_interval->update_call, 0, sizeof(hrt_call));
+						memset(&sd->update_interval->update_entry, 0, sizeof(TimerWheel::Entry));
 						sd->update_interval->interval = arg;
 						sd->update_interval->last_update = hrt_absolute_time();
 
@@ -503,7 +504,7 @@ uORB::DeviceNode::poll_state(device::file_t *filp)
 void
 uORB::DeviceNode::poll_notify_one(struct pollfd *fds, short events)
 {
-	SubscriberData *sd = filp_to_sd((device::file_t *)fds->priv);
+	SubscriberData *sd = filp_to_sd(poll_filep(fds));
 
 	/*
 	 * If the topic looks updated to the subscriber, go ahead and notify them.
@@ -562,7 +563,7 @@ uORB::DeviceNode::appears_updated(SubscriberData *sd)
 		 * must have collected the update we reported, otherwise
 		 * update_reported would still be true.
 		 */
-		if (!hrt_called(&sd->update_interval->update_call)) {
+		if (sd->update_interval->update_entry.pending()) {
 			break;
 		}
 
@@ -571,10 +572,10 @@ uORB::DeviceNode::appears_updated(SubscriberData *sd)
 		 * until the interval has passed once more by restarting the interval
 		 * timer and thereby re-scheduling a poll notification at that time.
 		 */
-		hrt_call_after(&sd->update_interval->update_call,
-			       sd->update_interval->interval,
-			       &uORB::DeviceNode::update_deferred_trampoline,
-			       (void *)this);
+		TimerWheel::schedule(&sd->update_interval->update_entry,
+				     sd->update_interval->interval,
+				     &uORB::DeviceNode::update_deferred_trampoline,
+				     (void *)this);
 
 		/*
 		 * Remember that we have told the subscriber that there is data.
@@ -604,10 +605,19 @@ uORB::DeviceNode::update_deferred()
 }
 
 void
-uORB::DeviceNode::update_deferred_trampoline(void *arg)
+uORB::DeviceNode::update_deferred_trampoline(void *arg, unsigned batch)
 {
 	uORB::DeviceNode *node = (uORB::DeviceNode *)arg;
 
+	/*
+	 * One poll notification covers every subscriber of the node, so
+	 * only the first of its entries expiring in a batch needs to send it.
+	 */
+	if (node->_deferred_batch == batch) {
+		return;
+	}
+
+	node->_deferred_batch = batch;
 	node->update_deferred();
 }
 
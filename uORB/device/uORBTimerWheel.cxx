@@ -0,0 +1,223 @@
+/****************************************************************************
+ * apps/uORB/device/uORBTimerWheel.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/irq.h>
+
+#include <stdint.h>
+
+#include "uORB/orb/uORBTimerWheel.hpp"
+
+#define TICK_US		((hrt_abstime)CONFIG_UORB_TIMERWHEEL_TICK)
+
+uORB::TimerWheel::Entry *uORB::TimerWheel::_level0[WHEEL_SIZE];
+uORB::TimerWheel::Entry *uORB::TimerWheel::_level1[WHEEL_SIZE];
+uORB::TimerWheel::Entry *uORB::TimerWheel::_overflow;
+uORB::TimerWheel::Entry *uORB::TimerWheel::_fired;
+unsigned uORB::TimerWheel::_count;
+unsigned uORB::TimerWheel::_batch;
+uint32_t uORB::TimerWheel::_tick;
+hrt_abstime uORB::TimerWheel::_next_tick_time;
+bool uORB::TimerWheel::_running;
+struct hrt_call uORB::TimerWheel::_call;
+
+void
+uORB::TimerWheel::insert(Entry *entry)
+{
+	Entry **slot;
+	uint32_t delta = entry->expiry - _tick;
+
+	/*
+	 * A delta of zero only happens while cascading; the level 0 slot of
+	 * the current tick is expired right after the cascade.
+	 */
+	if (delta < WHEEL_SIZE) {
+		slot = &_level0[entry->expiry & WHEEL_MASK];
+
+	} else if (delta < WHEEL_SPAN) {
+		slot = &_level1[(entry->expiry >> WHEEL_BITS) & WHEEL_MASK];
+
+	} else {
+		slot = &_overflow;
+	}
+
+	entry->next = *slot;
+	entry->pprev = slot;
+
+	if (*slot != nullptr) {
+		(*slot)->pprev = &entry->next;
+	}
+
+	*slot = entry;
+}
+
+void
+uORB::TimerWheel::unlink(Entry *entry)
+{
+	*entry->pprev = entry->next;
+
+	if (entry->next != nullptr) {
+		entry->next->pprev = entry->pprev;
+	}
+
+	entry->next = nullptr;
+	entry->pprev = nullptr;
+}
+
+void
+uORB::TimerWheel::cascade(Entry **slot)
+{
+	Entry *entry = *slot;
+	*slot = nullptr;
+
+	while (entry != nullptr) {
+		Entry *next = entry->next;
+		insert(entry);
+		entry = next;
+	}
+}
+
+void
+uORB::TimerWheel::advance()
+{
+	_tick++;
+
+	if ((_tick & (WHEEL_SPAN - 1)) == 0) {
+		cascade(&_overflow);
+	}
+
+	if ((_tick & WHEEL_MASK) == 0) {
+		cascade(&_level1[(_tick >> WHEEL_BITS) & WHEEL_MASK]);
+	}
+
+	Entry *entry = _level0[_tick & WHEEL_MASK];
+	_level0[_tick & WHEEL_MASK] = nullptr;
+
+	while (entry != nullptr) {
+		Entry *next = entry->next;
+
+		if (entry->expiry == _tick) {
+			entry->next = nullptr;
+			entry->pprev = nullptr;
+			entry->fired_next = _fired;
+			_fired = entry;
+			_count--;
+
+		} else {
+			insert(entry);
+		}
+
+		entry = next;
+	}
+}
+
+void
+uORB::TimerWheel::tick(void *arg)
+{
+	irqstate_t state = enter_critical_section();
+	hrt_abstime now = hrt_absolute_time();
+
+	while (_count > 0 && _next_tick_time <= now) {
+		_next_tick_time += TICK_US;
+		advance();
+	}
+
+	if (++_batch == 0) {
+		_batch = 1;
+	}
+
+	/*
+	 * Callouts may reschedule any entry, including those still on the
+	 * fired list, which is why that list has its own link.  An entry
+	 * rescheduled that way is pending again and must not fire until its
+	 * new expiry.
+	 */
+	while (_fired != nullptr) {
+		Entry *entry = _fired;
+		_fired = entry->fired_next;
+		entry->fired_next = nullptr;
+
+		if (entry->pending()) {
+			continue;
+		}
+
+		entry->callout(entry->arg, _batch);
+	}
+
+	if (_count > 0) {
+		hrt_call_after(&_call, _next_tick_time > now ? _next_tick_time - now : 0,
+			       &uORB::TimerWheel::tick, nullptr);
+
+	} else {
+		_running = false;
+	}
+
+	leave_critical_section(state);
+}
+
+void
+uORB::TimerWheel::schedule(Entry *entry, hrt_abstime delay, callout_t callout, void *arg)
+{
+	irqstate_t state = enter_critical_section();
+	hrt_abstime now = hrt_absolute_time();
+
+	if (entry->pending()) {
+		unlink(entry);
+		_count--;
+	}
+
+	/* the wheel is idle, restart it at the current tick */
+	if (!_running) {
+		_tick = (uint32_t)(now / TICK_US);
+		_next_tick_time = (now / TICK_US + 1) * TICK_US;
+	}
+
+	/* never expire early: round up, and at least one tick from now */
+	entry->expiry = (uint32_t)((now + delay + TICK_US - 1) / TICK_US);
+
+	if ((int32_t)(entry->expiry - _tick) < 1) {
+		entry->expiry = _tick + 1;
+	}
+
+	entry->callout = callout;
+	entry->arg = arg;
+	insert(entry);
+	_count++;
+
+	if (!_running) {
+		_running = true;
+		hrt_call_after(&_call, _next_tick_time - now, &uORB::TimerWheel::tick, nullptr);
+	}
+
+	leave_critical_section(state);
+}
+
+void
+uORB::TimerWheel::cancel(Entry *entry)
+{
+	irqstate_t state = enter_critical_section();
+
+	if (entry->pending()) {
+		unlink(entry);
+		_count--;
+	}
+
+	leave_critical_section(state);
+}
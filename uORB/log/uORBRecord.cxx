@@ -0,0 +1,281 @@
+/****************************************************************************
+ * apps/uORB/log/uORBRecord.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBRecord.cxx
+ *
+ * Topic recorder, writes the log format described in uORBLog.hpp.
+ */
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+
+#include "uORB/orb/uORBLog.hpp"
+#include "uORB/orb/uORBTopics.h"
+
+#define RECORD_MAXSUBS		CONFIG_UORB_LOG_MAXTOPICS
+#define RECORD_BUFSIZE		1024
+
+struct record_sub_s {
+	const struct orb_metadata *meta;
+	uint8_t *sample;	/**< log_data_s followed by the sample */
+	uint16_t size;		/**< size of the data record */
+	unsigned count;
+};
+
+static const struct orb_metadata *record_find_topic(const char *name)
+{
+	const struct orb_metadata *const *topics = orb_get_topics();
+
+	for (size_t i = 0; i < orb_topics_count(); i++) {
+		if (!strcmp(topics[i]->o_name, name)) {
+			return topics[i];
+		}
+	}
+
+	return nullptr;
+}
+
+static int record_format(FILE *stream, const struct orb_metadata *meta, uint16_t msg_id, int instance)
+{
+	struct log_format_s format;
+	const char *fields = meta->o_fields ? meta->o_fields : "";
+	size_t len = strlen(fields) + 1;
+	size_t size = UORB_LOG_ALIGN(sizeof(format) + len);
+	size_t pad = size - sizeof(format) - len;
+	static const uint8_t zeros[8] = {};
+
+	if (size > UINT16_MAX) {
+		return -E2BIG;
+	}
+
+	memset(&format, 0, sizeof(format));
+	format.header.size = size;
+	format.header.type = UORB_LOG_FORMAT;
+	format.header.instance = instance;
+	format.header.msg_id = msg_id;
+	format.size_no_padding = meta->o_size_no_padding ? meta->o_size_no_padding : meta->o_size;
+	format.size = meta->o_size;
+	strncpy(format.name, meta->o_name, sizeof(format.name) - 1);
+
+	if (fwrite(&format, sizeof(format), 1, stream) != 1 ||
+	    fwrite(fields, len, 1, stream) != 1 ||
+	    (pad > 0 && fwrite(zeros, pad, 1, stream) != 1)) {
+		return -EIO;
+	}
+
+	return OK;
+}
+
+static void record_usage()
+{
+	printf("Usage: uorb record -o <file> [-d <seconds>] <topic> [<topic> ...]\n");
+}
+
+int uORB::Log::record(int argc, char *argv[])
+{
+	struct record_sub_s subs[RECORD_MAXSUBS];
+	struct pollfd fds[RECORD_MAXSUBS];
+	struct log_file_header_s header;
+	const char *path = nullptr;
+	unsigned duration = 10;
+	unsigned nsubs = 0;
+	unsigned total = 0;
+	FILE *stream = nullptr;
+	int ret = OK;
+	int ch;
+
+	optind = 1;
+
+	while ((ch = getopt(argc, argv, "o:d:")) != EOF) {
+		switch (ch) {
+		case 'o':
+			path = optarg;
+			break;
+
+		case 'd':
+			duration = strtoul(optarg, nullptr, 0);
+			break;
+
+		default:
+			record_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (path == nullptr || optind >= argc) {
+		record_usage();
+		return -EINVAL;
+	}
+
+	/* subscribe to every existing instance of the topics */
+
+	for (int i = optind; i < argc; i++) {
+		const struct orb_metadata *meta = record_find_topic(argv[i]);
+
+		if (meta == nullptr) {
+			printf("uorb record: unknown topic %s\n", argv[i]);
+			ret = -ENOENT;
+			goto out;
+		}
+
+		for (int instance = 0; instance < ORB_MULTI_MAX_INSTANCES; instance++) {
+			if (orb_exists(meta, instance) != OK) {
+				continue;
+			}
+
+			if (nsubs >= RECORD_MAXSUBS) {
+				printf("uorb record: too many topics\n");
+				ret = -E2BIG;
+				goto out;
+			}
+
+			struct record_sub_s *sub = &subs[nsubs];
+			uint16_t size_no_padding = meta->o_size_no_padding ? meta->o_size_no_padding : meta->o_size;
+
+			sub->meta = meta;
+			sub->count = 0;
+			sub->size = UORB_LOG_ALIGN(sizeof(struct log_data_s) + size_no_padding);
+
+			/* room for the whole struct, orb_copy() writes o_size bytes */
+
+			sub->sample = new uint8_t[sizeof(struct log_data_s) + meta->o_size + 8];
+
+			if (sub->sample == nullptr) {
+				ret = -ENOMEM;
+				goto out;
+			}
+
+			memset(sub->sample, 0, sizeof(struct log_data_s) + meta->o_size + 8);
+
+			fds[nsubs].fd = orb_subscribe_multi(meta, instance);
+			fds[nsubs].events = POLLIN;
+
+			if (fds[nsubs].fd < 0) {
+				delete[] sub->sample;
+				ret = -errno;
+				goto out;
+			}
+
+			struct log_data_s *data = (struct log_data_s *)sub->sample;
+			data->header.size = sub->size;
+			data->header.type = UORB_LOG_DATA;
+			data->header.instance = instance;
+			data->header.msg_id = nsubs;
+			nsubs++;
+		}
+	}
+
+	if (nsubs == 0) {
+		printf("uorb record: no topic is advertised\n");
+		ret = -ENOENT;
+		goto out;
+	}
+
+	stream = fopen(path, "w");
+
+	if (stream == nullptr) {
+		printf("uorb record: cannot open %s: %d\n", path, errno);
+		ret = -errno;
+		goto out;
+	}
+
+	setvbuf(stream, nullptr, _IOFBF, RECORD_BUFSIZE);
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, UORB_LOG_MAGIC, sizeof(header.magic));
+	header.version = UORB_LOG_VERSION;
+	header.start_time = hrt_absolute_time();
+
+	if (fwrite(&header, sizeof(header), 1, stream) != 1) {
+		ret = -EIO;
+		goto out;
+	}
+
+	for (unsigned i = 0; i < nsubs; i++) {
+		struct log_data_s *data = (struct log_data_s *)subs[i].sample;
+
+		ret = record_format(stream, subs[i].meta, i, data->header.instance);
+
+		if (ret != OK) {
+			goto out;
+		}
+	}
+
+	printf("uorb record: %u topic instances to %s for %u s\n", nsubs, path, duration);
+
+	{
+		hrt_abstime end = header.start_time + (hrt_abstime)duration * 1000000;
+
+		while (hrt_absolute_time() < end) {
+			if (poll(fds, nsubs, 100) <= 0) {
+				continue;
+			}
+
+			for (unsigned i = 0; i < nsubs; i++) {
+				if (!(fds[i].revents & POLLIN)) {
+					continue;
+				}
+
+				struct record_sub_s *sub = &subs[i];
+				struct log_data_s *data = (struct log_data_s *)sub->sample;
+
+				if (orb_copy(sub->meta, fds[i].fd, sub->sample + sizeof(*data)) != OK) {
+					continue;
+				}
+
+				data->time = hrt_absolute_time();
+
+				if (fwrite(sub->sample, sub->size, 1, stream) != 1) {
+					ret = -EIO;
+					goto out;
+				}
+
+				sub->count++;
+				total++;
+			}
+		}
+	}
+
+	for (unsigned i = 0; i < nsubs; i++) {
+		printf("  %-32s %u samples\n", subs[i].meta->o_name, subs[i].count);
+	}
+
+	printf("uorb record: %u samples\n", total);
+
+out:
+
+	if (stream != nullptr && fclose(stream) != 0 && ret == OK) {
+		ret = -EIO;
+	}
+
+	for (unsigned i = 0; i < nsubs; i++) {
+		orb_unsubscribe(fds[i].fd);
+		delete[] subs[i].sample;
+	}
+
+	return ret;
+}
@@ -0,0 +1,397 @@
+/****************************************************************************
+ * apps/uORB/log/uORBReplay.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBReplay.cxx
+ *
+ * Topic log replay.
+ *
+ * The log is mapped to memory and walked in place; each sample is copied
+ * once, into the publication buffer of its topic, where the timestamp is
+ * rewritten before it is published.  Topics are advertised again through
+ * Manager::orb_advertise_multi() when their first sample is replayed.
+ */
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "uORB/orb/uORBLog.hpp"
+#include "uORB/orb/uORBManager.hpp"
+#include "uORB/orb/uORBTopics.h"
+
+#define REPLAY_MAXTOPICS	CONFIG_UORB_LOG_MAXTOPICS
+
+/* Field list prefix of topics whose first field is the sample timestamp */
+
+#define REPLAY_TIMESTAMP	"uint64_t timestamp;"
+
+struct replay_topic_s {
+	const struct orb_metadata *meta;	/**< null if the topic is not replayed */
+	orb_advert_t handle;
+	uint8_t *buffer;			/**< o_size bytes, published from */
+	uint16_t size_no_padding;
+	bool timestamp;				/**< true: rewrite the first field */
+	unsigned count;
+};
+
+/**
+ * The log being replayed.  It is mapped to memory if the file system
+ * supports that, and read one record at a time otherwise.
+ */
+struct replay_file_s {
+	int fd;
+	size_t size;
+	const uint8_t *map;			/**< the whole log or MAP_FAILED */
+	uint8_t *buffer;			/**< current record if not mapped */
+	size_t buflen;
+};
+
+static void replay_usage()
+{
+	printf("Usage: uorb replay [-s <speed>] [-k] <file>\n");
+	printf("  -s <speed>  1 replays in real time (default), 2 twice as fast,\n");
+	printf("              0 as fast as possible\n");
+	printf("  -k          keep the recorded sample timestamps\n");
+}
+
+static const struct orb_metadata *replay_find_topic(const char *name)
+{
+	const struct orb_metadata *const *topics = orb_get_topics();
+
+	for (size_t i = 0; i < orb_topics_count(); i++) {
+		if (!strcmp(topics[i]->o_name, name)) {
+			return topics[i];
+		}
+	}
+
+	return nullptr;
+}
+
+/**
+ * Return the record at offset, which follows the previous record.  A
+ * record that does not fit in the log or is misaligned is an error.
+ */
+static int replay_record(struct replay_file_s *file, size_t offset, const struct log_record_s **record)
+{
+	struct log_record_s header;
+
+	if (file->map != (const uint8_t *)MAP_FAILED) {
+		memcpy(&header, file->map + offset, sizeof(header));
+
+	} else if (read(file->fd, &header, sizeof(header)) != sizeof(header)) {
+		return -EIO;
+	}
+
+	if (header.size < sizeof(header) || (header.size & 7) != 0 || offset + header.size > file->size) {
+		return -EINVAL;
+	}
+
+	if (file->map != (const uint8_t *)MAP_FAILED) {
+		*record = (const struct log_record_s *)(file->map + offset);
+		return OK;
+	}
+
+	if (header.size > file->buflen) {
+		uint8_t *buffer = (uint8_t *)realloc(file->buffer, header.size);
+
+		if (buffer == nullptr) {
+			return -ENOMEM;
+		}
+
+		file->buffer = buffer;
+		file->buflen = header.size;
+	}
+
+	size_t remaining = header.size - sizeof(header);
+
+	memcpy(file->buffer, &header, sizeof(header));
+
+	if (read(file->fd, file->buffer + sizeof(header), remaining) != (ssize_t)remaining) {
+		return -EIO;
+	}
+
+	*record = (const struct log_record_s *)file->buffer;
+	return OK;
+}
+
+/**
+ * Match a format record with a topic of this build.  The topic is
+ * skipped, with a warning, unless its layout is unchanged.
+ */
+static int replay_format(struct replay_topic_s *topics, const struct log_format_s *format)
+{
+	char name[ORB_MAXNAME + 1];
+	const char *fields = (const char *)(format + 1);
+	size_t maxlen = format->header.size - sizeof(*format);
+
+	if (format->header.msg_id >= REPLAY_MAXTOPICS || format->header.size <= sizeof(*format) ||
+	    memchr(fields, '\0', maxlen) == nullptr) {
+		return -EINVAL;
+	}
+
+	memcpy(name, format->name, ORB_MAXNAME);
+	name[ORB_MAXNAME] = '\0';
+
+	struct replay_topic_s *topic = &topics[format->header.msg_id];
+	const struct orb_metadata *meta = replay_find_topic(name);
+
+	if (topic->meta != nullptr) {
+		return -EINVAL;
+	}
+
+	if (meta == nullptr) {
+		printf("uorb replay: skipping unknown topic %s\n", name);
+		return OK;
+	}
+
+	uint16_t size_no_padding = meta->o_size_no_padding ? meta->o_size_no_padding : meta->o_size;
+	const char *o_fields = meta->o_fields ? meta->o_fields : "";
+
+	if (format->size != meta->o_size || format->size_no_padding != size_no_padding ||
+	    strcmp(fields, o_fields) != 0) {
+		printf("uorb replay: skipping %s, its layout has changed\n", name);
+		return OK;
+	}
+
+	topic->buffer = new uint8_t[meta->o_size];
+
+	if (topic->buffer == nullptr) {
+		return -ENOMEM;
+	}
+
+	memset(topic->buffer, 0, meta->o_size);
+	topic->meta = meta;
+	topic->handle = nullptr;
+	topic->size_no_padding = size_no_padding;
+	topic->timestamp = !strncmp(o_fields, REPLAY_TIMESTAMP, strlen(REPLAY_TIMESTAMP));
+	topic->count = 0;
+	return OK;
+}
+
+int uORB::Log::replay(int argc, char *argv[])
+{
+	struct replay_topic_s topics[REPLAY_MAXTOPICS];
+	struct log_file_header_s header;
+	struct replay_file_s file;
+	bool keep_timestamps = false;
+	float speed = 1.0f;
+	unsigned total = 0;
+	struct stat st;
+	size_t offset;
+	int ret = OK;
+	int ch;
+
+	optind = 1;
+
+	while ((ch = getopt(argc, argv, "s:k")) != EOF) {
+		switch (ch) {
+		case 's':
+			speed = strtof(optarg, nullptr);
+			break;
+
+		case 'k':
+			keep_timestamps = true;
+			break;
+
+		default:
+			replay_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (optind != argc - 1 || speed < 0.0f) {
+		replay_usage();
+		return -EINVAL;
+	}
+
+	memset(topics, 0, sizeof(topics));
+	memset(&file, 0, sizeof(file));
+
+	file.fd = open(argv[optind], O_RDONLY);
+
+	if (file.fd < 0) {
+		printf("uorb replay: cannot open %s: %d\n", argv[optind], errno);
+		return -errno;
+	}
+
+	if (fstat(file.fd, &st) < 0 || (size_t)st.st_size < sizeof(header)) {
+		close(file.fd);
+		printf("uorb replay: %s is not a topic log\n", argv[optind]);
+		return -EINVAL;
+	}
+
+	/*
+	 * mmap() only works in place on XIP file systems, or by copying the
+	 * whole log to RAM with CONFIG_FS_RAMMAP.  Otherwise read the log
+	 * sequentially.
+	 */
+	file.size = st.st_size;
+	file.map = (const uint8_t *)mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+
+	if (file.map != (const uint8_t *)MAP_FAILED) {
+		memcpy(&header, file.map, sizeof(header));
+
+	} else if (read(file.fd, &header, sizeof(header)) != sizeof(header)) {
+		printf("uorb replay: cannot read %s: %d\n", argv[optind], errno);
+		ret = -EIO;
+		goto out;
+	}
+
+	if (memcmp(header.magic, UORB_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+	    header.version != UORB_LOG_VERSION) {
+		printf("uorb replay: %s is not a topic log\n", argv[optind]);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	{
+		const hrt_abstime start = hrt_absolute_time();
+		hrt_abstime first = 0;
+		bool started = false;
+
+		for (offset = sizeof(header); offset + sizeof(struct log_record_s) <= file.size; ) {
+			const struct log_record_s *record;
+
+			ret = replay_record(&file, offset, &record);
+
+			if (ret != OK) {
+				printf("uorb replay: bad record at offset %zu\n", offset);
+				break;
+			}
+
+			offset += record->size;
+
+			if (record->type == UORB_LOG_FORMAT) {
+				if (record->size < sizeof(struct log_format_s)) {
+					ret = -EINVAL;
+					break;
+				}
+
+				ret = replay_format(topics, (const struct log_format_s *)record);
+
+				if (ret != OK) {
+					printf("uorb replay: bad format record\n");
+					break;
+				}
+
+				continue;
+			}
+
+			if (record->type != UORB_LOG_DATA || record->msg_id >= REPLAY_MAXTOPICS) {
+				continue;
+			}
+
+			const struct log_data_s *data = (const struct log_data_s *)record;
+			struct replay_topic_s *topic = &topics[record->msg_id];
+
+			if (topic->meta == nullptr || record->size < sizeof(*data) + topic->size_no_padding) {
+				continue;
+			}
+
+			if (!started) {
+				first = data->time;
+				started = true;
+			}
+
+			/* pace the replay on the recording time of the samples */
+
+			hrt_abstime elapsed = data->time - first;
+
+			if (speed > 0.0f) {
+				hrt_abstime due = start + (hrt_abstime)(elapsed / speed);
+				hrt_abstime now = hrt_absolute_time();
+
+				if (due > now) {
+					usleep(due - now);
+				}
+			}
+
+			memcpy(topic->buffer, data + 1, topic->size_no_padding);
+
+			/* move the sample to the time line of the replay */
+
+			if (topic->timestamp && !keep_timestamps) {
+				uint64_t timestamp;
+
+				memcpy(&timestamp, topic->buffer, sizeof(timestamp));
+
+				if (timestamp != 0) {
+					timestamp = timestamp - first + start;
+					memcpy(topic->buffer, &timestamp, sizeof(timestamp));
+				}
+			}
+
+			if (topic->handle == nullptr) {
+				int instance;
+
+				topic->handle = uORB::Manager::get_instance()->orb_advertise_multi(topic->meta,
+						topic->buffer, &instance, ORB_PRIO_DEFAULT);
+
+				if (topic->handle == nullptr) {
+					printf("uorb replay: cannot advertise %s\n", topic->meta->o_name);
+					topic->meta = nullptr;
+					continue;
+				}
+
+			} else {
+				uORB::Manager::get_instance()->orb_publish(topic->meta, topic->handle, topic->buffer);
+			}
+
+			topic->count++;
+			total++;
+		}
+
+		hrt_abstime duration = hrt_absolute_time() - start;
+
+		for (unsigned i = 0; i < REPLAY_MAXTOPICS; i++) {
+			if (topics[i].count > 0) {
+				printf("  %-32s %u samples\n", topics[i].meta->o_name, topics[i].count);
+			}
+		}
+
+		printf("uorb replay: %u samples in %llu ms\n", total, (unsigned long long)(duration / 1000));
+	}
+
+out:
+
+	for (unsigned i = 0; i < REPLAY_MAXTOPICS; i++) {
+		if (topics[i].handle != nullptr) {
+			uORB::Manager::get_instance()->orb_unadvertise(topics[i].handle);
+		}
+
+		delete[] topics[i].buffer;
+	}
+
+	if (file.map != (const uint8_t *)MAP_FAILED) {
+		munmap((void *)file.map, file.size);
+	}
+
+	free(file.buffer);
+	close(file.fd);
+	return ret;
+}
@@ -0,0 +1,241 @@
+/****************************************************************************
+ * apps/uORB/test/uorbtest.cxx
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uorbtest.cxx
+ *
+ * uORB tests and benchmarks.
+ *
+ * "uorbtest poll" blocks a number of threads in poll() on one topic and
+ * measures the cost of publishing to them, of setting up and tearing down
+ * a poll while they wait, and counts the wakeups they receive.
+ */
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+
+#include "uORB/orb/uORB.h"
+
+#define UORBTEST_MAXWAITERS	CONFIG_UORB_TEST_MAXWAITERS
+
+extern "C" { int uorbtest_main(int argc, char *argv[]); }
+
+struct uorbtest_s {
+	uint64_t timestamp;
+	uint32_t seq;
+	uint8_t _padding0[4];
+};
+
+ORB_DECLARE(uorbtest_poll);
+ORB_DEFINE(uorbtest_poll, struct uorbtest_s, 12, "uint64_t timestamp;uint32_t seq;uint8_t[4] _padding0;");
+
+static volatile bool g_should_exit;
+static volatile unsigned g_wakeups[UORBTEST_MAXWAITERS];
+
+static void usage()
+{
+	printf("Usage: uorbtest poll [-w <waiters>] [-n <publishes>] [-d <delay us>]\n");
+}
+
+static uint64_t test_now()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static void *test_waiter(void *arg)
+{
+	unsigned index = (unsigned)(uintptr_t)arg;
+	struct uorbtest_s msg;
+	struct pollfd fds;
+
+	fds.fd = orb_subscribe(ORB_ID(uorbtest_poll));
+	fds.events = POLLIN;
+
+	if (fds.fd < 0) {
+		return nullptr;
+	}
+
+	while (!g_should_exit) {
+		if (poll(&fds, 1, 100) > 0 && (fds.revents & POLLIN)) {
+			orb_copy(ORB_ID(uorbtest_poll), fds.fd, &msg);
+			g_wakeups[index]++;
+		}
+	}
+
+	orb_unsubscribe(fds.fd);
+	return nullptr;
+}
+
+static int test_poll(unsigned nwaiters, unsigned count, unsigned delay)
+{
+	pthread_t threads[UORBTEST_MAXWAITERS];
+	struct uorbtest_s msg;
+	unsigned started = 0;
+	int ret = OK;
+
+	memset(&msg, 0, sizeof(msg));
+
+	orb_advert_t handle = orb_advertise(ORB_ID(uorbtest_poll), &msg);
+
+	if (handle == nullptr) {
+		printf("uorbtest: advertise failed: %d\n", errno);
+		return -errno;
+	}
+
+	g_should_exit = false;
+	memset((void *)g_wakeups, 0, sizeof(g_wakeups));
+
+	for (; started < nwaiters; started++) {
+		if (pthread_create(&threads[started], nullptr, test_waiter,
+				   (void *)(uintptr_t)started) != 0) {
+			printf("uorbtest: only %u waiters started\n", started);
+			break;
+		}
+	}
+
+	/* let the waiters block in poll() */
+
+	usleep(200000);
+
+	uint64_t total = 0;
+	uint64_t worst = 0;
+
+	for (unsigned i = 0; i < count; i++) {
+		msg.timestamp = test_now();
+		msg.seq = i;
+
+		uint64_t start = test_now();
+		orb_publish(ORB_ID(uorbtest_poll), handle, &msg);
+		uint64_t elapsed = test_now() - start;
+
+		total += elapsed;
+
+		if (elapsed > worst) {
+			worst = elapsed;
+		}
+
+		usleep(delay);
+	}
+
+	/* poll setup and teardown with all waiters registered */
+
+	struct pollfd fds;
+	uint64_t poll_total = 0;
+
+	fds.fd = orb_subscribe(ORB_ID(uorbtest_poll));
+	fds.events = POLLIN;
+
+	if (fds.fd >= 0) {
+		orb_copy(ORB_ID(uorbtest_poll), fds.fd, &msg);
+
+		for (unsigned i = 0; i < count; i++) {
+			uint64_t start = test_now();
+			poll(&fds, 1, 0);
+			poll_total += test_now() - start;
+		}
+
+		orb_unsubscribe(fds.fd);
+
+	} else {
+		ret = -errno;
+	}
+
+	g_should_exit = true;
+
+	for (unsigned i = 0; i < started; i++) {
+		pthread_join(threads[i], nullptr);
+	}
+
+	orb_unadvertise(handle);
+
+	unsigned wakeups = 0;
+
+	for (unsigned i = 0; i < started; i++) {
+		wakeups += g_wakeups[i];
+	}
+
+	printf("waiters:       %u\n", started);
+	printf("publishes:     %u\n", count);
+	printf("publish:       %" PRIu64 " us avg, %" PRIu64 " us max\n",
+	       count ? total / count : 0, worst);
+	printf("poll:          %" PRIu64 " us avg\n", count ? poll_total / count : 0);
+	printf("wakeups:       %u of %u\n", wakeups, started * count);
+
+	return ret;
+}
+
+int uorbtest_main(int argc, char *argv[])
+{
+	unsigned nwaiters = 16;
+	unsigned count = 1000;
+	unsigned delay = 1000;
+	int ch;
+
+	if (argc < 2) {
+		usage();
+		return -EINVAL;
+	}
+
+	if (!strcmp(argv[1], "poll")) {
+		optind = 2;
+
+		while ((ch = getopt(argc, argv, "w:n:d:")) != EOF) {
+			switch (ch) {
+			case 'w':
+				nwaiters = strtoul(optarg, nullptr, 0);
+				break;
+
+			case 'n':
+				count = strtoul(optarg, nullptr, 0);
+				break;
+
+			case 'd':
+				delay = strtoul(optarg, nullptr, 0);
+				break;
+
+			default:
+				usage();
+				return -EINVAL;
+			}
+		}
+
+		if (nwaiters > UORBTEST_MAXWAITERS) {
+			printf("uorbtest: at most %d waiters\n", UORBTEST_MAXWAITERS);
+			return -EINVAL;
+		}
+
+		return test_poll(nwaiters, count, delay);
+	}
+
+	usage();
+	return -EINVAL;
+}
@@ -0,0 +1,377 @@
+#!/usr/bin/env python3
+############################################################################
+# apps/uORB/tools/msggen.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+'''Generate the uORB topic headers and metadata from .msg files.
+
+Each <name>.msg file describes one message struct, struct <name>_s, with
+one field or constant per line:
+
+    # comment
+    # TOPICS topic_a topic_b      topics using this struct (default: <name>)
+    uint64 timestamp              # trailing comments are allowed
+    float32[3] xyz
+    uint8 MODE_IDLE = 0           constant
+
+Fields are reordered by decreasing alignment so that the struct has no
+internal padding, and explicit padding is added at the end.  For every
+message a header <name>.h is written to the include directory, holding the
+struct, the constants, ORB_DECLARE() of each topic and pack/unpack routines
+that copy the message to and from a buffer without the padding.  A single
+source file holds ORB_DEFINE() of every topic with its unpadded size and
+field list, and orb_get_topics() / orb_topics_count().
+'''
+
+import argparse
+import os
+import re
+import sys
+
+# .msg type: (C type, size)
+
+TYPES = {
+    'bool':    ('bool', 1),
+    'char':    ('char', 1),
+    'int8':    ('int8_t', 1),
+    'uint8':   ('uint8_t', 1),
+    'int16':   ('int16_t', 2),
+    'uint16':  ('uint16_t', 2),
+    'int32':   ('int32_t', 4),
+    'uint32':  ('uint32_t', 4),
+    'int64':   ('int64_t', 8),
+    'uint64':  ('uint64_t', 8),
+    'float32': ('float', 4),
+    'float64': ('double', 8),
+}
+
+NAME_RE = re.compile(r'^[A-Za-z][A-Za-z0-9_]*$')
+FIELD_RE = re.compile(r'^(\w+)(?:\[(\d+)\])?\s+(\w+)$')
+CONST_RE = re.compile(r'^(\w+)\s+(\w+)\s*=\s*(\S+)$')
+
+
+class MsgError(Exception):
+    pass
+
+
+class Field:
+    def __init__(self, msgtype, count, name):
+        self.ctype, self.align = TYPES[msgtype]
+        self.count = count
+        self.name = name
+
+    @property
+    def size(self):
+        return self.align * (self.count or 1)
+
+    def declaration(self):
+        if self.count:
+            return '%s %s[%d];' % (self.ctype, self.name, self.count)
+        return '%s %s;' % (self.ctype, self.name)
+
+    def description(self):
+        if self.count:
+            return '%s[%d] %s' % (self.ctype, self.count, self.name)
+        return '%s %s' % (self.ctype, self.name)
+
+
+class Message:
+    def __init__(self, path):
+        self.path = path
+        self.name = os.path.splitext(os.path.basename(path))[0]
+        self.topics = []
+        self.fields = []
+        self.constants = []
+
+        if not NAME_RE.match(self.name):
+            raise MsgError('%s: invalid message name' % path)
+
+        with open(path) as f:
+            for lineno, line in enumerate(f, 1):
+                self.parse_line(line, lineno)
+
+        if not self.fields:
+            raise MsgError('%s: no fields' % path)
+
+        if not self.topics:
+            self.topics = [self.name]
+
+        self.layout()
+
+    def error(self, lineno, text):
+        return MsgError('%s:%d: %s' % (self.path, lineno, text))
+
+    def parse_line(self, line, lineno):
+        line = line.strip()
+
+        if line.startswith('#'):
+            words = line[1:].split()
+            if words and words[0] == 'TOPICS':
+                for topic in words[1:]:
+                    if not NAME_RE.match(topic):
+                        raise self.error(lineno, 'invalid topic %s' % topic)
+                    self.topics.append(topic)
+            return
+
+        line = line.split('#', 1)[0].strip()
+        if not line:
+            return
+
+        m = CONST_RE.match(line)
+        if m:
+            msgtype, name, value = m.groups()
+            if msgtype not in TYPES or msgtype in ('bool', 'char') or \
+               msgtype.startswith('float'):
+                raise self.error(lineno, 'constants must be integers')
+            self.check_name(name, lineno)
+            try:
+                int(value, 0)
+            except ValueError:
+                raise self.error(lineno, 'invalid value %s' % value)
+            self.constants.append((TYPES[msgtype][0], name, value))
+            return
+
+        m = FIELD_RE.match(line)
+        if not m:
+            raise self.error(lineno, 'syntax error')
+
+        msgtype, count, name = m.groups()
+        if msgtype not in TYPES:
+            raise self.error(lineno, 'unknown type %s' % msgtype)
+
+        count = int(count) if count is not None else 0
+        if count == 0 and m.group(2) is not None:
+            raise self.error(lineno, 'empty array %s' % name)
+
+        self.check_name(name, lineno)
+        self.fields.append(Field(msgtype, count, name))
+
+    def check_name(self, name, lineno):
+        if not NAME_RE.match(name):
+            raise self.error(lineno, 'invalid name %s' % name)
+        if name in [f.name for f in self.fields] or \
+           name in [c[1] for c in self.constants]:
+            raise self.error(lineno, 'duplicate name %s' % name)
+
+    def layout(self):
+        # Largest alignment first leaves no gaps between the fields.  The
+        # sort is stable, so fields of one size keep the .msg order.
+
+        self.fields.sort(key=lambda f: -f.align)
+
+        self.size_no_padding = sum(f.size for f in self.fields)
+        align = self.fields[0].align
+        self.size = (self.size_no_padding + align - 1) // align * align
+
+        self.padding = self.size - self.size_no_padding
+        if self.padding:
+            pad = Field('uint8', self.padding, '_padding0')
+            self.padded_fields = self.fields + [pad]
+        else:
+            self.padded_fields = self.fields
+
+    @property
+    def struct(self):
+        return '%s_s' % self.name
+
+    @property
+    def macro(self):
+        return self.name.upper()
+
+    def fields_description(self):
+        return ';'.join(f.description() for f in self.padded_fields) + ';'
+
+
+def generated_banner(out, source):
+    out.append('/* Automatically generated from %s by msggen.py.  Do not edit. */'
+               % source)
+    out.append('')
+
+
+def write_if_changed(path, lines):
+    text = '\n'.join(lines) + '\n'
+
+    try:
+        with open(path) as f:
+            if f.read() == text:
+                return
+    except IOError:
+        pass
+
+    with open(path, 'w') as f:
+        f.write(text)
+
+
+def generate_header(msg):
+    out = []
+    generated_banner(out, os.path.basename(msg.path))
+
+    out.append('#pragma once')
+    out.append('')
+    out.append('#include <stdint.h>')
+    out.append('#include <stddef.h>')
+    out.append('#ifdef __cplusplus')
+    out.append('#include <cstring>')
+    out.append('#else')
+    out.append('#include <stdbool.h>')
+    out.append('#include <string.h>')
+    out.append('#endif')
+    out.append('')
+    out.append('#include "uORB/orb/uORB.h"')
+    out.append('')
+
+    if msg.constants:
+        out.append('#ifndef __cplusplus')
+        for ctype, name, value in msg.constants:
+            out.append('#define %s %s' % (name, value))
+        out.append('#endif')
+        out.append('')
+
+    out.append('/* Size of the message without the padding at the end */')
+    out.append('')
+    out.append('#define %s_PACKED_SIZE %d' % (msg.macro, msg.size_no_padding))
+    out.append('')
+
+    out.append('#ifdef __cplusplus')
+    out.append('struct __attribute__ ((visibility ("default"))) %s {' % msg.struct)
+    out.append('#else')
+    out.append('struct %s {' % msg.struct)
+    out.append('#endif')
+    for f in msg.padded_fields:
+        out.append('\t%s' % f.declaration())
+    if msg.constants:
+        out.append('#ifdef __cplusplus')
+        for ctype, name, value in msg.constants:
+            out.append('\tstatic constexpr %s %s = %s;' % (ctype, name, value))
+        out.append('#endif')
+    out.append('};')
+    out.append('')
+
+    # The fields are contiguous, so the packed message is the struct
+    # without its trailing padding.
+
+    out.append('/* Copy a message to buf, %d bytes, without padding */' %
+               msg.size_no_padding)
+    out.append('')
+    out.append('static inline size_t %s_pack(const struct %s *msg, uint8_t *buf)'
+               % (msg.name, msg.struct))
+    out.append('{')
+    out.append('\tmemcpy(buf, msg, %s_PACKED_SIZE);' % msg.macro)
+    out.append('\treturn %s_PACKED_SIZE;' % msg.macro)
+    out.append('}')
+    out.append('')
+    out.append('/* Copy a message packed by %s_pack() from buf */' % msg.name)
+    out.append('')
+    out.append('static inline size_t %s_unpack(struct %s *msg, const uint8_t *buf)'
+               % (msg.name, msg.struct))
+    out.append('{')
+    out.append('\tmemcpy(msg, buf, %s_PACKED_SIZE);' % msg.macro)
+    if msg.padding:
+        out.append('\tmemset(msg->_padding0, 0, sizeof(msg->_padding0));')
+    out.append('\treturn %s_PACKED_SIZE;' % msg.macro)
+    out.append('}')
+    out.append('')
+
+    if len(msg.topics) > 1:
+        out.append('/* register these as object request broker structures */')
+    else:
+        out.append('/* register this as object request broker structure */')
+    for topic in msg.topics:
+        out.append('ORB_DECLARE(%s);' % topic)
+
+    return out
+
+
+def generate_source(msgs):
+    out = []
+    generated_banner(out, 'the uORB message definitions')
+
+    out.append('#include <stddef.h>')
+    out.append('')
+    out.append('#include "uORB/device/drv_orb_dev.h"')
+    out.append('#include "uORB/orb/uORBTopics.h"')
+    out.append('')
+
+    for msg in msgs:
+        out.append('#include "uORB/topics/%s.h"' % msg.name)
+    out.append('')
+
+    for msg in msgs:
+        out.append('static_assert(sizeof(struct %s) == %d, "%s layout");' %
+                   (msg.struct, msg.size, msg.name))
+        for topic in msg.topics:
+            out.append('ORB_DEFINE(%s, struct %s, %s_PACKED_SIZE,' %
+                       (topic, msg.struct, msg.macro))
+            out.append('\t   "%s");' % msg.fields_description())
+        out.append('')
+
+    out.append('static const struct orb_metadata *const g_orb_topics[] = {')
+    for msg in msgs:
+        for topic in msg.topics:
+            out.append('\tORB_ID(%s),' % topic)
+    out.append('};')
+    out.append('')
+    out.append('size_t orb_topics_count()')
+    out.append('{')
+    out.append('\treturn sizeof(g_orb_topics) / sizeof(g_orb_topics[0]);')
+    out.append('}')
+    out.append('')
+    out.append('const struct orb_metadata *const *orb_get_topics()')
+    out.append('{')
+    out.append('\treturn g_orb_topics;')
+    out.append('}')
+
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-I', dest='incdir', required=True,
+                        help='directory receiving the topic headers')
+    parser.add_argument('-o', dest='source', required=True,
+                        help='source file receiving the topic metadata')
+    parser.add_argument('msgs', nargs='+', help='.msg files')
+    args = parser.parse_args()
+
+    try:
+        msgs = sorted((Message(path) for path in args.msgs),
+                      key=lambda m: m.name)
+    except (MsgError, IOError) as e:
+        sys.stderr.write('msggen.py: %s\n' % e)
+        return 1
+
+    topics = [t for m in msgs for t in m.topics]
+    for topic in set(topics):
+        if topics.count(topic) > 1:
+            sys.stderr.write('msggen.py: topic %s defined twice\n' % topic)
+            return 1
+
+    if not os.path.isdir(args.incdir):
+        os.makedirs(args.incdir)
+
+    for msg in msgs:
+        write_if_changed(os.path.join(args.incdir, msg.name + '.h'),
+                         generate_header(msg))
+
+    write_if_changed(args.source, generate_source(msgs))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
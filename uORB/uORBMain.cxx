@@ -48,6 +48,7 @@
 #include "uORB/orb/uORBDevices.hpp"
 #include "uORB/orb/uORBManager.hpp"
 #include "uORB/orb/uORBCommon.hpp"
+#include "uORB/orb/uORBLog.hpp"
 
 extern "C" { int uorb_main(int argc, char *argv[]); }
 
@@ -60,6 +61,10 @@ static void usage()
 	printf("Monitor topic publication rates\n");
 	printf("print all instead of only currently publishing topics\n");
 	printf("<filter1> [<filter2>] topic(s) to match (implies -a)\n");
+#ifdef CONFIG_UORB_LOG
+	printf("record -o <file> [-d <seconds>] <topic> [<topic> ...]\n");
+	printf("replay [-s <speed>] [-k] <file>\n");
+#endif
 }
 
 int
@@ -121,6 +126,23 @@ uorb_main(int argc, char *argv[])
 		return OK;
 	}
 
+#ifdef CONFIG_UORB_LOG
+
+	if (!strcmp(argv[1], "record") || !strcmp(argv[1], "replay")) {
+		if (g_dev == nullptr) {
+			syslog(LOG_INFO,"uorb is not running\n");
+			return -ENODEV;
+		}
+
+		if (!strcmp(argv[1], "record")) {
+			return uORB::Log::record(argc - 1, argv + 1);
+		}
+
+		return uORB::Log::replay(argc - 1, argv + 1);
+	}
+
+#endif
+
 	usage();
 	return -EINVAL;
 }
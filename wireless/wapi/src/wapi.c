@@ -670,7 +670,7 @@ static int wapi_scan_results_cmd(int sock, int argc, FAR char **argv)
 {
   int sleepdur = 200 * 1000;
   int sleeptries = 25;
-  struct wapi_list_s list;
+  struct wapi_scan_results_s results;
   FAR struct wapi_scan_info_s *info;
   int ret;
 
@@ -696,20 +696,21 @@ static int wapi_scan_results_cmd(int sock, int argc, FAR char **argv)
       return ret;
     }
 
-  /* Collect results */
+  /* Collect results, one per BSSID, strongest first */
 
-  bzero(&list, sizeof(struct wapi_list_s));
-  ret = wapi_scan_coll(sock, argv[0], &list);
+  ret = wapi_scan_coll_flat(sock, argv[0],
+                            WAPI_SCAN_DEDUPE | WAPI_SCAN_SORT_RSSI,
+                            &results);
   if (ret < 0)
     {
-      WAPI_ERROR("ERROR: wapi_scan_coll() failed: %d\n", ret);
+      WAPI_ERROR("ERROR: wapi_scan_coll_flat() failed: %d\n", ret);
       return ret;
     }
 
   /* Print found aps */
 
   printf("bssid / frequency / signal level / ssid\n");
-  for (info = list.head.scan; info; info = info->next)
+  for (info = results.aps; info; info = info->next)
     {
       printf("%02x:%02x:%02x:%02x:%02x:%02x\t%g\t%d\t%s\n",
              info->ap.ether_addr_octet[0], info->ap.ether_addr_octet[1],
@@ -720,7 +721,7 @@ static int wapi_scan_results_cmd(int sock, int argc, FAR char **argv)
 
   /* Free ap list */
 
-  wapi_scan_coll_free(&list);
+  wapi_scan_results_free(&results);
   return 0;
 }
 
@@ -41,6 +41,7 @@
 #include <sys/ioctl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 #include <math.h>
 #include <errno.h>
@@ -294,55 +295,21 @@ static int wapi_event_stream_extract(FAR struct wapi_event_stream_s *stream,
 }
 
 /****************************************************************************
- * Name: wapi_scan_event
+ * Name: wapi_scan_event_info
  *
  * Description:
+ *   Decode one event into the current cell.  SIOCGIWAP, which starts a new
+ *   cell, is handled by the callers.
  *
  ****************************************************************************/
 
-static int wapi_scan_event(FAR struct iw_event *event,
-                           FAR struct wapi_list_s *list)
+static int wapi_scan_event_info(FAR struct iw_event *event,
+                                FAR struct wapi_scan_info_s *info)
 {
-  FAR struct wapi_scan_info_s *info;
-
-  /* Get current "wapi_info_t". */
-
-  info = list->head.scan;
-
   /* Decode the event. */
 
   switch (event->cmd)
     {
-    case SIOCGIWAP:
-      {
-        struct wapi_scan_info_s *temp;
-
-        /* Allocate a new cell. */
-
-        temp = malloc(sizeof(struct wapi_scan_info_s));
-        if (!temp)
-          {
-            WAPI_STRERROR("malloc()");
-            return -1;
-          }
-
-        /* Reset it. */
-
-        bzero(temp, sizeof(struct wapi_scan_info_s));
-
-        /* Save cell identifier. */
-
-        memcpy(&temp->ap, &event->u.ap_addr.sa_data,
-               sizeof(struct ether_addr));
-
-        /* Push it to the head of the list. */
-
-        temp->next = info;
-        list->head.scan = temp;
-
-        break;
-      }
-
     case SIOCGIWFREQ:
       {
         info->has_freq = 1;
@@ -439,6 +406,367 @@ static int wapi_scan_event(FAR struct iw_event *event,
   return 0;
 }
 
+/****************************************************************************
+ * Name: wapi_scan_event
+ *
+ * Description:
+ *
+ ****************************************************************************/
+
+static int wapi_scan_event(FAR struct iw_event *event,
+                           FAR struct wapi_list_s *list)
+{
+  FAR struct wapi_scan_info_s *info;
+
+  /* Get current "wapi_info_t". */
+
+  info = list->head.scan;
+
+  if (event->cmd == SIOCGIWAP)
+    {
+      struct wapi_scan_info_s *temp;
+
+      /* Allocate a new cell. */
+
+      temp = malloc(sizeof(struct wapi_scan_info_s));
+      if (!temp)
+        {
+          WAPI_STRERROR("malloc()");
+          return -1;
+        }
+
+      /* Reset it. */
+
+      bzero(temp, sizeof(struct wapi_scan_info_s));
+
+      /* Save cell identifier. */
+
+      memcpy(&temp->ap, &event->u.ap_addr.sa_data,
+             sizeof(struct ether_addr));
+
+      /* Push it to the head of the list. */
+
+      temp->next = info;
+      list->head.scan = temp;
+      return 0;
+    }
+
+  if (info == NULL)
+    {
+      /* Event before the first cell */
+
+      return 0;
+    }
+
+  return wapi_scan_event_info(event, info);
+}
+
+/****************************************************************************
+ * Name: wapi_scan_count
+ *
+ * Description:
+ *   Count the cells (SIOCGIWAP events) in an event stream.
+ *
+ ****************************************************************************/
+
+static int wapi_scan_count(FAR const char *buf, size_t len)
+{
+  FAR const struct iw_event *iwe;
+  FAR const char *end = buf + len;
+  int count = 0;
+
+  while (buf + offsetof(struct iw_event, u) <= end)
+    {
+      iwe = (FAR const struct iw_event *)buf;
+      if (buf + iwe->len > end || iwe->len < offsetof(struct iw_event, u))
+        {
+          return -EINVAL;
+        }
+
+      if (iwe->cmd == SIOCGIWAP)
+        {
+          count++;
+        }
+
+      buf += iwe->len;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: wapi_scan_fill
+ *
+ * Description:
+ *   Decode an event stream into an array of at most "maxaps" cells.
+ *
+ ****************************************************************************/
+
+static int wapi_scan_fill(FAR char *buf, size_t len,
+                          FAR struct wapi_scan_info_s *aps, int maxaps)
+{
+  FAR struct wapi_scan_info_s *info = NULL;
+  struct wapi_event_stream_s stream;
+  struct iw_event iwe;
+  int naps = 0;
+
+  wapi_event_stream_init(&stream, buf, len);
+  while (wapi_event_stream_extract(&stream, &iwe) > 0)
+    {
+      if (iwe.cmd == SIOCGIWAP)
+        {
+          if (naps >= maxaps)
+            {
+              break;
+            }
+
+          info = &aps[naps++];
+          bzero(info, sizeof(struct wapi_scan_info_s));
+          memcpy(&info->ap, &iwe.u.ap_addr.sa_data,
+                 sizeof(struct ether_addr));
+        }
+      else if (info != NULL)
+        {
+          /* A bad field only invalidates that field of the cell */
+
+          wapi_scan_event_info(&iwe, info);
+        }
+    }
+
+  return naps;
+}
+
+/****************************************************************************
+ * Name: wapi_scan_cmp_bssid / wapi_scan_cmp_rssi
+ *
+ * Description:
+ *   qsort() comparators.  Cells without a signal level sort last.
+ *
+ ****************************************************************************/
+
+static int wapi_scan_cmp_rssi(FAR const void *a, FAR const void *b)
+{
+  FAR const struct wapi_scan_info_s *ia = a;
+  FAR const struct wapi_scan_info_s *ib = b;
+
+  if (ia->has_rssi != ib->has_rssi)
+    {
+      return ib->has_rssi - ia->has_rssi;
+    }
+
+  return ib->rssi - ia->rssi;
+}
+
+static int wapi_scan_cmp_bssid(FAR const void *a, FAR const void *b)
+{
+  FAR const struct wapi_scan_info_s *ia = a;
+  FAR const struct wapi_scan_info_s *ib = b;
+  int ret;
+
+  ret = memcmp(&ia->ap, &ib->ap, sizeof(struct ether_addr));
+  return ret != 0 ? ret : wapi_scan_cmp_rssi(a, b);
+}
+
+/****************************************************************************
+ * Name: wapi_scan_finish
+ *
+ * Description:
+ *   Apply the WAPI_SCAN_* options to an array of cells and chain them.
+ *
+ ****************************************************************************/
+
+static int wapi_scan_finish(FAR struct wapi_scan_info_s *aps, int naps,
+                            int flags)
+{
+  int i;
+  int j;
+
+  if ((flags & WAPI_SCAN_DEDUPE) != 0 && naps > 1)
+    {
+      /* Group the cells by BSSID, strongest first, and keep the first of
+       * each group.  A hidden ESSID is taken from a duplicate that has it.
+       */
+
+      qsort(aps, naps, sizeof(struct wapi_scan_info_s), wapi_scan_cmp_bssid);
+
+      for (i = 0, j = 1; j < naps; j++)
+        {
+          if (memcmp(&aps[i].ap, &aps[j].ap, sizeof(struct ether_addr)) == 0)
+            {
+              if (aps[i].essid[0] == '\0' && aps[j].essid[0] != '\0')
+                {
+                  aps[i].has_essid  = aps[j].has_essid;
+                  aps[i].essid_flag = aps[j].essid_flag;
+                  memcpy(aps[i].essid, aps[j].essid, sizeof(aps[i].essid));
+                }
+            }
+          else if (++i != j)
+            {
+              aps[i] = aps[j];
+            }
+        }
+
+      naps = i + 1;
+    }
+
+  if ((flags & WAPI_SCAN_SORT_RSSI) != 0 && naps > 1)
+    {
+      qsort(aps, naps, sizeof(struct wapi_scan_info_s), wapi_scan_cmp_rssi);
+    }
+
+  for (i = 0; i < naps; i++)
+    {
+      aps[i].next = i + 1 < naps ? &aps[i + 1] : NULL;
+    }
+
+  return naps;
+}
+
+/****************************************************************************
+ * Name: wapi_scan_build
+ *
+ * Description:
+ *   Turn an arena holding "len" bytes of events into the result array.  The
+ *   arena is grown to hold the cells after the events, then the cells are
+ *   moved to the front and the arena is trimmed.  The arena is always
+ *   consumed.
+ *
+ ****************************************************************************/
+
+static int wapi_scan_build(FAR char *arena, size_t len, int flags,
+                           FAR struct wapi_scan_results_s *results)
+{
+  FAR struct wapi_scan_info_s *aps;
+  FAR char *tmp;
+  size_t offset;
+  int naps;
+
+  results->aps  = NULL;
+  results->naps = 0;
+
+  naps = wapi_scan_count(arena, len);
+  if (naps <= 0)
+    {
+      free(arena);
+      return naps;
+    }
+
+  offset = (len + sizeof(double) - 1) & ~(sizeof(double) - 1);
+  tmp = realloc(arena, offset + naps * sizeof(struct wapi_scan_info_s));
+  if (tmp == NULL)
+    {
+      WAPI_STRERROR("realloc()");
+      free(arena);
+      return -ENOMEM;
+    }
+
+  arena = tmp;
+  aps   = (FAR struct wapi_scan_info_s *)&arena[offset];
+  naps  = wapi_scan_fill(arena, len, aps, naps);
+  if (naps == 0)
+    {
+      free(arena);
+      return 0;
+    }
+
+  /* Drop the events, then chain the cells at their final location */
+
+  memmove(arena, aps, naps * sizeof(struct wapi_scan_info_s));
+  aps = (FAR struct wapi_scan_info_s *)arena;
+
+  tmp = realloc(arena, naps * sizeof(struct wapi_scan_info_s));
+  if (tmp != NULL)
+    {
+      aps = (FAR struct wapi_scan_info_s *)tmp;
+    }
+
+  results->aps  = aps;
+  results->naps = wapi_scan_finish(aps, naps, flags);
+  return results->naps;
+}
+
+/****************************************************************************
+ * Name: wapi_scan_fetch
+ *
+ * Description:
+ *   Read the raw scan events into *arena, growing it as needed.  The
+ *   arena is kept (and owned by the caller) on both success and failure.
+ *
+ * Returned Value:
+ *   The number of bytes of events; -EAGAIN if the scan is still running;
+ *   another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t wapi_scan_fetch(int sock, FAR const char *ifname,
+                               FAR char **arena, FAR size_t *arenalen)
+{
+  struct iwreq wrq =
+  {
+  };
+
+  FAR char *tmp;
+  size_t newlen;
+  int errcode;
+  int ret;
+
+  if (*arena == NULL)
+    {
+      newlen = *arenalen > 0 ? *arenalen : IW_SCAN_MAX_DATA;
+      *arena = malloc(newlen);
+      if (*arena == NULL)
+        {
+          WAPI_STRERROR("malloc()");
+          return -ENOMEM;
+        }
+
+      *arenalen = newlen;
+    }
+
+  for (; ; )
+    {
+      wrq.u.data.pointer = *arena;
+      wrq.u.data.length  = *arenalen > UINT16_MAX ? UINT16_MAX : *arenalen;
+      wrq.u.data.flags   = 0;
+      strncpy(wrq.ifr_name, ifname, IFNAMSIZ);
+
+      ret = ioctl(sock, SIOCGIWSCAN, (unsigned long)((uintptr_t)&wrq));
+      if (ret >= 0)
+        {
+          return wrq.u.data.length;
+        }
+
+      errcode = errno;
+      if (errcode != E2BIG || *arenalen >= UINT16_MAX)
+        {
+          if (errcode != EAGAIN)
+            {
+              WAPI_IOCTL_STRERROR(SIOCGIWSCAN, errcode);
+            }
+
+          return -errcode;
+        }
+
+      /* Grow to the size the driver reports, or double if it does not */
+
+      newlen = *arenalen * 2;
+      if (wrq.u.data.length > *arenalen)
+        {
+          newlen = wrq.u.data.length;
+        }
+
+      tmp = realloc(*arena, newlen);
+      if (tmp == NULL)
+        {
+          WAPI_STRERROR("realloc()");
+          return -ENOMEM;
+        }
+
+      *arena    = tmp;
+      *arenalen = newlen;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1393,6 +1721,156 @@ void wapi_scan_coll_free(FAR struct wapi_list_s *list)
     }
 }
 
+/****************************************************************************
+ * Name: wapi_scan_parse
+ *
+ * Description:
+ *   Parse a SIOCGIWSCAN event buffer into a flat array of results.
+ *
+ ****************************************************************************/
+
+int wapi_scan_parse(FAR const char *buf, size_t len, int flags,
+                    FAR struct wapi_scan_results_s *results)
+{
+  FAR char *arena;
+
+  WAPI_VALIDATE_PTR(buf);
+  WAPI_VALIDATE_PTR(results);
+
+  /* The events are decoded in place, so work on a copy */
+
+  arena = malloc(len > 0 ? len : 1);
+  if (arena == NULL)
+    {
+      WAPI_STRERROR("malloc()");
+      return -ENOMEM;
+    }
+
+  memcpy(arena, buf, len);
+  return wapi_scan_build(arena, len, flags, results);
+}
+
+/****************************************************************************
+ * Name: wapi_scan_coll_flat
+ *
+ * Description:
+ *   Collects the results of a scan process into a flat array.
+ *
+ ****************************************************************************/
+
+int wapi_scan_coll_flat(int sock, FAR const char *ifname, int flags,
+                        FAR struct wapi_scan_results_s *results)
+{
+  FAR char *arena = NULL;
+  size_t arenalen = 0;
+  ssize_t len;
+
+  WAPI_VALIDATE_PTR(results);
+
+  len = wapi_scan_fetch(sock, ifname, &arena, &arenalen);
+  if (len < 0)
+    {
+      free(arena);
+      return len;
+    }
+
+  return wapi_scan_build(arena, len, flags, results);
+}
+
+/****************************************************************************
+ * Name: wapi_scan_results_free
+ *
+ * Description:
+ *   Free the flat scan results.
+ *
+ ****************************************************************************/
+
+void wapi_scan_results_free(FAR struct wapi_scan_results_s *results)
+{
+  if (results != NULL)
+    {
+      free(results->aps);
+      results->aps  = NULL;
+      results->naps = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: wapi_scan_async_start
+ *
+ * Description:
+ *   Starts a scan and returns immediately.
+ *
+ ****************************************************************************/
+
+int wapi_scan_async_start(FAR struct wapi_scan_async_s *scan, int sock,
+                          FAR const char *ifname, FAR const char *essid,
+                          int flags)
+{
+  WAPI_VALIDATE_PTR(scan);
+
+  /* A previous arena is kept as a size hint for this scan */
+
+  scan->sock  = sock;
+  scan->flags = flags;
+  strlcpy(scan->ifname, ifname, sizeof(scan->ifname));
+
+  return wapi_scan_init(sock, ifname, essid);
+}
+
+/****************************************************************************
+ * Name: wapi_scan_async_poll
+ *
+ * Description:
+ *   Checks for the results of an asynchronous scan without blocking.
+ *
+ ****************************************************************************/
+
+int wapi_scan_async_poll(FAR struct wapi_scan_async_s *scan,
+                         FAR struct wapi_scan_results_s *results)
+{
+  ssize_t len;
+  int ret;
+
+  WAPI_VALIDATE_PTR(scan);
+  WAPI_VALIDATE_PTR(results);
+
+  len = wapi_scan_fetch(scan->sock, scan->ifname, &scan->arena,
+                        &scan->arenalen);
+  if (len == -EAGAIN)
+    {
+      return 1;
+    }
+  else if (len < 0)
+    {
+      return len;
+    }
+
+  /* The arena now belongs to the results; only its size is remembered */
+
+  ret = wapi_scan_build(scan->arena, len, scan->flags, results);
+  scan->arena = NULL;
+  return ret < 0 ? ret : 0;
+}
+
+/****************************************************************************
+ * Name: wapi_scan_async_cancel
+ *
+ * Description:
+ *   Release the resources of an asynchronous scan.
+ *
+ ****************************************************************************/
+
+void wapi_scan_async_cancel(FAR struct wapi_scan_async_s *scan)
+{
+  if (scan != NULL)
+    {
+      free(scan->arena);
+      scan->arena    = NULL;
+      scan->arenalen = 0;
+    }
+}
+
 /****************************************************************************
  * Name: wapi_set_country
  *